@@ -0,0 +1,369 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOST_INTERPROCESS_ARENA_ALLOCATOR_HPP
+#define BOOST_INTERPROCESS_ARENA_ALLOCATOR_HPP
+
+#if (defined _MSC_VER) && (_MSC_VER >= 1200)
+#  pragma once
+#endif
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/detail/workaround.hpp>
+
+#include <boost/intrusive/pointer_traits.hpp>
+
+#include <boost/interprocess/interprocess_fwd.hpp>
+#include <boost/interprocess/detail/utilities.hpp>
+#include <boost/interprocess/detail/type_traits.hpp>
+#include <boost/interprocess/containers/version_type.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/assert.hpp>
+#include <boost/utility/addressof.hpp>
+#include <cstddef>
+#include <new>
+
+//!\file
+//!Describes segment_arena, a bump allocator that carves big chunks of a
+//!memory segment, and arena_allocator, an STL compatible allocator that uses it
+
+namespace boost {
+namespace interprocess {
+
+//!A sub-arena of a memory segment for short-lived allocations. It allocates chunks
+//!of "chunk_size" bytes from the segment manager and serves allocations incrementing
+//!a pointer in the current chunk, so only one allocation in "chunk_size" bytes locks
+//!the memory algorithm of the segment. Memory is not reused when it's deallocated:
+//!all of it is released at once with reset() or release(), which return chunks to
+//!the segment manager with a single deallocate_many() call.
+//!
+//!The arena can be placed in the managed segment, as it only stores
+//!"typename SegmentManager::void_pointer" pointers. It's not synchronized:
+//!a segment_arena must not be used concurrently by several threads.
+template<class SegmentManager>
+class segment_arena
+{
+   /// @cond
+   segment_arena(const segment_arena &);
+   segment_arena &operator=(const segment_arena &);
+
+   typedef typename SegmentManager::void_pointer                  void_pointer;
+   typedef typename boost::intrusive::
+      pointer_traits<void_pointer>::template
+         rebind_pointer<SegmentManager>::type                     segment_manager_ptr;
+   typedef typename boost::intrusive::
+      pointer_traits<void_pointer>::template
+         rebind_pointer<char>::type                               char_ptr;
+   /// @endcond
+
+   public:
+   typedef SegmentManager                                         segment_manager;
+   typedef typename SegmentManager::size_type                     size_type;
+   typedef typename SegmentManager::multiallocation_chain         multiallocation_chain;
+
+   //!Alignment of the allocations of the arena
+   static const size_type Alignment = SegmentManager::memory_algorithm::Alignment;
+
+   static const size_type DefaultChunkSize = 64*1024;
+
+   //!Constructs an empty arena that will allocate chunks of "chunk_size"
+   //!bytes from the segment manager. Never throws
+   explicit segment_arena(segment_manager *segment_mngr, size_type chunk_size = DefaultChunkSize)
+      :  mp_mngr(segment_mngr), m_first(), m_cur(), m_end()
+      ,  m_chunk_size(chunk_size > MinChunkSize ? chunk_size : MinChunkSize)
+      ,  m_num_chunks(0)
+   {}
+
+   //!Returns all the chunks to the segment manager. Never throws
+   ~segment_arena()
+   {  this->release();  }
+
+   //!Allocates nbytes bytes aligned to Alignment. Returns 0 if the
+   //!segment manager can't allocate a new chunk. Never throws
+   void *allocate(size_type nbytes, std::nothrow_t)
+   {
+      const size_type units = nbytes ? (nbytes + Alignment - 1)/Alignment*Alignment : Alignment;
+      if(units < nbytes)
+         return 0;
+      if(size_type(m_end - m_cur) >= units){
+         void *ret = ipcdetail::to_raw_pointer(m_cur);
+         m_cur += difference_type(units);
+         return ret;
+      }
+      return this->priv_allocate_new_chunk(units);
+   }
+
+   //!Allocates nbytes bytes aligned to Alignment.
+   //!Throws boost::interprocess::bad_alloc if there is no enough memory
+   void *allocate(size_type nbytes)
+   {
+      void *ret = this->allocate(nbytes, std::nothrow);
+      if(!ret)
+         throw bad_alloc();
+      return ret;
+   }
+
+   //!Memory is only released with reset() or release().
+   //!Never throws
+   void deallocate(void *)
+   {}
+
+   //!Deallocates all the allocations of the arena. The current chunk is
+   //!kept for following allocations and the rest are returned to the segment
+   //!manager. Never throws
+   void reset()
+   {
+      if(!m_end){
+         this->release();
+         return;
+      }
+      chunk_t *const cur = static_cast<chunk_t*>(ipcdetail::to_raw_pointer(m_first));
+      multiallocation_chain chain;
+      this->priv_chunks_to_chain(cur->m_next, chain);
+      mp_mngr->deallocate_many(chain);
+      cur->m_next  = void_pointer();
+      m_num_chunks = 1;
+      m_cur = static_cast<char*>(static_cast<void*>(cur)) + HeaderSize;
+   }
+
+   //!Deallocates all the allocations of the arena and returns all chunks
+   //!to the segment manager. Never throws
+   void release()
+   {
+      multiallocation_chain chain;
+      this->priv_chunks_to_chain(m_first, chain);
+      mp_mngr->deallocate_many(chain);
+      m_first = void_pointer();
+      m_cur = m_end = char_ptr();
+      m_num_chunks = 0;
+   }
+
+   //!Returns the number of chunks allocated from the segment manager. Never throws
+   size_type get_num_chunks() const
+   {  return m_num_chunks;  }
+
+   //!Returns the size of the chunks of the arena. Never throws
+   size_type get_chunk_size() const
+   {  return m_chunk_size;  }
+
+   //!Returns the number of bytes that can be allocated without
+   //!allocating a new chunk. Never throws
+   size_type get_free_memory() const
+   {  return size_type(m_end - m_cur);  }
+
+   //!Returns the segment manager. Never throws
+   segment_manager *get_segment_manager() const
+   {  return ipcdetail::to_raw_pointer(mp_mngr);  }
+
+   /// @cond
+   private:
+   typedef typename SegmentManager::difference_type               difference_type;
+
+   struct chunk_t
+   {
+      void_pointer m_next;
+   };
+
+   static const size_type HeaderSize   = (sizeof(chunk_t) + Alignment - 1)/Alignment*Alignment;
+   static const size_type MinChunkSize = HeaderSize*16;
+
+   //Allocates a chunk for an allocation of "units" bytes. Allocations bigger than a
+   //quarter of the chunk size get their own chunk, placed after the current one
+   void *priv_allocate_new_chunk(size_type units)
+   {
+      const bool own_chunk = units > m_chunk_size/4;
+      const size_type chunk_size = own_chunk ? units + HeaderSize : m_chunk_size;
+      if(chunk_size < units)
+         return 0;
+      void *addr = mp_mngr->allocate(chunk_size, std::nothrow);
+      if(!addr)
+         return 0;
+      chunk_t *const chunk = ::new(addr) chunk_t;
+      char *const ret = static_cast<char*>(addr) + HeaderSize;
+      ++m_num_chunks;
+      if(own_chunk && m_end){
+         chunk_t *const cur = static_cast<chunk_t*>(ipcdetail::to_raw_pointer(m_first));
+         chunk->m_next = cur->m_next;
+         cur->m_next   = chunk;
+      }
+      else{
+         //The first chunk of the list is the current one if m_end is not null
+         chunk->m_next = m_first;
+         m_first = chunk;
+         if(!own_chunk){
+            m_cur = ret + units;
+            m_end = static_cast<char*>(addr) + chunk_size;
+         }
+      }
+      return ret;
+   }
+
+   void priv_chunks_to_chain(const void_pointer &first, multiallocation_chain &chain)
+   {
+      void_pointer next = first;
+      while(next){
+         chunk_t *const chunk = static_cast<chunk_t*>(ipcdetail::to_raw_pointer(next));
+         next = chunk->m_next;
+         chunk->~chunk_t();
+         chain.push_back(void_pointer(chunk));
+      }
+   }
+
+   segment_manager_ptr  mp_mngr;
+   void_pointer         m_first;
+   char_ptr             m_cur;
+   char_ptr             m_end;
+   size_type            m_chunk_size;
+   size_type            m_num_chunks;
+   /// @endcond
+};
+
+//!An STL compatible allocator that allocates memory from a segment_arena.
+//!The internal pointer type will of the same type (raw, smart) as
+//!"typename SegmentManager::void_pointer" type. This allows
+//!placing the allocator in shared memory, memory mapped-files, etc...
+//!
+//!deallocate() does nothing: memory is released when the arena
+//!is reset or released, so containers that use arena_allocator must not
+//!be used after that, other than to be destroyed.
+template<class T, class SegmentManager>
+class arena_allocator
+{
+   /// @cond
+   private:
+   typedef arena_allocator<T, SegmentManager>            self_t;
+   typedef typename SegmentManager::void_pointer         aux_pointer_t;
+   typedef typename boost::intrusive::
+      pointer_traits<aux_pointer_t>::template
+         rebind_pointer<const void>::type                cvoid_ptr;
+
+   //Not assignable from related arena_allocator
+   template<class T2, class SegmentManager2>
+   arena_allocator& operator=(const arena_allocator<T2, SegmentManager2>&);
+
+   //Not assignable from other arena_allocator
+   arena_allocator& operator=(const arena_allocator&);
+   /// @endcond
+
+   public:
+   typedef SegmentManager                                segment_manager;
+   typedef segment_arena<SegmentManager>                 arena_type;
+   typedef T                                             value_type;
+   typedef typename boost::intrusive::
+      pointer_traits<cvoid_ptr>::template
+         rebind_pointer<T>::type                         pointer;
+   typedef typename boost::intrusive::
+      pointer_traits<pointer>::template
+         rebind_pointer<const T>::type                   const_pointer;
+   typedef typename ipcdetail::add_reference
+                     <value_type>::type                  reference;
+   typedef typename ipcdetail::add_reference
+                     <const value_type>::type            const_reference;
+   typedef typename segment_manager::size_type           size_type;
+   typedef typename segment_manager::difference_type     difference_type;
+
+   typedef boost::interprocess::version_type<arena_allocator, 1>   version;
+
+   //!Obtains an arena_allocator that allocates
+   //!objects of type T2
+   template<class T2>
+   struct rebind
+   {
+      typedef arena_allocator<T2, SegmentManager>  other;
+   };
+
+   //!Constructor from the arena. Never throws
+   arena_allocator(arena_type *arena)
+      : mp_arena(arena) { }
+
+   //!Constructor from other arena_allocator. Never throws
+   arena_allocator(const arena_allocator &other)
+      : mp_arena(other.get_arena()){ }
+
+   //!Constructor from related arena_allocator. Never throws
+   template<class T2>
+   arena_allocator(const arena_allocator<T2, SegmentManager> &other)
+      : mp_arena(other.get_arena()){}
+
+   //!Returns the arena. Never throws
+   arena_type* get_arena() const
+   {  return ipcdetail::to_raw_pointer(mp_arena);   }
+
+   //!Returns the segment manager. Never throws
+   segment_manager* get_segment_manager() const
+   {  return mp_arena->get_segment_manager();   }
+
+   //!Allocates memory for an array of count elements.
+   //!Throws boost::interprocess::bad_alloc if there is no enough memory
+   pointer allocate(size_type count, cvoid_ptr hint = 0)
+   {
+      (void)hint;
+      if(size_overflows<sizeof(T)>(count)){
+         throw bad_alloc();
+      }
+      return pointer(static_cast<value_type*>(mp_arena->allocate(count*sizeof(T))));
+   }
+
+   //!Does nothing: memory is released by the arena. Never throws
+   void deallocate(const pointer &ptr, size_type)
+   {  mp_arena->deallocate((void*)ipcdetail::to_raw_pointer(ptr));  }
+
+   //!Returns the number of elements that could be allocated. Never throws
+   size_type max_size() const
+   {  return mp_arena->get_segment_manager()->get_size()/sizeof(T);   }
+
+   //!Returns address of mutable object. Never throws
+   pointer address(reference value) const
+   {  return pointer(boost::addressof(value));  }
+
+   //!Returns address of non mutable object. Never throws
+   const_pointer address(const_reference value) const
+   {  return const_pointer(boost::addressof(value));  }
+
+   //!Constructs an object. Throws if T(const T&) throws
+   void construct(const pointer &ptr, const_reference v)
+   {  new((void*)ipcdetail::to_raw_pointer(ptr)) value_type(v);  }
+
+   //!Destroys object. Throws if object's destructor throws
+   void destroy(const pointer &ptr)
+   {  BOOST_ASSERT(ptr != 0); (*ptr).~value_type();  }
+
+   //!Swap arenas. Does not throw. If each arena_allocator is placed in
+   //!different memory segments, the result is undefined.
+   friend void swap(self_t &alloc1, self_t &alloc2)
+   {  ipcdetail::do_swap(alloc1.mp_arena, alloc2.mp_arena);   }
+
+   /// @cond
+   private:
+   typedef typename boost::intrusive::
+      pointer_traits<cvoid_ptr>::template
+         rebind_pointer<arena_type>::type                arena_ptr_t;
+   arena_ptr_t mp_arena;
+   /// @endcond
+};
+
+//!Equality test for same type of arena_allocator
+template<class T, class SegmentManager> inline
+bool operator==(const arena_allocator<T, SegmentManager> &alloc1,
+                const arena_allocator<T, SegmentManager> &alloc2)
+   {  return alloc1.get_arena() == alloc2.get_arena(); }
+
+//!Inequality test for same type of arena_allocator
+template<class T, class SegmentManager> inline
+bool operator!=(const arena_allocator<T, SegmentManager> &alloc1,
+                const arena_allocator<T, SegmentManager> &alloc2)
+   {  return alloc1.get_arena() != alloc2.get_arena(); }
+
+}  //namespace interprocess {
+}  //namespace boost {
+
+#include <boost/interprocess/detail/config_end.hpp>
+
+#endif   //BOOST_INTERPROCESS_ARENA_ALLOCATOR_HPP
@@ -21,6 +21,7 @@
 #include <boost/interprocess/interprocess_fwd.hpp>
 #include <boost/interprocess/allocators/detail/adaptive_node_pool.hpp>
 #include <boost/interprocess/allocators/detail/allocator_common.hpp>
+#include <boost/interprocess/allocators/detail/magazine_node_pool.hpp>
 #include <boost/interprocess/detail/utilities.hpp>
 #include <boost/interprocess/detail/workaround.hpp>
 #include <boost/interprocess/containers/version_type.hpp>
@@ -110,23 +111,31 @@ class cached_adaptive_pool_v1
 //!
 //!OverheadPercent is the (approximated) maximum size overhead (1-20%) of the allocator:
 //!(memory usable for nodes / total memory allocated from the segment manager)
+//!
+//!CachePolicy selects where free nodes are cached: in each allocator
+//!(allocator_cache_policy, the default) or in per-thread magazines of
+//!the node pool (magazine_cache_policy)
 template < class T
          , class SegmentManager
          , std::size_t NodesPerBlock
          , std::size_t MaxFreeBlocks
          , unsigned char OverheadPercent
+         , class CachePolicy
          >
 class cached_adaptive_pool
    /// @cond
    :  public ipcdetail::cached_allocator_impl
          < T
-         , ipcdetail::shared_adaptive_node_pool
-            < SegmentManager
-            , sizeof_value<T>::value
-            , NodesPerBlock
-            , MaxFreeBlocks
-            , OverheadPercent
-            >
+         , typename ipcdetail::select_cached_node_pool
+            < ipcdetail::shared_adaptive_node_pool
+               < SegmentManager
+               , sizeof_value<T>::value
+               , NodesPerBlock
+               , MaxFreeBlocks
+               , OverheadPercent
+               >
+            , CachePolicy
+            >::type
          , 2>
    /// @endcond
 {
@@ -135,13 +144,16 @@ class cached_adaptive_pool
    public:
    typedef ipcdetail::cached_allocator_impl
          < T
-         , ipcdetail::shared_adaptive_node_pool
-            < SegmentManager
-            , sizeof_value<T>::value
-            , NodesPerBlock
-            , MaxFreeBlocks
-            , OverheadPercent
-            >
+         , typename ipcdetail::select_cached_node_pool
+            < ipcdetail::shared_adaptive_node_pool
+               < SegmentManager
+               , sizeof_value<T>::value
+               , NodesPerBlock
+               , MaxFreeBlocks
+               , OverheadPercent
+               >
+            , CachePolicy
+            >::type
          , 2> base_t;
 
    public:
@@ -151,7 +163,7 @@ class cached_adaptive_pool
    struct rebind
    {
       typedef cached_adaptive_pool
-         <T2, SegmentManager, NodesPerBlock, MaxFreeBlocks, OverheadPercent>  other;
+         <T2, SegmentManager, NodesPerBlock, MaxFreeBlocks, OverheadPercent, CachePolicy>  other;
    };
 
    cached_adaptive_pool(SegmentManager *segment_mngr,
@@ -161,7 +173,7 @@ class cached_adaptive_pool
 
    template<class T2>
    cached_adaptive_pool
-      (const cached_adaptive_pool<T2, SegmentManager, NodesPerBlock, MaxFreeBlocks, OverheadPercent> &other)
+      (const cached_adaptive_pool<T2, SegmentManager, NodesPerBlock, MaxFreeBlocks, OverheadPercent, CachePolicy> &other)
       : base_t(other)
    {}
 
@@ -184,15 +196,15 @@ class cached_adaptive_pool
    template<class T2>
    struct rebind
    {
-      typedef cached_adaptive_pool<T2, SegmentManager, NodesPerBlock, MaxFreeBlocks, OverheadPercent> other;
+      typedef cached_adaptive_pool<T2, SegmentManager, NodesPerBlock, MaxFreeBlocks, OverheadPercent, CachePolicy> other;
    };
 
    private:
    //!Not assignable from
    //!related cached_adaptive_pool
-   template<class T2, class SegmentManager2, std::size_t N2, std::size_t F2, unsigned char OP2>
+   template<class T2, class SegmentManager2, std::size_t N2, std::size_t F2, unsigned char OP2, class C2>
    cached_adaptive_pool& operator=
-      (const cached_adaptive_pool<T2, SegmentManager2, N2, F2, OP2>&);
+      (const cached_adaptive_pool<T2, SegmentManager2, N2, F2, OP2, C2>&);
 
    //!Not assignable from
    //!other cached_adaptive_pool
@@ -213,7 +225,7 @@ class cached_adaptive_pool
    //!Can throw boost::interprocess::bad_alloc
    template<class T2>
    cached_adaptive_pool
-      (const cached_adaptive_pool<T2, SegmentManager, NodesPerBlock, MaxFreeBlocks, OverheadPercent> &other);
+      (const cached_adaptive_pool<T2, SegmentManager, NodesPerBlock, MaxFreeBlocks, OverheadPercent, CachePolicy> &other);
 
    //!Destructor, removes node_pool_t from memory
    //!if its reference count reaches to zero. Never throws
@@ -334,15 +346,15 @@ class cached_adaptive_pool
 
 //!Equality test for same type
 //!of cached_adaptive_pool
-template<class T, class S, std::size_t NodesPerBlock, std::size_t F, std::size_t OP> inline
-bool operator==(const cached_adaptive_pool<T, S, NodesPerBlock, F, OP> &alloc1,
-                const cached_adaptive_pool<T, S, NodesPerBlock, F, OP> &alloc2);
+template<class T, class S, std::size_t NodesPerBlock, std::size_t F, std::size_t OP, class C> inline
+bool operator==(const cached_adaptive_pool<T, S, NodesPerBlock, F, OP, C> &alloc1,
+                const cached_adaptive_pool<T, S, NodesPerBlock, F, OP, C> &alloc2);
 
 //!Inequality test for same type
 //!of cached_adaptive_pool
-template<class T, class S, std::size_t NodesPerBlock, std::size_t F, std::size_t OP> inline
-bool operator!=(const cached_adaptive_pool<T, S, NodesPerBlock, F, OP> &alloc1,
-                const cached_adaptive_pool<T, S, NodesPerBlock, F, OP> &alloc2);
+template<class T, class S, std::size_t NodesPerBlock, std::size_t F, std::size_t OP, class C> inline
+bool operator!=(const cached_adaptive_pool<T, S, NodesPerBlock, F, OP, C> &alloc1,
+                const cached_adaptive_pool<T, S, NodesPerBlock, F, OP, C> &alloc2);
 
 #endif
 
@@ -21,6 +21,7 @@
 #include <boost/interprocess/interprocess_fwd.hpp>
 #include <boost/interprocess/allocators/detail/node_pool.hpp>
 #include <boost/interprocess/allocators/detail/allocator_common.hpp>
+#include <boost/interprocess/allocators/detail/magazine_node_pool.hpp>
 #include <boost/interprocess/detail/workaround.hpp>
 #include <boost/interprocess/detail/utilities.hpp>
 #include <boost/interprocess/containers/version_type.hpp>
@@ -88,19 +89,30 @@ class cached_node_allocator_v1
 
 /// @endcond
 
+//!PoolPolicy selects how the node pool shared by all cached_node_allocators
+//!is synchronized: mutex_pool_policy (the default) or lock_free_pool_policy.
+//!CachePolicy selects where free nodes are cached: in each allocator
+//!(allocator_cache_policy, the default) or in per-thread magazines of
+//!the node pool (magazine_cache_policy)
 template < class T
          , class SegmentManager
          , std::size_t NodesPerBlock
+         , class PoolPolicy
+         , class CachePolicy
          >
 class cached_node_allocator
    /// @cond
    :  public ipcdetail::cached_allocator_impl
          < T
-         , ipcdetail::shared_node_pool
-            < SegmentManager
-            , sizeof_value<T>::value
-            , NodesPerBlock
-            >
+         , typename ipcdetail::select_cached_node_pool
+            < typename ipcdetail::select_node_pool
+               < SegmentManager
+               , sizeof_value<T>::value
+               , NodesPerBlock
+               , PoolPolicy
+               >::type
+            , CachePolicy
+            >::type
          , 2>
    /// @endcond
 {
@@ -109,11 +121,15 @@ class cached_node_allocator
    public:
    typedef ipcdetail::cached_allocator_impl
          < T
-         , ipcdetail::shared_node_pool
-            < SegmentManager
-            , sizeof_value<T>::value
-            , NodesPerBlock
-            >
+         , typename ipcdetail::select_cached_node_pool
+            < typename ipcdetail::select_node_pool
+               < SegmentManager
+               , sizeof_value<T>::value
+               , NodesPerBlock
+               , PoolPolicy
+               >::type
+            , CachePolicy
+            >::type
          , 2> base_t;
 
    public:
@@ -123,7 +139,7 @@ class cached_node_allocator
    template<class T2>
    struct rebind
    {
-      typedef cached_node_allocator<T2, SegmentManager, NodesPerBlock>  other;
+      typedef cached_node_allocator<T2, SegmentManager, NodesPerBlock, PoolPolicy, CachePolicy>  other;
    };
 
    cached_node_allocator(SegmentManager *segment_mngr,
@@ -133,7 +149,7 @@ class cached_node_allocator
 
    template<class T2>
    cached_node_allocator
-      (const cached_node_allocator<T2, SegmentManager, NodesPerBlock> &other)
+      (const cached_node_allocator<T2, SegmentManager, NodesPerBlock, PoolPolicy, CachePolicy> &other)
       : base_t(other)
    {}
 
@@ -156,15 +172,15 @@ class cached_node_allocator
    template<class T2>
    struct rebind
    {
-      typedef cached_node_allocator<T2, SegmentManager> other;
+      typedef cached_node_allocator<T2, SegmentManager, NodesPerBlock, PoolPolicy, CachePolicy> other;
    };
 
    private:
    //!Not assignable from
    //!related cached_node_allocator
-   template<class T2, class SegmentManager2, std::size_t N2>
+   template<class T2, class SegmentManager2, std::size_t N2, class P2, class C2>
    cached_node_allocator& operator=
-      (const cached_node_allocator<T2, SegmentManager2, N2>&);
+      (const cached_node_allocator<T2, SegmentManager2, N2, P2, C2>&);
 
    //!Not assignable from
    //!other cached_node_allocator
@@ -185,7 +201,7 @@ class cached_node_allocator
    //!Can throw boost::interprocess::bad_alloc
    template<class T2>
    cached_node_allocator
-      (const cached_node_allocator<T2, SegmentManager, NodesPerBlock> &other);
+      (const cached_node_allocator<T2, SegmentManager, NodesPerBlock, PoolPolicy, CachePolicy> &other);
 
    //!Destructor, removes node_pool_t from memory
    //!if its reference count reaches to zero. Never throws
@@ -306,15 +322,15 @@ class cached_node_allocator
 
 //!Equality test for same type
 //!of cached_node_allocator
-template<class T, class S, std::size_t NPC> inline
-bool operator==(const cached_node_allocator<T, S, NPC> &alloc1,
-                const cached_node_allocator<T, S, NPC> &alloc2);
+template<class T, class S, std::size_t NPC, class P, class C> inline
+bool operator==(const cached_node_allocator<T, S, NPC, P, C> &alloc1,
+                const cached_node_allocator<T, S, NPC, P, C> &alloc2);
 
 //!Inequality test for same type
 //!of cached_node_allocator
-template<class T, class S, std::size_t NPC> inline
-bool operator!=(const cached_node_allocator<T, S, NPC> &alloc1,
-                const cached_node_allocator<T, S, NPC> &alloc2);
+template<class T, class S, std::size_t NPC, class P, class C> inline
+bool operator!=(const cached_node_allocator<T, S, NPC, P, C> &alloc1,
+                const cached_node_allocator<T, S, NPC, P, C> &alloc2);
 
 #endif
 
@@ -297,6 +297,13 @@ class cache_impl
    }
 };
 
+//!Obtains the cache that cached allocators use with NodePool
+template<class NodePool>
+struct select_cache_impl
+{
+   typedef cache_impl<NodePool> type;
+};
+
 template<class Derived, class T, class SegmentManager>
 class array_allocation_impl
 {
@@ -678,7 +685,7 @@ class cached_allocator_impl
 
    /// @cond
    private:
-   cache_impl<node_pool_t> m_cache;
+   typename select_cache_impl<node_pool_t>::type m_cache;
 };
 
 //!Equality test for same type of
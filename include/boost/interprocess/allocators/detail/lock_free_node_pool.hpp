@@ -0,0 +1,372 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOST_INTERPROCESS_DETAIL_LOCK_FREE_NODE_POOL_HPP
+#define BOOST_INTERPROCESS_DETAIL_LOCK_FREE_NODE_POOL_HPP
+
+#if (defined _MSC_VER) && (_MSC_VER >= 1200)
+#  pragma once
+#endif
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/detail/workaround.hpp>
+
+#include <boost/interprocess/detail/atomic.hpp>
+
+#if defined(BOOST_INTERPROCESS_HAS_ATOMIC64)
+
+#include <boost/intrusive/pointer_traits.hpp>
+#include <boost/interprocess/detail/utilities.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/detail/no_exceptions_support.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/assert.hpp>
+#include <cstddef>
+
+//!\file
+//!Describes a node pool whose free node list can be used without locks
+
+namespace boost {
+namespace interprocess {
+namespace ipcdetail {
+
+//!Pooled shared memory allocator using single segregated storage, whose
+//!free node list is a lock-free stack. The head of the stack is a 64 bit word
+//!that packs the offset of the first free node from the pool and a tag that
+//!is incremented in each push and pop, to avoid the ABA problem, so it's valid
+//!in every process that maps the segment. Only new blocks of nodes, obtained
+//!from the segment manager, are allocated under a mutex. Includes a reference
+//!count but the class does not delete itself, this is responsibility of user
+//!classes. Node size (NodeSize) and the number of nodes allocated per block
+//!(NodesPerBlock) are known at compile time
+template< class SegmentManager, std::size_t NodeSize, std::size_t NodesPerBlock >
+class lock_free_node_pool
+{
+   //Non-copyable
+   lock_free_node_pool();
+   lock_free_node_pool(const lock_free_node_pool &);
+   lock_free_node_pool &operator=(const lock_free_node_pool &);
+
+   typedef typename SegmentManager::void_pointer                  void_pointer;
+   typedef typename SegmentManager::mutex_family::mutex_type      mutex_type;
+   typedef typename boost::intrusive::pointer_traits
+      <void_pointer>::template rebind_pointer<SegmentManager>::type segment_manager_ptr_t;
+
+   public:
+   typedef SegmentManager                                         segment_manager;
+   typedef typename SegmentManager::multiallocation_chain         multiallocation_chain;
+   typedef typename SegmentManager::size_type                     size_type;
+
+   static const size_type nodes_per_block = NodesPerBlock;
+   //Deprecated, use nodes_per_block
+   static const size_type nodes_per_chunk = NodesPerBlock;
+
+   //!Constructor from a segment manager. Never throws
+   lock_free_node_pool(segment_manager *segment_mngr)
+      :  mp_segment_mngr(segment_mngr), m_head(0), m_blocks(0), m_usecount(0)
+   {}
+
+   //!Destructor. Deallocates all allocated blocks. Never throws
+   ~lock_free_node_pool()
+   {  this->purge_blocks();  }
+
+   //!Returns the segment manager. Never throws
+   segment_manager* get_segment_manager() const
+   {  return ipcdetail::to_raw_pointer(mp_segment_mngr);  }
+
+   //!Allocates a node without locking unless a new block of nodes
+   //!must be allocated. Can throw boost::interprocess::bad_alloc
+   void *allocate_node()
+   {
+      node_t *node = this->priv_pop();
+      return node ? node : this->priv_alloc_block();
+   }
+
+   //!Deallocates a node without locking. Never throws
+   void deallocate_node(void *ptr)
+   {
+      node_t *node = static_cast<node_t*>(ptr);
+      this->priv_push(node, node);
+   }
+
+   //!Allocates n nodes. Can throw boost::interprocess::bad_alloc
+   void allocate_nodes(const size_type n, multiallocation_chain &chain)
+   {
+      multiallocation_chain nodes;
+      BOOST_TRY{
+         for(size_type i = 0; i != n; ++i){
+            nodes.push_front(void_pointer(this->allocate_node()));
+         }
+      }
+      BOOST_CATCH(...){
+         this->deallocate_nodes(nodes);
+         BOOST_RETHROW
+      }
+      BOOST_CATCH_END
+      chain.splice_after(chain.last(), nodes);
+   }
+
+   //!Deallocates the nodes of the chain pushing them in a single
+   //!operation. Never throws
+   void deallocate_nodes(multiallocation_chain &chain)
+   {
+      if(chain.empty())
+         return;
+      node_t *const first = static_cast<node_t*>(ipcdetail::to_raw_pointer(chain.pop_front()));
+      node_t *last = first;
+      while(!chain.empty()){
+         node_t *const node = static_cast<node_t*>(ipcdetail::to_raw_pointer(chain.pop_front()));
+         last->m_next = this->priv_encode(node);
+         last = node;
+      }
+      this->priv_push(first, last);
+   }
+
+   //!Deallocates all the free blocks of memory. Nodes are taken from the
+   //!free list while blocks are inspected, so other threads only
+   //!wait for the lock if they must allocate a new block. Never throws
+   void deallocate_free_blocks()
+   {
+      //-----------------------
+      boost::interprocess::scoped_lock<mutex_type> guard(m_mutex);
+      //-----------------------
+      node_t *free_nodes = this->priv_pop_all();
+      void_pointer *prev_hook = &m_blocks;
+      while(*prev_hook){
+         char *const block = static_cast<char*>(ipcdetail::to_raw_pointer(*prev_hook));
+         void_pointer &hook = priv_block_hook(block);
+
+         //Count the free nodes of this block
+         size_type count = 0;
+         for(node_t *node = free_nodes; node; node = this->priv_decode(node->m_next)){
+            count += priv_is_in_block(block, node);
+         }
+         //If all are free, unlink them and deallocate the block
+         if(count == NodesPerBlock){
+            node_t *kept = 0, *kept_last = 0;
+            for(node_t *node = free_nodes; node; ){
+               node_t *const next = this->priv_decode(node->m_next);
+               if(!priv_is_in_block(block, node)){
+                  if(kept_last)
+                     kept_last->m_next = this->priv_encode(node);
+                  else
+                     kept = node;
+                  kept_last = node;
+               }
+               node = next;
+            }
+            if(kept_last)
+               kept_last->m_next = 0;
+            free_nodes = kept;
+            *prev_hook = hook;
+            this->get_segment_manager()->deallocate(block);
+         }
+         else{
+            prev_hook = &hook;
+         }
+      }
+      if(free_nodes){
+         node_t *last = free_nodes;
+         while(node_t *next = this->priv_decode(last->m_next)){
+            last = next;
+         }
+         this->priv_push(free_nodes, last);
+      }
+   }
+
+   //!Deallocates all used memory. Precondition: all nodes allocated from this pool should
+   //!already be deallocated. Otherwise, undefined behaviour. Never throws
+   void purge_blocks()
+   {
+      //-----------------------
+      boost::interprocess::scoped_lock<mutex_type> guard(m_mutex);
+      //-----------------------
+      this->priv_pop_all();
+      while(m_blocks){
+         char *const block = static_cast<char*>(ipcdetail::to_raw_pointer(m_blocks));
+         m_blocks = priv_block_hook(block);
+         this->get_segment_manager()->deallocate(block);
+      }
+   }
+
+   //!Increments internal reference count and returns new count. Never throws
+   size_type inc_ref_count()
+   {
+      //-----------------------
+      boost::interprocess::scoped_lock<mutex_type> guard(m_mutex);
+      //-----------------------
+      return ++m_usecount;
+   }
+
+   //!Decrements internal reference count and returns new count. Never throws
+   size_type dec_ref_count()
+   {
+      //-----------------------
+      boost::interprocess::scoped_lock<mutex_type> guard(m_mutex);
+      //-----------------------
+      BOOST_ASSERT(m_usecount > 0);
+      return --m_usecount;
+   }
+
+   //!Deprecated, use deallocate_free_blocks.
+   void deallocate_free_chunks()
+   {  this->deallocate_free_blocks();  }
+
+   //!Deprecated, use purge_blocks.
+   void purge_chunks()
+   {  this->purge_blocks();  }
+
+   private:
+   //Offsets are stored in units of the node alignment
+   //in the 32 high bits of the head, the tag in the low ones
+   static const std::size_t NodeAlign  = ::boost::alignment_of<void_pointer>::value;
+   static const std::size_t RealNodeSize = ipcdetail::ct_rounded_size<NodeSize, NodeAlign>::value;
+   static const std::size_t BlockSize  = RealNodeSize*NodesPerBlock;
+
+   //A free node stores the encoded offset of the next free node
+   struct node_t
+   {
+      boost::uint32_t m_next;
+   };
+
+   boost::uint32_t priv_encode(const node_t *node) const
+   {
+      if(!node)
+         return 0;
+      const std::ptrdiff_t offset = reinterpret_cast<const char*>(node) - reinterpret_cast<const char*>(this);
+      BOOST_ASSERT(offset % std::ptrdiff_t(NodeAlign) == 0);
+      return boost::uint32_t(boost::int32_t(offset/std::ptrdiff_t(NodeAlign)));
+   }
+
+   node_t *priv_decode(boost::uint32_t units) const
+   {
+      if(!units)
+         return 0;
+      const std::ptrdiff_t offset = std::ptrdiff_t(boost::int32_t(units))*std::ptrdiff_t(NodeAlign);
+      return reinterpret_cast<node_t*>(const_cast<char*>(reinterpret_cast<const char*>(this)) + offset);
+   }
+
+   //Returns true if all nodes of a block placed in "block" can be encoded
+   bool priv_is_encodable(const char *block) const
+   {
+      const std::ptrdiff_t max_offset = std::ptrdiff_t(NodeAlign)*std::ptrdiff_t(0x7FFFFFFF);
+      const std::ptrdiff_t begin = block - reinterpret_cast<const char*>(this);
+      const std::ptrdiff_t end   = begin + std::ptrdiff_t(BlockSize);
+      return -max_offset <= begin && end <= max_offset;
+   }
+
+   static void_pointer &priv_block_hook(char *block)
+   {  return *reinterpret_cast<void_pointer*>(block + BlockSize);  }
+
+   static bool priv_is_in_block(const char *block, const node_t *node)
+   {
+      const char *const addr = reinterpret_cast<const char*>(node);
+      return block <= addr && addr < block + BlockSize;
+   }
+
+   //Pushes the linked list of nodes [first, last]
+   void priv_push(node_t *first, node_t *last)
+   {
+      const boost::uint64_t first_units = boost::uint64_t(this->priv_encode(first)) << 32u;
+      boost::uint64_t head = ipcdetail::atomic_read64(&m_head);
+      for(;;){
+         last->m_next = boost::uint32_t(head >> 32u);
+         const boost::uint64_t new_head = first_units | boost::uint32_t(head + 1u);
+         const boost::uint64_t prev = ipcdetail::atomic_cas64(&m_head, new_head, head);
+         if(prev == head)
+            return;
+         head = prev;
+      }
+   }
+
+   //Pops a node, returns 0 if there are no free nodes. The next node
+   //read from a node taken concurrently can be garbage, but then
+   //the tag has been incremented so the exchange fails
+   node_t *priv_pop()
+   {
+      boost::uint64_t head = ipcdetail::atomic_read64(&m_head);
+      for(;;){
+         node_t *const node = this->priv_decode(boost::uint32_t(head >> 32u));
+         if(!node)
+            return 0;
+         const boost::uint32_t next = *static_cast<volatile boost::uint32_t*>(&node->m_next);
+         const boost::uint64_t new_head = (boost::uint64_t(next) << 32u) | boost::uint32_t(head + 1u);
+         const boost::uint64_t prev = ipcdetail::atomic_cas64(&m_head, new_head, head);
+         if(prev == head)
+            return node;
+         head = prev;
+      }
+   }
+
+   //Empties the stack, returning the list of free nodes
+   node_t *priv_pop_all()
+   {
+      boost::uint64_t head = ipcdetail::atomic_read64(&m_head);
+      for(;;){
+         const boost::uint64_t prev = ipcdetail::atomic_cas64(&m_head, boost::uint32_t(head + 1u), head);
+         if(prev == head)
+            return this->priv_decode(boost::uint32_t(head >> 32u));
+         head = prev;
+      }
+   }
+
+   //Allocates a new block from the segment manager, returns a node
+   //from it and pushes the rest. Another thread might have pushed
+   //nodes meanwhile so check it again under the lock.
+   //Can throw boost::interprocess::bad_alloc
+   void *priv_alloc_block()
+   {
+      //-----------------------
+      boost::interprocess::scoped_lock<mutex_type> guard(m_mutex);
+      //-----------------------
+      if(node_t *node = this->priv_pop())
+         return node;
+
+      char *const block = static_cast<char*>
+         (this->get_segment_manager()->allocate(BlockSize + sizeof(void_pointer)));
+      if(!this->priv_is_encodable(block)){
+         this->get_segment_manager()->deallocate(block);
+         throw bad_alloc();
+      }
+      ::new(&priv_block_hook(block)) void_pointer(m_blocks);
+      m_blocks = block;
+
+      //Link all nodes but the first one
+      node_t *const first = reinterpret_cast<node_t*>(block + RealNodeSize);
+      node_t *last = first;
+      for(size_type i = 2; i < NodesPerBlock; ++i){
+         node_t *const node = reinterpret_cast<node_t*>(reinterpret_cast<char*>(last) + RealNodeSize);
+         last->m_next = this->priv_encode(node);
+         last = node;
+      }
+      if(NodesPerBlock > 1)
+         this->priv_push(first, last);
+      return block;
+   }
+
+   segment_manager_ptr_t      mp_segment_mngr;
+   //Aligned so that 64 bit CAS never splits a cache line on 32 bit systems
+   volatile boost::uint64_t   m_head __attribute__((__aligned__(8)));
+   mutex_type                 m_mutex;
+   void_pointer               m_blocks;      //Protected by m_mutex
+   size_type                  m_usecount;    //Protected by m_mutex
+};
+
+}  //namespace ipcdetail {
+}  //namespace interprocess {
+}  //namespace boost {
+
+#endif   //#if defined(BOOST_INTERPROCESS_HAS_ATOMIC64)
+
+#include <boost/interprocess/detail/config_end.hpp>
+
+#endif   //#ifndef BOOST_INTERPROCESS_DETAIL_LOCK_FREE_NODE_POOL_HPP
@@ -0,0 +1,421 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOST_INTERPROCESS_DETAIL_MAGAZINE_NODE_POOL_HPP
+#define BOOST_INTERPROCESS_DETAIL_MAGAZINE_NODE_POOL_HPP
+
+#if (defined _MSC_VER) && (_MSC_VER >= 1200)
+#  pragma once
+#endif
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/detail/workaround.hpp>
+
+#include <boost/intrusive/pointer_traits.hpp>
+
+#include <boost/interprocess/interprocess_fwd.hpp>
+#include <boost/interprocess/allocators/detail/allocator_common.hpp>
+#include <boost/interprocess/detail/utilities.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/detail/no_exceptions_support.hpp>
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <new>
+
+//!\file
+//!Describes a node pool that caches free nodes in magazines per thread
+
+namespace boost {
+namespace interprocess {
+
+//!Cache policy of cached_node_allocator and cached_adaptive_pool:
+//!each allocator object caches free nodes.
+struct allocator_cache_policy {};
+
+//!Cache policy of cached_node_allocator and cached_adaptive_pool: free nodes
+//!are cached in magazines per thread that are placed in the segment and shared
+//!by all the allocators of the node pool.
+struct magazine_cache_policy {};
+
+namespace ipcdetail {
+
+//!A node pool that caches free nodes of NodePool in magazines, lists of up to
+//!get_magazine_size() nodes. Threads are assigned one of NumSlots slots by a
+//!hash of their process and thread ids. Each slot holds a loaded and a previous
+//!magazine protected by its own mutex, so nodes deallocated by any thread
+//!go to its slot. Full magazines are exchanged with a depot of the pool in
+//!constant time and NodePool is used only when the depot can't supply or store
+//!a full magazine.
+template<class NodePool>
+class magazine_node_pool
+   :  public NodePool
+{
+   //Non-copyable
+   magazine_node_pool();
+   magazine_node_pool(const magazine_node_pool &);
+   magazine_node_pool &operator=(const magazine_node_pool &);
+
+   typedef typename NodePool::segment_manager::void_pointer       void_pointer;
+   typedef typename NodePool::segment_manager::
+      mutex_family::mutex_type                                    mutex_type;
+
+   public:
+   typedef typename NodePool::segment_manager                     segment_manager;
+   typedef typename NodePool::multiallocation_chain               multiallocation_chain;
+   typedef typename NodePool::size_type                           size_type;
+
+   static const size_type NumSlots = 16;
+   static const size_type MaxFullMagazines = 16;
+   static const size_type DefaultMagazineSize = 32;
+
+   //!Constructor from a segment manager. Never throws
+   magazine_node_pool(segment_manager *segment_mngr)
+      :  NodePool(segment_mngr), m_magazine_size(DefaultMagazineSize), m_num_full(0)
+   {}
+
+   //!Destructor. Returns cached nodes to NodePool. Never throws
+   ~magazine_node_pool()
+   {  this->flush_magazines();  }
+
+   //!Allocates a node from the magazines of the calling thread.
+   //!Can throw boost::interprocess::bad_alloc
+   void *allocate_node()
+   {
+      slot_t &slot = this->priv_slot();
+      //-----------------------
+      boost::interprocess::scoped_lock<mutex_type> guard(slot.m_mutex);
+      //-----------------------
+      if(!this->priv_load(slot)){
+         const size_type magazine_size = this->get_magazine_size();
+         if(!magazine_size){
+            return NodePool::allocate_node();
+         }
+         multiallocation_chain chain;
+         NodePool::allocate_nodes(magazine_size, chain);
+         while(!chain.empty()){
+            priv_push(slot.m_loaded, ipcdetail::to_raw_pointer(chain.pop_front()));
+         }
+      }
+      return priv_pop(slot.m_loaded);
+   }
+
+   //!Deallocates a node to the magazines of the calling thread. Never throws
+   void deallocate_node(void *ptr)
+   {
+      slot_t &slot = this->priv_slot();
+      //-----------------------
+      boost::interprocess::scoped_lock<mutex_type> guard(slot.m_mutex);
+      //-----------------------
+      if(!this->get_magazine_size()){
+         NodePool::deallocate_node(ptr);
+         return;
+      }
+      this->priv_unload(slot);
+      priv_push(slot.m_loaded, ptr);
+   }
+
+   //!Allocates n nodes, taking cached nodes first.
+   //!Can throw boost::interprocess::bad_alloc
+   void allocate_nodes(size_type n, multiallocation_chain &chain)
+   {
+      multiallocation_chain nodes;
+      {
+         slot_t &slot = this->priv_slot();
+         //-----------------------
+         boost::interprocess::scoped_lock<mutex_type> guard(slot.m_mutex);
+         //-----------------------
+         for(; n && this->priv_load(slot); --n){
+            nodes.push_back(void_pointer(priv_pop(slot.m_loaded)));
+         }
+      }
+      if(n){
+         BOOST_TRY{
+            NodePool::allocate_nodes(n, nodes);
+         }
+         BOOST_CATCH(...){
+            this->deallocate_nodes(nodes);
+            BOOST_RETHROW
+         }
+         BOOST_CATCH_END
+      }
+      chain.splice_after(chain.last(), nodes);
+   }
+
+   //!Deallocates the nodes of the chain to the magazines
+   //!of the calling thread. Never throws
+   void deallocate_nodes(multiallocation_chain &chain)
+   {
+      if(!this->get_magazine_size()){
+         NodePool::deallocate_nodes(chain);
+         return;
+      }
+      slot_t &slot = this->priv_slot();
+      //-----------------------
+      boost::interprocess::scoped_lock<mutex_type> guard(slot.m_mutex);
+      //-----------------------
+      while(!chain.empty()){
+         this->priv_unload(slot);
+         priv_push(slot.m_loaded, ipcdetail::to_raw_pointer(chain.pop_front()));
+      }
+   }
+
+   //!Returns cached nodes to NodePool and deallocates its free blocks. Never throws
+   void deallocate_free_blocks()
+   {
+      this->flush_magazines();
+      NodePool::deallocate_free_blocks();
+   }
+
+   //!Deallocates all used memory. Precondition: all nodes allocated from this pool should
+   //!already be deallocated. Otherwise, undefined behaviour. Never throws
+   void purge_blocks()
+   {
+      this->flush_magazines();
+      NodePool::purge_blocks();
+   }
+
+   //!Returns the nodes cached by all threads to NodePool. Never throws
+   void flush_magazines()
+   {
+      multiallocation_chain chain;
+      for(size_type i = 0; i != NumSlots; ++i){
+         //-----------------------
+         boost::interprocess::scoped_lock<mutex_type> guard(m_slots[i].m_mutex);
+         //-----------------------
+         priv_to_chain(m_slots[i].m_loaded, chain);
+         priv_to_chain(m_slots[i].m_previous, chain);
+      }
+      {
+         //-----------------------
+         boost::interprocess::scoped_lock<mutex_type> guard(m_depot_mutex);
+         //-----------------------
+         for(; m_num_full; --m_num_full){
+            priv_to_chain(m_full[m_num_full-1], chain);
+         }
+      }
+      NodePool::deallocate_nodes(chain);
+   }
+
+   //!Sets the maximum number of nodes of a magazine. Magazines bigger than
+   //!"n" are considered full. A value of 0 disables magazines. Can be called
+   //!while other threads use the pool. Never throws
+   void set_magazine_size(size_type n)
+   {
+      const boost::uint32_t max_size = boost::uint32_t(-1);
+      ipcdetail::atomic_write32(&m_magazine_size, n < max_size ? boost::uint32_t(n) : max_size);
+      if(!n){
+         this->flush_magazines();
+      }
+   }
+
+   //!Returns the maximum number of nodes of a magazine. Never throws
+   size_type get_magazine_size() const
+   {  return ipcdetail::atomic_read32(const_cast<volatile boost::uint32_t*>(&m_magazine_size));  }
+
+   private:
+   //A magazine is a list of free nodes linked through their first bytes
+   struct magazine_t
+   {
+      magazine_t() : m_first(0), m_size(0) {}
+      void_pointer   m_first;
+      size_type      m_size;
+   };
+
+   struct slot_t
+   {
+      mutex_type     m_mutex;
+      magazine_t     m_loaded;
+      magazine_t     m_previous;
+   };
+
+   slot_t &priv_slot()
+   {  return m_slots[ipcdetail::get_current_thread_hash() % NumSlots];  }
+
+   static void priv_push(magazine_t &m, void *node)
+   {
+      ::new(node) void_pointer(m.m_first);
+      m.m_first = node;
+      ++m.m_size;
+   }
+
+   static void *priv_pop(magazine_t &m)
+   {
+      BOOST_ASSERT(m.m_size);
+      void *const node = ipcdetail::to_raw_pointer(m.m_first);
+      m.m_first = *static_cast<void_pointer*>(node);
+      --m.m_size;
+      return node;
+   }
+
+   static void priv_to_chain(magazine_t &m, multiallocation_chain &chain)
+   {
+      while(m.m_size){
+         chain.push_front(void_pointer(priv_pop(m)));
+      }
+   }
+
+   static void priv_swap(magazine_t &a, magazine_t &b)
+   {
+      const magazine_t tmp(a);
+      a = b;
+      b = tmp;
+   }
+
+   //Makes sure the loaded magazine has nodes, swapping it with the
+   //previous one or exchanging it with a full one from the depot.
+   //Returns false if there are no cached nodes. The slot must be locked
+   bool priv_load(slot_t &slot)
+   {
+      if(slot.m_loaded.m_size)
+         return true;
+      if(slot.m_previous.m_size){
+         priv_swap(slot.m_loaded, slot.m_previous);
+         return true;
+      }
+      //-----------------------
+      boost::interprocess::scoped_lock<mutex_type> guard(m_depot_mutex);
+      //-----------------------
+      if(!m_num_full)
+         return false;
+      slot.m_loaded = m_full[--m_num_full];
+      return true;
+   }
+
+   //Makes sure the loaded magazine is not full, swapping it with the
+   //previous one or storing the previous one in the depot. Full magazines
+   //that don't fit in the depot are returned to NodePool. The slot must be locked
+   void priv_unload(slot_t &slot)
+   {
+      if(slot.m_loaded.m_size < this->get_magazine_size())
+         return;
+      if(slot.m_previous.m_size){
+         bool stored = false;
+         {
+            //-----------------------
+            boost::interprocess::scoped_lock<mutex_type> guard(m_depot_mutex);
+            //-----------------------
+            if(m_num_full != MaxFullMagazines){
+               m_full[m_num_full++] = slot.m_previous;
+               stored = true;
+            }
+         }
+         if(stored){
+            slot.m_previous = magazine_t();
+         }
+         else{
+            multiallocation_chain chain;
+            priv_to_chain(slot.m_previous, chain);
+            NodePool::deallocate_nodes(chain);
+         }
+      }
+      priv_swap(slot.m_loaded, slot.m_previous);
+   }
+
+   slot_t         m_slots[NumSlots];
+   mutex_type     m_depot_mutex;
+   volatile boost::uint32_t m_magazine_size; //Read and written atomically
+   magazine_t     m_full[MaxFullMagazines];  //Protected by m_depot_mutex
+   size_type      m_num_full;                //Protected by m_depot_mutex
+};
+
+//!The cache of a cached allocator whose node pool is a magazine_node_pool: nodes are
+//!cached by the pool, so the allocator only holds a pointer to the pool
+template<class MagazinePool>
+class magazine_cache_impl
+{
+   typedef typename MagazinePool::segment_manager::
+      void_pointer                                          void_pointer;
+   typedef typename boost::intrusive::
+      pointer_traits<void_pointer>::template
+         rebind_pointer<MagazinePool>::type                 node_pool_ptr;
+   typedef typename MagazinePool::multiallocation_chain     multiallocation_chain;
+   typedef typename MagazinePool::segment_manager::size_type size_type;
+   node_pool_ptr                 mp_node_pool;
+
+   public:
+   typedef typename MagazinePool::segment_manager           segment_manager;
+
+   //!The magazine size is shared by all allocators, so "max_cached_nodes" is ignored
+   magazine_cache_impl(segment_manager *segment_mngr, size_type)
+      : mp_node_pool(get_or_create_node_pool<MagazinePool>(segment_mngr))
+   {}
+
+   magazine_cache_impl(const magazine_cache_impl &other)
+      : mp_node_pool(other.get_node_pool())
+   {
+      mp_node_pool->inc_ref_count();
+   }
+
+   ~magazine_cache_impl()
+   {  ipcdetail::destroy_node_pool_if_last_link(ipcdetail::to_raw_pointer(mp_node_pool));  }
+
+   MagazinePool *get_node_pool() const
+   {  return ipcdetail::to_raw_pointer(mp_node_pool); }
+
+   segment_manager *get_segment_manager() const
+   {  return mp_node_pool->get_segment_manager(); }
+
+   //!Each thread caches up to two magazines
+   size_type get_max_cached_nodes() const
+   {  return 2*mp_node_pool->get_magazine_size(); }
+
+   void *cached_allocation()
+   {  return mp_node_pool->allocate_node();  }
+
+   void cached_allocation(size_type n, multiallocation_chain &chain)
+   {  mp_node_pool->allocate_nodes(n, chain);  }
+
+   void cached_deallocation(void *ptr)
+   {  mp_node_pool->deallocate_node(ptr);  }
+
+   void cached_deallocation(multiallocation_chain &chain)
+   {  mp_node_pool->deallocate_nodes(chain);  }
+
+   //!Sets the magazine size of the pool to half of "newmax". Never throws
+   void set_max_cached_nodes(size_type newmax)
+   {  mp_node_pool->set_magazine_size(newmax/2);  }
+
+   //!Returns the nodes cached by all threads to the pool. Never throws
+   void deallocate_all_cached_nodes()
+   {  mp_node_pool->flush_magazines();  }
+
+   void swap(magazine_cache_impl &other)
+   {  ipcdetail::do_swap(mp_node_pool, other.mp_node_pool);  }
+};
+
+template<class NodePool>
+struct select_cache_impl< magazine_node_pool<NodePool> >
+{
+   typedef magazine_cache_impl< magazine_node_pool<NodePool> > type;
+};
+
+//!Obtains the node pool of a cached allocator that implements a cache policy
+template<class NodePool, class CachePolicy>
+struct select_cached_node_pool
+{
+   typedef NodePool type;
+};
+
+template<class NodePool>
+struct select_cached_node_pool<NodePool, magazine_cache_policy>
+{
+   typedef magazine_node_pool<NodePool> type;
+};
+
+}  //namespace ipcdetail {
+}  //namespace interprocess {
+}  //namespace boost {
+
+#include <boost/interprocess/detail/config_end.hpp>
+
+#endif   //#ifndef BOOST_INTERPROCESS_DETAIL_MAGAZINE_NODE_POOL_HPP
@@ -24,6 +24,7 @@
 #include <boost/interprocess/detail/utilities.hpp>
 #include <boost/interprocess/allocators/detail/allocator_common.hpp>
 #include <boost/container/detail/node_pool_impl.hpp>
+#include <boost/interprocess/allocators/detail/lock_free_node_pool.hpp>
 #include <cstddef>
 
 
@@ -32,6 +33,18 @@
 
 namespace boost {
 namespace interprocess {
+
+//!Node pool policy of node_allocator and cached_node_allocator: the free node
+//!list shared by all allocators of the same segment and node size is
+//!protected by a mutex.
+struct mutex_pool_policy {};
+
+//!Node pool policy of node_allocator and cached_node_allocator: the free node
+//!list shared by all allocators of the same segment and node size is a
+//!lock-free stack and only new blocks of nodes are allocated under a mutex.
+//!Requires 64 bit atomic operations, mutex_pool_policy is used otherwise.
+struct lock_free_pool_policy {};
+
 namespace ipcdetail {
 
 
@@ -100,6 +113,30 @@ class shared_node_pool
    {}
 };
 
+//!Obtains the shared node pool that implements a node pool policy
+template< class SegmentManager
+        , std::size_t NodeSize
+        , std::size_t NodesPerBlock
+        , class PoolPolicy
+        >
+struct select_node_pool
+{
+   typedef shared_node_pool<SegmentManager, NodeSize, NodesPerBlock> type;
+};
+
+#if defined(BOOST_INTERPROCESS_HAS_ATOMIC64)
+
+template< class SegmentManager
+        , std::size_t NodeSize
+        , std::size_t NodesPerBlock
+        >
+struct select_node_pool<SegmentManager, NodeSize, NodesPerBlock, lock_free_pool_policy>
+{
+   typedef lock_free_node_pool<SegmentManager, NodeSize, NodesPerBlock> type;
+};
+
+#endif   //#if defined(BOOST_INTERPROCESS_HAS_ATOMIC64)
+
 }  //namespace ipcdetail {
 }  //namespace interprocess {
 }  //namespace boost {
@@ -47,11 +47,12 @@ template < unsigned int Version
          , class T
          , class SegmentManager
          , std::size_t NodesPerBlock
+         , class PoolPolicy
          >
 class node_allocator_base
    : public node_pool_allocation_impl
    < node_allocator_base
-      < Version, T, SegmentManager, NodesPerBlock>
+      < Version, T, SegmentManager, NodesPerBlock, PoolPolicy>
    , Version
    , T
    , SegmentManager
@@ -61,15 +62,15 @@ class node_allocator_base
    typedef typename SegmentManager::void_pointer         void_pointer;
    typedef SegmentManager                                segment_manager;
    typedef node_allocator_base
-      <Version, T, SegmentManager, NodesPerBlock>   self_t;
+      <Version, T, SegmentManager, NodesPerBlock, PoolPolicy>   self_t;
 
    /// @cond
 
    template <int dummy>
    struct node_pool
    {
-      typedef ipcdetail::shared_node_pool
-      < SegmentManager, sizeof_value<T>::value, NodesPerBlock> type;
+      typedef typename ipcdetail::select_node_pool
+      < SegmentManager, sizeof_value<T>::value, NodesPerBlock, PoolPolicy>::type type;
 
       static type *get(void *p)
       {  return static_cast<type*>(p);  }
@@ -103,15 +104,15 @@ class node_allocator_base
    template<class T2>
    struct rebind
    {
-      typedef node_allocator_base<Version, T2, SegmentManager, NodesPerBlock>       other;
+      typedef node_allocator_base<Version, T2, SegmentManager, NodesPerBlock, PoolPolicy>       other;
    };
 
    /// @cond
    private:
    //!Not assignable from related node_allocator_base
-   template<unsigned int Version2, class T2, class SegmentManager2, std::size_t N2>
+   template<unsigned int Version2, class T2, class SegmentManager2, std::size_t N2, class P2>
    node_allocator_base& operator=
-      (const node_allocator_base<Version2, T2, SegmentManager2, N2>&);
+      (const node_allocator_base<Version2, T2, SegmentManager2, N2, P2>&);
 
    //!Not assignable from other node_allocator_base
    //node_allocator_base& operator=(const node_allocator_base&);
@@ -137,7 +138,7 @@ class node_allocator_base
    //!Can throw boost::interprocess::bad_alloc
    template<class T2>
    node_allocator_base
-      (const node_allocator_base<Version, T2, SegmentManager, NodesPerBlock> &other)
+      (const node_allocator_base<Version, T2, SegmentManager, NodesPerBlock, PoolPolicy> &other)
       : mp_node_pool(ipcdetail::get_or_create_node_pool<typename node_pool<0>::type>(other.get_segment_manager())) { }
 
    //!Assignment from other node_allocator_base
@@ -176,16 +177,16 @@ class node_allocator_base
 
 //!Equality test for same type
 //!of node_allocator_base
-template<unsigned int V, class T, class S, std::size_t NPC> inline
-bool operator==(const node_allocator_base<V, T, S, NPC> &alloc1,
-                const node_allocator_base<V, T, S, NPC> &alloc2)
+template<unsigned int V, class T, class S, std::size_t NPC, class P> inline
+bool operator==(const node_allocator_base<V, T, S, NPC, P> &alloc1,
+                const node_allocator_base<V, T, S, NPC, P> &alloc2)
    {  return alloc1.get_node_pool() == alloc2.get_node_pool(); }
 
 //!Inequality test for same type
 //!of node_allocator_base
-template<unsigned int V, class T, class S, std::size_t NPC> inline
-bool operator!=(const node_allocator_base<V, T, S, NPC> &alloc1,
-                const node_allocator_base<V, T, S, NPC> &alloc2)
+template<unsigned int V, class T, class S, std::size_t NPC, class P> inline
+bool operator!=(const node_allocator_base<V, T, S, NPC, P> &alloc1,
+                const node_allocator_base<V, T, S, NPC, P> &alloc2)
    {  return alloc1.get_node_pool() != alloc2.get_node_pool(); }
 
 template < class T
@@ -198,11 +199,12 @@ class node_allocator_v1
          , T
          , SegmentManager
          , NodesPerBlock
+         , mutex_pool_policy
          >
 {
    public:
    typedef ipcdetail::node_allocator_base
-         < 1, T, SegmentManager, NodesPerBlock> base_t;
+         < 1, T, SegmentManager, NodesPerBlock, mutex_pool_policy> base_t;
 
    template<class T2>
    struct rebind
@@ -232,10 +234,12 @@ class node_allocator_v1
 //!This node allocator shares a segregated storage between all instances
 //!of node_allocator with equal sizeof(T) placed in the same segment
 //!group. NodesPerBlock is the number of nodes allocated at once when the allocator
-//!needs runs out of nodes
+//!needs runs out of nodes. PoolPolicy selects how the segregated storage is
+//!synchronized: mutex_pool_policy (the default) or lock_free_pool_policy
 template < class T
          , class SegmentManager
          , std::size_t NodesPerBlock
+         , class PoolPolicy
          >
 class node_allocator
    /// @cond
@@ -244,20 +248,21 @@ class node_allocator
          , T
          , SegmentManager
          , NodesPerBlock
+         , PoolPolicy
          >
    /// @endcond
 {
 
    #ifndef BOOST_INTERPROCESS_DOXYGEN_INVOKED
    typedef ipcdetail::node_allocator_base
-         < 2, T, SegmentManager, NodesPerBlock> base_t;
+         < 2, T, SegmentManager, NodesPerBlock, PoolPolicy> base_t;
    public:
    typedef boost::interprocess::version_type<node_allocator, 2>   version;
 
    template<class T2>
    struct rebind
    {
-      typedef node_allocator<T2, SegmentManager, NodesPerBlock>  other;
+      typedef node_allocator<T2, SegmentManager, NodesPerBlock, PoolPolicy>  other;
    };
 
    node_allocator(SegmentManager *segment_mngr)
@@ -266,7 +271,7 @@ class node_allocator
 
    template<class T2>
    node_allocator
-      (const node_allocator<T2, SegmentManager, NodesPerBlock> &other)
+      (const node_allocator<T2, SegmentManager, NodesPerBlock, PoolPolicy> &other)
       : base_t(other)
    {}
 
@@ -289,15 +294,15 @@ class node_allocator
    template<class T2>
    struct rebind
    {
-      typedef node_allocator<T2, SegmentManager, NodesPerBlock> other;
+      typedef node_allocator<T2, SegmentManager, NodesPerBlock, PoolPolicy> other;
    };
 
    private:
    //!Not assignable from
    //!related node_allocator
-   template<class T2, class SegmentManager2, std::size_t N2>
+   template<class T2, class SegmentManager2, std::size_t N2, class P2>
    node_allocator& operator=
-      (const node_allocator<T2, SegmentManager2, N2>&);
+      (const node_allocator<T2, SegmentManager2, N2, P2>&);
 
    //!Not assignable from
    //!other node_allocator
@@ -318,7 +323,7 @@ class node_allocator
    //!Can throw boost::interprocess::bad_alloc
    template<class T2>
    node_allocator
-      (const node_allocator<T2, SegmentManager, NodesPerBlock> &other);
+      (const node_allocator<T2, SegmentManager, NodesPerBlock, PoolPolicy> &other);
 
    //!Destructor, removes node_pool_t from memory
    //!if its reference count reaches to zero. Never throws
@@ -432,15 +437,15 @@ class node_allocator
 
 //!Equality test for same type
 //!of node_allocator
-template<class T, class S, std::size_t NPC> inline
-bool operator==(const node_allocator<T, S, NPC> &alloc1,
-                const node_allocator<T, S, NPC> &alloc2);
+template<class T, class S, std::size_t NPC, class P> inline
+bool operator==(const node_allocator<T, S, NPC, P> &alloc1,
+                const node_allocator<T, S, NPC, P> &alloc2);
 
 //!Inequality test for same type
 //!of node_allocator
-template<class T, class S, std::size_t NPC> inline
-bool operator!=(const node_allocator<T, S, NPC> &alloc1,
-                const node_allocator<T, S, NPC> &alloc2);
+template<class T, class S, std::size_t NPC, class P> inline
+bool operator!=(const node_allocator<T, S, NPC, P> &alloc1,
+                const node_allocator<T, S, NPC, P> &alloc2);
 
 #endif
 
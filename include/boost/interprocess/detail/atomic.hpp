@@ -552,10 +552,108 @@ inline bool atomic_add_unless32
    return c != unless_this;
 }
 
+//! Memory barriers for lock-free algorithms. Loads issued before
+//! atomic_read_barrier are not reordered with memory accesses issued after it
+//! (acquire) and memory accesses issued before atomic_write_barrier are not
+//! reordered with stores issued after it (release). atomic_full_barrier also
+//! orders stores issued before it with loads issued after it.
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+
+//x86 only reorders stores with later loads,
+//so only the compiler must be prevented from reordering them
+inline void atomic_read_barrier()
+{  __asm__ __volatile__("" ::: "memory");   }
+
+inline void atomic_write_barrier()
+{  __asm__ __volatile__("" ::: "memory");   }
+
+//A locked instruction on the stack is cheaper than mfence
+inline void atomic_full_barrier()
+{
+   #if defined(__x86_64__)
+   __asm__ __volatile__("lock; orl $0, (%%rsp)" ::: "memory", "cc");
+   #else
+   __asm__ __volatile__("lock; orl $0, (%%esp)" ::: "memory", "cc");
+   #endif
+}
+
+#elif defined(__GNUC__) && ( __GNUC__ * 100 + __GNUC_MINOR__ >= 401 )
+
+inline void atomic_read_barrier()
+{  __sync_synchronize();   }
+
+inline void atomic_write_barrier()
+{  __sync_synchronize();   }
+
+inline void atomic_full_barrier()
+{  __sync_synchronize();   }
+
+#else
+
+//Atomic read-modify-write operations are full barriers,
+//use them on a local variable to avoid writing shared memory
+inline void atomic_full_barrier()
+{
+   volatile boost::uint32_t dummy = 0;
+   atomic_cas32(&dummy, 0, 0);
+}
+
+inline void atomic_read_barrier()
+{  atomic_full_barrier();  }
+
+inline void atomic_write_barrier()
+{  atomic_full_barrier();  }
+
+#endif
+
+}  //namespace ipcdetail
+}  //namespace interprocess
+}  //namespace boost
+
+//64 bit atomic operations are only provided where the compiler
+//offers them, users must check BOOST_INTERPROCESS_HAS_ATOMIC64
+#if defined(__GNUC__) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
+
+#define BOOST_INTERPROCESS_HAS_ATOMIC64
+
+namespace boost{
+namespace interprocess{
+namespace ipcdetail{
+
+//! Atomically add 'val' to an boost::uint64_t
+//! "mem": pointer to the object
+//! "val": amount to add
+//! Returns the old value pointed to by mem
+inline boost::uint64_t atomic_add64
+   (volatile boost::uint64_t *mem, boost::uint64_t val)
+{  return __sync_fetch_and_add(const_cast<boost::uint64_t *>(mem), val);   }
+
+//! Compare an boost::uint64_t's value with "cmp".
+//! If they are the same swap the value with "with"
+//! "mem": pointer to the value
+//! "with": what to swap it with
+//! "cmp": the value to compare it to
+//! Returns the old value of *mem
+inline boost::uint64_t atomic_cas64
+   (volatile boost::uint64_t *mem, boost::uint64_t with, boost::uint64_t cmp)
+{  return __sync_val_compare_and_swap(const_cast<boost::uint64_t *>(mem), cmp, with);   }
+
+//! Atomically read an boost::uint64_t from memory
+//! (plain loads are not atomic in 32 bit platforms)
+inline boost::uint64_t atomic_read64(volatile boost::uint64_t *mem)
+{
+   #if defined(__x86_64__)
+   return *mem;
+   #else
+   return atomic_cas64(mem, 0, 0);
+   #endif
+}
+
 }  //namespace ipcdetail
 }  //namespace interprocess
 }  //namespace boost
 
+#endif   //#if defined(__GNUC__) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
 
 #include <boost/interprocess/detail/config_end.hpp>
 
@@ -89,6 +89,7 @@ class basic_managed_memory_impl
       const_named_iterator                            const_named_iterator;
    typedef typename segment_manager::
       const_unique_iterator                           const_unique_iterator;
+   typedef typename segment_manager::stats_type       stats_type;
 
    /// @cond
 
@@ -244,8 +245,14 @@ class basic_managed_memory_impl
    bool check_sanity()
    {   return mp_header->check_sanity(); }
 
+   //!Fills "stats" with the statistics of free and
+   //!allocated blocks of the used memory algorithm
+   void get_stats(stats_type &stats)
+   {   mp_header->get_stats(stats); }
+
    //!Writes to zero free memory (memory not yet allocated) of
-   //!the memory algorithm
+   //!the memory algorithm. Whole free pages are returned to
+   //!the operating system instead, if it's able to do it
    void zero_free_memory()
    {   mp_header->zero_free_memory(); }
 
@@ -643,6 +650,25 @@ class basic_managed_memory_impl
    void shrink_to_fit_indexes()
    {  mp_header->shrink_to_fit_indexes();  }
 
+   //!Registers "ptr" as the owner of a relocatable buffer
+   //!that compact() can move. See segment_manager::register_relocatable.
+   //!Can throw boost::interprocess::bad_alloc if there is no enough memory.
+   template<class Pointer>
+   void register_relocatable(Pointer &ptr)
+   {  mp_header->register_relocatable(ptr);  }
+
+   //!Unregisters "ptr", previously registered with register_relocatable().
+   //!Returns false if "ptr" was not registered. Never throws.
+   template<class Pointer>
+   bool unregister_relocatable(Pointer &ptr)
+   {  return mp_header->unregister_relocatable(ptr);  }
+
+   //!Moves relocatable buffers towards the start of the segment.
+   //!Returns the number of buffers that were moved.
+   //!See segment_manager::compact.
+   size_type compact()
+   {  return mp_header->compact();  }
+
    //!Returns the number of named objects stored
    //!in the managed segment.
    size_type get_num_named_objects()
@@ -741,7 +767,12 @@ class create_open_func
          return false;
       }
       else if(created){
-         return m_frontend->create_impl(addr, static_cast<size_type>(size));
+         if(!m_frontend->create_impl(addr, static_cast<size_type>(size)))
+            return false;
+         //managed_open_or_create_impl has just created the device,
+         //so the memory that is not used by the headers reads as zero
+         m_frontend->get_segment_manager()->mark_free_memory_zeroed();
+         return true;
       }
       else{
          return m_frontend->open_impl  (addr, static_cast<size_type>(size));
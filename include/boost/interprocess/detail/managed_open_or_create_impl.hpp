@@ -101,6 +101,15 @@ class managed_open_or_create_impl
       CorruptedSegment
    };
 
+   //Initialized segments store InitializedSegment plus the version of the layout
+   //of the structures placed in them (memory algorithms, segment managers,
+   //message queues and synchronization objects). Increment it when one of
+   //those layouts changes: older libraries don't know the value and fail to
+   //open the segment with corrupted_error, and segments of older libraries,
+   //that store InitializedSegment, are rejected the same way.
+   static const boost::uint32_t LayoutVersion = 1;
+   static const boost::uint32_t InitializedLayoutSegment = InitializedSegment | (LayoutVersion << 8);
+
    public:
    static const std::size_t
       ManagedOpenOrCreateUserOffset =
@@ -401,6 +410,8 @@ class managed_open_or_create_impl
 
             if(previous == UninitializedSegment){
                try{
+                  //"created" tells construct_func that the device is new,
+                  //so the memory it has not written reads as zero
                   construct_func( static_cast<char*>(region.get_address()) + ManagedOpenOrCreateUserOffset
                                 , size - ManagedOpenOrCreateUserOffset, true);
                   //All ok, just move resources to the external mapped region
@@ -410,9 +421,9 @@ class managed_open_or_create_impl
                   atomic_write32(patomic_word, CorruptedSegment);
                   throw;
                }
-               atomic_write32(patomic_word, InitializedSegment);
+               atomic_write32(patomic_word, InitializedLayoutSegment);
             }
-            else if(previous == InitializingSegment || previous == InitializedSegment){
+            else if(previous == InitializingSegment || (previous & 0xFF) == InitializedSegment){
                throw interprocess_exception(error_info(already_exists_error));
             }
             else{
@@ -452,7 +463,11 @@ class managed_open_or_create_impl
             value = atomic_read32(patomic_word);
          }
 
-         if(value != InitializedSegment)
+         if((value & 0xFF) == InitializedSegment && value != InitializedLayoutSegment){
+            throw interprocess_exception(error_info(corrupted_error),
+               "boost::interprocess: segment created with an incompatible layout version");
+         }
+         if(value != InitializedLayoutSegment)
             throw interprocess_exception(error_info(corrupted_error));
 
          construct_func( static_cast<char*>(region.get_address()) + ManagedOpenOrCreateUserOffset
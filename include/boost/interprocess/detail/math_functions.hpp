@@ -18,6 +18,8 @@
 
 #include <climits>
 #include <boost/static_assert.hpp>
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
 
 namespace boost {
 namespace interprocess {
@@ -103,6 +105,42 @@ inline std::size_t floor_log2 (std::size_t x)
    return log2;
 }
 
+//Returns the position of the highest set bit of a non-zero
+//32 bit integer, counting leading zeros if the compiler can
+inline unsigned int floor_log2_32 (boost::uint32_t x)
+{
+   #if defined(__GNUC__) && ((__GNUC__ > 3) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4))
+   return 31u - static_cast<unsigned int>(__builtin_clz(x));
+   #else
+   return static_cast<unsigned int>(floor_log2(std::size_t(x)));
+   #endif
+}
+
+//Returns the position of the highest set bit of a non-zero
+//integer, counting leading zeros if the compiler can
+inline std::size_t floor_log2_nz (std::size_t x)
+{
+   BOOST_ASSERT(x != 0);
+   #if defined(__GNUC__) && ((__GNUC__ > 3) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4))
+   return sizeof(unsigned long long)*CHAR_BIT - 1u -
+      static_cast<std::size_t>(__builtin_clzll(static_cast<unsigned long long>(x)));
+   #else
+   return floor_log2(x);
+   #endif
+}
+
+//Returns the position of the lowest set bit of a non-zero
+//integer, counting trailing zeros if the compiler can
+inline std::size_t lowest_bit_nz (std::size_t x)
+{
+   BOOST_ASSERT(x != 0);
+   #if defined(__GNUC__) && ((__GNUC__ > 3) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4))
+   return static_cast<std::size_t>(__builtin_ctzll(static_cast<unsigned long long>(x)));
+   #else
+   return floor_log2(x & (~x + 1u));
+   #endif
+}
+
 } // namespace ipcdetail
 } // namespace interprocess
 } // namespace boost
@@ -29,6 +29,7 @@
 #     include <unistd.h>
 #     include <sys/types.h>
 #     include <sys/stat.h>
+#     include <sys/mman.h>
 #     include <errno.h>
 #     include <cstdio>
 #     include <dirent.h>
@@ -189,6 +190,10 @@ inline bool write_file(file_handle_t hnd, const void *data, std::size_t numdata)
 inline file_handle_t invalid_file()
 {  return winapi::invalid_handle_value;  }
 
+//Views of file mappings can't release their pages
+inline bool release_mapped_pages(void *, std::size_t)
+{  return false;  }
+
 inline bool close_file(file_handle_t hnd)
 {  return 0 != winapi::close_handle(hnd);   }
 
@@ -489,6 +494,19 @@ inline bool write_file(file_handle_t hnd, const void *data, std::size_t numdata)
 inline file_handle_t invalid_file()
 {  return -1;  }
 
+//Frees the pages and the backing store of [addr, addr + size), which must be
+//page aligned, so that they read as zeroes. Only shared mappings of shared
+//memory and of files placed in file systems that can punch holes support it
+inline bool release_mapped_pages(void *addr, std::size_t size)
+{
+   #if defined(MADV_REMOVE)
+   return 0 == ::madvise(addr, size, MADV_REMOVE);
+   #else
+   (void)addr; (void)size;
+   return false;
+   #endif
+}
+
 inline bool close_file(file_handle_t hnd)
 {  return ::close(hnd) == 0;   }
 
@@ -15,6 +15,8 @@
 #include <boost/interprocess/detail/workaround.hpp>
 #include <boost/interprocess/streams/bufferstream.hpp>
 #include <boost/interprocess/detail/posix_time_types_wrk.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>
 
 #if (defined BOOST_INTERPROCESS_WINDOWS)
 #  include <boost/interprocess/detail/win32_api.hpp>
@@ -62,6 +64,24 @@ inline void thread_yield()
 inline void thread_sleep(unsigned int ms)
 {  winapi::Sleep(ms);  }
 
+//thread specific storage
+typedef unsigned long OS_tss_key_t;
+
+inline bool create_tss_key(OS_tss_key_t &key)
+{
+   key = winapi::tls_alloc();
+   return key != 0xFFFFFFFF;  //TLS_OUT_OF_INDEXES
+}
+
+inline void delete_tss_key(OS_tss_key_t key)
+{  winapi::tls_free(key);  }
+
+inline void *get_tss_value(OS_tss_key_t key)
+{  return winapi::tls_get_value(key);  }
+
+inline bool set_tss_value(OS_tss_key_t key, void *value)
+{  return winapi::tls_set_value(key, value);  }
+
 //systemwide thread
 inline OS_systemwide_thread_id_t get_current_systemwide_thread_id()
 {
@@ -170,6 +190,21 @@ inline void thread_sleep(unsigned int ms)
    ::nanosleep(&rqt, 0);
 }
 
+//thread specific storage
+typedef pthread_key_t OS_tss_key_t;
+
+inline bool create_tss_key(OS_tss_key_t &key)
+{  return 0 == ::pthread_key_create(&key, 0);  }
+
+inline void delete_tss_key(OS_tss_key_t key)
+{  ::pthread_key_delete(key);  }
+
+inline void *get_tss_value(OS_tss_key_t key)
+{  return ::pthread_getspecific(key);  }
+
+inline bool set_tss_value(OS_tss_key_t key, void *value)
+{  return 0 == ::pthread_setspecific(key, value);  }
+
 //systemwide thread
 inline OS_systemwide_thread_id_t get_current_systemwide_thread_id()
 {
@@ -202,6 +237,45 @@ inline void get_pid_str(pid_str_t &pid_str, OS_process_id_t pid)
 inline void get_pid_str(pid_str_t &pid_str)
 {  get_pid_str(pid_str, get_current_process_id());  }
 
+//!Returns the FNV-1a hash of "size" bytes starting from "hash". The low bits
+//!of the result only depend on the low bits of each byte
+inline boost::uint64_t fnv1a_hash(const void *data, std::size_t size, boost::uint64_t hash = 2166136261u)
+{
+   const unsigned char *p = static_cast<const unsigned char*>(data);
+   for(std::size_t i = 0; i != size; ++i){
+      hash = (hash ^ p[i])*16777619u;
+   }
+   return hash;
+}
+
+//!Mixes the bits of "h" with the 64 bit finalizer of MurmurHash3, so that
+//!every bit of the result depends on every bit of "h"
+inline std::size_t thread_hash_finalize(boost::uint64_t h)
+{
+   const boost::uint64_t c1 = (boost::uint64_t(0xff51afd7u) << 32) | 0xed558ccdu;
+   const boost::uint64_t c2 = (boost::uint64_t(0xc4ceb9feu) << 32) | 0x1a85ec53u;
+   h ^= h >> 33;
+   h *= c1;
+   h ^= h >> 33;
+   h *= c2;
+   h ^= h >> 33;
+   return std::size_t(h);
+}
+
+//!Returns a hash of the process and thread ids of the calling thread,
+//!to spread threads of several processes among shared resources with a
+//!modulo. Thread ids of different processes can be equal and are usually
+//!addresses a fixed stack size apart that only differ in a few bits,
+//!so their FNV-1a hash is finalized before being returned.
+//!The process id is obtained once, as it's a system call in some systems:
+//!a forked process uses the id of its parent, which only affects the hash
+inline std::size_t get_current_thread_hash()
+{
+   static const OS_process_id_t pid = get_current_process_id();
+   const OS_thread_id_t  tid = get_current_thread_id();
+   return thread_hash_finalize(fnv1a_hash(&tid, sizeof(tid), fnv1a_hash(&pid, sizeof(pid))));
+}
+
 }  //namespace ipcdetail{
 }  //namespace interprocess {
 }  //namespace boost {
@@ -24,6 +24,8 @@
 #include <boost/interprocess/detail/type_traits.hpp>
 #include <boost/interprocess/detail/utilities.hpp>
 #include <boost/interprocess/detail/in_place_interface.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
 #include <boost/interprocess/exceptions.hpp>
 #include <boost/type_traits/make_unsigned.hpp>
 #include <boost/type_traits/alignment_of.hpp>
@@ -72,6 +74,96 @@ class mem_algo_deallocator
    {  if(m_ptr) m_algo.deallocate(m_ptr);  }
 };
 
+//!Links the thread caches of segment managers that a thread has constructed.
+//!"mp_owner" is the segment manager of the cache and "m_thread" the thread
+//!whose list holds it
+struct thread_cache_link
+{
+   const void        *mp_owner;
+   thread_cache_link *mp_next;
+   OS_thread_id_t     m_thread;
+   bool               m_linked;
+};
+
+//!Process-wide key that stores the first thread_cache_link of each thread
+//!and the number of thread caches alive in the process, so that segment
+//!managers don't search the thread specific storage if there are none
+template<int Dummy>
+struct thread_cache_tss
+{
+   struct key_holder
+   {
+      key_holder()
+         :  m_created(create_tss_key(m_key))
+      {}
+
+      ~key_holder()
+      {
+         if(m_created){
+            delete_tss_key(m_key);
+            m_created = false;
+         }
+      }
+
+      OS_tss_key_t   m_key;
+      bool           m_created;
+   };
+
+   static thread_cache_link *get_first()
+   {  return s_key.m_created ? static_cast<thread_cache_link*>(get_tss_value(s_key.m_key)) : 0;  }
+
+   static void link(thread_cache_link &cache, const void *owner)
+   {
+      cache.mp_owner = owner;
+      cache.mp_next  = get_first();
+      cache.m_thread = get_current_thread_id();
+      cache.m_linked = s_key.m_created && set_tss_value(s_key.m_key, &cache);
+      if(cache.m_linked){
+         atomic_inc32(&s_num_caches);
+      }
+   }
+
+   //!Must be called by the thread that linked the cache, as the
+   //!thread specific list of another thread can't be modified
+   static void unlink(thread_cache_link &cache)
+   {
+      if(!cache.m_linked)
+         return;
+      BOOST_ASSERT(equal_thread_id(cache.m_thread, get_current_thread_id()));
+      thread_cache_link *prev = 0;
+      thread_cache_link *cur  = get_first();
+      for(; cur && cur != &cache; prev = cur, cur = cur->mp_next){}
+      if(cur){
+         if(prev){
+            prev->mp_next = cache.mp_next;
+         }
+         else{
+            set_tss_value(s_key.m_key, cache.mp_next);
+         }
+      }
+      cache.m_linked = false;
+      atomic_dec32(&s_num_caches);
+   }
+
+   static thread_cache_link *find(const void *owner)
+   {
+      if(!atomic_read32(&s_num_caches))
+         return 0;
+      thread_cache_link *cur = get_first();
+      for(; cur && cur->mp_owner != owner; cur = cur->mp_next){}
+      return cur;
+   }
+
+   static key_holder s_key;
+   static volatile boost::uint32_t s_num_caches;
+};
+
+template<int Dummy>
+typename thread_cache_tss<Dummy>::key_holder thread_cache_tss<Dummy>::s_key;
+
+template<int Dummy>
+volatile boost::uint32_t thread_cache_tss<Dummy>::s_num_caches = 0;
+
 /// @cond
 template<class size_type>
 struct block_header
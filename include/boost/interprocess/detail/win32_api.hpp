@@ -846,6 +846,10 @@ extern "C" __declspec(dllimport) int __stdcall GetProcessTimes
    , interprocess_filetime *lpUserTime );
 extern "C" __declspec(dllimport) void __stdcall Sleep(unsigned long);
 extern "C" __declspec(dllimport) int __stdcall SwitchToThread();
+extern "C" __declspec(dllimport) unsigned long __stdcall TlsAlloc();
+extern "C" __declspec(dllimport) int __stdcall TlsFree(unsigned long);
+extern "C" __declspec(dllimport) void * __stdcall TlsGetValue(unsigned long);
+extern "C" __declspec(dllimport) int __stdcall TlsSetValue(unsigned long, void *);
 extern "C" __declspec(dllimport) unsigned long __stdcall GetLastError();
 extern "C" __declspec(dllimport) void __stdcall SetLastError(unsigned long);
 extern "C" __declspec(dllimport) void * __stdcall GetCurrentProcess();
@@ -998,6 +1002,18 @@ inline void sleep(unsigned long ms)
 inline unsigned long get_current_thread_id()
 {  return GetCurrentThreadId();  }
 
+inline unsigned long tls_alloc()
+{  return TlsAlloc();  }
+
+inline bool tls_free(unsigned long index)
+{  return 0 != TlsFree(index);  }
+
+inline void *tls_get_value(unsigned long index)
+{  return TlsGetValue(index);  }
+
+inline bool tls_set_value(unsigned long index, void *value)
+{  return 0 != TlsSetValue(index, value);  }
+
 inline bool get_process_times
    ( void *hProcess, interprocess_filetime* lpCreationTime
    , interprocess_filetime *lpExitTime, interprocess_filetime *lpKernelTime
@@ -143,6 +143,16 @@
 //with processes compiled with those versions.
 #define BOOST_INTERPROCESS_MSG_QUEUE_CIRCULAR_INDEX
 
+//BOOST_INTERPROCESS_LINUX_FUTEX
+//Generic emulation primitives (spin_mutex and friends) sleep on a
+//process-shared futex instead of yielding the processor in a loop.
+//Processes compiled without this option use a different lock word protocol,
+//so define BOOST_INTERPROCESS_DISABLE_FUTEX if you want to communicate
+//with processes compiled with older versions.
+#if defined(__linux__) && !defined(BOOST_INTERPROCESS_DISABLE_FUTEX)
+   #define BOOST_INTERPROCESS_LINUX_FUTEX
+#endif
+
 //Inline attributes
 #if defined(_MSC_VER)
    #define BOOST_INTERPROCESS_ALWAYS_INLINE __forceinline
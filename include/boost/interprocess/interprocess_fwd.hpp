@@ -96,9 +96,23 @@ struct null_mutex_family;
 //////////////////////////////////////////////////////////////////////////////
 
 class barrier;
-class interprocess_sharable_mutex;
 class interprocess_condition;
 
+struct two_gate_policy;
+struct reader_preferring_policy;
+struct writer_preferring_policy;
+struct phase_fair_policy;
+
+template<class Policy>
+class interprocess_sharable_mutex_t;
+
+class interprocess_sharable_mutex;
+
+template<class Policy>
+class interprocess_upgradable_mutex_t;
+
+class interprocess_upgradable_mutex;
+
 //////////////////////////////////////////////////////////////////////////////
 //                              Locks
 //////////////////////////////////////////////////////////////////////////////
@@ -119,13 +133,29 @@ class upgradable_lock;
 template<class T, class SegmentManager>
 class allocator;
 
-template<class T, class SegmentManager, std::size_t NodesPerBlock = 64>
+template<class SegmentManager>
+class segment_arena;
+
+template<class T, class SegmentManager>
+class arena_allocator;
+
+struct mutex_pool_policy;
+
+struct lock_free_pool_policy;
+
+struct allocator_cache_policy;
+
+struct magazine_cache_policy;
+
+template<class T, class SegmentManager, std::size_t NodesPerBlock = 64, class PoolPolicy = mutex_pool_policy>
 class node_allocator;
 
 template<class T, class SegmentManager, std::size_t NodesPerBlock = 64>
 class private_node_allocator;
 
-template<class T, class SegmentManager, std::size_t NodesPerBlock = 64>
+template<class T, class SegmentManager, std::size_t NodesPerBlock = 64, class PoolPolicy = mutex_pool_policy
+         , class CachePolicy = allocator_cache_policy
+>
 class cached_node_allocator;
 
 template<class T, class SegmentManager, std::size_t NodesPerBlock = 64, std::size_t MaxFreeBlocks = 2
@@ -139,7 +169,7 @@ template<class T, class SegmentManager, std::size_t NodesPerBlock = 64, std::siz
 class private_adaptive_pool;
 
 template<class T, class SegmentManager, std::size_t NodesPerBlock = 64, std::size_t MaxFreeBlocks = 2
-         , unsigned char OverheadPercent = 5
+         , unsigned char OverheadPercent = 5, class CachePolicy = allocator_cache_policy
 >
 class cached_adaptive_pool;
 
@@ -164,6 +194,12 @@ class simple_seq_fit;
 template<class MutexFamily, class VoidMutex = offset_ptr<void>, std::size_t MemAlignment = 0>
 class rbtree_best_fit;
 
+template<class MutexFamily, class VoidMutex = offset_ptr<void>, std::size_t NumArenas = 8>
+class sharded_best_fit;
+
+template<class MutexFamily, class VoidMutex = offset_ptr<void>, std::size_t MemAlignment = 0>
+class tlsf_fit;
+
 //////////////////////////////////////////////////////////////////////////////
 //                         Index Types
 //////////////////////////////////////////////////////////////////////////////
@@ -407,6 +443,16 @@ class message_queue_t;
 
 typedef message_queue_t<offset_ptr<void> > message_queue;
 
+template<class VoidPointer>
+class ring_message_queue_t;
+
+typedef ring_message_queue_t<offset_ptr<void> > ring_message_queue;
+
+template<class VoidPointer>
+class broadcast_queue_t;
+
+typedef broadcast_queue_t<offset_ptr<void> > broadcast_queue;
+
 }}  //namespace boost { namespace interprocess {
 
 //////////////////////////////////////////////////////////////////////////////
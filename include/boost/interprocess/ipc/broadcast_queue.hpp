@@ -0,0 +1,1002 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOST_INTERPROCESS_BROADCAST_QUEUE_HPP
+#define BOOST_INTERPROCESS_BROADCAST_QUEUE_HPP
+
+#if (defined _MSC_VER) && (_MSC_VER >= 1200)
+#  pragma once
+#endif
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/detail/workaround.hpp>
+
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/detail/managed_open_or_create_impl.hpp>
+#include <boost/interprocess/sync/interprocess_eventcount.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+#include <boost/interprocess/detail/utilities.hpp>
+#include <boost/interprocess/offset_ptr.hpp>
+#include <boost/interprocess/creation_tags.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/permissions.hpp>
+#include <boost/interprocess/detail/posix_time_types_wrk.hpp>
+#include <boost/detail/no_exceptions_support.hpp>
+#include <boost/intrusive/pointer_traits.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>   //std::size_t
+#include <cstring>   //memcpy
+#include <new>
+
+//!\file
+//!Describes an inter-process publish/subscribe queue: a single sender
+//!broadcasts messages stored once in a ring of fixed-size slots and every
+//!subscriber receives all of them through its own read position.
+
+namespace boost{  namespace interprocess{
+
+//!What the sender of a broadcast_queue_t does when the ring is full because
+//!a subscriber has not received the oldest message. Selected when the queue
+//!is created.
+enum broadcast_policy
+{
+   //!The sender blocks until the slowest subscriber receives a message.
+   block_slow_subscribers,
+   //!The sender overwrites the oldest message. Subscribers that had not
+   //!received it skip it and count it as lost.
+   overwrite_slow_subscribers,
+   //!The sender evicts the subscribers that had not received the oldest
+   //!message and overwrites it. Evicted subscribers can't receive anymore.
+   evict_slow_subscribers
+};
+
+/// @cond
+namespace ipcdetail
+{
+   template<class VoidPointer>
+   class broadcast_queue_initialization_func_t;
+
+   //Read positions of subscribers and the sender position are placed
+   //in different cache lines to avoid false sharing
+   static const std::size_t broadcast_cache_line_size = 64;
+}
+/// @endcond
+
+//!A queue that broadcasts the messages of a single sender to several subscribers.
+//!Messages are stored once in a ring of "get_max_msg()" preallocated slots of
+//!"get_max_msg_size()" bytes and each subscriber receives every message sent
+//!since it subscribed, in the order they were sent, unless the broadcast_policy
+//!of the queue drops messages for slow subscribers. Up to "get_max_subscribers()"
+//!subscribers can be attached at the same time, from any process.
+//!
+//!Only one thread may send at the same time. Senders and subscribers don't take
+//!locks: they only block when the ring is full or there are no new messages, and
+//!no system call is issued to wake them if nobody is blocked.
+template<class VoidPointer>
+class broadcast_queue_t
+{
+   /// @cond
+   //Blocking modes
+   enum block_t   {  blocking,   timed,   non_blocking   };
+
+   broadcast_queue_t();
+   /// @endcond
+
+   public:
+   typedef VoidPointer                                                 void_pointer;
+   typedef typename boost::intrusive::
+      pointer_traits<void_pointer>::template
+         rebind_pointer<char>::type                                    char_ptr;
+   typedef typename boost::intrusive::pointer_traits<char_ptr>::difference_type difference_type;
+   typedef typename boost::make_unsigned<difference_type>::type        size_type;
+
+   class subscriber;
+
+   //!Creates a process shared broadcast queue with name "name" whose sender blocks
+   //!while a subscriber has not received the oldest message. The number of slots
+   //!is "max_num_msg" rounded up to a power of two, each slot holds messages of up
+   //!to "max_msg_size" bytes and up to "max_subscribers" subscribers can be attached.
+   //!Throws on error and if the queue was previously created.
+   broadcast_queue_t(create_only_t create_only,
+                 const char *name,
+                 size_type max_num_msg,
+                 size_type max_msg_size,
+                 size_type max_subscribers,
+                 const permissions &perm = permissions());
+
+   //!Same as the previous constructor but slow subscribers are
+   //!handled as selected by "policy".
+   broadcast_queue_t(create_only_t create_only,
+                 const char *name,
+                 size_type max_num_msg,
+                 size_type max_msg_size,
+                 size_type max_subscribers,
+                 broadcast_policy policy,
+                 const permissions &perm = permissions());
+
+   //!Opens or creates a process shared broadcast queue with name "name".
+   //!If the queue is created, the sender blocks on slow subscribers and the rest
+   //!of parameters are used as in the create_only constructor. If the queue was
+   //!previously created the queue will be opened and those parameters are ignored.
+   //!Throws on error.
+   broadcast_queue_t(open_or_create_t open_or_create,
+                 const char *name,
+                 size_type max_num_msg,
+                 size_type max_msg_size,
+                 size_type max_subscribers,
+                 const permissions &perm = permissions());
+
+   //!Same as the previous constructor but if the queue is created
+   //!slow subscribers are handled as selected by "policy".
+   broadcast_queue_t(open_or_create_t open_or_create,
+                 const char *name,
+                 size_type max_num_msg,
+                 size_type max_msg_size,
+                 size_type max_subscribers,
+                 broadcast_policy policy,
+                 const permissions &perm = permissions());
+
+   //!Opens a previously created process shared broadcast queue with name "name".
+   //!If the queue was not previously created or there are no free resources,
+   //!throws an error.
+   broadcast_queue_t(open_only_t open_only,
+                 const char *name);
+
+   //!Destroys *this and indicates that the calling process is finished using
+   //!the resource. Subscribers attached through *this must be destroyed before.
+   //!The queue can still be opened again calling the open constructor overload.
+   //!To erase the queue from the system use remove().
+   ~broadcast_queue_t();
+
+   //!Broadcasts a message stored in buffer "buffer" with size "buffer_size" with
+   //!priority "priority". If the ring is full and the queue was created with
+   //!block_slow_subscribers the sender is blocked. Throws interprocess_error on error.
+   void send (const void *buffer,     size_type buffer_size,
+              unsigned int priority);
+
+   //!Broadcasts a message stored in buffer "buffer" with size "buffer_size" with
+   //!priority "priority". If the ring is full and the queue was created with
+   //!block_slow_subscribers the sender is not blocked and returns false, otherwise
+   //!returns true. Throws interprocess_error on error.
+   bool try_send    (const void *buffer,     size_type buffer_size,
+                         unsigned int priority);
+
+   //!Broadcasts a message stored in buffer "buffer" with size "buffer_size" with
+   //!priority "priority". If the ring is full and the queue was created with
+   //!block_slow_subscribers the sender retries until time "abs_time" is reached.
+   //!Returns true if the message has been successfully sent. Returns false if
+   //!timeout is reached. Throws interprocess_error on error.
+   bool timed_send    (const void *buffer,     size_type buffer_size,
+                           unsigned int priority,  const boost::posix_time::ptime& abs_time);
+
+   //!Returns the number of slots of the queue. The queue must be
+   //!opened or created previously. Otherwise, returns 0.
+   //!Never throws
+   size_type get_max_msg() const;
+
+   //!Returns the maximum size of message allowed by the queue. The queue
+   //!must be opened or created previously. Otherwise, returns 0.
+   //!Never throws
+   size_type get_max_msg_size() const;
+
+   //!Returns the maximum number of subscribers attached at the same time.
+   //!The queue must be opened or created previously. Otherwise, returns 0.
+   //!Never throws
+   size_type get_max_subscribers() const;
+
+   //!Returns the number of subscribers currently attached, including the
+   //!evicted ones that were not destroyed yet. The value might be outdated
+   //!when returned if other processes are using the queue.
+   //!Never throws
+   size_type get_num_subscribers() const;
+
+   //!Returns the slow subscriber policy selected when the queue was created.
+   //!Never throws
+   broadcast_policy get_policy() const;
+
+   //!Removes the broadcast queue from the system.
+   //!Returns false on error. Never throws
+   static bool remove(const char *name);
+
+   /// @cond
+   private:
+   typedef boost::posix_time::ptime ptime;
+
+   friend class ipcdetail::broadcast_queue_initialization_func_t<VoidPointer>;
+   friend class subscriber;
+
+   bool do_send(block_t block,
+                const void *buffer,      size_type buffer_size,
+                unsigned int priority,   const ptime &abs_time);
+
+   //!Returns the needed memory size for the shared broadcast queue.
+   //!Never throws
+   static size_type get_mem_size
+      (size_type max_msg_size, size_type max_num_msg, size_type max_subscribers);
+   typedef ipcdetail::managed_open_or_create_impl
+      <shared_memory_object, ipcdetail::broadcast_cache_line_size, true, false> open_create_impl_t;
+   open_create_impl_t m_shmem;
+   /// @endcond
+};
+
+//!A subscriber attached to a broadcast_queue_t. It receives the messages
+//!sent after it was constructed, in the order they were sent. A subscriber
+//!must only be used by one thread at the same time.
+template<class VoidPointer>
+class broadcast_queue_t<VoidPointer>::subscriber
+{
+   /// @cond
+   subscriber(const subscriber &);
+   subscriber &operator=(const subscriber &);
+   /// @endcond
+
+   public:
+   //!Attaches a subscriber to "queue", which must outlive it. Throws
+   //!interprocess_exception with out_of_resource_error if "get_max_subscribers()"
+   //!subscribers are already attached.
+   explicit subscriber(broadcast_queue_t &queue);
+
+   //!Detaches the subscriber, so that the sender does not wait for it anymore.
+   //!Never throws
+   ~subscriber();
+
+   //!Receives the oldest message not received yet. The message is stored in
+   //!buffer "buffer", which has size "buffer_size". The received message has size
+   //!"recvd_size" and priority "priority". If there are no new messages the
+   //!subscriber is blocked. Throws interprocess_error on error and if the
+   //!subscriber was evicted.
+   void receive (void *buffer,           size_type buffer_size,
+                 size_type &recvd_size,unsigned int &priority);
+
+   //!Same as receive() but if there are no new messages the subscriber
+   //!is not blocked and returns false, otherwise returns true.
+   bool try_receive (void *buffer,           size_type buffer_size,
+                     size_type &recvd_size,unsigned int &priority);
+
+   //!Same as receive() but if there are no new messages the subscriber
+   //!retries until time "abs_time" is reached. Returns true if a message
+   //!has been received. Returns false if timeout is reached.
+   bool timed_receive (void *buffer,           size_type buffer_size,
+                       size_type &recvd_size,unsigned int &priority,
+                       const boost::posix_time::ptime &abs_time);
+
+   //!Returns the number of messages sent since the subscriber was attached
+   //!that it will not receive because they were overwritten before.
+   //!Never throws
+   size_type get_num_lost() const;
+
+   //!Returns true if the sender evicted the subscriber because it was too slow.
+   //!Never throws
+   bool is_evicted() const;
+
+   //!Returns the number of messages sent and not received yet by this subscriber.
+   //!The value might be outdated when returned.
+   //!Never throws
+   size_type get_num_msg() const;
+
+   /// @cond
+   private:
+   typedef boost::posix_time::ptime ptime;
+
+   bool do_receive(block_t block,
+                   void *buffer,         size_type buffer_size,
+                   size_type &recvd_size, unsigned int &priority,
+                   const ptime &abs_time);
+
+   broadcast_queue_t &m_queue;
+   size_type         m_index;
+   size_type         m_num_lost;
+   /// @endcond
+};
+
+/// @cond
+
+namespace ipcdetail {
+
+//!This header is the prefix of each slot of the ring
+template<class VoidPointer>
+class broadcast_msg_hdr_t
+{
+   typedef VoidPointer                                                     void_pointer;
+   typedef typename boost::intrusive::
+      pointer_traits<void_pointer>::template
+         rebind_pointer<char>::type                                        char_ptr;
+   typedef typename boost::intrusive::pointer_traits<char_ptr>::difference_type difference_type;
+   typedef typename boost::make_unsigned<difference_type>::type            size_type;
+
+   public:
+   //Odd while the sender writes the slot, so that subscribers
+   //can detect that the message was overwritten while copying it
+   volatile boost::uint32_t   seq;
+   //Ring position of the message stored in the slot
+   volatile boost::uint32_t   pos;
+   unsigned int               priority;
+   size_type                  len;
+   void * data(){ return this+1; }
+};
+
+//!Read position of a subscriber, each one in its own cache line
+struct broadcast_subscriber_hdr_t
+{
+   enum state_t { free_state, joining_state, active_state, evicted_state };
+
+   volatile boost::uint32_t   state;
+   //Position of the next message to be received
+   volatile boost::uint32_t   cursor;
+};
+
+//!This header is placed in the beginning of the shared memory and contains
+//!the data to control the queue, followed by the subscribers and the ring of slots.
+template<class VoidPointer>
+class broadcast_queue_hdr_t
+{
+   typedef VoidPointer                                                     void_pointer;
+   typedef broadcast_msg_hdr_t<void_pointer>                               msg_header;
+   typedef broadcast_subscriber_hdr_t                                      subscriber_header;
+   typedef typename boost::intrusive::
+      pointer_traits<void_pointer>::template
+         rebind_pointer<char>::type                                        char_ptr;
+   typedef typename boost::intrusive::pointer_traits<char_ptr>::difference_type difference_type;
+   typedef typename boost::make_unsigned<difference_type>::type            size_type;
+   typedef ipcdetail::managed_open_or_create_impl
+      <shared_memory_object, broadcast_cache_line_size, true, false>        open_create_impl_t;
+
+   //Positions are 32 bit counters that wrap around, so the
+   //number of slots must be a power of two that fits in them
+   static const size_type MaxSlots = size_type(1u) << 31;
+
+   static const size_type SubscriberSize =
+      ct_rounded_size<sizeof(subscriber_header), broadcast_cache_line_size>::value;
+
+   static size_type get_header_size()
+   {  return ct_rounded_size<sizeof(broadcast_queue_hdr_t), broadcast_cache_line_size>::value;  }
+
+   public:
+   enum pop_result_t {  pop_ok, pop_empty, pop_evicted  };
+
+   //!Constructor. This object must be constructed in the beginning of the
+   //!shared memory of the size returned by the function "get_mem_size".
+   //!This constructor initializes the subscribers and the slots. Never throws.
+   broadcast_queue_hdr_t(size_type max_num_msg, size_type max_msg_size,
+                         size_type max_subscribers, broadcast_policy policy)
+      :  m_max_num_msg(get_num_slots(max_num_msg)),
+         m_max_msg_size(max_msg_size),
+         m_slot_size(get_slot_size(max_msg_size)),
+         m_max_subscribers(max_subscribers),
+         m_policy(policy),
+         m_head(0),
+         m_min_cursor(0)
+   {
+      for(size_type i = 0; i != m_max_subscribers; ++i){
+         subscriber_header *sub = new(&this->subscriber_at(i)) subscriber_header;
+         sub->state  = subscriber_header::free_state;
+         sub->cursor = 0;
+      }
+      for(size_type i = 0; i != m_max_num_msg; ++i){
+         msg_header *msg = new(&this->slot(boost::uint32_t(i))) msg_header;
+         msg->seq       = 0;
+         //No subscriber can expect this position before the slot is written
+         msg->pos       = boost::uint32_t(i - m_max_num_msg);
+         msg->priority  = 0;
+         msg->len       = 0;
+      }
+   }
+
+   //!Returns the number of slots of a queue created with "max_num_msg".
+   static size_type get_num_slots(size_type max_num_msg)
+   {
+      size_type num = 1;
+      while(num < max_num_msg && num < MaxSlots){
+         num <<= 1;
+      }
+      return num;
+   }
+
+   //!Returns the size of a slot holding messages of up to "max_msg_size" bytes.
+   static size_type get_slot_size(size_type max_msg_size)
+   {
+      return sizeof(msg_header) +
+         ipcdetail::get_rounded_size(max_msg_size, size_type(::boost::alignment_of<msg_header>::value));
+   }
+
+   //!Returns the number of bytes needed to construct a broadcast queue with
+   //!"max_num_size" maximum number of messages, "max_msg_size" maximum
+   //!message size and "max_subscribers" subscribers. Never throws.
+   static size_type get_mem_size
+      (size_type max_msg_size, size_type max_num_msg, size_type max_subscribers)
+   {
+      return get_header_size() + max_subscribers*SubscriberSize +
+         get_num_slots(max_num_msg)*get_slot_size(max_msg_size) +
+         open_create_impl_t::ManagedOpenOrCreateUserOffset;
+   }
+
+   //!Copies the message in the slot of the next position. Returns false if
+   //!a subscriber has not received the message stored in the slot and
+   //!the policy is block_slow_subscribers.
+   bool try_push(const void *buffer, size_type size, unsigned int priority);
+
+   //!Copies the oldest message not received by the subscriber "index" in
+   //!"buffer" and advances its position. Adds to "lost" the number of messages
+   //!it skips because they were overwritten.
+   pop_result_t try_pop(size_type index, size_type &lost,
+                        void *buffer, size_type &recvd_size, unsigned int &priority);
+
+   //!Takes a free subscriber. Returns false if all of them are taken.
+   bool subscribe(size_type &index);
+
+   //!Releases the subscriber "index"
+   void unsubscribe(size_type index)
+   {  atomic_write32(&this->subscriber_at(index).state, subscriber_header::free_state);  }
+
+   bool is_evicted(size_type index)
+   {
+      return atomic_read32(&this->subscriber_at(index).state)
+         == subscriber_header::evicted_state;
+   }
+
+   //!Returns the number of messages not received by the subscriber "index".
+   size_type get_num_msg(size_type index)
+   {
+      const boost::uint32_t cursor = atomic_read32(&this->subscriber_at(index).cursor);
+      const size_type num = size_type(boost::uint32_t(atomic_read32(&m_head) - cursor));
+      return num > m_max_num_msg ? m_max_num_msg : num;
+   }
+
+   size_type get_num_subscribers()
+   {
+      size_type num = 0;
+      for(size_type i = 0; i != m_max_subscribers; ++i){
+         const boost::uint32_t state = atomic_read32(&this->subscriber_at(i).state);
+         num += state == subscriber_header::active_state ||
+                state == subscriber_header::evicted_state;
+      }
+      return num;
+   }
+
+   private:
+   //!Recomputes the position of the slowest subscriber, evicting the ones
+   //!that have not received the message stored in the slot of "pos" if the
+   //!policy is evict_slow_subscribers. Returns true if the slot can be written.
+   bool update_min_cursor(boost::uint32_t pos);
+
+   subscriber_header &subscriber_at(size_type index)
+   {
+      return *reinterpret_cast<subscriber_header*>
+         (reinterpret_cast<char*>(this) + get_header_size() + index*SubscriberSize);
+   }
+
+   msg_header &slot(boost::uint32_t pos)
+   {
+      return *reinterpret_cast<msg_header*>
+         ( reinterpret_cast<char*>(this) + get_header_size() + m_max_subscribers*SubscriberSize
+         + size_type(pos & boost::uint32_t(m_max_num_msg - 1))*m_slot_size);
+   }
+
+   public:
+   //Number of slots of the ring (a power of two)
+   const size_type            m_max_num_msg;
+   //Maximum size of messages of the queue
+   const size_type            m_max_msg_size;
+   //Size of each slot, including its header
+   const size_type            m_slot_size;
+   //Number of subscriber headers
+   const size_type            m_max_subscribers;
+   //broadcast_policy selected on creation
+   const boost::uint32_t      m_policy;
+   char                       m_pad0[broadcast_cache_line_size];
+   //Position of the next message to be sent
+   volatile boost::uint32_t   m_head;
+   //Position of the slowest subscriber when the sender last checked them,
+   //only used by the sender
+   boost::uint32_t            m_min_cursor;
+   char                       m_pad1[broadcast_cache_line_size];
+   //Blocks subscribers when there are no new messages
+   interprocess_eventcount    m_not_empty;
+   //Blocks the sender when the slowest subscriber is a lap behind
+   interprocess_eventcount    m_not_full;
+};
+
+template<class VoidPointer>
+inline bool broadcast_queue_hdr_t<VoidPointer>::update_min_cursor(boost::uint32_t pos)
+{
+   boost::uint32_t min_cursor = pos;
+   for(size_type i = 0; i != m_max_subscribers; ++i){
+      subscriber_header &sub = this->subscriber_at(i);
+      if(atomic_read32(&sub.state) != subscriber_header::active_state){
+         continue;
+      }
+      const boost::uint32_t cursor = atomic_read32(&sub.cursor);
+      if(size_type(boost::uint32_t(pos - cursor)) >= m_max_num_msg &&
+         m_policy == evict_slow_subscribers){
+         //If the subscriber is detached meanwhile the entry must not be marked
+         atomic_cas32(&sub.state, subscriber_header::evicted_state, subscriber_header::active_state);
+         continue;
+      }
+      if(boost::uint32_t(pos - cursor) > boost::uint32_t(pos - min_cursor)){
+         min_cursor = cursor;
+      }
+   }
+   //Subscribers must have finished reading the slot before it's overwritten
+   atomic_read_barrier();
+   m_min_cursor = min_cursor;
+   return size_type(boost::uint32_t(pos - min_cursor)) < m_max_num_msg;
+}
+
+template<class VoidPointer>
+inline bool broadcast_queue_hdr_t<VoidPointer>::try_push
+   (const void *buffer, size_type size, unsigned int priority)
+{
+   //Only the sender writes the head
+   const boost::uint32_t pos = atomic_read32(&m_head);
+   //Subscribers are only checked when the slowest known one could be overwritten
+   if(m_policy != overwrite_slow_subscribers &&
+      size_type(boost::uint32_t(pos - m_min_cursor)) >= m_max_num_msg &&
+      !this->update_min_cursor(pos)){
+      return false;
+   }
+
+   msg_header &msg = this->slot(pos);
+   const boost::uint32_t seq = msg.seq;
+   atomic_write32(&msg.seq, seq + 1);
+   atomic_write_barrier();
+   msg.pos        = pos;
+   msg.len        = size;
+   msg.priority   = priority;
+   std::memcpy(msg.data(), buffer, size);
+
+   //Publish the message after its contents
+   atomic_write_barrier();
+   atomic_write32(&msg.seq, seq + 2);
+   atomic_write32(&m_head, pos + 1);
+   return true;
+}
+
+template<class VoidPointer>
+inline typename broadcast_queue_hdr_t<VoidPointer>::pop_result_t
+   broadcast_queue_hdr_t<VoidPointer>::try_pop
+      (size_type index, size_type &lost, void *buffer, size_type &recvd_size, unsigned int &priority)
+{
+   subscriber_header &sub = this->subscriber_at(index);
+   //Only this subscriber writes its position
+   boost::uint32_t cursor = sub.cursor;
+   for(;;){
+      if(atomic_read32(&sub.state) == subscriber_header::evicted_state){
+         return pop_evicted;
+      }
+      const boost::uint32_t head = atomic_read32(&m_head);
+      if(cursor == head){
+         return pop_empty;
+      }
+      if(size_type(boost::uint32_t(head - cursor)) > m_max_num_msg){
+         //The sender has lapped the subscriber, skip the overwritten messages
+         const boost::uint32_t oldest = head - boost::uint32_t(m_max_num_msg);
+         lost  += size_type(boost::uint32_t(oldest - cursor));
+         cursor = oldest;
+      }
+
+      msg_header &msg = this->slot(cursor);
+      const boost::uint32_t seq = atomic_read32(&msg.seq);
+      atomic_read_barrier();
+      if((seq & 1u) || msg.pos != cursor){
+         //The slot is being overwritten by the next lap
+         thread_yield();
+         continue;
+      }
+      size_type len  = msg.len;
+      if(len > m_max_msg_size){
+         len = m_max_msg_size;
+      }
+      priority = msg.priority;
+      std::memcpy(buffer, msg.data(), len);
+      //The copy is only valid if the slot was not written meanwhile
+      atomic_read_barrier();
+      if(atomic_read32(&msg.seq) != seq){
+         continue;
+      }
+      recvd_size = len;
+      break;
+   }
+
+   //Release the slot for the sender of the next lap
+   atomic_write_barrier();
+   atomic_write32(&sub.cursor, cursor + 1);
+   return pop_ok;
+}
+
+template<class VoidPointer>
+inline bool broadcast_queue_hdr_t<VoidPointer>::subscribe(size_type &index)
+{
+   for(size_type i = 0; i != m_max_subscribers; ++i){
+      subscriber_header &sub = this->subscriber_at(i);
+      if(atomic_cas32(&sub.state, subscriber_header::joining_state, subscriber_header::free_state)
+            != subscriber_header::free_state){
+         continue;
+      }
+      atomic_write32(&sub.cursor, atomic_read32(&m_head));
+      atomic_cas32(&sub.state, subscriber_header::active_state, subscriber_header::joining_state);
+      //The sender might have checked the subscribers before it was active and
+      //might write up to a lap after the position it found: start from a
+      //position read after the sender can see the subscriber
+      atomic_write32(&sub.cursor, atomic_read32(&m_head));
+      index = i;
+      return true;
+   }
+   return false;
+}
+
+//!This is the atomic functor to be executed when creating or opening
+//!shared memory. Never throws
+template<class VoidPointer>
+class broadcast_queue_initialization_func_t
+{
+   public:
+   typedef typename boost::intrusive::
+      pointer_traits<VoidPointer>::template
+         rebind_pointer<char>::type                                    char_ptr;
+   typedef typename boost::intrusive::pointer_traits<char_ptr>::difference_type difference_type;
+   typedef typename boost::make_unsigned<difference_type>::type        size_type;
+
+   broadcast_queue_initialization_func_t(size_type maxmsg = 0,
+                         size_type maxmsgsize = 0,
+                         size_type maxsubscribers = 0,
+                         broadcast_policy policy = block_slow_subscribers)
+      : m_maxmsg (maxmsg), m_maxmsgsize(maxmsgsize)
+      , m_maxsubscribers(maxsubscribers), m_policy(policy) {}
+
+   bool operator()(void *address, size_type, bool created)
+   {
+      char      *mptr;
+
+      if(created){
+         mptr     = reinterpret_cast<char*>(address);
+         //Construct the queue header at the beginning
+         BOOST_TRY{
+            new (mptr) broadcast_queue_hdr_t<VoidPointer>
+               (m_maxmsg, m_maxmsgsize, m_maxsubscribers, m_policy);
+         }
+         BOOST_CATCH(...){
+            return false;
+         }
+         BOOST_CATCH_END
+      }
+      return true;
+   }
+
+   std::size_t get_min_size() const
+   {
+      return broadcast_queue_hdr_t<VoidPointer>::get_mem_size(m_maxmsgsize, m_maxmsg, m_maxsubscribers)
+      - broadcast_queue_t<VoidPointer>::open_create_impl_t::ManagedOpenOrCreateUserOffset;
+   }
+
+   const size_type m_maxmsg;
+   const size_type m_maxmsgsize;
+   const size_type m_maxsubscribers;
+   const broadcast_policy m_policy;
+};
+
+}  //namespace ipcdetail {
+
+template<class VoidPointer>
+inline broadcast_queue_t<VoidPointer>::~broadcast_queue_t()
+{}
+
+template<class VoidPointer>
+inline typename broadcast_queue_t<VoidPointer>::size_type broadcast_queue_t<VoidPointer>::get_mem_size
+   (size_type max_msg_size, size_type max_num_msg, size_type max_subscribers)
+{  return ipcdetail::broadcast_queue_hdr_t<VoidPointer>::get_mem_size(max_msg_size, max_num_msg, max_subscribers);   }
+
+template<class VoidPointer>
+inline broadcast_queue_t<VoidPointer>::broadcast_queue_t(create_only_t,
+                                    const char *name,
+                                    size_type max_num_msg,
+                                    size_type max_msg_size,
+                                    size_type max_subscribers,
+                                    const permissions &perm)
+      //Create shared memory and execute functor atomically
+   :  m_shmem(create_only,
+              name,
+              get_mem_size(max_msg_size, max_num_msg, max_subscribers),
+              read_write,
+              static_cast<void*>(0),
+              //Prepare initialization functor
+              ipcdetail::broadcast_queue_initialization_func_t<VoidPointer>
+                 (max_num_msg, max_msg_size, max_subscribers),
+              perm)
+{}
+
+template<class VoidPointer>
+inline broadcast_queue_t<VoidPointer>::broadcast_queue_t(create_only_t,
+                                    const char *name,
+                                    size_type max_num_msg,
+                                    size_type max_msg_size,
+                                    size_type max_subscribers,
+                                    broadcast_policy policy,
+                                    const permissions &perm)
+      //Create shared memory and execute functor atomically
+   :  m_shmem(create_only,
+              name,
+              get_mem_size(max_msg_size, max_num_msg, max_subscribers),
+              read_write,
+              static_cast<void*>(0),
+              //Prepare initialization functor
+              ipcdetail::broadcast_queue_initialization_func_t<VoidPointer>
+                 (max_num_msg, max_msg_size, max_subscribers, policy),
+              perm)
+{}
+
+template<class VoidPointer>
+inline broadcast_queue_t<VoidPointer>::broadcast_queue_t(open_or_create_t,
+                                    const char *name,
+                                    size_type max_num_msg,
+                                    size_type max_msg_size,
+                                    size_type max_subscribers,
+                                    const permissions &perm)
+      //Create shared memory and execute functor atomically
+   :  m_shmem(open_or_create,
+              name,
+              get_mem_size(max_msg_size, max_num_msg, max_subscribers),
+              read_write,
+              static_cast<void*>(0),
+              //Prepare initialization functor
+              ipcdetail::broadcast_queue_initialization_func_t<VoidPointer>
+                 (max_num_msg, max_msg_size, max_subscribers),
+              perm)
+{}
+
+template<class VoidPointer>
+inline broadcast_queue_t<VoidPointer>::broadcast_queue_t(open_or_create_t,
+                                    const char *name,
+                                    size_type max_num_msg,
+                                    size_type max_msg_size,
+                                    size_type max_subscribers,
+                                    broadcast_policy policy,
+                                    const permissions &perm)
+      //Create shared memory and execute functor atomically
+   :  m_shmem(open_or_create,
+              name,
+              get_mem_size(max_msg_size, max_num_msg, max_subscribers),
+              read_write,
+              static_cast<void*>(0),
+              //Prepare initialization functor
+              ipcdetail::broadcast_queue_initialization_func_t<VoidPointer>
+                 (max_num_msg, max_msg_size, max_subscribers, policy),
+              perm)
+{}
+
+template<class VoidPointer>
+inline broadcast_queue_t<VoidPointer>::broadcast_queue_t(open_only_t, const char *name)
+   //Create shared memory and execute functor atomically
+   :  m_shmem(open_only,
+              name,
+              read_write,
+              static_cast<void*>(0),
+              //Prepare initialization functor
+              ipcdetail::broadcast_queue_initialization_func_t<VoidPointer> ())
+{}
+
+template<class VoidPointer>
+inline void broadcast_queue_t<VoidPointer>::send
+   (const void *buffer, size_type buffer_size, unsigned int priority)
+{  this->do_send(blocking, buffer, buffer_size, priority, ptime()); }
+
+template<class VoidPointer>
+inline bool broadcast_queue_t<VoidPointer>::try_send
+   (const void *buffer, size_type buffer_size, unsigned int priority)
+{  return this->do_send(non_blocking, buffer, buffer_size, priority, ptime()); }
+
+template<class VoidPointer>
+inline bool broadcast_queue_t<VoidPointer>::timed_send
+   (const void *buffer, size_type buffer_size
+   ,unsigned int priority, const boost::posix_time::ptime &abs_time)
+{
+   if(abs_time == boost::posix_time::pos_infin){
+      this->send(buffer, buffer_size, priority);
+      return true;
+   }
+   return this->do_send(timed, buffer, buffer_size, priority, abs_time);
+}
+
+template<class VoidPointer>
+inline bool broadcast_queue_t<VoidPointer>::do_send(block_t block,
+                                const void *buffer,      size_type buffer_size,
+                                unsigned int priority,   const boost::posix_time::ptime &abs_time)
+{
+   ipcdetail::broadcast_queue_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::broadcast_queue_hdr_t<VoidPointer>*>(m_shmem.get_user_address());
+   //Check if buffer is smaller than maximum allowed
+   if (buffer_size > p_hdr->m_max_msg_size) {
+      throw interprocess_exception(size_error);
+   }
+
+   while(!p_hdr->try_push(buffer, buffer_size, priority)){
+      if(block == non_blocking){
+         return false;
+      }
+      //A subscriber is a lap behind. Register as a waiter and try again, so
+      //that a subscriber receiving or detaching after this point will wake us up
+      const interprocess_eventcount::key_type key = p_hdr->m_not_full.prepare_wait();
+      if(p_hdr->try_push(buffer, buffer_size, priority)){
+         p_hdr->m_not_full.cancel_wait();
+         break;
+      }
+      if(!p_hdr->m_not_full.timed_wait
+            (key, block == timed ? abs_time : ptime(boost::posix_time::pos_infin))){
+         //Timeout, last chance
+         if(!p_hdr->try_push(buffer, buffer_size, priority)){
+            return false;
+         }
+         break;
+      }
+   }
+
+   //Wake all subscribers blocked at the head, no system
+   //call is issued if none of them was waiting
+   p_hdr->m_not_empty.notify_all();
+   return true;
+}
+
+template<class VoidPointer>
+inline typename broadcast_queue_t<VoidPointer>::size_type broadcast_queue_t<VoidPointer>::get_max_msg() const
+{
+   ipcdetail::broadcast_queue_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::broadcast_queue_hdr_t<VoidPointer>*>(m_shmem.get_user_address());
+   return p_hdr ? p_hdr->m_max_num_msg : 0;
+}
+
+template<class VoidPointer>
+inline typename broadcast_queue_t<VoidPointer>::size_type broadcast_queue_t<VoidPointer>::get_max_msg_size() const
+{
+   ipcdetail::broadcast_queue_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::broadcast_queue_hdr_t<VoidPointer>*>(m_shmem.get_user_address());
+   return p_hdr ? p_hdr->m_max_msg_size : 0;
+}
+
+template<class VoidPointer>
+inline typename broadcast_queue_t<VoidPointer>::size_type broadcast_queue_t<VoidPointer>::get_max_subscribers() const
+{
+   ipcdetail::broadcast_queue_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::broadcast_queue_hdr_t<VoidPointer>*>(m_shmem.get_user_address());
+   return p_hdr ? p_hdr->m_max_subscribers : 0;
+}
+
+template<class VoidPointer>
+inline typename broadcast_queue_t<VoidPointer>::size_type broadcast_queue_t<VoidPointer>::get_num_subscribers() const
+{
+   ipcdetail::broadcast_queue_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::broadcast_queue_hdr_t<VoidPointer>*>(m_shmem.get_user_address());
+   return p_hdr ? p_hdr->get_num_subscribers() : 0;
+}
+
+template<class VoidPointer>
+inline broadcast_policy broadcast_queue_t<VoidPointer>::get_policy() const
+{
+   ipcdetail::broadcast_queue_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::broadcast_queue_hdr_t<VoidPointer>*>(m_shmem.get_user_address());
+   return p_hdr ? broadcast_policy(p_hdr->m_policy) : block_slow_subscribers;
+}
+
+template<class VoidPointer>
+inline bool broadcast_queue_t<VoidPointer>::remove(const char *name)
+{  return shared_memory_object::remove(name);  }
+
+template<class VoidPointer>
+inline broadcast_queue_t<VoidPointer>::subscriber::subscriber(broadcast_queue_t &queue)
+   :  m_queue(queue), m_index(0), m_num_lost(0)
+{
+   ipcdetail::broadcast_queue_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::broadcast_queue_hdr_t<VoidPointer>*>(m_queue.m_shmem.get_user_address());
+   if(!p_hdr->subscribe(m_index)){
+      throw interprocess_exception(out_of_resource_error);
+   }
+}
+
+template<class VoidPointer>
+inline broadcast_queue_t<VoidPointer>::subscriber::~subscriber()
+{
+   ipcdetail::broadcast_queue_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::broadcast_queue_hdr_t<VoidPointer>*>(m_queue.m_shmem.get_user_address());
+   p_hdr->unsubscribe(m_index);
+   //The sender might be waiting for this subscriber
+   p_hdr->m_not_full.notify_one();
+}
+
+template<class VoidPointer>
+inline void broadcast_queue_t<VoidPointer>::subscriber::receive
+   (void *buffer, size_type buffer_size, size_type &recvd_size, unsigned int &priority)
+{  this->do_receive(blocking, buffer, buffer_size, recvd_size, priority, ptime()); }
+
+template<class VoidPointer>
+inline bool broadcast_queue_t<VoidPointer>::subscriber::try_receive
+   (void *buffer, size_type buffer_size, size_type &recvd_size, unsigned int &priority)
+{  return this->do_receive(non_blocking, buffer, buffer_size, recvd_size, priority, ptime()); }
+
+template<class VoidPointer>
+inline bool broadcast_queue_t<VoidPointer>::subscriber::timed_receive
+   (void *buffer, size_type buffer_size, size_type &recvd_size, unsigned int &priority,
+    const boost::posix_time::ptime &abs_time)
+{
+   if(abs_time == boost::posix_time::pos_infin){
+      this->receive(buffer, buffer_size, recvd_size, priority);
+      return true;
+   }
+   return this->do_receive(timed, buffer, buffer_size, recvd_size, priority, abs_time);
+}
+
+template<class VoidPointer>
+inline bool broadcast_queue_t<VoidPointer>::subscriber::do_receive(block_t block,
+                          void *buffer,            size_type buffer_size,
+                          size_type &recvd_size,   unsigned int &priority,
+                          const boost::posix_time::ptime &abs_time)
+{
+   typedef ipcdetail::broadcast_queue_hdr_t<VoidPointer> header_t;
+   header_t *p_hdr = static_cast<header_t*>(m_queue.m_shmem.get_user_address());
+   //Check if buffer is big enough for any message
+   if (buffer_size < p_hdr->m_max_msg_size) {
+      throw interprocess_exception(size_error);
+   }
+
+   typename header_t::pop_result_t res;
+   while((res = p_hdr->try_pop(m_index, m_num_lost, buffer, recvd_size, priority)) == header_t::pop_empty){
+      if(block == non_blocking){
+         return false;
+      }
+      //No new messages. Register as a waiter and try again, so that
+      //a message sent after this point will wake us up
+      const interprocess_eventcount::key_type key = p_hdr->m_not_empty.prepare_wait();
+      res = p_hdr->try_pop(m_index, m_num_lost, buffer, recvd_size, priority);
+      if(res != header_t::pop_empty){
+         p_hdr->m_not_empty.cancel_wait();
+         break;
+      }
+      if(!p_hdr->m_not_empty.timed_wait
+            (key, block == timed ? abs_time : ptime(boost::posix_time::pos_infin))){
+         //Timeout, last chance
+         res = p_hdr->try_pop(m_index, m_num_lost, buffer, recvd_size, priority);
+         if(res == header_t::pop_empty){
+            return false;
+         }
+         break;
+      }
+   }
+
+   if(res == header_t::pop_evicted){
+      throw interprocess_exception(not_found_error, "boost::interprocess::broadcast_queue: subscriber evicted");
+   }
+
+   //Wake the sender if it waits for this subscriber, no system
+   //call is issued if the sender is not blocked
+   if(p_hdr->m_policy == block_slow_subscribers){
+      p_hdr->m_not_full.notify_one();
+   }
+   return true;
+}
+
+template<class VoidPointer>
+inline typename broadcast_queue_t<VoidPointer>::size_type
+   broadcast_queue_t<VoidPointer>::subscriber::get_num_lost() const
+{  return m_num_lost;  }
+
+template<class VoidPointer>
+inline bool broadcast_queue_t<VoidPointer>::subscriber::is_evicted() const
+{
+   ipcdetail::broadcast_queue_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::broadcast_queue_hdr_t<VoidPointer>*>(m_queue.m_shmem.get_user_address());
+   return p_hdr->is_evicted(m_index);
+}
+
+template<class VoidPointer>
+inline typename broadcast_queue_t<VoidPointer>::size_type
+   broadcast_queue_t<VoidPointer>::subscriber::get_num_msg() const
+{
+   ipcdetail::broadcast_queue_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::broadcast_queue_hdr_t<VoidPointer>*>(m_queue.m_shmem.get_user_address());
+   return p_hdr->get_num_msg(m_index);
+}
+
+/// @endcond
+
+}} //namespace boost{  namespace interprocess{
+
+#include <boost/interprocess/detail/config_end.hpp>
+
+#endif   //#ifndef BOOST_INTERPROCESS_BROADCAST_QUEUE_HPP
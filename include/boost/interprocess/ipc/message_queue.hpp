@@ -20,17 +20,22 @@
 #include <boost/interprocess/sync/interprocess_mutex.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 #include <boost/interprocess/detail/utilities.hpp>
+#include <boost/interprocess/detail/math_functions.hpp>
+#include <boost/interprocess/mem_algo/rbtree_best_fit.hpp>
+#include <boost/interprocess/sync/mutex_family.hpp>
 #include <boost/interprocess/offset_ptr.hpp>
 #include <boost/interprocess/creation_tags.hpp>
 #include <boost/interprocess/exceptions.hpp>
 #include <boost/interprocess/permissions.hpp>
 #include <boost/detail/no_exceptions_support.hpp>
+#include <boost/move/move.hpp>
 #include <boost/interprocess/detail/type_traits.hpp>
 #include <boost/intrusive/pointer_traits.hpp>
 #include <boost/type_traits/make_unsigned.hpp>
 #include <boost/type_traits/alignment_of.hpp>
 #include <boost/intrusive/pointer_traits.hpp>
 #include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
 #include <algorithm> //std::lower_bound
 #include <cstddef>   //std::size_t
 #include <cstring>   //memcpy
@@ -43,10 +48,33 @@
 
 namespace boost{  namespace interprocess{
 
+//!Index used by a message_queue_t to find the queued message with the
+//!highest priority. Selected when the queue is created.
+enum message_queue_index
+{
+   //!Messages are kept in an array sorted by priority. Any priority can be
+   //!used, but a message sent with a lower priority than the last queued
+   //!one moves up to half of the queued messages.
+   sorted_priority_index,
+   //!Messages are kept in a FIFO list per priority and the highest non-empty
+   //!list is found in a bitmap, so sending and receiving take constant time.
+   //!Priorities must be lower than message_queue_bucket_priorities.
+   bucket_priority_index
+};
+
+//!Number of priorities supported by bucket_priority_index
+static const unsigned int message_queue_bucket_priorities = 32u;
+
 namespace ipcdetail
 {
    template<class VoidPointer>
    class msg_queue_initialization_func_t;
+
+   template<class VoidPointer>
+   class msg_hdr_t;
+
+   template<class VoidPointer>
+   class mq_hdr_t;
 }
 
 //!A class that allows sending messages
@@ -69,6 +97,176 @@ class message_queue_t
    typedef typename boost::intrusive::pointer_traits<char_ptr>::difference_type difference_type;
    typedef typename boost::make_unsigned<difference_type>::type        size_type;
 
+   //!A message reserved with reserve_send(). The sender writes the message
+   //!in place and then publishes it with commit(), without copying it from
+   //!another buffer. The message is returned to the queue if it's destroyed
+   //!before being committed.
+   class send_slot
+   {
+      /// @cond
+      BOOST_MOVABLE_BUT_NOT_COPYABLE(send_slot)
+      typedef ipcdetail::msg_hdr_t<VoidPointer> msg_header;
+      /// @endcond
+      public:
+      //!Constructs a slot that holds no message.
+      send_slot()
+         :  mp_queue(0), mp_msg(0)
+      {}
+
+      //!Moves the reservation held by "other" to *this.
+      send_slot(BOOST_RV_REF(send_slot) other)
+         :  mp_queue(other.mp_queue), mp_msg(other.mp_msg)
+      {  other.mp_queue = 0;  other.mp_msg = 0;  }
+
+      //!Cancels the reservation held by *this and moves the one held by "other".
+      send_slot &operator=(BOOST_RV_REF(send_slot) other)
+      {
+         if(this != &other){
+            this->cancel();
+            mp_queue = other.mp_queue;
+            mp_msg   = other.mp_msg;
+            other.mp_queue = 0;
+            other.mp_msg   = 0;
+         }
+         return *this;
+      }
+
+      //!Cancels the reservation if it was not committed.
+      ~send_slot()
+      {  this->cancel();  }
+
+      //!Returns true if *this holds a reserved message.
+      bool valid() const
+      {  return mp_msg != 0;  }
+
+      //!Returns the buffer where the message must be written.
+      void *data() const
+      {  return mp_msg->data();  }
+
+      //!Returns the size passed to reserve_send().
+      size_type size() const
+      {  return mp_msg->len;  }
+
+      //!Returns the priority passed to reserve_send().
+      unsigned int priority() const
+      {  return mp_msg->priority;  }
+
+      //!Precondition: valid().
+      //!Effects: Queues the message with the size passed to reserve_send().
+      //!Postcondition: !valid().
+      void commit()
+      {  this->commit(mp_msg->len);  }
+
+      //!Precondition: valid() and msg_size <= size().
+      //!Effects: Queues the first "msg_size" bytes of the message.
+      //!Postcondition: !valid().
+      void commit(size_type msg_size)
+      {
+         BOOST_ASSERT(mp_msg && msg_size <= mp_msg->len);
+         msg_header &msg = *mp_msg;
+         mp_msg = 0;
+         mp_queue->commit_send(msg, msg_size);
+      }
+
+      //!Effects: If valid(), returns the message to the queue without sending it.
+      //!Postcondition: !valid().
+      void cancel()
+      {
+         if(mp_msg){
+            msg_header &msg = *mp_msg;
+            mp_msg = 0;
+            mp_queue->cancel_send(msg);
+         }
+      }
+
+      /// @cond
+      private:
+      friend class message_queue_t;
+      send_slot(message_queue_t *queue, msg_header *msg)
+         :  mp_queue(queue), mp_msg(msg)
+      {}
+
+      message_queue_t *mp_queue;
+      msg_header      *mp_msg;
+      /// @endcond
+   };
+
+   //!A message received with peek_receive(). The receiver reads the message
+   //!in place, without copying it to another buffer, and then releases it.
+   //!The message is released if it's destroyed before.
+   class receive_view
+   {
+      /// @cond
+      BOOST_MOVABLE_BUT_NOT_COPYABLE(receive_view)
+      typedef ipcdetail::msg_hdr_t<VoidPointer> msg_header;
+      /// @endcond
+      public:
+      //!Constructs a view that holds no message.
+      receive_view()
+         :  mp_queue(0), mp_msg(0)
+      {}
+
+      //!Moves the message held by "other" to *this.
+      receive_view(BOOST_RV_REF(receive_view) other)
+         :  mp_queue(other.mp_queue), mp_msg(other.mp_msg)
+      {  other.mp_queue = 0;  other.mp_msg = 0;  }
+
+      //!Releases the message held by *this and moves the one held by "other".
+      receive_view &operator=(BOOST_RV_REF(receive_view) other)
+      {
+         if(this != &other){
+            this->release();
+            mp_queue = other.mp_queue;
+            mp_msg   = other.mp_msg;
+            other.mp_queue = 0;
+            other.mp_msg   = 0;
+         }
+         return *this;
+      }
+
+      //!Releases the message.
+      ~receive_view()
+      {  this->release();  }
+
+      //!Returns true if *this holds a received message.
+      bool valid() const
+      {  return mp_msg != 0;  }
+
+      //!Returns the contents of the message.
+      const void *data() const
+      {  return mp_msg->data();  }
+
+      //!Returns the size of the message.
+      size_type size() const
+      {  return mp_msg->len;  }
+
+      //!Returns the priority of the message.
+      unsigned int priority() const
+      {  return mp_msg->priority;  }
+
+      //!Effects: If valid(), returns the message buffer to the queue.
+      //!Postcondition: !valid().
+      void release()
+      {
+         if(mp_msg){
+            msg_header &msg = *mp_msg;
+            mp_msg = 0;
+            mp_queue->release_receive(msg);
+         }
+      }
+
+      /// @cond
+      private:
+      friend class message_queue_t;
+      receive_view(message_queue_t *queue, msg_header *msg)
+         :  mp_queue(queue), mp_msg(msg)
+      {}
+
+      message_queue_t *mp_queue;
+      msg_header      *mp_msg;
+      /// @endcond
+   };
+
    //!Creates a process shared message queue with name "name". For this message queue,
    //!the maximum number of messages will be "max_num_msg" and the maximum message size
    //!will be "max_msg_size". Throws on error and if the queue was previously created.
@@ -78,6 +276,29 @@ class message_queue_t
                  size_type max_msg_size,
                  const permissions &perm = permissions());
 
+   //!Same as the previous constructor but messages are ordered
+   //!by priority with the index selected by "index".
+   message_queue_t(create_only_t create_only,
+                 const char *name,
+                 size_type max_num_msg,
+                 size_type max_msg_size,
+                 message_queue_index index,
+                 const permissions &perm = permissions());
+
+   //!Same as the previous constructor but messages are not preallocated: each
+   //!message only uses its actual size from a storage of "storage_size" bytes
+   //!shared by all messages. Senders block when there are "max_num_msg" queued
+   //!messages or the storage is exhausted. The storage is enlarged if it
+   //!can't hold a message of "max_msg_size" bytes. If "storage_size" is 0,
+   //!messages are preallocated as with the previous constructor.
+   message_queue_t(create_only_t create_only,
+                 const char *name,
+                 size_type max_num_msg,
+                 size_type max_msg_size,
+                 message_queue_index index,
+                 size_type storage_size,
+                 const permissions &perm = permissions());
+
    //!Opens or creates a process shared message queue with name "name".
    //!If the queue is created, the maximum number of messages will be "max_num_msg"
    //!and the maximum message size will be "max_msg_size". If queue was previously
@@ -89,6 +310,25 @@ class message_queue_t
                  size_type max_msg_size,
                  const permissions &perm = permissions());
 
+   //!Same as the previous constructor but if the queue is created messages
+   //!are ordered by priority with the index selected by "index".
+   message_queue_t(open_or_create_t open_or_create,
+                 const char *name,
+                 size_type max_num_msg,
+                 size_type max_msg_size,
+                 message_queue_index index,
+                 const permissions &perm = permissions());
+
+   //!Same as the previous constructor but if the queue is created messages
+   //!are stored in "storage_size" bytes of variable size storage.
+   message_queue_t(open_or_create_t open_or_create,
+                 const char *name,
+                 size_type max_num_msg,
+                 size_type max_msg_size,
+                 message_queue_index index,
+                 size_type storage_size,
+                 const permissions &perm = permissions());
+
    //!Opens a previously created process shared message queue with name "name".
    //!If the queue was not previously created or there are no free resources,
    //!throws an error.
@@ -150,6 +390,99 @@ class message_queue_t
                        size_type &recvd_size,unsigned int &priority,
                        const boost::posix_time::ptime &abs_time);
 
+   //!Describes a message sent with send_n().
+   struct send_buffer
+   {
+      //!Message contents
+      const void     *buffer;
+      //!Size of the message
+      size_type      size;
+      //!Priority of the message
+      unsigned int   priority;
+   };
+
+   //!Describes a buffer where receive_n() stores a message.
+   struct receive_buffer
+   {
+      //!Buffer for the message contents
+      void           *buffer;
+      //!Size of the buffer, must not be smaller than get_max_msg_size()
+      size_type      buffer_size;
+      //!Set to the size of the received message
+      size_type      recvd_size;
+      //!Set to the priority of the received message
+      unsigned int   priority;
+   };
+
+   //!Sends the "num_msg" messages described by "msgs", as if send() was called
+   //!for each one, but locking the queue once for all the messages that fit in
+   //!it and waking receivers at most once for them. If the message queue is full
+   //!the sender is blocked. Throws interprocess_error on error.
+   void send_n(const send_buffer *msgs, size_type num_msg);
+
+   //!Same as send_n but if the message queue becomes full the sender is not
+   //!blocked. Returns the number of messages sent, that were the first ones
+   //!of "msgs". Throws interprocess_error on error.
+   size_type try_send_n(const send_buffer *msgs, size_type num_msg);
+
+   //!Same as send_n but if the message queue is full the sender retries until
+   //!time "abs_time" is reached. Returns the number of messages sent, that were
+   //!the first ones of "msgs". Throws interprocess_error on error.
+   size_type timed_send_n(const send_buffer *msgs, size_type num_msg,
+                          const boost::posix_time::ptime &abs_time);
+
+   //!Receives up to "num_msg" messages from the message queue in the buffers
+   //!described by "msgs", in the order receive() would return them, locking
+   //!the queue once and waking senders at most once. If the message queue is
+   //!empty the receiver is blocked until there is at least one message.
+   //!Returns the number of received messages. Throws interprocess_error on error.
+   size_type receive_n(receive_buffer *msgs, size_type num_msg);
+
+   //!Same as receive_n but if the message queue is empty the receiver is
+   //!not blocked and returns 0. Throws interprocess_error on error.
+   size_type try_receive_n(receive_buffer *msgs, size_type num_msg);
+
+   //!Same as receive_n but if the message queue is empty the receiver retries
+   //!until time "abs_time" is reached. Returns 0 if timeout is reached.
+   //!Throws interprocess_error on error.
+   size_type timed_receive_n(receive_buffer *msgs, size_type num_msg,
+                             const boost::posix_time::ptime &abs_time);
+
+   //!Reserves a free message of size "msg_size" and priority "priority" that is
+   //!filled through the returned slot and sent calling its commit() function.
+   //!The reserved message counts as a queued one, so if the message queue is
+   //!full the sender is blocked. If the process dies before committing or
+   //!cancelling the slot the reserved message is lost. Throws interprocess_error
+   //!on error.
+   send_slot reserve_send(size_type msg_size, unsigned int priority);
+
+   //!Same as reserve_send but if the message queue is full the sender is
+   //!not blocked and returns a slot that is not valid().
+   //!Throws interprocess_error on error.
+   send_slot try_reserve_send(size_type msg_size, unsigned int priority);
+
+   //!Same as reserve_send but if the message queue is full the sender
+   //!retries until time "abs_time" is reached. Returns a slot that is
+   //!not valid() if timeout is reached. Throws interprocess_error on error.
+   send_slot timed_reserve_send(size_type msg_size, unsigned int priority,
+                                const boost::posix_time::ptime &abs_time);
+
+   //!Receives a message from the message queue, like receive(), but the message
+   //!is not copied: it's read through the returned view and stays out of the
+   //!queue until the view is released. If the message queue is empty the
+   //!receiver is blocked. Throws interprocess_error on error.
+   receive_view peek_receive();
+
+   //!Same as peek_receive but if the message queue is empty the receiver is
+   //!not blocked and returns a view that is not valid().
+   //!Throws interprocess_error on error.
+   receive_view try_peek_receive();
+
+   //!Same as peek_receive but if the message queue is empty the receiver
+   //!retries until time "abs_time" is reached. Returns a view that is not
+   //!valid() if timeout is reached. Throws interprocess_error on error.
+   receive_view timed_peek_receive(const boost::posix_time::ptime &abs_time);
+
    //!Returns the maximum number of messages allowed by the queue. The message
    //!queue must be opened or created previously. Otherwise, returns 0.
    //!Never throws
@@ -160,10 +493,20 @@ class message_queue_t
    //!Never throws
    size_type get_max_msg_size() const;
 
-   //!Returns the number of messages currently stored.
+   //!Returns the number of messages currently stored. Reserved messages
+   //!that are not committed yet are not counted.
    //!Never throws
    size_type get_num_msg() const;
 
+   //!Returns the priority index selected when the queue was created.
+   //!Never throws
+   message_queue_index get_index() const;
+
+   //!Returns the size in bytes of the variable size storage of the queue,
+   //!or 0 if messages are preallocated.
+   //!Never throws
+   size_type get_storage_size() const;
+
    //!Removes the message queue from the system.
    //!Returns false on error. Never throws
    static bool remove(const char *name);
@@ -171,9 +514,50 @@ class message_queue_t
    /// @cond
    private:
    typedef boost::posix_time::ptime ptime;
+   typedef ipcdetail::mq_hdr_t<VoidPointer>  mq_header;
+   typedef ipcdetail::msg_hdr_t<VoidPointer> msg_header;
 
    friend class ipcdetail::msg_queue_initialization_func_t<VoidPointer>;
 
+   //Waits until a message of "msg_size" bytes can be queued, with the mutex
+   //locked. With variable size storage, the message is allocated in "storage".
+   //Returns false if it still can't be queued.
+   bool wait_not_full(mq_header *p_hdr, block_t block,
+                      scoped_lock<interprocess_mutex> &lock, const ptime &abs_time,
+                      size_type msg_size, msg_header *&storage);
+
+   //Wakes one of the "num_waiters" blocked senders for each of the "num_freed"
+   //messages freed, and all of them if some were waiting for variable size storage
+   static void notify_senders(mq_header *p_hdr, size_type num_freed,
+                              size_type num_waiters, bool storage_waiters);
+
+   //Wakes one of the "num_waiters" blocked receivers for each
+   //of the "num_queued" messages queued
+   static void notify_receivers(mq_header *p_hdr, size_type num_queued,
+                                size_type num_waiters);
+
+   //Waits until the queue is not empty, with the mutex locked.
+   //Returns false if it's still empty.
+   bool wait_not_empty(mq_header *p_hdr, block_t block,
+                       scoped_lock<interprocess_mutex> &lock, const ptime &abs_time);
+
+   size_type do_send_n(block_t block, const send_buffer *msgs,
+                       size_type num_msg, const ptime &abs_time);
+
+   size_type do_receive_n(block_t block, receive_buffer *msgs,
+                          size_type num_msg, const ptime &abs_time);
+
+   msg_header *do_reserve_send(block_t block, size_type msg_size,
+                               unsigned int priority, const ptime &abs_time);
+
+   void commit_send(msg_header &msg, size_type msg_size);
+
+   void cancel_send(msg_header &msg);
+
+   msg_header *do_peek_receive(block_t block, const ptime &abs_time);
+
+   void release_receive(msg_header &msg);
+
    bool do_receive(block_t block,
                    void *buffer,         size_type buffer_size,
                    size_type &recvd_size, unsigned int &priority,
@@ -183,9 +567,13 @@ class message_queue_t
                 const void *buffer,      size_type buffer_size,
                 unsigned int priority,   const ptime &abs_time);
 
+   //!Throws if a message can't be sent with "priority"
+   static void check_priority(const mq_header *p_hdr, unsigned int priority);
+
    //!Returns the needed memory size for the shared message queue.
    //!Never throws
-   static size_type get_mem_size(size_type max_msg_size, size_type max_num_msg);
+   static size_type get_mem_size(size_type max_msg_size, size_type max_num_msg,
+                                 message_queue_index index, size_type storage_size);
    typedef ipcdetail::managed_open_or_create_impl<shared_memory_object, 0, true, false> open_create_impl_t;
    open_create_impl_t m_shmem;
    /// @endcond
@@ -227,6 +615,29 @@ class priority_functor
       {  return msg1->priority < msg2->priority;  }
 };
 
+//!Control block of bucket_priority_index. It's followed by an array of
+//!"max_num_msg" links, one per message, that chain queued messages of the
+//!same priority and free messages in singly linked lists.
+template<class SizeType>
+struct mq_buckets_t
+{
+   //!Link value that ends a list
+   static SizeType nil()
+   {  return SizeType(-1);  }
+
+   //!Returns the array of links
+   SizeType *links()
+   {  return reinterpret_cast<SizeType*>(this+1);  }
+
+   //!Bit "p" is set if there are queued messages with priority "p"
+   boost::uint32_t   m_bitmap;
+   //!First message of the free message list
+   SizeType          m_free;
+   //!First (oldest) and last message queued with each priority
+   SizeType          m_head[message_queue_bucket_priorities];
+   SizeType          m_tail[message_queue_bucket_priorities];
+};
+
 //!This header is placed in the beginning of the shared memory and contains
 //!the data to control the queue. This class initializes the shared memory
 //!in the following way: in ascending memory address with proper alignment
@@ -278,6 +689,17 @@ class priority_functor
 //!   An array of buffers of preallocated messages, each one prefixed with the
 //!   msg_hdr_t structure. Each of this message is pointed by one pointer of
 //!   the index structure.
+//!
+//!If the queue uses variable size storage, messages are not preallocated. The
+//!storage is managed by a rbtree_best_fit placed after the index and each
+//!message is allocated, header included, when a sender takes it and deallocated
+//!when it's freed. Free index positions don't point to any message.
+//!
+//!If the queue uses bucket_priority_index, the index is never reordered:
+//!index[n] points to the n-th message (or to the message allocated from
+//!variable size storage when "n" is taken). It's followed by a mq_buckets_t
+//!block and its links, placed before the messages. Queued messages are
+//!chained in a FIFO list per priority and free messages in a LIFO list.
 template<class VoidPointer>
 class mq_hdr_t
    : public ipcdetail::priority_functor<VoidPointer>
@@ -293,6 +715,14 @@ class mq_hdr_t
    typedef typename boost::intrusive::
       pointer_traits<void_pointer>::template
          rebind_pointer<msg_hdr_ptr_t>::type                              msg_hdr_ptr_ptr_t;
+   typedef mq_buckets_t<size_type>                                         mq_buckets;
+   typedef typename boost::intrusive::
+      pointer_traits<void_pointer>::template
+         rebind_pointer<mq_buckets>::type                                  mq_buckets_ptr_t;
+   typedef rbtree_best_fit<null_mutex_family, void_pointer>                storage_algo;
+   typedef typename boost::intrusive::
+      pointer_traits<void_pointer>::template
+         rebind_pointer<storage_algo>::type                                storage_algo_ptr_t;
    typedef ipcdetail::managed_open_or_create_impl<shared_memory_object, 0, true, false> open_create_impl_t;
 
    public:
@@ -300,18 +730,26 @@ class mq_hdr_t
    //!shared memory of the size returned by the function "get_mem_size".
    //!This constructor initializes the needed resources and creates
    //!the internal structures like the priority index. This can throw.
-   mq_hdr_t(size_type max_num_msg, size_type max_msg_size)
+   mq_hdr_t(size_type max_num_msg, size_type max_msg_size,
+            message_queue_index index, size_type storage_size)
       : m_max_num_msg(max_num_msg),
          m_max_msg_size(max_msg_size),
-         m_cur_num_msg(0)
+         m_index(index),
+         m_storage_size(storage_size ? get_storage_size(max_msg_size, storage_size) : 0u),
+         m_num_storage_waiters(0),
+         m_num_send_waiters(0),
+         m_num_recv_waiters(0),
+         m_cur_num_msg(0),
+         m_cur_num_reserved(0)
          #if defined(BOOST_INTERPROCESS_MSG_QUEUE_CIRCULAR_INDEX)
          ,m_cur_first_msg(0u)
          #endif
       {  this->initialize_memory();  }
 
-   //!Returns true if the message queue is full
+   //!Returns true if the message queue is full. Reserved messages
+   //!are not free, so they count as inserted ones
    bool is_full() const
-      {  return m_cur_num_msg == m_max_num_msg;  }
+      {  return m_cur_num_msg + m_cur_num_reserved == m_max_num_msg;  }
 
    //!Returns true if the message queue is empty
    bool is_empty() const
@@ -349,6 +787,46 @@ class mq_hdr_t
    iterator inserted_ptr_end() const
       {  return &mp_index[this->end_pos()];  }
 
+   //!Returns the index position of the n-th free message counting backwards
+   //!from the first inserted one. The first "m_cur_num_reserved" of those
+   //!positions hold reserved messages.
+   size_type free_tail_pos(size_type n) const
+   {  return (m_cur_first_msg + (m_max_num_msg - 1u - n)) % m_max_num_msg;  }
+
+   //!Returns true if insert_at(where) takes the free message placed just
+   //!before the first inserted one instead of the first free message
+   bool inserts_at_front(iterator where) const
+   {
+      if(where == this->inserted_ptr_end()){
+         return false;
+      }
+      else if(where == this->inserted_ptr_begin()){
+         return true;
+      }
+      const size_type pos  = where - &mp_index[0];
+      const size_type circ_pos = pos >= m_cur_first_msg ? pos - m_cur_first_msg : pos + (m_max_num_msg - m_cur_first_msg);
+      return circ_pos < m_cur_num_msg/2;
+   }
+
+   //!Returns the index position of the free message that insert_at(where)
+   //!takes, before it moves reserved messages
+   size_type taken_free_pos(iterator where) const
+   {
+      return this->inserts_at_front(where)
+         ? this->free_tail_pos(m_cur_num_reserved)
+         : size_type(this->inserted_ptr_end() - &mp_index[0]);
+   }
+
+   //!Front insertions take the free message placed just before the first inserted
+   //!one. If it's reserved, exchange it with the first unreserved message of the
+   //!tail so that reserved messages still precede the first inserted message.
+   void move_reserved_before_front()
+   {
+      if(m_cur_num_reserved){
+         this->swap_index(this->free_tail_pos(0), this->free_tail_pos(m_cur_num_reserved));
+      }
+   }
+
    iterator lower_bound(const msg_hdr_ptr_t & value, priority_functor<VoidPointer> func)
    {
       iterator begin(this->inserted_ptr_begin()), end(this->inserted_ptr_end());
@@ -381,6 +859,7 @@ class mq_hdr_t
          return **it_inserted_ptr_end;
       }
       else if(where == it_inserted_ptr_beg){
+         this->move_reserved_before_front();
          //unsigned integer guarantees underflow
          m_cur_first_msg = m_cur_first_msg ? m_cur_first_msg : m_max_num_msg;
          --m_cur_first_msg;
@@ -392,6 +871,7 @@ class mq_hdr_t
          size_type circ_pos = pos >= m_cur_first_msg ? pos - m_cur_first_msg : pos + (m_max_num_msg - m_cur_first_msg);
          //Check if it's more efficient to move back or move front
          if(circ_pos < m_cur_num_msg/2){
+            this->move_reserved_before_front();
             //The queue can't be full so m_cur_num_msg == 0 or m_cur_num_msg <= pos
             //indicates two step insertion
             if(!pos){
@@ -470,6 +950,20 @@ class mq_hdr_t
    iterator inserted_ptr_end() const
    {  return &mp_index[m_cur_num_msg]; }
 
+   //!Returns the index position of the n-th free message counting backwards
+   //!from the end of the index. The first "m_cur_num_reserved" of those
+   //!positions hold reserved messages.
+   size_type free_tail_pos(size_type n) const
+   {  return m_max_num_msg - 1u - n;  }
+
+   //!insert_at always takes the first free message
+   bool inserts_at_front(iterator) const
+   {  return false;  }
+
+   //!Returns the index position of the free message that insert_at(where) takes
+   size_type taken_free_pos(iterator) const
+   {  return m_cur_num_msg;  }
+
    iterator lower_bound(const msg_hdr_ptr_t & value, priority_functor<VoidPointer> func)
    {  return std::lower_bound(this->inserted_ptr_begin(), this->inserted_ptr_end(), value, func);  }
 
@@ -484,8 +978,285 @@ class mq_hdr_t
 
    #endif
 
-   //!Inserts the first free message in the priority queue
-   msg_header & queue_free_msg(unsigned int priority)
+   //!Returns true if the queue uses bucket_priority_index
+   bool uses_buckets() const
+   {  return m_index == bucket_priority_index;  }
+
+   //!Returns true if messages are allocated from variable size storage
+   bool uses_storage() const
+   {  return m_storage_size != 0;  }
+
+   //!Returns true if a message of "size" bytes can be queued. With variable
+   //!size storage, the message is allocated and returned in "storage".
+   bool try_allocate_msg(size_type size, msg_header *&storage)
+   {
+      if(this->is_full()){
+         return false;
+      }
+      else if(this->uses_storage()){
+         void *addr = mp_storage->allocate(sizeof(msg_header) + size);
+         if(!addr){
+            return false;
+         }
+         storage = ::new(addr) msg_header;
+         storage->len      = 0;
+         storage->priority = 0;
+      }
+      return true;
+   }
+
+   //!Returns a message to the variable size storage
+   void deallocate_msg(msg_header &msg)
+   {  mp_storage->deallocate(&msg);  }
+
+   //!Returns the position of "msg" in the array of messages
+   size_type msg_number(const msg_header &msg) const
+   {
+      const size_type r_max_msg_size = ipcdetail::get_rounded_size
+         (m_max_msg_size, size_type(::boost::alignment_of<msg_header>::value)) + sizeof(msg_header);
+      return size_type(reinterpret_cast<const char*>(&msg) -
+                       reinterpret_cast<const char*>(&*mp_index[0])) / r_max_msg_size;
+   }
+
+   //!Appends message "n" to the list of "priority"
+   void bucket_push(unsigned int priority, size_type n)
+   {
+      mq_buckets &b = *mp_buckets;
+      const boost::uint32_t bit = boost::uint32_t(1u) << priority;
+      b.links()[n] = mq_buckets::nil();
+      if(b.m_bitmap & bit){
+         b.links()[b.m_tail[priority]] = n;
+      }
+      else{
+         b.m_head[priority] = n;
+         b.m_bitmap |= bit;
+      }
+      b.m_tail[priority] = n;
+   }
+
+   //!Returns the oldest message of the highest non-empty priority
+   size_type bucket_top() const
+   {
+      BOOST_ASSERT(mp_buckets->m_bitmap);
+      return mp_buckets->m_head[ipcdetail::floor_log2_32(mp_buckets->m_bitmap)];
+   }
+
+   //!Unlinks and returns the oldest message of the highest non-empty priority
+   size_type bucket_pop_top()
+   {
+      mq_buckets &b = *mp_buckets;
+      BOOST_ASSERT(b.m_bitmap);
+      const unsigned int priority = ipcdetail::floor_log2_32(b.m_bitmap);
+      const size_type n = b.m_head[priority];
+      b.m_head[priority] = b.links()[n];
+      if(b.m_head[priority] == mq_buckets::nil()){
+         b.m_bitmap &= ~(boost::uint32_t(1u) << priority);
+      }
+      return n;
+   }
+
+   //!Unlinks and returns a message of the free message list
+   size_type bucket_pop_free()
+   {
+      mq_buckets &b = *mp_buckets;
+      const size_type n = b.m_free;
+      BOOST_ASSERT(n != mq_buckets::nil());
+      b.m_free = b.links()[n];
+      return n;
+   }
+
+   //!Puts message "n" in the free message list
+   void bucket_push_free(size_type n)
+   {
+      mq_buckets &b = *mp_buckets;
+      b.links()[n] = b.m_free;
+      b.m_free = n;
+   }
+
+   //!Inserts the first free message in the priority queue. With variable
+   //!size storage, "storage" is the message allocated by try_allocate_msg.
+   msg_header & queue_free_msg(unsigned int priority, msg_header *storage)
+   {
+      if(this->uses_buckets()){
+         const size_type n = this->bucket_pop_free();
+         if(storage){
+            mp_index[n] = storage;
+         }
+         this->bucket_push(priority, n);
+         ++m_cur_num_msg;
+         return *mp_index[n];
+      }
+      iterator where = this->insertion_point(priority);
+      if(storage){
+         mp_index[this->taken_free_pos(where)] = storage;
+      }
+      return this->insert_at(where);
+   }
+
+   //!Copies a message to the first free message and inserts it in the
+   //!priority queue. The queue must not be full. With variable size
+   //!storage, "storage" is the message allocated by try_allocate_msg.
+   void queue_msg(const void *buffer, size_type size, unsigned int priority, msg_header *storage)
+   {
+      //Insert the first free message in the priority queue
+      msg_header &free_msg_hdr = this->queue_free_msg(priority, storage);
+
+      //Sanity check, free msgs are always cleaned when received
+      BOOST_ASSERT(free_msg_hdr.priority == 0);
+      BOOST_ASSERT(free_msg_hdr.len == 0);
+
+      //Copy control data to the free message
+      free_msg_hdr.priority = priority;
+      free_msg_hdr.len      = size;
+
+      //Copy user buffer to the message
+      std::memcpy(free_msg_hdr.data(), buffer, size);
+   }
+
+   //!Copies the top priority message to "buffer" and puts it in the
+   //!free message list. The queue must not be empty.
+   void pop_top_msg(void *buffer, size_type &recvd_size, unsigned int &priority)
+   {
+      const bool buckets = this->uses_buckets();
+      msg_header &top = buckets ? *mp_index[this->bucket_top()] : this->top_msg();
+
+      //Get data from the message
+      recvd_size     = top.len;
+      priority       = top.priority;
+
+      //Some cleanup to ease debugging
+      top.len       = 0;
+      top.priority  = 0;
+
+      //Copy data to receiver's bufers
+      std::memcpy(buffer, top.data(), recvd_size);
+
+      //Free top message and put it in the free message list
+      if(this->uses_storage()){
+         this->deallocate_msg(top);
+      }
+      if(buckets){
+         this->bucket_push_free(this->bucket_pop_top());
+         --m_cur_num_msg;
+      }
+      else{
+         this->free_top_msg();
+      }
+   }
+
+   //!Takes a free message out of the free message list, so that it can be
+   //!filled without holding the mutex. The message must be queued with
+   //!queue_reserved_msg or returned with release_reserved_msg. With variable
+   //!size storage, "storage" is the message allocated by try_allocate_msg.
+   msg_header & reserve_free_msg(msg_header *storage)
+   {
+      if(this->uses_buckets()){
+         ++m_cur_num_reserved;
+         //With variable size storage, reserved messages don't hold a
+         //free list position: there is always one left when queued
+         return storage ? *storage : *mp_index[this->bucket_pop_free()];
+      }
+      if(storage){
+         mp_index[this->free_tail_pos(m_cur_num_reserved)] = storage;
+      }
+      msg_header &msg = *mp_index[this->free_tail_pos(m_cur_num_reserved)];
+      ++m_cur_num_reserved;
+      return msg;
+   }
+
+   //!Takes the top priority message out of the queue, so that it can be read
+   //!without holding the mutex. The message must be returned with
+   //!release_reserved_msg.
+   msg_header & reserve_top_msg()
+   {
+      if(this->uses_buckets()){
+         --m_cur_num_msg;
+         ++m_cur_num_reserved;
+         const size_type n = this->bucket_pop_top();
+         msg_header &msg = *mp_index[n];
+         if(this->uses_storage()){
+            this->bucket_push_free(n);
+         }
+         return msg;
+      }
+      this->free_top_msg();
+      //The top message is now the first free one, move it to the reserved ones
+      const size_type pos = this->free_tail_pos(m_cur_num_reserved);
+      this->swap_index(this->inserted_ptr_end() - &mp_index[0], pos);
+      ++m_cur_num_reserved;
+      return *mp_index[pos];
+   }
+
+   //!Returns a reserved message to the free message list
+   void release_reserved_msg(msg_header &msg)
+   {
+      if(this->uses_storage()){
+         if(this->uses_buckets()){
+            --m_cur_num_reserved;
+         }
+         else{
+            this->unreserve_msg(msg);
+         }
+         this->deallocate_msg(msg);
+      }
+      else if(this->uses_buckets()){
+         this->bucket_push_free(this->msg_number(msg));
+         --m_cur_num_reserved;
+      }
+      else{
+         this->unreserve_msg(msg);
+      }
+   }
+
+   //!Moves a reserved message to the first free position after the reserved ones
+   void unreserve_msg(msg_header &msg)
+   {
+      //The message is left as the first unreserved message of the tail
+      size_type i = 0;
+      while(&*mp_index[this->free_tail_pos(i)] != &msg){
+         ++i;
+         BOOST_ASSERT(i < m_cur_num_reserved);
+      }
+      --m_cur_num_reserved;
+      this->swap_index(this->free_tail_pos(i), this->free_tail_pos(m_cur_num_reserved));
+   }
+
+   //!Inserts a message obtained with reserve_free_msg in the priority queue
+   void queue_reserved_msg(msg_header &msg)
+   {
+      if(this->uses_buckets()){
+         size_type n;
+         if(this->uses_storage()){
+            n = this->bucket_pop_free();
+            mp_index[n] = &msg;
+         }
+         else{
+            n = this->msg_number(msg);
+         }
+         this->bucket_push(msg.priority, n);
+         --m_cur_num_reserved;
+         ++m_cur_num_msg;
+         return;
+      }
+      this->unreserve_msg(msg);
+      iterator where = this->insertion_point(msg.priority);
+      //Place the message where insert_at will take the free message from
+      this->swap_index(this->taken_free_pos(where), this->free_tail_pos(m_cur_num_reserved));
+      msg_header &inserted = this->insert_at(where);
+      (void)inserted;
+      BOOST_ASSERT(&inserted == &msg);
+   }
+
+   //!Exchanges two pointers of the index
+   void swap_index(size_type pos1, size_type pos2)
+   {
+      const msg_hdr_ptr_t tmp = mp_index[pos1];
+      mp_index[pos1] = mp_index[pos2];
+      mp_index[pos2] = tmp;
+   }
+
+   //!Returns the position where a message with the given priority must be inserted
+   iterator insertion_point(unsigned int priority)
    {
       //Get priority queue's range
       iterator it  (inserted_ptr_begin()), it_end(inserted_ptr_end());
@@ -509,23 +1280,58 @@ class mq_hdr_t
          }
          
       }
-      //Insert the free message in the correct position
-      return this->insert_at(it);
+      return it;
    }
 
-   //!Returns the number of bytes needed to construct a message queue with
-   //!"max_num_size" maximum number of messages and "max_msg_size" maximum
-   //!message size. Never throws.
-   static size_type get_mem_size
-      (size_type max_msg_size, size_type max_num_msg)
+   //!Returns the number of bytes of the mq_buckets_t block and
+   //!its links, placed after the index. Never throws.
+   static size_type get_buckets_size(message_queue_index index, size_type max_num_msg)
+   {
+      const size_type msg_hdr_align = ::boost::alignment_of<msg_header>::value;
+      return index == bucket_priority_index
+         ? ipcdetail::get_rounded_size(sizeof(mq_buckets) + max_num_msg*sizeof(size_type), msg_hdr_align)
+         : 0u;
+   }
+
+   //!Returns "storage_size" enlarged, if needed, so that an empty variable
+   //!size storage can hold a message of "max_msg_size" bytes. Never throws.
+   static size_type get_storage_size(size_type max_msg_size, size_type storage_size)
+   {
+      const size_type min_size = storage_algo::get_min_size(0) +
+         ipcdetail::get_rounded_size(sizeof(msg_header) + max_msg_size, storage_algo::Alignment) +
+         2*sizeof(size_type) + storage_algo::Alignment;
+      return ipcdetail::get_rounded_size
+         (storage_size < min_size ? min_size : storage_size, storage_algo::Alignment);
+   }
+
+   //!Returns the offset of the variable size storage or the preallocated
+   //!messages from the beginning of the header. Never throws.
+   static size_type get_msgs_offset
+      (size_type max_num_msg, message_queue_index index, size_type storage_size)
    {
       const size_type
 		 msg_hdr_align  = ::boost::alignment_of<msg_header>::value,
 		 index_align    = ::boost::alignment_of<msg_hdr_ptr_t>::value,
          r_hdr_size     = ipcdetail::ct_rounded_size<sizeof(mq_hdr_t), index_align>::value,
          r_index_size   = ipcdetail::get_rounded_size(max_num_msg*sizeof(msg_hdr_ptr_t), msg_hdr_align),
-         r_max_msg_size = ipcdetail::get_rounded_size(max_msg_size, msg_hdr_align) + sizeof(msg_header);
-      return r_hdr_size + r_index_size + (max_num_msg*r_max_msg_size) +
+         offset         = r_hdr_size + r_index_size + get_buckets_size(index, max_num_msg);
+      return storage_size ? ipcdetail::get_rounded_size(offset, storage_algo::Alignment) : offset;
+   }
+
+   //!Returns the number of bytes needed to construct a message queue with
+   //!"max_num_size" maximum number of messages and "max_msg_size" maximum
+   //!message size. If "storage_size" is not zero messages are stored in
+   //!variable size storage. Never throws.
+   static size_type get_mem_size
+      (size_type max_msg_size, size_type max_num_msg,
+       message_queue_index index, size_type storage_size)
+   {
+      const size_type
+		 msg_hdr_align  = ::boost::alignment_of<msg_header>::value,
+         r_max_msg_size = ipcdetail::get_rounded_size(max_msg_size, msg_hdr_align) + sizeof(msg_header),
+         r_msgs_size    = storage_size ? get_storage_size(max_msg_size, storage_size)
+                                       : max_num_msg*r_max_msg_size;
+      return get_msgs_offset(max_num_msg, index, storage_size) + r_msgs_size +
          open_create_impl_t::ManagedOpenOrCreateUserOffset;
    }
 
@@ -538,6 +1344,7 @@ class mq_hdr_t
 		  index_align    = ::boost::alignment_of<msg_hdr_ptr_t>::value,
          r_hdr_size     = ipcdetail::ct_rounded_size<sizeof(mq_hdr_t), index_align>::value,
          r_index_size   = ipcdetail::get_rounded_size(m_max_num_msg*sizeof(msg_hdr_ptr_t), msg_hdr_align),
+         r_buckets_size = get_buckets_size(m_index, m_max_num_msg),
          r_max_msg_size = ipcdetail::get_rounded_size(m_max_msg_size, msg_hdr_align) + sizeof(msg_header);
 
       //Pointer to the index
@@ -546,16 +1353,38 @@ class mq_hdr_t
 
       //Pointer to the first message header
       msg_header *msg_hdr   =  reinterpret_cast<msg_header*>
-                                 (reinterpret_cast<char*>(this)+r_hdr_size+r_index_size);
+                                 (reinterpret_cast<char*>(this) +
+                                  get_msgs_offset(m_max_num_msg, m_index, m_storage_size));
 
       //Initialize the pointer to the index
       mp_index             = index;
 
-      //Initialize the index so each slot points to a preallocated message
-      for(size_type i = 0; i < m_max_num_msg; ++i){
-         index[i] = msg_hdr;
-         msg_hdr  = reinterpret_cast<msg_header*>
-                        (reinterpret_cast<char*>(msg_hdr)+r_max_msg_size);
+      if(this->uses_storage()){
+         //Messages are allocated when taken, the index points to none
+         mp_storage = ::new(msg_hdr) storage_algo(m_storage_size, 0);
+         for(size_type i = 0; i < m_max_num_msg; ++i){
+            index[i] = 0;
+         }
+      }
+      else{
+         //Initialize the index so each slot points to a preallocated message
+         for(size_type i = 0; i < m_max_num_msg; ++i){
+            index[i] = msg_hdr;
+            msg_hdr  = reinterpret_cast<msg_header*>
+                           (reinterpret_cast<char*>(msg_hdr)+r_max_msg_size);
+         }
+      }
+
+      //Initialize empty priority lists and chain all messages in the free list
+      if(r_buckets_size){
+         mq_buckets *buckets = reinterpret_cast<mq_buckets*>
+                                 (reinterpret_cast<char*>(this)+r_hdr_size+r_index_size);
+         buckets->m_bitmap = 0u;
+         buckets->m_free   = m_max_num_msg ? 0u : mq_buckets::nil();
+         for(size_type i = 0; i < m_max_num_msg; ++i){
+            buckets->links()[i] = (i + 1u) < m_max_num_msg ? i + 1u : mq_buckets::nil();
+         }
+         mp_buckets = buckets;
       }
    }
 
@@ -566,8 +1395,25 @@ class mq_hdr_t
    const size_type            m_max_num_msg;
    //Maximum size of messages of the queue
    const size_type            m_max_msg_size;
+   //Index used to order messages by priority
+   const message_queue_index  m_index;
+   //Bucket index control block, only used by bucket_priority_index
+   mq_buckets_ptr_t           mp_buckets;
+   //Size of the variable size storage, 0 if messages are preallocated
+   const size_type            m_storage_size;
+   //Variable size storage, only used if m_storage_size is not 0
+   storage_algo_ptr_t         mp_storage;
+   //Senders blocked because the variable size storage was exhausted
+   size_type                  m_num_storage_waiters;
+   //Senders blocked in m_cond_send, including storage waiters
+   size_type                  m_num_send_waiters;
+   //Receivers blocked in m_cond_recv
+   size_type                  m_num_recv_waiters;
    //Current number of messages
    size_type                  m_cur_num_msg;
+   //Messages being filled by senders or read by receivers,
+   //out of both the queue and the free message list
+   size_type                  m_cur_num_reserved;
    //Mutex to protect data structures
    interprocess_mutex         m_mutex;
    //Condition block receivers when there are no messages
@@ -594,8 +1440,10 @@ class msg_queue_initialization_func_t
    typedef typename boost::make_unsigned<difference_type>::type        size_type;
 
    msg_queue_initialization_func_t(size_type maxmsg = 0,
-                         size_type maxmsgsize = 0)
-      : m_maxmsg (maxmsg), m_maxmsgsize(maxmsgsize) {}
+                         size_type maxmsgsize = 0,
+                         message_queue_index index = sorted_priority_index,
+                         size_type storage_size = 0)
+      : m_maxmsg (maxmsg), m_maxmsgsize(maxmsgsize), m_index(index), m_storage_size(storage_size) {}
 
    bool operator()(void *address, size_type, bool created)
    {
@@ -605,7 +1453,7 @@ class msg_queue_initialization_func_t
          mptr     = reinterpret_cast<char*>(address);
          //Construct the message queue header at the beginning
          BOOST_TRY{
-            new (mptr) mq_hdr_t<VoidPointer>(m_maxmsg, m_maxmsgsize);
+            new (mptr) mq_hdr_t<VoidPointer>(m_maxmsg, m_maxmsgsize, m_index, m_storage_size);
          }
          BOOST_CATCH(...){
             return false;
@@ -617,12 +1465,14 @@ class msg_queue_initialization_func_t
 
    std::size_t get_min_size() const
    {
-      return mq_hdr_t<VoidPointer>::get_mem_size(m_maxmsgsize, m_maxmsg)
+      return mq_hdr_t<VoidPointer>::get_mem_size(m_maxmsgsize, m_maxmsg, m_index, m_storage_size)
       - message_queue_t<VoidPointer>::open_create_impl_t::ManagedOpenOrCreateUserOffset;
    }
 
    const size_type m_maxmsg;
    const size_type m_maxmsgsize;
+   const message_queue_index m_index;
+   const size_type m_storage_size;
 };
 
 }  //namespace ipcdetail {
@@ -633,8 +1483,17 @@ inline message_queue_t<VoidPointer>::~message_queue_t()
 
 template<class VoidPointer>
 inline typename message_queue_t<VoidPointer>::size_type message_queue_t<VoidPointer>::get_mem_size
-   (size_type max_msg_size, size_type max_num_msg)
-{  return ipcdetail::mq_hdr_t<VoidPointer>::get_mem_size(max_msg_size, max_num_msg);   }
+   (size_type max_msg_size, size_type max_num_msg, message_queue_index index, size_type storage_size)
+{  return ipcdetail::mq_hdr_t<VoidPointer>::get_mem_size(max_msg_size, max_num_msg, index, storage_size);   }
+
+template<class VoidPointer>
+inline void message_queue_t<VoidPointer>::check_priority
+   (const mq_header *p_hdr, unsigned int priority)
+{
+   if(p_hdr->uses_buckets() && priority >= message_queue_bucket_priorities){
+      throw interprocess_exception(invalid_argument);
+   }
+}
 
 template<class VoidPointer>
 inline message_queue_t<VoidPointer>::message_queue_t(create_only_t,
@@ -645,7 +1504,7 @@ inline message_queue_t<VoidPointer>::message_queue_t(create_only_t,
       //Create shared memory and execute functor atomically
    :  m_shmem(create_only,
               name,
-              get_mem_size(max_msg_size, max_num_msg),
+              get_mem_size(max_msg_size, max_num_msg, sorted_priority_index, 0),
               read_write,
               static_cast<void*>(0),
               //Prepare initialization functor
@@ -653,6 +1512,43 @@ inline message_queue_t<VoidPointer>::message_queue_t(create_only_t,
               perm)
 {}
 
+template<class VoidPointer>
+inline message_queue_t<VoidPointer>::message_queue_t(create_only_t,
+                                    const char *name,
+                                    size_type max_num_msg,
+                                    size_type max_msg_size,
+                                    message_queue_index index,
+                                    const permissions &perm)
+      //Create shared memory and execute functor atomically
+   :  m_shmem(create_only,
+              name,
+              get_mem_size(max_msg_size, max_num_msg, index, 0),
+              read_write,
+              static_cast<void*>(0),
+              //Prepare initialization functor
+              ipcdetail::msg_queue_initialization_func_t<VoidPointer> (max_num_msg, max_msg_size, index),
+              perm)
+{}
+
+template<class VoidPointer>
+inline message_queue_t<VoidPointer>::message_queue_t(create_only_t,
+                                    const char *name,
+                                    size_type max_num_msg,
+                                    size_type max_msg_size,
+                                    message_queue_index index,
+                                    size_type storage_size,
+                                    const permissions &perm)
+      //Create shared memory and execute functor atomically
+   :  m_shmem(create_only,
+              name,
+              get_mem_size(max_msg_size, max_num_msg, index, storage_size),
+              read_write,
+              static_cast<void*>(0),
+              //Prepare initialization functor
+              ipcdetail::msg_queue_initialization_func_t<VoidPointer> (max_num_msg, max_msg_size, index, storage_size),
+              perm)
+{}
+
 template<class VoidPointer>
 inline message_queue_t<VoidPointer>::message_queue_t(open_or_create_t,
                                     const char *name,
@@ -662,7 +1558,7 @@ inline message_queue_t<VoidPointer>::message_queue_t(open_or_create_t,
       //Create shared memory and execute functor atomically
    :  m_shmem(open_or_create,
               name,
-              get_mem_size(max_msg_size, max_num_msg),
+              get_mem_size(max_msg_size, max_num_msg, sorted_priority_index, 0),
               read_write,
               static_cast<void*>(0),
               //Prepare initialization functor
@@ -670,6 +1566,43 @@ inline message_queue_t<VoidPointer>::message_queue_t(open_or_create_t,
               perm)
 {}
 
+template<class VoidPointer>
+inline message_queue_t<VoidPointer>::message_queue_t(open_or_create_t,
+                                    const char *name,
+                                    size_type max_num_msg,
+                                    size_type max_msg_size,
+                                    message_queue_index index,
+                                    const permissions &perm)
+      //Create shared memory and execute functor atomically
+   :  m_shmem(open_or_create,
+              name,
+              get_mem_size(max_msg_size, max_num_msg, index, 0),
+              read_write,
+              static_cast<void*>(0),
+              //Prepare initialization functor
+              ipcdetail::msg_queue_initialization_func_t<VoidPointer> (max_num_msg, max_msg_size, index),
+              perm)
+{}
+
+template<class VoidPointer>
+inline message_queue_t<VoidPointer>::message_queue_t(open_or_create_t,
+                                    const char *name,
+                                    size_type max_num_msg,
+                                    size_type max_msg_size,
+                                    message_queue_index index,
+                                    size_type storage_size,
+                                    const permissions &perm)
+      //Create shared memory and execute functor atomically
+   :  m_shmem(open_or_create,
+              name,
+              get_mem_size(max_msg_size, max_num_msg, index, storage_size),
+              read_write,
+              static_cast<void*>(0),
+              //Prepare initialization functor
+              ipcdetail::msg_queue_initialization_func_t<VoidPointer> (max_num_msg, max_msg_size, index, storage_size),
+              perm)
+{}
+
 template<class VoidPointer>
 inline message_queue_t<VoidPointer>::message_queue_t(open_only_t, const char *name)
    //Create shared memory and execute functor atomically
@@ -713,63 +1646,28 @@ inline bool message_queue_t<VoidPointer>::do_send(block_t block,
    if (buffer_size > p_hdr->m_max_msg_size) {
       throw interprocess_exception(size_error);
    }
+   check_priority(p_hdr, priority);
 
-   bool was_empty = false;
+   size_type num_waiters = 0;
    //---------------------------------------------
    scoped_lock<interprocess_mutex> lock(p_hdr->m_mutex);
    //---------------------------------------------
    {
       //If the queue is full execute blocking logic
-      if (p_hdr->is_full()) {
-         switch(block){
-            case non_blocking :
-               return false;
-            break;
-
-            case blocking :
-               do{
-                  p_hdr->m_cond_send.wait(lock);
-               }
-               while (p_hdr->is_full());
-            break;
-
-            case timed :
-               do{
-                  if(!p_hdr->m_cond_send.timed_wait(lock, abs_time)){
-                     if(p_hdr->is_full())
-                        return false;
-                     break;
-                  }
-               }
-               while (p_hdr->is_full());
-            break;
-            default:
-            break;
-         }
+      msg_header *storage = 0;
+      if (!this->wait_not_full(p_hdr, block, lock, abs_time, buffer_size, storage)) {
+         return false;
       }
 
-      was_empty = p_hdr->is_empty();
-      //Insert the first free message in the priority queue
-      ipcdetail::msg_hdr_t<VoidPointer> &free_msg_hdr = p_hdr->queue_free_msg(priority);
-
-      //Sanity check, free msgs are always cleaned when received
-      BOOST_ASSERT(free_msg_hdr.priority == 0);
-      BOOST_ASSERT(free_msg_hdr.len == 0);
-
-      //Copy control data to the free message
-      free_msg_hdr.priority = priority;
-      free_msg_hdr.len      = buffer_size;
-
-      //Copy user buffer to the message
-      std::memcpy(free_msg_hdr.data(), buffer, buffer_size);
+      num_waiters = p_hdr->m_num_recv_waiters;
+      p_hdr->queue_msg(buffer, buffer_size, priority, storage);
    }  // Lock end
 
    //Notify outside lock to avoid contention. This might produce some
    //spurious wakeups, but it's usually far better than notifying inside.
-   //If this message changes the queue empty state, notify it to receivers
-   if (was_empty){
-      p_hdr->m_cond_recv.notify_one();
-   }
+   //Each message wakes a blocked receiver, even if the queue was not empty
+   //because previously woken receivers have not taken their messages yet
+   notify_receivers(p_hdr, 1u, num_waiters);
 
    return true;
 }
@@ -811,70 +1709,414 @@ inline bool
       throw interprocess_exception(size_error);
    }
 
-   bool was_full = false;
+   size_type num_waiters = 0;
+   bool storage_waiters = false;
    //---------------------------------------------
    scoped_lock<interprocess_mutex> lock(p_hdr->m_mutex);
    //---------------------------------------------
    {
       //If there are no messages execute blocking logic
-      if (p_hdr->is_empty()) {
-         switch(block){
-            case non_blocking :
-               return false;
-            break;
+      if (!this->wait_not_empty(p_hdr, block, lock, abs_time)) {
+         return false;
+      }
 
-            case blocking :
-               do{
-                  p_hdr->m_cond_recv.wait(lock);
-               }
-               while (p_hdr->is_empty());
-            break;
+      num_waiters = p_hdr->m_num_send_waiters;
+      storage_waiters = p_hdr->m_num_storage_waiters != 0;
+      //There is at least one message ready to pick, get the top one
+      p_hdr->pop_top_msg(buffer, recvd_size, priority);
+   }  //Lock end
 
-            case timed :
-               do{
-                  if(!p_hdr->m_cond_recv.timed_wait(lock, abs_time)){
-                     if(p_hdr->is_empty())
-                        return false;
-                     break;
-                  }
-               }
-               while (p_hdr->is_empty());
-            break;
+   //Notify outside lock to avoid contention. This might produce some
+   //spurious wakeups, but it's usually far better than notifying inside.
+   //The freed message wakes a blocked sender
+   notify_senders(p_hdr, 1u, num_waiters, storage_waiters);
 
-            //Paranoia check
-            default:
-            break;
+   return true;
+}
+
+template<class VoidPointer>
+inline bool message_queue_t<VoidPointer>::wait_not_full
+   (mq_header *p_hdr, block_t block, scoped_lock<interprocess_mutex> &lock,
+    const ptime &abs_time, size_type msg_size, msg_header *&storage)
+{
+   while (!p_hdr->try_allocate_msg(msg_size, storage)) {
+      if(block == non_blocking){
+         return false;
+      }
+      //Senders waiting for storage are counted so that
+      //any freed message wakes them
+      const bool storage_waiter = !p_hdr->is_full();
+      p_hdr->m_num_storage_waiters += storage_waiter;
+      ++p_hdr->m_num_send_waiters;
+      bool timed_out = false;
+      BOOST_TRY{
+         if(block == blocking){
+            p_hdr->m_cond_send.wait(lock);
+         }
+         else{
+            timed_out = !p_hdr->m_cond_send.timed_wait(lock, abs_time);
          }
       }
+      BOOST_CATCH(...){
+         p_hdr->m_num_storage_waiters -= storage_waiter;
+         --p_hdr->m_num_send_waiters;
+         BOOST_RETHROW
+      }
+      BOOST_CATCH_END
+      p_hdr->m_num_storage_waiters -= storage_waiter;
+      --p_hdr->m_num_send_waiters;
+      if(timed_out){
+         return p_hdr->try_allocate_msg(msg_size, storage);
+      }
+   }
+   return true;
+}
 
-      //There is at least one message ready to pick, get the top one
-      ipcdetail::msg_hdr_t<VoidPointer> &top_msg = p_hdr->top_msg();
+template<class VoidPointer>
+inline void message_queue_t<VoidPointer>::notify_senders
+   (mq_header *p_hdr, size_type num_freed, size_type num_waiters, bool storage_waiters)
+{
+   if(!num_freed || !num_waiters){
+      return;
+   }
+   //Senders waiting for storage might need several freed messages
+   if(storage_waiters || num_freed >= num_waiters){
+      p_hdr->m_cond_send.notify_all();
+   }
+   else{
+      for(size_type i = 0; i != num_freed; ++i){
+         p_hdr->m_cond_send.notify_one();
+      }
+   }
+}
 
-      //Get data from the message
-      recvd_size     = top_msg.len;
-      priority       = top_msg.priority;
+template<class VoidPointer>
+inline void message_queue_t<VoidPointer>::notify_receivers
+   (mq_header *p_hdr, size_type num_queued, size_type num_waiters)
+{
+   if(!num_queued || !num_waiters){
+      return;
+   }
+   if(num_queued >= num_waiters){
+      p_hdr->m_cond_recv.notify_all();
+   }
+   else{
+      for(size_type i = 0; i != num_queued; ++i){
+         p_hdr->m_cond_recv.notify_one();
+      }
+   }
+}
 
-      //Some cleanup to ease debugging
-      top_msg.len       = 0;
-      top_msg.priority  = 0;
+template<class VoidPointer>
+inline bool message_queue_t<VoidPointer>::wait_not_empty
+   (mq_header *p_hdr, block_t block, scoped_lock<interprocess_mutex> &lock, const ptime &abs_time)
+{
+   if (p_hdr->is_empty()) {
+      if(block == non_blocking){
+         return false;
+      }
+      //Blocked receivers are counted so that senders
+      //wake one of them for each queued message
+      ++p_hdr->m_num_recv_waiters;
+      bool timed_out = false;
+      BOOST_TRY{
+         do{
+            if(block == blocking){
+               p_hdr->m_cond_recv.wait(lock);
+            }
+            else if(!p_hdr->m_cond_recv.timed_wait(lock, abs_time)){
+               timed_out = true;
+               break;
+            }
+         }
+         while (p_hdr->is_empty());
+      }
+      BOOST_CATCH(...){
+         --p_hdr->m_num_recv_waiters;
+         BOOST_RETHROW
+      }
+      BOOST_CATCH_END
+      --p_hdr->m_num_recv_waiters;
+      if(timed_out && p_hdr->is_empty()){
+         return false;
+      }
+   }
+   return true;
+}
 
-      //Copy data to receiver's bufers
-      std::memcpy(buffer, top_msg.data(), recvd_size);
+template<class VoidPointer>
+inline void message_queue_t<VoidPointer>::send_n(const send_buffer *msgs, size_type num_msg)
+{  this->do_send_n(blocking, msgs, num_msg, ptime());  }
 
-      was_full = p_hdr->is_full();
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::size_type
+   message_queue_t<VoidPointer>::try_send_n(const send_buffer *msgs, size_type num_msg)
+{  return this->do_send_n(non_blocking, msgs, num_msg, ptime());  }
 
-      //Free top message and put it in the free message list
-      p_hdr->free_top_msg();
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::size_type
+   message_queue_t<VoidPointer>::timed_send_n
+      (const send_buffer *msgs, size_type num_msg, const boost::posix_time::ptime &abs_time)
+{
+   if(abs_time == boost::posix_time::pos_infin){
+      this->send_n(msgs, num_msg);
+      return num_msg;
+   }
+   return this->do_send_n(timed, msgs, num_msg, abs_time);
+}
+
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::size_type
+   message_queue_t<VoidPointer>::do_send_n
+      (block_t block, const send_buffer *msgs, size_type num_msg, const ptime &abs_time)
+{
+   mq_header *p_hdr = static_cast<mq_header*>(m_shmem.get_user_address());
+   //Check all messages before sending any of them
+   for(size_type i = 0; i != num_msg; ++i){
+      if (msgs[i].size > p_hdr->m_max_msg_size) {
+         throw interprocess_exception(size_error);
+      }
+      check_priority(p_hdr, msgs[i].priority);
+   }
+
+   size_type num_sent = 0;
+   while(num_sent != num_msg){
+      size_type num_waiters = 0;
+      size_type num_queued = 0;
+      {
+         //---------------------------------------------
+         scoped_lock<interprocess_mutex> lock(p_hdr->m_mutex);
+         //---------------------------------------------
+         msg_header *storage = 0;
+         if (!this->wait_not_full(p_hdr, block, lock, abs_time, msgs[num_sent].size, storage)) {
+            break;
+         }
+         num_waiters = p_hdr->m_num_recv_waiters;
+         //Queue all the messages that fit
+         do{
+            const send_buffer &msg = msgs[num_sent];
+            p_hdr->queue_msg(msg.buffer, msg.size, msg.priority, storage);
+            ++num_sent;
+            ++num_queued;
+            storage = 0;
+         }
+         while(num_sent != num_msg && p_hdr->try_allocate_msg(msgs[num_sent].size, storage));
+      }  // Lock end
+
+      //Notify outside lock, see do_send. Receivers must be woken before
+      //blocking in a full queue, as they might be waiting since it was empty
+      notify_receivers(p_hdr, num_queued, num_waiters);
+   }
+   return num_sent;
+}
+
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::size_type
+   message_queue_t<VoidPointer>::receive_n(receive_buffer *msgs, size_type num_msg)
+{  return this->do_receive_n(blocking, msgs, num_msg, ptime());  }
+
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::size_type
+   message_queue_t<VoidPointer>::try_receive_n(receive_buffer *msgs, size_type num_msg)
+{  return this->do_receive_n(non_blocking, msgs, num_msg, ptime());  }
+
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::size_type
+   message_queue_t<VoidPointer>::timed_receive_n
+      (receive_buffer *msgs, size_type num_msg, const boost::posix_time::ptime &abs_time)
+{
+   if(abs_time == boost::posix_time::pos_infin){
+      return this->receive_n(msgs, num_msg);
+   }
+   return this->do_receive_n(timed, msgs, num_msg, abs_time);
+}
+
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::size_type
+   message_queue_t<VoidPointer>::do_receive_n
+      (block_t block, receive_buffer *msgs, size_type num_msg, const ptime &abs_time)
+{
+   mq_header *p_hdr = static_cast<mq_header*>(m_shmem.get_user_address());
+   //Check if buffers are big enough for any message
+   for(size_type i = 0; i != num_msg; ++i){
+      if (msgs[i].buffer_size < p_hdr->m_max_msg_size) {
+         throw interprocess_exception(size_error);
+      }
+   }
+   if(!num_msg){
+      return 0;
+   }
+
+   size_type num_waiters = 0;
+   bool storage_waiters = false;
+   size_type num_recvd = 0;
+   {
+      //---------------------------------------------
+      scoped_lock<interprocess_mutex> lock(p_hdr->m_mutex);
+      //---------------------------------------------
+      if (!this->wait_not_empty(p_hdr, block, lock, abs_time)) {
+         return 0;
+      }
+      num_waiters = p_hdr->m_num_send_waiters;
+      storage_waiters = p_hdr->m_num_storage_waiters != 0;
+      //Drain the queue up to "num_msg" messages
+      for(; num_recvd != num_msg && !p_hdr->is_empty(); ++num_recvd){
+         receive_buffer &msg = msgs[num_recvd];
+         p_hdr->pop_top_msg(msg.buffer, msg.recvd_size, msg.priority);
+      }
    }  //Lock end
 
-   //Notify outside lock to avoid contention. This might produce some
-   //spurious wakeups, but it's usually far better than notifying inside.
-   //If this reception changes the queue full state, notify senders
-   if (was_full){
-      p_hdr->m_cond_send.notify_one();
+   //Notify outside lock, see do_receive
+   notify_senders(p_hdr, num_recvd, num_waiters, storage_waiters);
+   return num_recvd;
+}
+
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::send_slot
+   message_queue_t<VoidPointer>::reserve_send(size_type msg_size, unsigned int priority)
+{  return send_slot(this, this->do_reserve_send(blocking, msg_size, priority, ptime()));  }
+
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::send_slot
+   message_queue_t<VoidPointer>::try_reserve_send(size_type msg_size, unsigned int priority)
+{  return send_slot(this, this->do_reserve_send(non_blocking, msg_size, priority, ptime()));  }
+
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::send_slot
+   message_queue_t<VoidPointer>::timed_reserve_send
+      (size_type msg_size, unsigned int priority, const boost::posix_time::ptime &abs_time)
+{
+   if(abs_time == boost::posix_time::pos_infin){
+      return this->reserve_send(msg_size, priority);
    }
+   return send_slot(this, this->do_reserve_send(timed, msg_size, priority, abs_time));
+}
 
-   return true;
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::msg_header *
+   message_queue_t<VoidPointer>::do_reserve_send(block_t block, size_type msg_size,
+                                                 unsigned int priority, const ptime &abs_time)
+{
+   mq_header *p_hdr = static_cast<mq_header*>(m_shmem.get_user_address());
+   //Check if the message is smaller than maximum allowed
+   if (msg_size > p_hdr->m_max_msg_size) {
+      throw interprocess_exception(size_error);
+   }
+   check_priority(p_hdr, priority);
+
+   //---------------------------------------------
+   scoped_lock<interprocess_mutex> lock(p_hdr->m_mutex);
+   //---------------------------------------------
+   msg_header *storage = 0;
+   if (!this->wait_not_full(p_hdr, block, lock, abs_time, msg_size, storage)) {
+      return 0;
+   }
+   //Take the message out of the free message list. Its
+   //header stores the reservation until it's committed
+   msg_header &msg = p_hdr->reserve_free_msg(storage);
+   BOOST_ASSERT(msg.priority == 0);
+   BOOST_ASSERT(msg.len == 0);
+   msg.priority = priority;
+   msg.len      = msg_size;
+   return &msg;
+}
+
+template<class VoidPointer>
+inline void message_queue_t<VoidPointer>::commit_send(msg_header &msg, size_type msg_size)
+{
+   mq_header *p_hdr = static_cast<mq_header*>(m_shmem.get_user_address());
+   size_type num_waiters = 0;
+   {
+      //---------------------------------------------
+      scoped_lock<interprocess_mutex> lock(p_hdr->m_mutex);
+      //---------------------------------------------
+      num_waiters = p_hdr->m_num_recv_waiters;
+      msg.len   = msg_size;
+      p_hdr->queue_reserved_msg(msg);
+   }  // Lock end
+
+   //Notify outside lock, see do_send
+   notify_receivers(p_hdr, 1u, num_waiters);
+}
+
+template<class VoidPointer>
+inline void message_queue_t<VoidPointer>::cancel_send(msg_header &msg)
+{
+   mq_header *p_hdr = static_cast<mq_header*>(m_shmem.get_user_address());
+   size_type num_waiters = 0;
+   bool storage_waiters = false;
+   {
+      //---------------------------------------------
+      scoped_lock<interprocess_mutex> lock(p_hdr->m_mutex);
+      //---------------------------------------------
+      num_waiters = p_hdr->m_num_send_waiters;
+      storage_waiters = p_hdr->m_num_storage_waiters != 0;
+      //Free messages are always clean
+      msg.len       = 0;
+      msg.priority  = 0;
+      p_hdr->release_reserved_msg(msg);
+   }  // Lock end
+
+   //The reserved message is free again
+   notify_senders(p_hdr, 1u, num_waiters, storage_waiters);
+}
+
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::receive_view
+   message_queue_t<VoidPointer>::peek_receive()
+{  return receive_view(this, this->do_peek_receive(blocking, ptime()));  }
+
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::receive_view
+   message_queue_t<VoidPointer>::try_peek_receive()
+{  return receive_view(this, this->do_peek_receive(non_blocking, ptime()));  }
+
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::receive_view
+   message_queue_t<VoidPointer>::timed_peek_receive(const boost::posix_time::ptime &abs_time)
+{
+   if(abs_time == boost::posix_time::pos_infin){
+      return this->peek_receive();
+   }
+   return receive_view(this, this->do_peek_receive(timed, abs_time));
+}
+
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::msg_header *
+   message_queue_t<VoidPointer>::do_peek_receive(block_t block, const ptime &abs_time)
+{
+   mq_header *p_hdr = static_cast<mq_header*>(m_shmem.get_user_address());
+   //---------------------------------------------
+   scoped_lock<interprocess_mutex> lock(p_hdr->m_mutex);
+   //---------------------------------------------
+   if (!this->wait_not_empty(p_hdr, block, lock, abs_time)) {
+      return 0;
+   }
+   //The message leaves the queue but its buffer can't be
+   //reused by senders until the receiver releases it
+   return &p_hdr->reserve_top_msg();
+}
+
+template<class VoidPointer>
+inline void message_queue_t<VoidPointer>::release_receive(msg_header &msg)
+{
+   mq_header *p_hdr = static_cast<mq_header*>(m_shmem.get_user_address());
+   size_type num_waiters = 0;
+   bool storage_waiters = false;
+   {
+      //---------------------------------------------
+      scoped_lock<interprocess_mutex> lock(p_hdr->m_mutex);
+      //---------------------------------------------
+      num_waiters = p_hdr->m_num_send_waiters;
+      storage_waiters = p_hdr->m_num_storage_waiters != 0;
+      //Some cleanup to ease debugging
+      msg.len       = 0;
+      msg.priority  = 0;
+      p_hdr->release_reserved_msg(msg);
+   }  // Lock end
+
+   //The released message wakes a blocked sender
+   notify_senders(p_hdr, 1u, num_waiters, storage_waiters);
 }
 
 template<class VoidPointer>
@@ -904,6 +2146,20 @@ inline typename message_queue_t<VoidPointer>::size_type message_queue_t<VoidPoin
    return 0;
 }
 
+template<class VoidPointer>
+inline message_queue_index message_queue_t<VoidPointer>::get_index() const
+{
+   ipcdetail::mq_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::mq_hdr_t<VoidPointer>*>(m_shmem.get_user_address());
+   return p_hdr ? p_hdr->m_index : sorted_priority_index;
+}
+
+template<class VoidPointer>
+inline typename message_queue_t<VoidPointer>::size_type message_queue_t<VoidPointer>::get_storage_size() const
+{
+   ipcdetail::mq_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::mq_hdr_t<VoidPointer>*>(m_shmem.get_user_address());
+   return p_hdr ? p_hdr->m_storage_size : 0;
+}
+
 template<class VoidPointer>
 inline bool message_queue_t<VoidPointer>::remove(const char *name)
 {  return shared_memory_object::remove(name);  }
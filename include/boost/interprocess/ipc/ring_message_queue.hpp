@@ -0,0 +1,791 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOST_INTERPROCESS_RING_MESSAGE_QUEUE_HPP
+#define BOOST_INTERPROCESS_RING_MESSAGE_QUEUE_HPP
+
+#if (defined _MSC_VER) && (_MSC_VER >= 1200)
+#  pragma once
+#endif
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/detail/workaround.hpp>
+
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/detail/managed_open_or_create_impl.hpp>
+#include <boost/interprocess/sync/interprocess_eventcount.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/interprocess/detail/utilities.hpp>
+#include <boost/interprocess/offset_ptr.hpp>
+#include <boost/interprocess/creation_tags.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/permissions.hpp>
+#include <boost/interprocess/detail/posix_time_types_wrk.hpp>
+#include <boost/detail/no_exceptions_support.hpp>
+#include <boost/intrusive/pointer_traits.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>   //std::size_t
+#include <cstring>   //memcpy
+#include <new>
+
+//!\file
+//!Describes an inter-process message queue implemented as a lock-free ring
+//!of fixed-size slots. It offers the same interface as message_queue_t but
+//!messages are delivered in FIFO order and senders and receivers only block
+//!when the queue is full or empty.
+
+namespace boost{  namespace interprocess{
+
+//!Number of concurrent senders and receivers supported by a
+//!ring_message_queue_t. Selected when the queue is created.
+enum ring_queue_mode
+{
+   //!A single sender and a single receiver can use the queue at the same time.
+   //!Sending and receiving don't need atomic read-modify-write operations.
+   spsc_ring_queue,
+   //!Any number of senders and receivers can use the queue at the same time.
+   mpmc_ring_queue
+};
+
+/// @cond
+namespace ipcdetail
+{
+   template<class VoidPointer>
+   class ring_msg_queue_initialization_func_t;
+
+   //Counters written by senders and receivers are placed
+   //in different cache lines to avoid false sharing
+   static const std::size_t ring_mq_cache_line_size = 64;
+}
+/// @endcond
+
+//!A message queue that allows sending messages between processes without locks.
+//!Messages are stored in a ring of "get_max_msg()" preallocated slots of
+//!"get_max_msg_size()" bytes and are received in the order they were sent. The
+//!priority of a message is transmitted to the receiver but does not reorder the
+//!queue. Senders block only if the queue is full and receivers only if it's empty,
+//!and no system call is issued to wake them if nobody is blocked.
+template<class VoidPointer>
+class ring_message_queue_t
+{
+   /// @cond
+   //Blocking modes
+   enum block_t   {  blocking,   timed,   non_blocking   };
+
+   ring_message_queue_t();
+   /// @endcond
+
+   public:
+   typedef VoidPointer                                                 void_pointer;
+   typedef typename boost::intrusive::
+      pointer_traits<void_pointer>::template
+         rebind_pointer<char>::type                                    char_ptr;
+   typedef typename boost::intrusive::pointer_traits<char_ptr>::difference_type difference_type;
+   typedef typename boost::make_unsigned<difference_type>::type        size_type;
+
+   //!Creates a process shared ring message queue with name "name" that
+   //!supports any number of concurrent senders and receivers. The number
+   //!of slots is "max_num_msg" rounded up to a power of two, up to 2^30,
+   //!and each slot holds messages of up to "max_msg_size" bytes. Throws on
+   //!error and if the queue was previously created.
+   ring_message_queue_t(create_only_t create_only,
+                 const char *name,
+                 size_type max_num_msg,
+                 size_type max_msg_size,
+                 const permissions &perm = permissions());
+
+   //!Same as the previous constructor but the queue supports the
+   //!concurrency level selected by "mode".
+   ring_message_queue_t(create_only_t create_only,
+                 const char *name,
+                 size_type max_num_msg,
+                 size_type max_msg_size,
+                 ring_queue_mode mode,
+                 const permissions &perm = permissions());
+
+   //!Opens or creates a process shared ring message queue with name "name".
+   //!If the queue is created, it supports any number of concurrent senders and
+   //!receivers and "max_num_msg" and "max_msg_size" are used as in the create_only
+   //!constructor. If the queue was previously created the queue will be opened
+   //!and "max_num_msg" and "max_msg_size" parameters are ignored. Throws on error.
+   ring_message_queue_t(open_or_create_t open_or_create,
+                 const char *name,
+                 size_type max_num_msg,
+                 size_type max_msg_size,
+                 const permissions &perm = permissions());
+
+   //!Same as the previous constructor but if the queue is created it
+   //!supports the concurrency level selected by "mode".
+   ring_message_queue_t(open_or_create_t open_or_create,
+                 const char *name,
+                 size_type max_num_msg,
+                 size_type max_msg_size,
+                 ring_queue_mode mode,
+                 const permissions &perm = permissions());
+
+   //!Opens a previously created process shared ring message queue with name "name".
+   //!If the queue was not previously created or there are no free resources,
+   //!throws an error.
+   ring_message_queue_t(open_only_t open_only,
+                 const char *name);
+
+   //!Destroys *this and indicates that the calling process is finished using
+   //!the resource. All opened message queues are still
+   //!valid after destruction. The destructor function will deallocate
+   //!any system resources allocated by the system for use by this process for
+   //!this resource. The resource can still be opened again calling
+   //!the open constructor overload. To erase the message queue from the system
+   //!use remove().
+   ~ring_message_queue_t();
+
+   //!Sends a message stored in buffer "buffer" with size "buffer_size" in the
+   //!message queue with priority "priority". If the message queue is full
+   //!the sender is blocked. Throws interprocess_error on error.
+   void send (const void *buffer,     size_type buffer_size,
+              unsigned int priority);
+
+   //!Sends a message stored in buffer "buffer" with size "buffer_size" through the
+   //!message queue with priority "priority". If the message queue is full
+   //!the sender is not blocked and returns false, otherwise returns true.
+   //!Throws interprocess_error on error.
+   bool try_send    (const void *buffer,     size_type buffer_size,
+                         unsigned int priority);
+
+   //!Sends a message stored in buffer "buffer" with size "buffer_size" in the
+   //!message queue with priority "priority". If the message queue is full
+   //!the sender retries until time "abs_time" is reached. Returns true if
+   //!the message has been successfully sent. Returns false if timeout is reached.
+   //!Throws interprocess_error on error.
+   bool timed_send    (const void *buffer,     size_type buffer_size,
+                           unsigned int priority,  const boost::posix_time::ptime& abs_time);
+
+   //!Receives the oldest message of the message queue. The message is stored in buffer
+   //!"buffer", which has size "buffer_size". The received message has size
+   //!"recvd_size" and priority "priority". If the message queue is empty
+   //!the receiver is blocked. Throws interprocess_error on error.
+   void receive (void *buffer,           size_type buffer_size,
+                 size_type &recvd_size,unsigned int &priority);
+
+   //!Receives the oldest message of the message queue. The message is stored in buffer
+   //!"buffer", which has size "buffer_size". The received message has size
+   //!"recvd_size" and priority "priority". If the message queue is empty
+   //!the receiver is not blocked and returns false, otherwise returns true.
+   //!Throws interprocess_error on error.
+   bool try_receive (void *buffer,           size_type buffer_size,
+                     size_type &recvd_size,unsigned int &priority);
+
+   //!Receives the oldest message of the message queue. The message is stored in buffer
+   //!"buffer", which has size "buffer_size". The received message has size
+   //!"recvd_size" and priority "priority". If the message queue is empty
+   //!the receiver retries until time "abs_time" is reached. Returns true if
+   //!the message has been successfully received. Returns false if timeout is reached.
+   //!Throws interprocess_error on error.
+   bool timed_receive (void *buffer,           size_type buffer_size,
+                       size_type &recvd_size,unsigned int &priority,
+                       const boost::posix_time::ptime &abs_time);
+
+   //!Returns the number of slots of the queue. The message
+   //!queue must be opened or created previously. Otherwise, returns 0.
+   //!Never throws
+   size_type get_max_msg() const;
+
+   //!Returns the maximum size of message allowed by the queue. The message
+   //!queue must be opened or created previously. Otherwise, returns 0.
+   //!Never throws
+   size_type get_max_msg_size() const;
+
+   //!Returns the number of messages currently stored. The value might be
+   //!outdated when returned if other processes are using the queue.
+   //!Never throws
+   size_type get_num_msg() const;
+
+   //!Returns the concurrency level selected when the queue was created.
+   //!Never throws
+   ring_queue_mode get_mode() const;
+
+   //!Removes the message queue from the system.
+   //!Returns false on error. Never throws
+   static bool remove(const char *name);
+
+   /// @cond
+   private:
+   typedef boost::posix_time::ptime ptime;
+
+   friend class ipcdetail::ring_msg_queue_initialization_func_t<VoidPointer>;
+
+   bool do_receive(block_t block,
+                   void *buffer,         size_type buffer_size,
+                   size_type &recvd_size, unsigned int &priority,
+                   const ptime &abs_time);
+
+   bool do_send(block_t block,
+                const void *buffer,      size_type buffer_size,
+                unsigned int priority,   const ptime &abs_time);
+
+   //!Returns the needed memory size for the shared message queue.
+   //!Never throws
+   static size_type get_mem_size(size_type max_msg_size, size_type max_num_msg);
+   typedef ipcdetail::managed_open_or_create_impl
+      <shared_memory_object, ipcdetail::ring_mq_cache_line_size, true, false> open_create_impl_t;
+   open_create_impl_t m_shmem;
+   /// @endcond
+};
+
+/// @cond
+
+namespace ipcdetail {
+
+//!This header is the prefix of each slot of the ring
+template<class VoidPointer>
+class ring_msg_hdr_t
+{
+   typedef VoidPointer                                                     void_pointer;
+   typedef typename boost::intrusive::
+      pointer_traits<void_pointer>::template
+         rebind_pointer<char>::type                                        char_ptr;
+   typedef typename boost::intrusive::pointer_traits<char_ptr>::difference_type difference_type;
+   typedef typename boost::make_unsigned<difference_type>::type            size_type;
+
+   public:
+   //Ring position the slot is ready for (mpmc_ring_queue only): equal to the
+   //sender position when empty and to the receiver position plus one when full
+   volatile boost::uint32_t   seq;
+   unsigned int               priority;
+   size_type                  len;
+   void * data(){ return this+1; }
+};
+
+//!This header is placed in the beginning of the shared memory and contains
+//!the data to control the queue, followed by the ring of slots.
+template<class VoidPointer>
+class ring_mq_hdr_t
+{
+   typedef VoidPointer                                                     void_pointer;
+   typedef ring_msg_hdr_t<void_pointer>                                    msg_header;
+   typedef typename boost::intrusive::
+      pointer_traits<void_pointer>::template
+         rebind_pointer<char>::type                                        char_ptr;
+   typedef typename boost::intrusive::pointer_traits<char_ptr>::difference_type difference_type;
+   typedef typename boost::make_unsigned<difference_type>::type            size_type;
+   typedef ipcdetail::managed_open_or_create_impl
+      <shared_memory_object, ring_mq_cache_line_size, true, false>          open_create_impl_t;
+
+   //Positions are 32 bit counters that wrap around, so the number of
+   //slots must be a power of two that fits in them. Sequence differences
+   //are compared as int32, which needs them to stay below 2^31 in magnitude
+   static const size_type MaxSlots = size_type(1u) << 30;
+
+   public:
+   //!Constructor. This object must be constructed in the beginning of the
+   //!shared memory of the size returned by the function "get_mem_size".
+   //!This constructor initializes the slots of the ring. Never throws.
+   ring_mq_hdr_t(size_type max_num_msg, size_type max_msg_size, ring_queue_mode mode)
+      :  m_max_num_msg(get_num_slots(max_num_msg)),
+         m_max_msg_size(max_msg_size),
+         m_slot_size(get_slot_size(max_msg_size)),
+         m_mode(mode),
+         m_tail(0),
+         m_head(0)
+   {
+      for(size_type i = 0; i != m_max_num_msg; ++i){
+         msg_header *msg = new(&this->slot(boost::uint32_t(i))) msg_header;
+         msg->seq       = boost::uint32_t(i);
+         msg->priority  = 0;
+         msg->len       = 0;
+      }
+   }
+
+   //!Returns the number of slots of a queue created with "max_num_msg".
+   static size_type get_num_slots(size_type max_num_msg)
+   {
+      size_type num = 1;
+      while(num < max_num_msg && num < MaxSlots){
+         num <<= 1;
+      }
+      return num;
+   }
+
+   //!Returns the size of a slot holding messages of up to "max_msg_size" bytes.
+   static size_type get_slot_size(size_type max_msg_size)
+   {
+      return sizeof(msg_header) +
+         ipcdetail::get_rounded_size(max_msg_size, size_type(::boost::alignment_of<msg_header>::value));
+   }
+
+   //!Returns the number of bytes needed to construct a ring message queue with
+   //!"max_num_size" maximum number of messages and "max_msg_size" maximum
+   //!message size. Never throws.
+   static size_type get_mem_size
+      (size_type max_msg_size, size_type max_num_msg)
+   {
+      return ipcdetail::ct_rounded_size<sizeof(ring_mq_hdr_t), ring_mq_cache_line_size>::value +
+         get_num_slots(max_num_msg)*get_slot_size(max_msg_size) +
+         open_create_impl_t::ManagedOpenOrCreateUserOffset;
+   }
+
+   //!Copies the message in a free slot. Returns false if the queue is full.
+   bool try_push(const void *buffer, size_type size, unsigned int priority);
+
+   //!Copies the oldest message in "buffer". Returns false if the queue is empty.
+   bool try_pop(void *buffer, size_type &recvd_size, unsigned int &priority);
+
+   //!Returns the number of messages of the queue.
+   size_type get_num_msg()
+   {
+      const boost::uint32_t head = atomic_read32(&m_head);
+      const size_type num = size_type(boost::uint32_t(atomic_read32(&m_tail) - head));
+      //Counters are read in different moments
+      return num > m_max_num_msg ? m_max_num_msg : num;
+   }
+
+   private:
+   msg_header &slot(boost::uint32_t pos)
+   {
+      return *reinterpret_cast<msg_header*>
+         ( reinterpret_cast<char*>(this)
+         + ipcdetail::ct_rounded_size<sizeof(ring_mq_hdr_t), ring_mq_cache_line_size>::value
+         + size_type(pos & boost::uint32_t(m_max_num_msg - 1))*m_slot_size);
+   }
+
+   public:
+   //Number of slots of the ring (a power of two)
+   const size_type            m_max_num_msg;
+   //Maximum size of messages of the queue
+   const size_type            m_max_msg_size;
+   //Size of each slot, including its header
+   const size_type            m_slot_size;
+   //ring_queue_mode selected on creation
+   const boost::uint32_t      m_mode;
+   char                       m_pad0[ring_mq_cache_line_size];
+   //Position of the next message to be sent
+   volatile boost::uint32_t   m_tail;
+   char                       m_pad1[ring_mq_cache_line_size];
+   //Position of the next message to be received
+   volatile boost::uint32_t   m_head;
+   char                       m_pad2[ring_mq_cache_line_size];
+   //Blocks receivers when there are no messages
+   interprocess_eventcount    m_not_empty;
+   //Blocks senders when the queue is full
+   interprocess_eventcount    m_not_full;
+};
+
+template<class VoidPointer>
+inline bool ring_mq_hdr_t<VoidPointer>::try_push
+   (const void *buffer, size_type size, unsigned int priority)
+{
+   boost::uint32_t pos;
+   msg_header *msg;
+   if(m_mode == spsc_ring_queue){
+      //Only this sender writes the tail
+      pos = atomic_read32(&m_tail);
+      if(size_type(boost::uint32_t(pos - atomic_read32(&m_head))) == m_max_num_msg){
+         return false;
+      }
+      //The receiver must have finished reading the slot before it's overwritten
+      atomic_read_barrier();
+      msg = &this->slot(pos);
+   }
+   else{
+      pos = atomic_read32(&m_tail);
+      for(;;){
+         msg = &this->slot(pos);
+         const boost::int32_t dif = boost::int32_t(atomic_read32(&msg->seq) - pos);
+         if(dif == 0){
+            //The slot is free, claim the position
+            const boost::uint32_t old_pos = atomic_cas32(&m_tail, pos + 1, pos);
+            if(old_pos == pos){
+               break;
+            }
+            pos = old_pos;
+         }
+         else if(dif < 0){
+            //The slot still holds the message sent a lap ago
+            return false;
+         }
+         else{
+            //Another sender has claimed the position
+            pos = atomic_read32(&m_tail);
+         }
+      }
+   }
+
+   msg->len       = size;
+   msg->priority  = priority;
+   std::memcpy(msg->data(), buffer, size);
+
+   //Publish the message after its contents
+   atomic_write_barrier();
+   if(m_mode == spsc_ring_queue){
+      atomic_write32(&m_tail, pos + 1);
+   }
+   else{
+      atomic_write32(&msg->seq, pos + 1);
+   }
+   return true;
+}
+
+template<class VoidPointer>
+inline bool ring_mq_hdr_t<VoidPointer>::try_pop
+   (void *buffer, size_type &recvd_size, unsigned int &priority)
+{
+   boost::uint32_t pos;
+   msg_header *msg;
+   if(m_mode == spsc_ring_queue){
+      //Only this receiver writes the head
+      pos = atomic_read32(&m_head);
+      if(pos == atomic_read32(&m_tail)){
+         return false;
+      }
+      msg = &this->slot(pos);
+   }
+   else{
+      pos = atomic_read32(&m_head);
+      for(;;){
+         msg = &this->slot(pos);
+         const boost::int32_t dif = boost::int32_t(atomic_read32(&msg->seq) - (pos + 1));
+         if(dif == 0){
+            //The slot holds a message, claim the position
+            const boost::uint32_t old_pos = atomic_cas32(&m_head, pos + 1, pos);
+            if(old_pos == pos){
+               break;
+            }
+            pos = old_pos;
+         }
+         else if(dif < 0){
+            //The message has not been published yet
+            return false;
+         }
+         else{
+            //Another receiver has claimed the position
+            pos = atomic_read32(&m_head);
+         }
+      }
+   }
+
+   //Message contents can't be read before it was published
+   atomic_read_barrier();
+   recvd_size  = msg->len;
+   priority    = msg->priority;
+   std::memcpy(buffer, msg->data(), recvd_size);
+
+   //Release the slot for the sender of the next lap
+   atomic_write_barrier();
+   if(m_mode == spsc_ring_queue){
+      atomic_write32(&m_head, pos + 1);
+   }
+   else{
+      atomic_write32(&msg->seq, pos + boost::uint32_t(m_max_num_msg));
+   }
+   return true;
+}
+
+//!This is the atomic functor to be executed when creating or opening
+//!shared memory. Never throws
+template<class VoidPointer>
+class ring_msg_queue_initialization_func_t
+{
+   public:
+   typedef typename boost::intrusive::
+      pointer_traits<VoidPointer>::template
+         rebind_pointer<char>::type                                    char_ptr;
+   typedef typename boost::intrusive::pointer_traits<char_ptr>::difference_type difference_type;
+   typedef typename boost::make_unsigned<difference_type>::type        size_type;
+
+   ring_msg_queue_initialization_func_t(size_type maxmsg = 0,
+                         size_type maxmsgsize = 0,
+                         ring_queue_mode mode = mpmc_ring_queue)
+      : m_maxmsg (maxmsg), m_maxmsgsize(maxmsgsize), m_mode(mode) {}
+
+   bool operator()(void *address, size_type, bool created)
+   {
+      char      *mptr;
+
+      if(created){
+         mptr     = reinterpret_cast<char*>(address);
+         //Construct the message queue header at the beginning
+         BOOST_TRY{
+            new (mptr) ring_mq_hdr_t<VoidPointer>(m_maxmsg, m_maxmsgsize, m_mode);
+         }
+         BOOST_CATCH(...){
+            return false;
+         }
+         BOOST_CATCH_END
+      }
+      return true;
+   }
+
+   std::size_t get_min_size() const
+   {
+      return ring_mq_hdr_t<VoidPointer>::get_mem_size(m_maxmsgsize, m_maxmsg)
+      - ring_message_queue_t<VoidPointer>::open_create_impl_t::ManagedOpenOrCreateUserOffset;
+   }
+
+   const size_type m_maxmsg;
+   const size_type m_maxmsgsize;
+   const ring_queue_mode m_mode;
+};
+
+}  //namespace ipcdetail {
+
+template<class VoidPointer>
+inline ring_message_queue_t<VoidPointer>::~ring_message_queue_t()
+{}
+
+template<class VoidPointer>
+inline typename ring_message_queue_t<VoidPointer>::size_type ring_message_queue_t<VoidPointer>::get_mem_size
+   (size_type max_msg_size, size_type max_num_msg)
+{  return ipcdetail::ring_mq_hdr_t<VoidPointer>::get_mem_size(max_msg_size, max_num_msg);   }
+
+template<class VoidPointer>
+inline ring_message_queue_t<VoidPointer>::ring_message_queue_t(create_only_t,
+                                    const char *name,
+                                    size_type max_num_msg,
+                                    size_type max_msg_size,
+                                    const permissions &perm)
+      //Create shared memory and execute functor atomically
+   :  m_shmem(create_only,
+              name,
+              get_mem_size(max_msg_size, max_num_msg),
+              read_write,
+              static_cast<void*>(0),
+              //Prepare initialization functor
+              ipcdetail::ring_msg_queue_initialization_func_t<VoidPointer> (max_num_msg, max_msg_size),
+              perm)
+{}
+
+template<class VoidPointer>
+inline ring_message_queue_t<VoidPointer>::ring_message_queue_t(create_only_t,
+                                    const char *name,
+                                    size_type max_num_msg,
+                                    size_type max_msg_size,
+                                    ring_queue_mode mode,
+                                    const permissions &perm)
+      //Create shared memory and execute functor atomically
+   :  m_shmem(create_only,
+              name,
+              get_mem_size(max_msg_size, max_num_msg),
+              read_write,
+              static_cast<void*>(0),
+              //Prepare initialization functor
+              ipcdetail::ring_msg_queue_initialization_func_t<VoidPointer> (max_num_msg, max_msg_size, mode),
+              perm)
+{}
+
+template<class VoidPointer>
+inline ring_message_queue_t<VoidPointer>::ring_message_queue_t(open_or_create_t,
+                                    const char *name,
+                                    size_type max_num_msg,
+                                    size_type max_msg_size,
+                                    const permissions &perm)
+      //Create shared memory and execute functor atomically
+   :  m_shmem(open_or_create,
+              name,
+              get_mem_size(max_msg_size, max_num_msg),
+              read_write,
+              static_cast<void*>(0),
+              //Prepare initialization functor
+              ipcdetail::ring_msg_queue_initialization_func_t<VoidPointer> (max_num_msg, max_msg_size),
+              perm)
+{}
+
+template<class VoidPointer>
+inline ring_message_queue_t<VoidPointer>::ring_message_queue_t(open_or_create_t,
+                                    const char *name,
+                                    size_type max_num_msg,
+                                    size_type max_msg_size,
+                                    ring_queue_mode mode,
+                                    const permissions &perm)
+      //Create shared memory and execute functor atomically
+   :  m_shmem(open_or_create,
+              name,
+              get_mem_size(max_msg_size, max_num_msg),
+              read_write,
+              static_cast<void*>(0),
+              //Prepare initialization functor
+              ipcdetail::ring_msg_queue_initialization_func_t<VoidPointer> (max_num_msg, max_msg_size, mode),
+              perm)
+{}
+
+template<class VoidPointer>
+inline ring_message_queue_t<VoidPointer>::ring_message_queue_t(open_only_t, const char *name)
+   //Create shared memory and execute functor atomically
+   :  m_shmem(open_only,
+              name,
+              read_write,
+              static_cast<void*>(0),
+              //Prepare initialization functor
+              ipcdetail::ring_msg_queue_initialization_func_t<VoidPointer> ())
+{}
+
+template<class VoidPointer>
+inline void ring_message_queue_t<VoidPointer>::send
+   (const void *buffer, size_type buffer_size, unsigned int priority)
+{  this->do_send(blocking, buffer, buffer_size, priority, ptime()); }
+
+template<class VoidPointer>
+inline bool ring_message_queue_t<VoidPointer>::try_send
+   (const void *buffer, size_type buffer_size, unsigned int priority)
+{  return this->do_send(non_blocking, buffer, buffer_size, priority, ptime()); }
+
+template<class VoidPointer>
+inline bool ring_message_queue_t<VoidPointer>::timed_send
+   (const void *buffer, size_type buffer_size
+   ,unsigned int priority, const boost::posix_time::ptime &abs_time)
+{
+   if(abs_time == boost::posix_time::pos_infin){
+      this->send(buffer, buffer_size, priority);
+      return true;
+   }
+   return this->do_send(timed, buffer, buffer_size, priority, abs_time);
+}
+
+template<class VoidPointer>
+inline bool ring_message_queue_t<VoidPointer>::do_send(block_t block,
+                                const void *buffer,      size_type buffer_size,
+                                unsigned int priority,   const boost::posix_time::ptime &abs_time)
+{
+   ipcdetail::ring_mq_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::ring_mq_hdr_t<VoidPointer>*>(m_shmem.get_user_address());
+   //Check if buffer is smaller than maximum allowed
+   if (buffer_size > p_hdr->m_max_msg_size) {
+      throw interprocess_exception(size_error);
+   }
+
+   while(!p_hdr->try_push(buffer, buffer_size, priority)){
+      if(block == non_blocking){
+         return false;
+      }
+      //The queue was full. Register as a waiter and try again, so that
+      //a receiver freeing a slot after this point will wake us up
+      const interprocess_eventcount::key_type key = p_hdr->m_not_full.prepare_wait();
+      if(p_hdr->try_push(buffer, buffer_size, priority)){
+         p_hdr->m_not_full.cancel_wait();
+         break;
+      }
+      if(!p_hdr->m_not_full.timed_wait
+            (key, block == timed ? abs_time : ptime(boost::posix_time::pos_infin))){
+         //Timeout, last chance
+         if(!p_hdr->try_push(buffer, buffer_size, priority)){
+            return false;
+         }
+         break;
+      }
+   }
+
+   //Wake a receiver if any is blocked, no system call is
+   //issued if the queue was not empty for any of them
+   p_hdr->m_not_empty.notify_one();
+   return true;
+}
+
+template<class VoidPointer>
+inline void ring_message_queue_t<VoidPointer>::receive(void *buffer,        size_type buffer_size,
+                                        size_type &recvd_size,   unsigned int &priority)
+{  this->do_receive(blocking, buffer, buffer_size, recvd_size, priority, ptime()); }
+
+template<class VoidPointer>
+inline bool
+   ring_message_queue_t<VoidPointer>::try_receive(void *buffer,              size_type buffer_size,
+                              size_type &recvd_size,   unsigned int &priority)
+{  return this->do_receive(non_blocking, buffer, buffer_size, recvd_size, priority, ptime()); }
+
+template<class VoidPointer>
+inline bool
+   ring_message_queue_t<VoidPointer>::timed_receive(void *buffer,            size_type buffer_size,
+                                size_type &recvd_size,   unsigned int &priority,
+                                const boost::posix_time::ptime &abs_time)
+{
+   if(abs_time == boost::posix_time::pos_infin){
+      this->receive(buffer, buffer_size, recvd_size, priority);
+      return true;
+   }
+   return this->do_receive(timed, buffer, buffer_size, recvd_size, priority, abs_time);
+}
+
+template<class VoidPointer>
+inline bool
+   ring_message_queue_t<VoidPointer>::do_receive(block_t block,
+                          void *buffer,            size_type buffer_size,
+                          size_type &recvd_size,   unsigned int &priority,
+                          const boost::posix_time::ptime &abs_time)
+{
+   ipcdetail::ring_mq_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::ring_mq_hdr_t<VoidPointer>*>(m_shmem.get_user_address());
+   //Check if buffer is big enough for any message
+   if (buffer_size < p_hdr->m_max_msg_size) {
+      throw interprocess_exception(size_error);
+   }
+
+   while(!p_hdr->try_pop(buffer, recvd_size, priority)){
+      if(block == non_blocking){
+         return false;
+      }
+      //The queue was empty. Register as a waiter and try again, so that
+      //a sender publishing a message after this point will wake us up
+      const interprocess_eventcount::key_type key = p_hdr->m_not_empty.prepare_wait();
+      if(p_hdr->try_pop(buffer, recvd_size, priority)){
+         p_hdr->m_not_empty.cancel_wait();
+         break;
+      }
+      if(!p_hdr->m_not_empty.timed_wait
+            (key, block == timed ? abs_time : ptime(boost::posix_time::pos_infin))){
+         //Timeout, last chance
+         if(!p_hdr->try_pop(buffer, recvd_size, priority)){
+            return false;
+         }
+         break;
+      }
+   }
+
+   //Wake a sender if any is blocked, no system call is
+   //issued if the queue was not full for any of them
+   p_hdr->m_not_full.notify_one();
+   return true;
+}
+
+template<class VoidPointer>
+inline typename ring_message_queue_t<VoidPointer>::size_type ring_message_queue_t<VoidPointer>::get_max_msg() const
+{
+   ipcdetail::ring_mq_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::ring_mq_hdr_t<VoidPointer>*>(m_shmem.get_user_address());
+   return p_hdr ? p_hdr->m_max_num_msg : 0;
+}
+
+template<class VoidPointer>
+inline typename ring_message_queue_t<VoidPointer>::size_type ring_message_queue_t<VoidPointer>::get_max_msg_size() const
+{
+   ipcdetail::ring_mq_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::ring_mq_hdr_t<VoidPointer>*>(m_shmem.get_user_address());
+   return p_hdr ? p_hdr->m_max_msg_size : 0;
+}
+
+template<class VoidPointer>
+inline typename ring_message_queue_t<VoidPointer>::size_type ring_message_queue_t<VoidPointer>::get_num_msg() const
+{
+   ipcdetail::ring_mq_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::ring_mq_hdr_t<VoidPointer>*>(m_shmem.get_user_address());
+   return p_hdr ? p_hdr->get_num_msg() : 0;
+}
+
+template<class VoidPointer>
+inline ring_queue_mode ring_message_queue_t<VoidPointer>::get_mode() const
+{
+   ipcdetail::ring_mq_hdr_t<VoidPointer> *p_hdr = static_cast<ipcdetail::ring_mq_hdr_t<VoidPointer>*>(m_shmem.get_user_address());
+   return p_hdr ? ring_queue_mode(p_hdr->m_mode) : mpmc_ring_queue;
+}
+
+template<class VoidPointer>
+inline bool ring_message_queue_t<VoidPointer>::remove(const char *name)
+{  return shared_memory_object::remove(name);  }
+
+/// @endcond
+
+}} //namespace boost{  namespace interprocess{
+
+#include <boost/interprocess/detail/config_end.hpp>
+
+#endif   //#ifndef BOOST_INTERPROCESS_RING_MESSAGE_QUEUE_HPP
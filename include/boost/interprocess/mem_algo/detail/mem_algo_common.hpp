@@ -24,6 +24,9 @@
 #include <boost/interprocess/detail/type_traits.hpp>
 #include <boost/interprocess/detail/math_functions.hpp>
 #include <boost/interprocess/detail/utilities.hpp>
+#include <boost/interprocess/detail/os_file_functions.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/mem_algo/memory_algorithm_stats.hpp>
 #include <boost/move/move.hpp>
 #include <boost/interprocess/detail/min_max.hpp>
 #include <boost/container/detail/multiallocation_chain.hpp>
@@ -83,6 +86,7 @@ class memory_algorithm_common
    typedef typename MemoryAlgorithm::multiallocation_chain     multiallocation_chain;
    typedef memory_algorithm_common<MemoryAlgorithm>            this_type;
    typedef typename MemoryAlgorithm::size_type                 size_type;
+   typedef memory_algorithm_stats<size_type>                   stats_type;
 
    static const size_type Alignment              = MemoryAlgorithm::Alignment;
    static const size_type MinBlockUnits          = MemoryAlgorithm::MinBlockUnits;
@@ -124,6 +128,52 @@ class memory_algorithm_common
       return this_type::priv_deallocate_many(memory_algo, chain);
    }
 
+   //!Counts in "stats" a block of "block_bytes" bytes
+   //!whose user buffer has "user_bytes" bytes
+   static void add_block_to_stats
+      (stats_type &stats, size_type block_bytes, size_type user_bytes, bool allocated)
+   {
+      const std::size_t size_class = stats_type::size_class(block_bytes);
+      if(allocated){
+         ++stats.allocated_blocks;
+         ++stats.allocated_histogram[size_class];
+         stats.allocated_bytes += user_bytes;
+      }
+      else{
+         ++stats.free_blocks;
+         ++stats.free_histogram[size_class];
+         stats.free_bytes += block_bytes;
+         if(user_bytes > stats.largest_free_block){
+            stats.largest_free_block = user_bytes;
+         }
+      }
+   }
+
+   //!Calculates the statistics derived from the counted blocks
+   static void complete_stats(stats_type &stats)
+   {
+      BOOST_ASSERT(stats.free_bytes + stats.allocated_bytes <= stats.segment_size);
+      stats.overhead_bytes = stats.segment_size - stats.free_bytes - stats.allocated_bytes;
+   }
+
+   //!Makes the free memory [beg, end) read as zeroes. The whole pages of the range
+   //!are returned to the operating system if it supports it, and the rest is written.
+   //!Returns true if pages were returned.
+   static bool zero_free_range(char *beg, char *end, std::size_t page_size)
+   {
+      char *const page_beg = reinterpret_cast<char*>
+         (get_rounded_size(reinterpret_cast<std::size_t>(beg), page_size));
+      char *const page_end = reinterpret_cast<char*>
+         (reinterpret_cast<std::size_t>(end) - reinterpret_cast<std::size_t>(end) % page_size);
+      if(page_beg < page_end && release_mapped_pages(page_beg, std::size_t(page_end - page_beg))){
+         this_type::priv_write_zeroes(beg, page_beg);
+         this_type::priv_write_zeroes(page_end, end);
+         return true;
+      }
+      this_type::priv_write_zeroes(beg, end);
+      return false;
+   }
+
    static bool calculate_lcm_and_needs_backwards_lcmed
       (size_type backwards_multiple, size_type received_size, size_type size_to_achieve,
       size_type &lcm_out, size_type &needs_backwards_lcmed_out)
@@ -449,6 +499,16 @@ class memory_algorithm_common
    }
 
    private:
+   static void priv_write_zeroes(char *beg, char *end)
+   {
+      //std::memset can be optimized out by some compilers, since
+      //the memory is not read again before it's deallocated
+      volatile char *ptr = beg;
+      while(ptr != end){
+         *ptr++ = 0;
+      }
+   }
+
    static void priv_allocate_many
       ( MemoryAlgorithm *memory_algo
       , const size_type *elem_sizes
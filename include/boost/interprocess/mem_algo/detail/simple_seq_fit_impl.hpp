@@ -32,6 +32,7 @@
 #include <boost/interprocess/sync/scoped_lock.hpp>
 #include <boost/intrusive/pointer_traits.hpp>
 #include <boost/interprocess/mem_algo/detail/mem_algo_common.hpp>
+#include <boost/interprocess/mem_algo/memory_algorithm_stats.hpp>
 #include <boost/type_traits/alignment_of.hpp>
 #include <boost/type_traits/type_with_alignment.hpp>
 #include <algorithm>
@@ -76,7 +77,8 @@ class simple_seq_fit_impl
 
    typedef typename boost::intrusive::pointer_traits<char_ptr>::difference_type difference_type;
    typedef typename boost::make_unsigned<difference_type>::type size_type;
-
+   //!Statistics returned by get_stats()
+   typedef memory_algorithm_stats<size_type>    stats_type;
 
    private:
    class block_ctrl;
@@ -119,6 +121,9 @@ class simple_seq_fit_impl
       size_type         m_size;
       //!The extra size required by the segment
       size_type         m_extra_hdr_bytes;
+      //!Number of allocated and deallocated blocks
+      size_type         m_num_allocations;
+      size_type         m_num_deallocations;
    }  m_header;
 
    friend class ipcdetail::memory_algorithm_common<simple_seq_fit_impl>;
@@ -150,7 +155,9 @@ class simple_seq_fit_impl
       //-----------------------
       boost::interprocess::scoped_lock<interprocess_mutex> guard(m_header);
       //-----------------------
+      const size_type prev_size = chain.size();
       algo_impl_t::allocate_many(this, elem_bytes, num_elements, chain);
+      m_header.m_num_allocations += chain.size() - prev_size;
    }
 
    //!Multiple element allocation, different size
@@ -159,7 +166,9 @@ class simple_seq_fit_impl
       //-----------------------
       boost::interprocess::scoped_lock<interprocess_mutex> guard(m_header);
       //-----------------------
+      const size_type prev_size = chain.size();
       algo_impl_t::allocate_many(this, elem_sizes, n_elements, sizeof_element, chain);
+      m_header.m_num_allocations += chain.size() - prev_size;
    }
 
    //!Multiple element deallocation
@@ -188,8 +197,13 @@ class simple_seq_fit_impl
    //!Makes an internal sanity check and returns true if success
    bool check_sanity();
 
-   //!Initializes to zero all the memory that's not in use.
-   //!This function is normally used for security reasons.
+   //!Fills "stats" traversing all blocks of the segment once,
+   //!with the memory algorithm locked
+   void get_stats(stats_type &stats);
+
+   //!Initializes to zero all the memory that's not in use. Whole free pages
+   //!are returned to the operating system instead of being written, if it's
+   //!able to do it. This function is normally used for security reasons.
    void zero_free_memory();
 
    template<class T>
@@ -335,6 +349,8 @@ inline simple_seq_fit_impl<MutexFamily, VoidPointer>::
    m_header.m_allocated = 0;
    m_header.m_size      = segment_size;
    m_header.m_extra_hdr_bytes = extra_hdr_bytes;
+   m_header.m_num_allocations   = 0;
+   m_header.m_num_deallocations = 0;
 
    //Initialize pointers
    size_type block1_off = priv_first_block_offset(this, extra_hdr_bytes);
@@ -518,13 +534,13 @@ inline void simple_seq_fit_impl<MutexFamily, VoidPointer>::zero_free_memory()
    boost::interprocess::scoped_lock<interprocess_mutex> guard(m_header);
    //-----------------------
    block_ctrl *block = ipcdetail::to_raw_pointer(m_header.m_root.m_next);
+   const std::size_t page_size = mapped_region::get_page_size();
 
    //Iterate through all free portions
    do{
       //Just clear user the memory part reserved for the user
-      std::memset( priv_get_user_buffer(block)
-                 , 0
-             , block->get_user_bytes());
+      char *const beg = static_cast<char*>(priv_get_user_buffer(block));
+      algo_impl_t::zero_free_range(beg, beg + block->get_user_bytes(), page_size);
       block = ipcdetail::to_raw_pointer(block->m_next);
    }
    while(block != &m_header.m_root);
@@ -567,6 +583,33 @@ inline bool simple_seq_fit_impl<MutexFamily, VoidPointer>::
    return true;
 }
 
+template<class MutexFamily, class VoidPointer>
+void simple_seq_fit_impl<MutexFamily, VoidPointer>::get_stats(stats_type &stats)
+{
+   stats.clear();
+   //-----------------------
+   boost::interprocess::scoped_lock<interprocess_mutex> guard(m_header);
+   //-----------------------
+   stats.segment_size  = m_header.m_size;
+   stats.allocations   = m_header.m_num_allocations;
+   stats.deallocations = m_header.m_num_deallocations;
+
+   //Blocks are contiguous, but growing the segment by less than
+   //MinBlockSize bytes leaves some bytes that don't form a block
+   char *const this_addr = reinterpret_cast<char*>(this);
+   size_type off = priv_first_block_offset(this, m_header.m_extra_hdr_bytes);
+   const size_type end_off = priv_block_end_offset();
+   while(end_off - off >= MinBlockSize){
+      block_ctrl *block = reinterpret_cast<block_ctrl*>(this_addr + off);
+      if(!block->m_size || block->get_total_bytes() > end_off - off)
+         break;
+      algo_impl_t::add_block_to_stats
+         (stats, block->get_total_bytes(), block->get_user_bytes(), priv_is_allocated_block(block));
+      off += block->get_total_bytes();
+   }
+   algo_impl_t::complete_stats(stats);
+}
+
 template<class MutexFamily, class VoidPointer>
 inline void* simple_seq_fit_impl<MutexFamily, VoidPointer>::
    allocate(size_type nbytes)
@@ -575,7 +618,11 @@ inline void* simple_seq_fit_impl<MutexFamily, VoidPointer>::
    boost::interprocess::scoped_lock<interprocess_mutex> guard(m_header);
    //-----------------------
    size_type ignore;
-   return priv_allocate(boost::interprocess::allocate_new, nbytes, nbytes, ignore).first;
+   void *ret = priv_allocate(boost::interprocess::allocate_new, nbytes, nbytes, ignore).first;
+   if(ret){
+      ++m_header.m_num_allocations;
+   }
+   return ret;
 }
 
 template<class MutexFamily, class VoidPointer>
@@ -585,8 +632,11 @@ inline void* simple_seq_fit_impl<MutexFamily, VoidPointer>::
    //-----------------------
    boost::interprocess::scoped_lock<interprocess_mutex> guard(m_header);
    //-----------------------
-   return algo_impl_t::
-      allocate_aligned(this, nbytes, alignment);
+   void *ret = algo_impl_t::allocate_aligned(this, nbytes, alignment);
+   if(ret){
+      ++m_header.m_num_allocations;
+   }
+   return ret;
 }
 
 template<class MutexFamily, class VoidPointer>
@@ -644,6 +694,13 @@ inline std::pair<void*, bool> simple_seq_fit_impl<MutexFamily, VoidPointer>::
       boost::interprocess::scoped_lock<interprocess_mutex> guard(m_header);
       //-----------------------
       ret = priv_allocate(command, l_size, p_size, r_size, reuse_ptr);
+      //Expansions don't allocate a new block
+      if(ret.first && !ret.second){
+         ++m_header.m_num_allocations;
+      }
+   }
+   if(ret.first && !ret.second && (command & boost::interprocess::zero_memory)){
+      std::memset(ret.first, 0, r_size);
    }
    received_size = r_size/sizeof_object;
    return ret;
@@ -746,6 +803,7 @@ inline void simple_seq_fit_impl<MutexFamily, VoidPointer>::
    //-----------------------
    boost::interprocess::scoped_lock<interprocess_mutex> guard(m_header);
    //-----------------------
+   m_header.m_num_deallocations += chain.size();
    while(!chain.empty()){
       this->priv_deallocate(to_raw_pointer(chain.pop_front()));
    }
@@ -1042,6 +1100,7 @@ void simple_seq_fit_impl<MutexFamily, VoidPointer>::deallocate(void* addr)
    //-----------------------
    boost::interprocess::scoped_lock<interprocess_mutex> guard(m_header);
    //-----------------------
+   ++m_header.m_num_deallocations;
    return this->priv_deallocate(addr);
 }
 
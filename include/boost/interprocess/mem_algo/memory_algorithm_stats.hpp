@@ -0,0 +1,107 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOST_INTERPROCESS_MEM_ALGO_MEMORY_ALGORITHM_STATS_HPP
+#define BOOST_INTERPROCESS_MEM_ALGO_MEMORY_ALGORITHM_STATS_HPP
+
+#if (defined _MSC_VER) && (_MSC_VER >= 1200)
+#  pragma once
+#endif
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/detail/workaround.hpp>
+
+#include <boost/interprocess/detail/math_functions.hpp>
+#include <boost/assert.hpp>
+#include <climits>
+#include <cstddef>
+
+//!\file
+//!Describes the statistics of free and allocated blocks that memory algorithms
+//!obtain with a single traversal of their blocks.
+
+namespace boost {
+namespace interprocess {
+
+//!Statistics of the free and allocated blocks of a memory algorithm, obtained
+//!by the "get_stats" function of the memory algorithm or the segment manager.
+//!Sizes are in bytes. Block sizes include the header of the block, so they
+//!are bigger than the size of the user buffer.
+//!
+//!Blocks of a block size of "bytes" are counted in the histogram entry
+//!"size_class(bytes)", which is the floor of the base 2 logarithm of "bytes".
+template<class SizeType>
+struct memory_algorithm_stats
+{
+   typedef SizeType size_type;
+
+   //!Number of entries of the histograms
+   static const std::size_t NumSizeClasses = sizeof(size_type)*CHAR_BIT;
+
+   //!Initializes all statistics to zero
+   memory_algorithm_stats()
+   {  this->clear();  }
+
+   //!Sets all statistics to zero
+   void clear()
+   {
+      segment_size = free_bytes = largest_free_block = allocated_bytes = overhead_bytes = 0;
+      free_blocks = allocated_blocks = allocations = deallocations = 0;
+      for(std::size_t i = 0; i != NumSizeClasses; ++i){
+         free_histogram[i] = allocated_histogram[i] = 0;
+      }
+   }
+
+   //!Returns the histogram entry of blocks of a block size of "bytes"
+   static std::size_t size_class(size_type bytes)
+   {
+      BOOST_ASSERT(bytes);
+      return ipcdetail::floor_log2_nz(std::size_t(bytes));
+   }
+
+   //!Size of the memory segment
+   size_type segment_size;
+   //!Bytes of the free blocks, including their headers
+   size_type free_bytes;
+   //!Bytes of the user buffer of the biggest free block
+   size_type largest_free_block;
+   //!Bytes of the user buffers of the allocated blocks
+   size_type allocated_bytes;
+   //!Bytes of the segment that are neither free nor usable by user buffers:
+   //!headers of allocated blocks, headers of the memory algorithm and the
+   //!segment manager and alignment padding
+   size_type overhead_bytes;
+   //!Number of free blocks
+   size_type free_blocks;
+   //!Number of allocated blocks
+   size_type allocated_blocks;
+   //!Number of blocks allocated since the memory algorithm was constructed
+   size_type allocations;
+   //!Number of blocks deallocated since the memory algorithm was constructed
+   size_type deallocations;
+   //!Number of free blocks of each size class
+   size_type free_histogram[NumSizeClasses];
+   //!Number of allocated blocks of each size class
+   size_type allocated_histogram[NumSizeClasses];
+};
+
+/// @cond
+
+template<class SizeType>
+const std::size_t memory_algorithm_stats<SizeType>::NumSizeClasses;
+
+/// @endcond
+
+}  //namespace interprocess {
+}  //namespace boost {
+
+#include <boost/interprocess/detail/config_end.hpp>
+
+#endif   //#ifndef BOOST_INTERPROCESS_MEM_ALGO_MEMORY_ALGORITHM_STATS_HPP
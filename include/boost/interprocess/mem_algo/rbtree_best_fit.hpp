@@ -22,6 +22,7 @@
 
 #include <boost/interprocess/interprocess_fwd.hpp>
 #include <boost/interprocess/mem_algo/detail/mem_algo_common.hpp>
+#include <boost/interprocess/mem_algo/memory_algorithm_stats.hpp>
 #include <boost/interprocess/containers/allocation_type.hpp>
 #include <boost/container/detail/multiallocation_chain.hpp>
 #include <boost/interprocess/offset_ptr.hpp>
@@ -92,6 +93,8 @@ class rbtree_best_fit
 
    typedef typename boost::intrusive::pointer_traits<char_ptr>::difference_type difference_type;
    typedef typename boost::make_unsigned<difference_type>::type     size_type;
+   //!Statistics returned by get_stats()
+   typedef memory_algorithm_stats<size_type>                        stats_type;
 
    /// @cond
 
@@ -107,9 +110,11 @@ class rbtree_best_fit
       //!This block's memory size (including block_ctrl
       //!header) in Alignment units
       size_type m_prev_size :  sizeof(size_type)*CHAR_BIT;
-      size_type m_size      :  sizeof(size_type)*CHAR_BIT - 2;
+      size_type m_size      :  sizeof(size_type)*CHAR_BIT - 3;
       size_type m_prev_allocated :  1;
       size_type m_allocated :  1;
+      //!A free block whose memory after the block_ctrl header is known to be zero
+      size_type m_zeroed    :  1;
    };
 
    //!Block control structure
@@ -117,7 +122,7 @@ class rbtree_best_fit
       :  public SizeHolder, public TreeHook
    {
       block_ctrl()
-      {  this->m_size = 0; this->m_allocated = 0, this->m_prev_allocated = 0;  }
+      {  this->m_size = 0; this->m_allocated = 0, this->m_prev_allocated = 0; this->m_zeroed = 0;  }
 
       friend bool operator<(const block_ctrl &a, const block_ctrl &b)
       {  return a.m_size < b.m_size;  }
@@ -141,6 +146,33 @@ class rbtree_best_fit
 
    typedef typename Imultiset::iterator                           imultiset_iterator;
 
+   //!Number of size classes cached in bins. Bin "i" caches
+   //!free blocks of MinBlockUnits + i units
+   static const size_type NumBins = 16;
+
+   //!Maximum number of blocks carved from the tree when a bin is empty
+   static const size_type BinRefillBlocks = 32;
+
+   //!List of free blocks of the same size class. Blocks in a bin are marked as
+   //!allocated in the tree, so they are not merged with their neighbours, and
+   //!they are linked through the first bytes of their user buffer.
+   //!Each bin has its own mutex, so threads allocating different size
+   //!classes don't contend.
+   struct bin_t
+   {
+      //!Protects the bin. It can be locked while the tree is locked, but the
+      //!tree must not be locked while it's locked. Several bins are only
+      //!locked at once by bins_lock, in index order
+      mutex_type           m_mutex;
+      //!Offset of the first block from the memory algorithm, 0 if empty
+      size_type            m_first;
+      //!Number of blocks in the list
+      size_type            m_count;
+      //!Blocks allocated and deallocated through the bin
+      size_type            m_allocations;
+      size_type            m_deallocations;
+   };
+
    //!This struct includes needed data and derives from
    //!mutex_type to allow EBO when using null mutex_type
    struct header_t : public mutex_type
@@ -153,8 +185,42 @@ class rbtree_best_fit
       size_type            m_allocated;
       //!The size of the memory segment
       size_type            m_size;
+      //!Blocks allocated and deallocated through the tree
+      size_type            m_num_allocations;
+      size_type            m_num_deallocations;
+      //!Maximum number of blocks cached in each bin, 0 disables bins
+      size_type            m_bin_capacity;
+      //!Free small blocks, indexed by size class
+      bin_t                m_bins[NumBins];
    }  m_header;
 
+   //!Locks all bins in index order, so that
+   //!cached blocks don't change while it's alive
+   class bins_lock
+   {
+      bins_lock(const bins_lock &);
+      bins_lock &operator=(const bins_lock &);
+
+      public:
+      explicit bins_lock(header_t &header)
+         :  m_header(header)
+      {
+         for(size_type i = 0; i != NumBins; ++i){
+            m_header.m_bins[i].m_mutex.lock();
+         }
+      }
+
+      ~bins_lock()
+      {
+         for(size_type i = NumBins; i != 0; --i){
+            m_header.m_bins[i-1].m_mutex.unlock();
+         }
+      }
+
+      private:
+      header_t &m_header;
+   };
+
    friend class ipcdetail::memory_algorithm_common<rbtree_best_fit>;
 
    typedef ipcdetail::memory_algorithm_common<rbtree_best_fit> algo_impl_t;
@@ -188,7 +254,12 @@ class rbtree_best_fit
       //-----------------------
       boost::interprocess::scoped_lock<mutex_type> guard(m_header);
       //-----------------------
+      const size_type prev_size = chain.size();
       algo_impl_t::allocate_many(this, elem_bytes, num_elements, chain);
+      if(chain.size() == prev_size && this->priv_flush_bins()){
+         algo_impl_t::allocate_many(this, elem_bytes, num_elements, chain);
+      }
+      m_header.m_num_allocations += chain.size() - prev_size;
    }
 
    //!Multiple element allocation, different size
@@ -197,7 +268,12 @@ class rbtree_best_fit
       //-----------------------
       boost::interprocess::scoped_lock<mutex_type> guard(m_header);
       //-----------------------
+      const size_type prev_size = chain.size();
       algo_impl_t::allocate_many(this, elem_sizes, n_elements, sizeof_element, chain);
+      if(chain.size() == prev_size && this->priv_flush_bins()){
+         algo_impl_t::allocate_many(this, elem_sizes, n_elements, sizeof_element, chain);
+      }
+      m_header.m_num_allocations += chain.size() - prev_size;
    }
 
    //!Multiple element allocation, different size
@@ -214,10 +290,19 @@ class rbtree_best_fit
    //!Returns the number of free bytes of the segment
    size_type get_free_memory()  const;
 
-   //!Initializes to zero all the memory that's not in use.
-   //!This function is normally used for security reasons.
+   //!Initializes to zero all the memory that's not in use. Whole free pages
+   //!are returned to the operating system instead of being written, if it's
+   //!able to do it, and free blocks are known to be zero until they are
+   //!written again, so allocation_command with boost::interprocess::zero_memory
+   //!does not clear them. This function is normally used for security reasons.
    void zero_free_memory();
 
+   //!Marks the free memory as known to be zero without writing it. Only has
+   //!effect if nothing has been allocated yet, so that the free block was never
+   //!written. Used when the segment has just been built over memory that reads
+   //!as zero, like a new shared memory object or file. Never throws.
+   void mark_free_memory_zeroed();
+
    //!Increases managed memory in
    //!extra_size bytes more
    void grow(size_type extra_size);
@@ -225,6 +310,34 @@ class rbtree_best_fit
    //!Decreases managed memory as much as possible
    void shrink_to_fit();
 
+   //!Enables size-class bins: allocate() and deallocate() serve blocks of up to
+   //!get_max_bin_size() bytes from lists of free blocks of the same size, that
+   //!are refilled in bulk from the free block tree, without locking the tree.
+   //!Up to "max_blocks" free blocks are cached for each size class. Cached blocks
+   //!are returned to the tree when an allocation would fail otherwise.
+   //!A value of 0, the default, disables bins and empties them.
+   void set_bin_capacity(size_type max_blocks);
+
+   //!Returns the maximum number of free blocks cached for each size class
+   size_type get_bin_capacity() const;
+
+   //!Returns the maximum number of bytes an allocation served from bins can request
+   static size_type get_max_bin_size();
+
+   /// @cond
+   //!Obtains up to "n" buffers of "nbytes" bytes, not more than get_max_bin_size(),
+   //!from the bin of their size class, refilling it from the tree if it's empty.
+   //!Buffers are linked through their first bytes in "list". Returns the number
+   //!of buffers. Used by the thread caches of segment managers. Never throws
+   size_type allocate_bin_list(size_type nbytes, size_type n, void *&list)
+   {  return this->priv_bin_allocate(priv_get_total_units(nbytes) - MinBlockUnits, n, list);  }
+
+   //!Caches the buffers linked through their first bytes in "list" in their bins
+   //!and deallocates the rest. Used by the thread caches of segment managers
+   void deallocate_bin_list(void *list)
+   {  this->priv_bin_deallocate(list);  }
+   /// @endcond
+
    //!Returns true if all allocated memory has been deallocated
    bool all_memory_deallocated();
 
@@ -232,6 +345,12 @@ class rbtree_best_fit
    //!and returns true if success
    bool check_sanity();
 
+   //!Fills "stats" traversing all blocks of the segment once, with the memory
+   //!algorithm locked. Blocks cached in bins are counted as free blocks. Blocks
+   //!cached by thread caches are counted as allocated blocks, and they are
+   //!counted as allocations and deallocations when they enter or leave a cache.
+   void get_stats(stats_type &stats);
+
    template<class T>
    std::pair<T *, bool>
       allocation_command  (boost::interprocess::allocation_type command,   size_type limit_size,
@@ -325,16 +444,41 @@ class rbtree_best_fit
    void priv_mark_as_free_block(block_ctrl *ptr);
 
    //!Checks if block has enough memory and splits/unlinks the block
-   //!returning the address to the users
+   //!returning the address to the users. If "zero_memory" is true
+   //!the user buffer is cleared.
    void* priv_check_and_allocate(size_type units
                                 ,block_ctrl* block
-                                ,size_type &received_size);
+                                ,size_type &received_size
+                                ,bool zero_memory = false);
    //!Real deallocation algorithm
    void priv_deallocate(void *addr);
 
    //!Makes a new memory portion available for allocation
    void priv_add_segment(void *addr, size_type size);
 
+   //!Returns true if blocks of "units" units belong to a size class
+   static bool priv_is_bin_units(size_type units);
+
+   //!Returns the link to the next block of a block in a bin
+   static size_type &priv_bin_link(block_ctrl *block);
+
+   //!Obtains up to "n" blocks of the size class "bin", linked through their
+   //!user buffers in "list". When the bin is empty a batch of blocks is carved
+   //!from the tree and the blocks not returned are cached in the bin.
+   //!Returns the number of blocks obtained.
+   size_type priv_bin_allocate(size_type bin, size_type n, void *&list);
+
+   //!Caches the blocks linked through their user buffers in "list" in bins
+   //!and returns to the tree the blocks that don't fit in them
+   void priv_bin_deallocate(void *list);
+
+   //!Returns all blocks cached in bins to the tree. The tree must be locked.
+   //!Returns true if any block was returned.
+   bool priv_flush_bins();
+
+   //!Returns the number of bytes cached in bins
+   size_type priv_bin_free_bytes() const;
+
    public:
 
    static const size_type Alignment = !MemAlignment
@@ -454,6 +598,15 @@ inline rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::
    m_header.m_allocated       = 0;
    m_header.m_size            = segment_size;
    m_header.m_extra_hdr_bytes = extra_hdr_bytes;
+   m_header.m_num_allocations   = 0;
+   m_header.m_num_deallocations = 0;
+   m_header.m_bin_capacity      = 0;
+   for(size_type i = 0; i != NumBins; ++i){
+      m_header.m_bins[i].m_first = 0;
+      m_header.m_bins[i].m_count = 0;
+      m_header.m_bins[i].m_allocations   = 0;
+      m_header.m_bins[i].m_deallocations = 0;
+   }
 
    //Now write calculate the offset of the first big block that will
    //cover the whole segment
@@ -483,7 +636,7 @@ void rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::grow(size_type ext
    m_header.m_size += extra_size;
 
    //We need at least MinBlockUnits blocks to create a new block
-   if((m_header.m_size - old_border_offset) < MinBlockUnits){
+   if((m_header.m_size - old_border_offset) < MinBlockUnits*Alignment){
       return;
    }
 
@@ -524,6 +677,9 @@ void rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::grow(size_type ext
 template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
 void rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::shrink_to_fit()
 {
+   //Cached blocks could be placed at the end of the segment
+   this->priv_flush_bins();
+
    //Get the address of the first block
    block_ctrl *first_block = priv_first_block();
    algo_impl_t::assert_alignment(first_block);
@@ -601,8 +757,10 @@ template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
 typename rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::size_type
 rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::get_free_memory()  const
 {
+   //Blocks cached in bins are free for the user
    return m_header.m_size - m_header.m_allocated -
-      priv_first_block_offset_from_this(this, m_header.m_extra_hdr_bytes);
+      priv_first_block_offset_from_this(this, m_header.m_extra_hdr_bytes) +
+      this->priv_bin_free_bytes();
 }
 
 template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
@@ -610,8 +768,9 @@ typename rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::size_type
 rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::
    get_min_size (size_type extra_hdr_bytes)
 {
-   return (algo_impl_t::ceil_units(sizeof(rbtree_best_fit)) +
-           algo_impl_t::ceil_units(extra_hdr_bytes) +
+   //The first block is placed after the header and the extra bytes,
+   //rounded together, as priv_first_block_offset_from_this does
+   return (algo_impl_t::ceil_units(sizeof(rbtree_best_fit) + extra_hdr_bytes) +
            MinBlockUnits + EndCtrlBlockUnits)*Alignment;
 }
 
@@ -622,6 +781,7 @@ inline bool rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::
    //-----------------------
    boost::interprocess::scoped_lock<mutex_type> guard(m_header);
    //-----------------------
+   this->priv_flush_bins();
    size_type block1_off  =
       priv_first_block_offset_from_this(this, m_header.m_extra_hdr_bytes);
 
@@ -663,18 +823,96 @@ bool rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::
    if(free_memory > (m_header.m_size - block1_off)){
       return false;
    }
+
+   //Check cached blocks are allocated and belong to their size class
+   //-----------------------
+   bins_lock bins_guard(m_header);
+   //-----------------------
+   for(size_type i = 0; i != NumBins; ++i){
+      size_type count = 0;
+      for(size_type off = m_header.m_bins[i].m_first; off; ++count){
+         block_ctrl *block = reinterpret_cast<block_ctrl*>(reinterpret_cast<char*>(this) + off);
+         if(!algo_impl_t::check_alignment(block) || !block->m_allocated ||
+            block->m_size != MinBlockUnits + i){
+            return false;
+         }
+         off = priv_bin_link(block);
+      }
+      if(count != m_header.m_bins[i].m_count){
+         return false;
+      }
+   }
    return true;
 }
 
+template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
+void rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::get_stats(stats_type &stats)
+{
+   stats.clear();
+   //-----------------------
+   boost::interprocess::scoped_lock<mutex_type> guard(m_header);
+   //-----------------------
+   //Bins are locked so that cached blocks don't change during the traversal
+   //-----------------------
+   bins_lock bins_guard(m_header);
+   //-----------------------
+   stats.segment_size  = m_header.m_size;
+   stats.allocations   = m_header.m_num_allocations;
+   stats.deallocations = m_header.m_num_deallocations;
+   for(size_type i = 0; i != NumBins; ++i){
+      stats.allocations   += m_header.m_bins[i].m_allocations;
+      stats.deallocations += m_header.m_bins[i].m_deallocations;
+   }
+
+   block_ctrl *const end_block = priv_end_block();
+   for(block_ctrl *block = priv_first_block(); block != end_block; block = priv_next_block(block)){
+      algo_impl_t::add_block_to_stats
+         ( stats, (size_type)block->m_size*Alignment
+         , ((size_type)block->m_size - AllocatedCtrlUnits)*Alignment + UsableByPreviousChunk
+         , priv_is_allocated_block(block));
+   }
+
+   //Blocks cached in bins are marked as allocated, but they are free
+   for(size_type i = 0; i != NumBins; ++i){
+      const size_type count = m_header.m_bins[i].m_count;
+      if(count){
+         const size_type block_bytes = (MinBlockUnits + i)*Alignment;
+         const size_type user_bytes  = block_bytes - AllocatedCtrlBytes + UsableByPreviousChunk;
+         const std::size_t size_class = stats_type::size_class(block_bytes);
+         stats.allocated_blocks -= count;
+         stats.allocated_histogram[size_class] -= count;
+         stats.allocated_bytes -= count*user_bytes;
+         stats.free_blocks += count;
+         stats.free_histogram[size_class] += count;
+         stats.free_bytes += count*block_bytes;
+         if(user_bytes > stats.largest_free_block){
+            stats.largest_free_block = user_bytes;
+         }
+      }
+   }
+   algo_impl_t::complete_stats(stats);
+}
+
 template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
 inline void* rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::
    allocate(size_type nbytes)
 {
+   //Small blocks are served from bins without locking the tree
+   if(m_header.m_bin_capacity && nbytes <= get_max_bin_size()){
+      void *list;
+      return priv_bin_allocate(priv_get_total_units(nbytes) - MinBlockUnits, 1, list) ? list : 0;
+   }
    //-----------------------
    boost::interprocess::scoped_lock<mutex_type> guard(m_header);
    //-----------------------
    size_type ignore;
    void * ret = priv_allocate(boost::interprocess::allocate_new, nbytes, nbytes, ignore).first;
+   if(!ret && this->priv_flush_bins()){
+      ret = priv_allocate(boost::interprocess::allocate_new, nbytes, nbytes, ignore).first;
+   }
+   if(ret){
+      ++m_header.m_num_allocations;
+   }
    return ret;
 }
 
@@ -685,7 +923,14 @@ inline void* rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::
    //-----------------------
    boost::interprocess::scoped_lock<mutex_type> guard(m_header);
    //-----------------------
-   return algo_impl_t::allocate_aligned(this, nbytes, alignment);
+   void *ret = algo_impl_t::allocate_aligned(this, nbytes, alignment);
+   if(!ret && this->priv_flush_bins()){
+      ret = algo_impl_t::allocate_aligned(this, nbytes, alignment);
+   }
+   if(ret){
+      ++m_header.m_num_allocations;
+   }
+   return ret;
 }
 
 template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
@@ -741,6 +986,13 @@ inline std::pair<void*, bool> rbtree_best_fit<MutexFamily, VoidPointer, MemAlign
       boost::interprocess::scoped_lock<mutex_type> guard(m_header);
       //-----------------------
       ret = priv_allocate(command, l_size, p_size, r_size, reuse_ptr, sizeof_object);
+      if(!ret.first && this->priv_flush_bins()){
+         ret = priv_allocate(command, l_size, p_size, r_size, reuse_ptr, sizeof_object);
+      }
+      //Expansions don't allocate a new block
+      if(ret.first && !ret.second){
+         ++m_header.m_num_allocations;
+      }
    }
    received_size = r_size/sizeof_object;
    return ret;
@@ -763,22 +1015,42 @@ inline void rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::zero_free_m
    //-----------------------
    boost::interprocess::scoped_lock<mutex_type> guard(m_header);
    //-----------------------
+   //Cached blocks are not in use, so they must be cleared too
+   this->priv_flush_bins();
    imultiset_iterator ib(m_header.m_imultiset.begin()), ie(m_header.m_imultiset.end());
+   const std::size_t page_size = mapped_region::get_page_size();
 
    //Iterate through all blocks obtaining their size
-   while(ib != ie){
-      //Just clear user the memory part reserved for the user
-      volatile char *ptr = reinterpret_cast<char*>(&*ib) + BlockCtrlBytes;
-      size_type s = (size_type)ib->m_size*Alignment - BlockCtrlBytes;
-      while(s--){
-         *ptr++ = 0;
+   for(; ib != ie; ++ib){
+      //Blocks that have not been written since they were cleared are skipped
+      if(ib->m_zeroed){
+         continue;
       }
+      //Just clear user the memory part reserved for the user
+      char *const beg = reinterpret_cast<char*>(&*ib) + BlockCtrlBytes;
+      algo_impl_t::zero_free_range(beg, beg + ((size_type)ib->m_size*Alignment - BlockCtrlBytes), page_size);
+      ib->m_zeroed = 1;
+   }
+}
 
-      //This surprisingly is optimized out by Visual C++ 7.1 in release mode!
-      //std::memset( reinterpret_cast<char*>(&*ib) + BlockCtrlBytes
-      //           , 0
-      //           , ib->m_size*Alignment - BlockCtrlBytes);
-      ++ib;
+template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
+inline void rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::mark_free_memory_zeroed()
+{
+   //-----------------------
+   boost::interprocess::scoped_lock<mutex_type> guard(m_header);
+   //-----------------------
+   //Freed blocks might hold the contents of old allocations
+   if(m_header.m_num_allocations){
+      return;
+   }
+   for(size_type i = 0; i != NumBins; ++i){
+      if(m_header.m_bins[i].m_allocations){
+         return;
+      }
+   }
+   imultiset_iterator ib(m_header.m_imultiset.begin()), ie(m_header.m_imultiset.end());
+   for(; ib != ie; ++ib){
+      ib->m_zeroed = 1;
    }
 }
 
@@ -932,6 +1204,7 @@ inline void rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::
    //-----------------------
    boost::interprocess::scoped_lock<mutex_type> guard(m_header);
    //-----------------------
+   m_header.m_num_deallocations += chain.size();
    algo_impl_t::deallocate_many(this, chain);
 }
 
@@ -976,16 +1249,17 @@ std::pair<void *, bool> rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>:
    if(command & boost::interprocess::allocate_new){
       size_block_ctrl_compare comp;
       imultiset_iterator it(m_header.m_imultiset.lower_bound(preferred_units, comp));
+      const bool zero_memory = 0 != (command & boost::interprocess::zero_memory);
 
       if(it != m_header.m_imultiset.end()){
          return return_type(this->priv_check_and_allocate
-            (preferred_units, ipcdetail::to_raw_pointer(&*it), received_size), false);
+            (preferred_units, ipcdetail::to_raw_pointer(&*it), received_size, zero_memory), false);
       }
 
       if(it != m_header.m_imultiset.begin()&&
               (--it)->m_size >= limit_units){
          return return_type(this->priv_check_and_allocate
-            (it->m_size, ipcdetail::to_raw_pointer(&*it), received_size), false);
+            (it->m_size, ipcdetail::to_raw_pointer(&*it), received_size, zero_memory), false);
       }
    }
 
@@ -1086,6 +1360,8 @@ bool rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::
       //the second's size will be the remaining space
       BOOST_ASSERT(next_block->m_size == priv_next_block(next_block)->m_prev_size);
       const size_type rem_units = merged_units - intended_units;
+      const bool next_zeroed = next_block->m_zeroed;
+      block_ctrl *relay = 0;
 
       //Check if we we need to update the old next block in the free blocks tree
       //If the new size fulfills tree invariants, we just need to replace the node
@@ -1095,10 +1371,25 @@ bool rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::
       //overwrite the tree hook of the old next block. So we first erase the
       //old if needed and we'll insert the new one after creating the new next
       imultiset_iterator old_next_block_it(Imultiset::s_iterator_to(*next_block));
-      const bool size_invariants_broken =
-            (next_block->m_size - rem_units ) < BlockCtrlUnits ||
+      bool size_invariants_broken =
             (old_next_block_it != m_header.m_imultiset.begin() &&
             (--imultiset_iterator(old_next_block_it))->m_size > rem_units);
+      //Small expansions of the last allocation of a growing buffer place the new
+      //next block over the hook of the old one. Instead of erase() + insert(),
+      //the old node is first replaced by a relay node placed after the header of
+      //the new next block, so that the fixup is O(1) no matter the tree size.
+      if(!size_invariants_broken && (next_block->m_size - rem_units) < BlockCtrlUnits){
+         if(rem_units >= 2*BlockCtrlUnits){
+            relay = new(reinterpret_cast<block_ctrl*>
+               (reinterpret_cast<char*>(block) + (intended_units + BlockCtrlUnits)*Alignment))block_ctrl;
+            relay->m_size = rem_units;
+            m_header.m_imultiset.replace_node(old_next_block_it, *relay);
+            old_next_block_it = Imultiset::s_iterator_to(*relay);
+         }
+         else{
+            size_invariants_broken = true;
+         }
+      }
       if(size_invariants_broken){
          m_header.m_imultiset.erase(old_next_block_it);
       }
@@ -1106,6 +1397,7 @@ bool rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::
       block_ctrl *rem_block = new(reinterpret_cast<block_ctrl*>
                      (reinterpret_cast<char*>(block) + intended_units*Alignment))block_ctrl;
       rem_block->m_size  = rem_units;
+      rem_block->m_zeroed = next_zeroed;
       algo_impl_t::assert_alignment(rem_block);
       BOOST_ASSERT(rem_block->m_size >= BlockCtrlUnits);
       priv_mark_as_free_block(rem_block);
@@ -1115,6 +1407,10 @@ bool rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::
          m_header.m_imultiset.insert(m_header.m_imultiset.begin(), *rem_block);
       else
          m_header.m_imultiset.replace_node(old_next_block_it, *rem_block);
+      //The relay node is placed in the zeroed memory of the new next block
+      if(relay && next_zeroed){
+         std::memset(static_cast<void*>(relay), 0, sizeof(block_ctrl));
+      }
 
       //Write the new length
       block->m_size = intended_user_units + AllocatedCtrlUnits;
@@ -1257,8 +1553,10 @@ template<class MutexFamily, class VoidPointer, std::size_t MemAlignment> inline
 void* rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::priv_check_and_allocate
    (size_type nunits
    ,typename rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::block_ctrl* block
-   ,size_type &received_size)
+   ,size_type &received_size
+   ,bool zero_memory)
 {
+   const bool zeroed = block->m_zeroed;
    size_type upper_nunits = nunits + BlockCtrlUnits;
    imultiset_iterator it_old = Imultiset::s_iterator_to(*block);
    algo_impl_t::assert_alignment(block);
@@ -1276,6 +1574,7 @@ void* rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::priv_check_and_al
                      (reinterpret_cast<char*>(block) + Alignment*nunits))block_ctrl;
       algo_impl_t::assert_alignment(rem_block);
       rem_block->m_size  = block_old_size - nunits;
+      rem_block->m_zeroed = zeroed;
       BOOST_ASSERT(rem_block->m_size >= BlockCtrlUnits);
       priv_mark_as_free_block(rem_block);
 
@@ -1322,16 +1621,27 @@ void* rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::priv_check_and_al
    const std::size_t s = BlockCtrlBytes - tree_hook_offset_in_block;
    std::memset(ptr, 0, s);
    this->priv_next_block(block)->m_prev_size = 0;
-   return priv_get_user_buffer(block);
+   void *user_buffer = priv_get_user_buffer(block);
+   //The rest of the buffer of a zeroed block is already clear
+   if(zero_memory && !zeroed){
+      std::memset(user_buffer, 0, received_size);
+   }
+   return user_buffer;
 }
 
 template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
 void rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::deallocate(void* addr)
 {
    if(!addr)   return;
+   //Small blocks are cached in bins without locking the tree
+   if(m_header.m_bin_capacity && priv_is_bin_units(priv_get_block(addr)->m_size)){
+      *static_cast<void**>(addr) = 0;
+      return this->priv_bin_deallocate(addr);
+   }
    //-----------------------
    boost::interprocess::scoped_lock<mutex_type> guard(m_header);
    //-----------------------
+   ++m_header.m_num_deallocations;
    return this->priv_deallocate(addr);
 }
 
@@ -1400,9 +1710,231 @@ void rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::priv_deallocate(vo
    else{
       m_header.m_imultiset.insert(m_header.m_imultiset.begin(), *block_to_insert);
    }
+   block_to_insert->m_zeroed = 0;
    priv_mark_as_free_block(block_to_insert);
 }
 
+template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
+inline void rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::set_bin_capacity(size_type max_blocks)
+{
+   //-----------------------
+   boost::interprocess::scoped_lock<mutex_type> guard(m_header);
+   //-----------------------
+   {
+      //-----------------------
+      bins_lock bins_guard(m_header);
+      //-----------------------
+      m_header.m_bin_capacity = max_blocks;
+   }
+   //Bins could hold more blocks than the new capacity
+   this->priv_flush_bins();
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
+inline typename rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::size_type
+   rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::get_bin_capacity() const
+{  return m_header.m_bin_capacity;  }
+
+template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
+inline typename rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::size_type
+   rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::get_max_bin_size()
+{  return (MinBlockUnits + NumBins - 1 - AllocatedCtrlUnits)*Alignment + UsableByPreviousChunk;  }
+
+template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
+inline bool rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::priv_is_bin_units(size_type units)
+{  return units >= MinBlockUnits && units < (MinBlockUnits + NumBins);  }
+
+template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
+inline typename rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::size_type &
+   rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::priv_bin_link(block_ctrl *block)
+{
+   //The link is an offset from the memory algorithm, which
+   //is valid in all processes that map the segment
+   return *static_cast<size_type*>(priv_get_user_buffer(block));
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
+typename rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::size_type
+   rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::priv_bin_allocate(size_type bin, size_type n, void *&list)
+{
+   size_type count = 0;
+   list = 0;
+   if(m_header.m_bin_capacity){
+      bin_t &b = m_header.m_bins[bin];
+      //-----------------------
+      boost::interprocess::scoped_lock<mutex_type> bin_guard(b.m_mutex);
+      //-----------------------
+      for(; count != n && b.m_first; ++count){
+         block_ctrl *block = reinterpret_cast<block_ctrl*>(reinterpret_cast<char*>(this) + b.m_first);
+         b.m_first = priv_bin_link(block);
+         priv_bin_link(block) = 0;
+         --b.m_count;
+         void *user = priv_get_user_buffer(block);
+         *static_cast<void**>(user) = list;
+         list = user;
+      }
+      b.m_allocations += count;
+   }
+   if(count){
+      return count;
+   }
+
+   //The bin is empty, carve a batch of blocks of the size class from a single
+   //free block. Unlike allocate_many, unused memory is not returned to the tree,
+   //so blocks are only written when they are allocated, like single blocks.
+   const size_type units = MinBlockUnits + bin;
+   //-----------------------
+   boost::interprocess::scoped_lock<mutex_type> guard(m_header);
+   //-----------------------
+   const size_type capacity = m_header.m_bin_capacity;
+   //Try a whole batch, then the requested blocks and then a single block, so
+   //that a refill never takes the last free block if a smaller one is enough
+   const size_type num_blocks[] =
+      { n + (capacity < BinRefillBlocks ? capacity : BinRefillBlocks), n, 1 };
+   void *ret = 0;
+   size_type ignore;
+   for(size_type i = 0; !ret && i != sizeof(num_blocks)/sizeof(num_blocks[0]); ++i){
+      const size_type nbytes = (num_blocks[i]*units - AllocatedCtrlUnits)*Alignment + UsableByPreviousChunk;
+      ret = priv_allocate(boost::interprocess::allocate_new, nbytes, nbytes, ignore).first;
+   }
+   if(!ret && this->priv_flush_bins()){
+      const size_type nbytes = (units - AllocatedCtrlUnits)*Alignment + UsableByPreviousChunk;
+      ret = priv_allocate(boost::interprocess::allocate_new, nbytes, nbytes, ignore).first;
+   }
+   if(!ret){
+      return 0;
+   }
+
+   block_ctrl *block = priv_get_block(ret);
+   char *addr = reinterpret_cast<char*>(block);
+   size_type remaining_units = block->m_size;
+   void *rejected = 0;
+   bin_t &b = m_header.m_bins[bin];
+   //-----------------------
+   boost::interprocess::scoped_lock<mutex_type> bin_guard(b.m_mutex);
+   //-----------------------
+   while(remaining_units){
+      //The first block takes the units that can't form a whole block
+      block_ctrl *piece = reinterpret_cast<block_ctrl*>(addr);
+      const size_type piece_units = units + remaining_units % units;
+      if(piece != block){
+         //The tail of the previous block and the tree hook are
+         //cleared as priv_check_and_allocate does with "block"
+         piece->m_prev_size = 0;
+         char *hook = reinterpret_cast<char*>(static_cast<TreeHook*>(piece));
+         std::memset(hook, 0, BlockCtrlBytes - (hook - addr));
+      }
+      piece->m_size = piece_units;
+      priv_mark_new_allocated_block(piece);
+
+      void *user = priv_get_user_buffer(piece);
+      if(count != n){
+         *static_cast<void**>(user) = list;
+         list = user;
+         ++count;
+      }
+      else if(piece_units == units && b.m_count < capacity){
+         priv_bin_link(piece) = b.m_first;
+         b.m_first = (size_type)(addr - reinterpret_cast<char*>(this));
+         ++b.m_count;
+      }
+      else{
+         *static_cast<void**>(user) = rejected;
+         rejected = user;
+      }
+      addr += piece_units*Alignment;
+      remaining_units -= piece_units;
+   }
+   b.m_allocations += count;
+   while(rejected){
+      void *next = *static_cast<void**>(rejected);
+      this->priv_deallocate(rejected);
+      rejected = next;
+   }
+   return count;
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
+void rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::priv_bin_deallocate(void *list)
+{
+   void *rejected = 0;
+   if(m_header.m_bin_capacity){
+      //Consecutive blocks of the same size class are cached locking their bin once
+      bin_t *locked = 0;
+      while(list){
+         void *next = *static_cast<void**>(list);
+         block_ctrl *block = priv_get_block(list);
+         const size_type units = block->m_size;
+         bin_t *b = priv_is_bin_units(units) ? &m_header.m_bins[units - MinBlockUnits] : 0;
+         if(b != locked){
+            if(locked)  locked->m_mutex.unlock();
+            if(b)       b->m_mutex.lock();
+            locked = b;
+         }
+         if(b && b->m_count < m_header.m_bin_capacity){
+            priv_bin_link(block) = b->m_first;
+            b->m_first = (size_type)(reinterpret_cast<char*>(block) - reinterpret_cast<char*>(this));
+            ++b->m_count;
+            ++b->m_deallocations;
+         }
+         else{
+            *static_cast<void**>(list) = rejected;
+            rejected = list;
+         }
+         list = next;
+      }
+      if(locked)  locked->m_mutex.unlock();
+   }
+   else{
+      rejected = list;
+   }
+
+   if(rejected){
+      //-----------------------
+      boost::interprocess::scoped_lock<mutex_type> guard(m_header);
+      //-----------------------
+      while(rejected){
+         void *next = *static_cast<void**>(rejected);
+         this->priv_deallocate(rejected);
+         ++m_header.m_num_deallocations;
+         rejected = next;
+      }
+   }
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
+bool rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::priv_flush_bins()
+{
+   bool flushed = false;
+   for(size_type i = 0; i != NumBins; ++i){
+      bin_t &b = m_header.m_bins[i];
+      //-----------------------
+      boost::interprocess::scoped_lock<mutex_type> bin_guard(b.m_mutex);
+      //-----------------------
+      while(b.m_first){
+         block_ctrl *block = reinterpret_cast<block_ctrl*>(reinterpret_cast<char*>(this) + b.m_first);
+         //Read the link before the block is merged
+         b.m_first = priv_bin_link(block);
+         this->priv_deallocate(priv_get_user_buffer(block));
+         flushed = true;
+      }
+      b.m_count = 0;
+   }
+   return flushed;
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t MemAlignment>
+typename rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::size_type
+   rbtree_best_fit<MutexFamily, VoidPointer, MemAlignment>::priv_bin_free_bytes() const
+{
+   //No synchronization, the result is just a hint if bins are being used
+   size_type bytes = 0;
+   for(size_type i = 0; i != NumBins; ++i){
+      bytes += m_header.m_bins[i].m_count*(MinBlockUnits + i)*Alignment;
+   }
+   return bytes;
+}
+
 /// @endcond
 
 }  //namespace interprocess {
@@ -0,0 +1,561 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOST_INTERPROCESS_MEM_ALGO_SHARDED_BEST_FIT_HPP
+#define BOOST_INTERPROCESS_MEM_ALGO_SHARDED_BEST_FIT_HPP
+
+#if (defined _MSC_VER) && (_MSC_VER >= 1200)
+#  pragma once
+#endif
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/detail/workaround.hpp>
+
+#include <boost/interprocess/interprocess_fwd.hpp>
+#include <boost/interprocess/mem_algo/rbtree_best_fit.hpp>
+#include <boost/interprocess/containers/allocation_type.hpp>
+#include <boost/container/detail/multiallocation_chain.hpp>
+#include <boost/interprocess/offset_ptr.hpp>
+#include <boost/interprocess/detail/utilities.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <utility>
+#include <new>
+
+//!\file
+//!Describes a memory algorithm that places several rbtree_best_fit arenas,
+//!each one with its own mutex, in a shared rbtree_best_fit arena.
+
+namespace boost {
+namespace interprocess {
+
+//!This class implements a memory algorithm made of a shared rbtree_best_fit
+//!arena that manages the whole segment and up to NumArenas thread arenas,
+//!rbtree_best_fit algorithms placed in blocks allocated from the shared arena
+//!when the segment is created. Each arena has its own mutex. A thread
+//!allocates small buffers from the thread arena selected by a hash of its
+//!process and thread ids, and large buffers from the shared arena. When an
+//!arena is exhausted the rest of arenas are tried in order, so an allocation
+//!only fails if no arena can hold it. Deallocations are routed to the arena
+//!that contains the address. Thread arenas take up to half of the segment and
+//!segments too small for NumArenas arenas of MinArenaSize bytes use less arenas.
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+class sharded_best_fit
+{
+   /// @cond
+   //Non-copyable
+   sharded_best_fit();
+   sharded_best_fit(const sharded_best_fit &);
+   sharded_best_fit &operator=(const sharded_best_fit &);
+   BOOST_STATIC_ASSERT((NumArenas > 0));
+   /// @endcond
+
+   public:
+   //!Memory algorithm that manages each arena
+   typedef rbtree_best_fit<MutexFamily, VoidPointer>              arena_type;
+   //!Shared mutex family used for the rest of the Interprocess framework
+   typedef MutexFamily        mutex_family;
+   //!Pointer type to be used with the rest of the Interprocess framework
+   typedef VoidPointer        void_pointer;
+   typedef typename arena_type::multiallocation_chain             multiallocation_chain;
+   typedef typename arena_type::difference_type                   difference_type;
+   typedef typename arena_type::size_type                         size_type;
+   //!Statistics returned by get_stats()
+   typedef typename arena_type::stats_type                        stats_type;
+
+   //!Minimum size of a thread arena
+   static const size_type MinArenaSize = 64*1024;
+
+   //!Requests bigger than the size of a thread arena divided
+   //!by LargeRequestRatio are served by the shared arena first
+   static const size_type LargeRequestRatio = 8;
+
+   //!Constructor. "size" is the total size of the managed memory segment,
+   //!"extra_hdr_bytes" indicates the extra bytes beginning in the sizeof(sharded_best_fit)
+   //!offset that the allocator should not use at all.
+   sharded_best_fit           (size_type size, size_type extra_hdr_bytes);
+
+   //!Destructor.
+   ~sharded_best_fit();
+
+   //!Obtains the minimum size needed by the algorithm
+   static size_type get_min_size (size_type extra_hdr_bytes);
+
+   //!Allocates bytes, returns 0 if there is not more memory
+   void* allocate             (size_type nbytes);
+
+   /// @cond
+
+   //Experimental. Dont' use
+
+   //!Multiple element allocation, same size
+   void allocate_many(size_type elem_bytes, size_type num_elements, multiallocation_chain &chain);
+
+   //!Multiple element allocation, different size
+   void allocate_many(const size_type *elem_sizes, size_type n_elements, size_type sizeof_element, multiallocation_chain &chain);
+
+   //!Multiple element deallocation
+   void deallocate_many(multiallocation_chain &chain);
+
+   /// @endcond
+
+   //!Deallocates previously allocated bytes
+   void   deallocate          (void *addr);
+
+   //!Returns the size of the memory segment
+   size_type get_size()  const;
+
+   //!Returns the number of free bytes of the segment
+   size_type get_free_memory()  const;
+
+   //!Initializes to zero all the memory that's not in use. Whole free pages
+   //!are returned to the operating system instead of being written, if it's
+   //!able to do it. This function is normally used for security reasons.
+   void zero_free_memory();
+
+   //!Increases managed memory in extra_size bytes more.
+   //!The shared arena receives the new memory.
+   void grow(size_type extra_size);
+
+   //!Decreases managed memory as much as possible.
+   //!Only the shared arena is shrunk.
+   void shrink_to_fit();
+
+   //!Calls set_bin_capacity(max_blocks) in every arena
+   void set_bin_capacity(size_type max_blocks);
+
+   //!Returns the maximum number of free blocks cached for each size class
+   size_type get_bin_capacity() const;
+
+   //!Returns true if all allocated memory has been deallocated
+   bool all_memory_deallocated();
+
+   //!Makes an internal sanity check
+   //!and returns true if success
+   bool check_sanity();
+
+   //!Fills "stats" adding the statistics of all arenas. Each arena
+   //!is locked only while its blocks are traversed. The blocks
+   //!that hold the thread arenas are not counted as allocated.
+   void get_stats(stats_type &stats);
+
+   template<class T>
+   std::pair<T *, bool>
+      allocation_command  (boost::interprocess::allocation_type command,   size_type limit_size,
+                           size_type preferred_size,size_type &received_size,
+                           T *reuse_ptr = 0);
+
+   std::pair<void *, bool>
+     raw_allocation_command  (boost::interprocess::allocation_type command,   size_type limit_object,
+                              size_type preferred_object,size_type &received_object,
+                              void *reuse_ptr = 0, size_type sizeof_object = 1);
+
+   //!Returns the size of the buffer previously allocated pointed by ptr
+   size_type size(const void *ptr) const;
+
+   //!Allocates aligned bytes, returns 0 if there is not more memory.
+   //!Alignment must be power of 2
+   void* allocate_aligned     (size_type nbytes, size_type alignment);
+
+   //!Returns the number of thread arenas of the segment
+   size_type get_num_arenas() const;
+
+   //!Returns the index of the thread arena the calling thread allocates
+   //!small buffers from. If there are no thread arenas, returns the index
+   //!of the shared arena
+   size_type get_thread_arena() const;
+
+   //!Returns the index of the arena that contains the address "ptr".
+   //!Thread arenas have indexes from 0 to get_num_arenas() - 1 and the
+   //!shared arena has index get_num_arenas()
+   size_type get_arena_index(const void *ptr) const;
+
+   //!Returns the memory algorithm of the arena "index"
+   arena_type &get_arena(size_type index);
+
+   /// @cond
+   private:
+   static size_type priv_shared_arena_offset(size_type extra_hdr_bytes);
+   arena_type *priv_arena(size_type index) const;
+   size_type priv_first_arena(size_type nbytes) const;
+
+   size_type m_extra_hdr_bytes;
+   size_type m_size;
+   size_type m_arena_size;
+   size_type m_num_arenas;
+   //Offsets from this of the thread arenas
+   size_type m_arena_offsets[NumArenas];
+   /// @endcond
+
+   public:
+   static const size_type Alignment = arena_type::Alignment;
+   static const size_type PayloadPerAllocation = arena_type::PayloadPerAllocation;
+};
+
+/// @cond
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline typename sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::size_type
+   sharded_best_fit<MutexFamily, VoidPointer, NumArenas>
+      ::priv_shared_arena_offset(size_type extra_hdr_bytes)
+{
+   return ipcdetail::get_rounded_size
+      (size_type(sizeof(sharded_best_fit) + extra_hdr_bytes), Alignment);
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline typename sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::arena_type *
+   sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::priv_arena(size_type index) const
+{
+   BOOST_ASSERT(index <= m_num_arenas);
+   char *const this_ptr = const_cast<char*>(reinterpret_cast<const char*>(this));
+   return reinterpret_cast<arena_type*>(this_ptr + (index == m_num_arenas
+      ? priv_shared_arena_offset(m_extra_hdr_bytes) : m_arena_offsets[index]));
+}
+
+//Large requests would fragment thread arenas and fill them soon
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline typename sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::size_type
+   sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::priv_first_arena(size_type nbytes) const
+{
+   return nbytes > m_arena_size/LargeRequestRatio ? m_num_arenas : this->get_thread_arena();
+}
+
+/// @endcond
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::
+   sharded_best_fit(size_type segment_size, size_type extra_hdr_bytes)
+   :  m_extra_hdr_bytes(extra_hdr_bytes), m_size(segment_size), m_arena_size(0), m_num_arenas(0)
+{
+   BOOST_ASSERT(get_min_size(extra_hdr_bytes) <= segment_size);
+   arena_type *const shared = ::new(priv_arena(0)) arena_type
+      (segment_size - priv_shared_arena_offset(extra_hdr_bytes), 0);
+
+   //Thread arenas take up to half of the free memory.
+   //Use less arenas if they would be too small
+   const size_type arenas_size = shared->get_free_memory()/2;
+   size_type num_arenas = NumArenas;
+   while(num_arenas && arenas_size/num_arenas < MinArenaSize){
+      --num_arenas;
+   }
+   if(!num_arenas){
+      return;
+   }
+   m_arena_size = arenas_size/num_arenas/Alignment*Alignment;
+   for(size_type i = 0; i != num_arenas; ++i){
+      void *const addr = shared->allocate(m_arena_size);
+      if(!addr){
+         break;
+      }
+      m_arena_offsets[i] = size_type(static_cast<char*>(addr) - reinterpret_cast<char*>(this));
+      ::new(addr) arena_type(shared->size(addr), 0);
+      ++m_num_arenas;
+   }
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::~sharded_best_fit()
+{
+   for(size_type i = 0; i != m_num_arenas; ++i){
+      priv_arena(i)->~arena_type();
+   }
+   priv_arena(m_num_arenas)->~arena_type();
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline typename sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::size_type
+   sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::get_min_size(size_type extra_hdr_bytes)
+{
+   return priv_shared_arena_offset(extra_hdr_bytes) +
+          ipcdetail::get_rounded_size(arena_type::get_min_size(0), Alignment);
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline typename sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::size_type
+   sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::get_num_arenas() const
+{  return m_num_arenas;  }
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline typename sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::size_type
+   sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::get_thread_arena() const
+{
+   if(m_num_arenas <= 1){
+      return 0;
+   }
+   return size_type(ipcdetail::get_current_thread_hash() % m_num_arenas);
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline typename sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::size_type
+   sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::get_arena_index(const void *ptr) const
+{
+   const char *const p = static_cast<const char*>(ptr);
+   for(size_type i = 0; i != m_num_arenas; ++i){
+      const arena_type *const arena = priv_arena(i);
+      const char *const beg = reinterpret_cast<const char*>(arena);
+      if(beg < p && p < beg + arena->get_size()){
+         return i;
+      }
+   }
+   return m_num_arenas;
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline typename sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::arena_type &
+   sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::get_arena(size_type index)
+{  return *priv_arena(index);  }
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline void* sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::
+   allocate(size_type nbytes)
+{
+   const size_type first = this->priv_first_arena(nbytes);
+   for(size_type i = 0; i <= m_num_arenas; ++i){
+      void *ret = priv_arena((first + i) % (m_num_arenas + 1))->allocate(nbytes);
+      if(ret){
+         return ret;
+      }
+   }
+   return 0;
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline void sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::
+   allocate_many(size_type elem_bytes, size_type num_elements, multiallocation_chain &chain)
+{
+   const size_type first = this->priv_first_arena(elem_bytes*num_elements);
+   const size_type prev_size = chain.size();
+   for(size_type i = 0; i <= m_num_arenas && chain.size() == prev_size; ++i){
+      priv_arena((first + i) % (m_num_arenas + 1))->allocate_many(elem_bytes, num_elements, chain);
+   }
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline void sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::
+   allocate_many(const size_type *elem_sizes, size_type n_elements, size_type sizeof_element, multiallocation_chain &chain)
+{
+   size_type nbytes = 0;
+   for(size_type i = 0; i != n_elements; ++i){
+      nbytes += elem_sizes[i]*sizeof_element;
+   }
+   const size_type first = this->priv_first_arena(nbytes);
+   const size_type prev_size = chain.size();
+   for(size_type i = 0; i <= m_num_arenas && chain.size() == prev_size; ++i){
+      priv_arena((first + i) % (m_num_arenas + 1))->allocate_many(elem_sizes, n_elements, sizeof_element, chain);
+   }
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline void sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::
+   deallocate_many(multiallocation_chain &chain)
+{
+   //Group buffers by owner arena so that each arena is locked once
+   multiallocation_chain arena_chains[NumArenas + 1];
+   while(!chain.empty()){
+      void_pointer ptr = chain.pop_front();
+      arena_chains[this->get_arena_index(ipcdetail::to_raw_pointer(ptr))].push_back(ptr);
+   }
+   for(size_type i = 0; i <= m_num_arenas; ++i){
+      if(!arena_chains[i].empty()){
+         priv_arena(i)->deallocate_many(arena_chains[i]);
+      }
+   }
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline void sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::deallocate(void* addr)
+{
+   if(!addr)   return;
+   priv_arena(this->get_arena_index(addr))->deallocate(addr);
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline typename sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::size_type
+   sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::get_size() const
+{  return m_size;  }
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+typename sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::size_type
+   sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::get_free_memory() const
+{
+   size_type free_memory = 0;
+   for(size_type i = 0; i <= m_num_arenas; ++i){
+      free_memory += priv_arena(i)->get_free_memory();
+   }
+   return free_memory;
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+void sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::zero_free_memory()
+{
+   for(size_type i = 0; i <= m_num_arenas; ++i){
+      priv_arena(i)->zero_free_memory();
+   }
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+void sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::grow(size_type extra_size)
+{
+   priv_arena(m_num_arenas)->grow(extra_size);
+   m_size += extra_size;
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+void sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::shrink_to_fit()
+{
+   arena_type *const shared = priv_arena(m_num_arenas);
+   shared->shrink_to_fit();
+   m_size = priv_shared_arena_offset(m_extra_hdr_bytes) + shared->get_size();
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+void sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::set_bin_capacity(size_type max_blocks)
+{
+   for(size_type i = 0; i <= m_num_arenas; ++i){
+      priv_arena(i)->set_bin_capacity(max_blocks);
+   }
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline typename sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::size_type
+   sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::get_bin_capacity() const
+{  return priv_arena(m_num_arenas)->get_bin_capacity();  }
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+bool sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::all_memory_deallocated()
+{
+   for(size_type i = 0; i != m_num_arenas; ++i){
+      if(!priv_arena(i)->all_memory_deallocated()){
+         return false;
+      }
+   }
+   //The shared arena only holds the thread arenas
+   stats_type stats;
+   priv_arena(m_num_arenas)->get_stats(stats);
+   return stats.allocated_blocks == m_num_arenas;
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+bool sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::check_sanity()
+{
+   arena_type *const shared = priv_arena(m_num_arenas);
+   for(size_type i = 0; i != m_num_arenas; ++i){
+      arena_type *const arena = priv_arena(i);
+      if(!arena->check_sanity() ||
+         arena->get_size() < m_arena_size || shared->size(arena) != arena->get_size()){
+         return false;
+      }
+   }
+   return shared->check_sanity() &&
+          priv_shared_arena_offset(m_extra_hdr_bytes) + shared->get_size() == m_size;
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+void sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::get_stats(stats_type &stats)
+{
+   stats.clear();
+   stats_type arena_stats;
+   for(size_type i = 0; i <= m_num_arenas; ++i){
+      priv_arena(i)->get_stats(arena_stats);
+      stats.free_bytes        += arena_stats.free_bytes;
+      stats.allocated_bytes   += arena_stats.allocated_bytes;
+      stats.free_blocks       += arena_stats.free_blocks;
+      stats.allocated_blocks  += arena_stats.allocated_blocks;
+      stats.allocations       += arena_stats.allocations;
+      stats.deallocations     += arena_stats.deallocations;
+      if(arena_stats.largest_free_block > stats.largest_free_block){
+         stats.largest_free_block = arena_stats.largest_free_block;
+      }
+      for(std::size_t c = 0; c != stats_type::NumSizeClasses; ++c){
+         stats.free_histogram[c]      += arena_stats.free_histogram[c];
+         stats.allocated_histogram[c] += arena_stats.allocated_histogram[c];
+      }
+   }
+   //The blocks of the shared arena that hold thread arenas are not user buffers
+   for(size_type i = 0; i != m_num_arenas; ++i){
+      const size_type arena_size = priv_arena(i)->get_size();
+      stats.allocated_blocks -= 1;
+      stats.allocated_bytes  -= arena_size;
+      stats.allocated_histogram[stats_type::size_class(arena_size + PayloadPerAllocation)] -= 1;
+      stats.allocations      -= 1;
+   }
+   //The headers of the arenas and of the sharded algorithm are overhead
+   stats.segment_size   = m_size;
+   stats.overhead_bytes = m_size - stats.free_bytes - stats.allocated_bytes;
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+template<class T>
+inline std::pair<T*, bool> sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::
+   allocation_command  (boost::interprocess::allocation_type command,   size_type limit_size,
+                        size_type preferred_size,size_type &received_size,
+                        T *reuse_ptr)
+{
+   std::pair<void*, bool> ret = this->raw_allocation_command
+      (command, limit_size, preferred_size, received_size, static_cast<void*>(reuse_ptr), sizeof(T));
+   BOOST_ASSERT(0 == ((std::size_t)ret.first % ::boost::alignment_of<T>::value));
+   return std::pair<T *, bool>(static_cast<T*>(ret.first), ret.second);
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline std::pair<void*, bool> sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::
+   raw_allocation_command  (boost::interprocess::allocation_type command,   size_type limit_objects,
+                        size_type preferred_objects,size_type &received_objects,
+                        void *reuse_ptr, size_type sizeof_object)
+{
+   //Expansions and shrinks are done by the arena that owns the buffer
+   const size_type first = reuse_ptr ? this->get_arena_index(reuse_ptr)
+                                     : this->priv_first_arena(preferred_objects*sizeof_object);
+   std::pair<void*, bool> ret = priv_arena(first)->raw_allocation_command
+      (command, limit_objects, preferred_objects, received_objects, reuse_ptr, sizeof_object);
+   if(ret.first || !(command & boost::interprocess::allocate_new)){
+      return ret;
+   }
+
+   //Other arenas can only allocate new buffers
+   const boost::interprocess::allocation_type new_command = boost::interprocess::allocation_type
+      (command & ~(boost::interprocess::expand_fwd | boost::interprocess::expand_bwd));
+   for(size_type i = 1; i <= m_num_arenas; ++i){
+      ret = priv_arena((first + i) % (m_num_arenas + 1))->raw_allocation_command
+         (new_command, limit_objects, preferred_objects, received_objects, 0, sizeof_object);
+      if(ret.first){
+         return ret;
+      }
+   }
+   return ret;
+}
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline typename sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::size_type
+   sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::size(const void *ptr) const
+{  return priv_arena(this->get_arena_index(ptr))->size(ptr);  }
+
+template<class MutexFamily, class VoidPointer, std::size_t NumArenas>
+inline void* sharded_best_fit<MutexFamily, VoidPointer, NumArenas>::
+   allocate_aligned(size_type nbytes, size_type alignment)
+{
+   const size_type first = this->priv_first_arena(nbytes);
+   for(size_type i = 0; i <= m_num_arenas; ++i){
+      void *ret = priv_arena((first + i) % (m_num_arenas + 1))->allocate_aligned(nbytes, alignment);
+      if(ret){
+         return ret;
+      }
+   }
+   return 0;
+}
+
+}  //namespace interprocess {
+}  //namespace boost {
+
+#include <boost/interprocess/detail/config_end.hpp>
+
+#endif   //#ifndef BOOST_INTERPROCESS_MEM_ALGO_SHARDED_BEST_FIT_HPP
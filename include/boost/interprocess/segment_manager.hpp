@@ -20,6 +20,7 @@
 
 #include <boost/detail/no_exceptions_support.hpp>
 #include <boost/interprocess/detail/type_traits.hpp>
+#include <boost/type_traits/has_trivial_copy.hpp>
 
 #include <boost/interprocess/detail/transform_iterator.hpp>
 
@@ -31,10 +32,16 @@
 #include <boost/interprocess/indexes/iset_index.hpp>
 #include <boost/interprocess/exceptions.hpp>
 #include <boost/interprocess/allocators/allocator.hpp>
+#include <boost/interprocess/mem_algo/memory_algorithm_stats.hpp>
 #include <boost/interprocess/smart_ptr/deleter.hpp>
 #include <boost/move/move.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/intrusive/pointer_traits.hpp>
+#include <boost/static_assert.hpp>
 #include <cstddef>   //std::size_t
+#include <cstring>   //std::memcpy
+#include <algorithm> //std::sort
+#include <functional>   //std::less
 #include <string>    //char_traits
 #include <new>       //std::nothrow
 #include <utility>   //std::pair
@@ -51,6 +58,34 @@
 namespace boost{
 namespace interprocess{
 
+/// @cond
+namespace ipcdetail{
+
+//!Detects memory algorithms that can be told that their free
+//!memory reads as zero, like rbtree_best_fit
+template<class MemoryAlgorithm>
+struct has_mark_free_memory_zeroed
+{
+   template<void (MemoryAlgorithm::*)()> struct helper;
+   template<class T> static char test(helper<&T::mark_free_memory_zeroed> *);
+   template<class T> static int  test(...);
+   static const bool value = sizeof(test<MemoryAlgorithm>(0)) == sizeof(char);
+};
+
+//!Detects memory algorithms with size-class bins that exchange
+//!lists of buffers with thread caches, like rbtree_best_fit
+template<class MemoryAlgorithm>
+struct has_bin_list
+{
+   template<void (MemoryAlgorithm::*)(void *)> struct helper;
+   template<class T> static char test(helper<&T::deallocate_bin_list> *);
+   template<class T> static int  test(...);
+   static const bool value = sizeof(test<MemoryAlgorithm>(0)) == sizeof(char);
+};
+
+}  //namespace ipcdetail{
+/// @endcond
+
 //!This object is the public base class of segment manager.
 //!This class only depends on the memory allocation algorithm
 //!and implements all the allocation features not related
@@ -79,6 +114,9 @@ class segment_manager_base
 
    /// @endcond
 
+   //!Statistics of free and allocated blocks returned by get_stats()
+   typedef memory_algorithm_stats<size_type>          stats_type;
+
    //!This constant indicates the payload size
    //!associated with each allocation of the memory algorithm
    static const size_type PayloadPerAllocation = MemoryAlgorithm::PayloadPerAllocation;
@@ -118,7 +156,11 @@ class segment_manager_base
    //!Allocates nbytes bytes. This function is only used in
    //!single-segment management. Never throws
    void * allocate (size_type nbytes, std::nothrow_t)
-   {  return MemoryAlgorithm::allocate(nbytes);   }
+   {
+      if(thread_cache *cache = this->priv_thread_cache())
+         return cache->allocate(nbytes);
+      return MemoryAlgorithm::allocate(nbytes);
+   }
 
    /// @cond
 
@@ -167,7 +209,7 @@ class segment_manager_base
    //!on failure
    void * allocate(size_type nbytes)
    {
-      void * ret = MemoryAlgorithm::allocate(nbytes);
+      void * ret = this->allocate(nbytes, std::nothrow_t());
       if(!ret)
          throw bad_alloc();
       return ret;
@@ -218,7 +260,12 @@ class segment_manager_base
    //!Deallocates the bytes allocated with allocate/allocate_many()
    //!pointed by addr
    void   deallocate          (void *addr)
-   {  MemoryAlgorithm::deallocate(addr);   }
+   {
+      if(thread_cache *cache = this->priv_thread_cache())
+         cache->deallocate(addr);
+      else
+         MemoryAlgorithm::deallocate(addr);
+   }
 
    //!Increases managed memory in extra_size bytes more. This only works
    //!with single-segment management.
@@ -226,9 +273,14 @@ class segment_manager_base
    {  MemoryAlgorithm::grow(extra_size);   }
 
    //!Decreases managed memory to the minimum. This only works
-   //!with single-segment management.
+   //!with single-segment management. Flushes the thread_cache
+   //!of the calling thread, if any.
    void shrink_to_fit()
-   {  MemoryAlgorithm::shrink_to_fit();   }
+   {
+      if(thread_cache *cache = this->priv_thread_cache())
+         cache->flush();
+      MemoryAlgorithm::shrink_to_fit();
+   }
 
    //!Returns the result of "all_memory_deallocated()" function
    //!of the used memory algorithm
@@ -240,17 +292,163 @@ class segment_manager_base
    bool check_sanity()
    {   return MemoryAlgorithm::check_sanity(); }
 
+   //!Fills "stats" with the statistics of free and allocated blocks
+   //!of the used memory algorithm. The memory algorithm is locked
+   //!only while its blocks are traversed, so it can be called from
+   //!any process while other processes allocate.
+   void get_stats(stats_type &stats)
+   {   MemoryAlgorithm::get_stats(stats); }
+
    //!Writes to zero free memory (memory not yet allocated)
-   //!of the memory algorithm
+   //!of the memory algorithm. Whole free pages are returned
+   //!to the operating system instead, if it's able to do it
    void zero_free_memory()
    {   MemoryAlgorithm::zero_free_memory(); }
 
+   //!Sets the maximum number of free blocks cached for each size class
+   //!by memory algorithms with size-class bins, like rbtree_best_fit.
+   //!0 disables bins.
+   void set_bin_capacity(size_type max_blocks)
+   {   MemoryAlgorithm::set_bin_capacity(max_blocks); }
+
+   //!Returns the maximum number of free blocks cached for each size class
+   //!by memory algorithms with size-class bins, like rbtree_best_fit.
+   size_type get_bin_capacity() const
+   {   return MemoryAlgorithm::get_bin_capacity(); }
+
    //!Returns the size of the buffer previously allocated pointed by ptr
    size_type size(const void *ptr) const
    {   return MemoryAlgorithm::size(ptr); }
 
    /// @cond
+   //!Tells the memory algorithm that its free memory reads as zero, if it
+   //!can use it. Only called just after constructing the segment manager
+   //!over new memory. Never throws
+   void mark_free_memory_zeroed()
+   {
+      this->priv_mark_free_memory_zeroed
+         (ipcdetail::bool_<ipcdetail::has_mark_free_memory_zeroed<MemoryAlgorithm>::value>());
+   }
+   /// @endcond
+
+   //!A cache of small free blocks owned by a thread of a process. While it's alive,
+   //!allocate() and deallocate() called by the thread that constructed it (so also
+   //!anonymous, named and unique object construction) use the cache: blocks of up to
+   //!get_max_cached_size() bytes are served from size-class lists, so most small
+   //!allocations don't lock the memory algorithm. Lists are refilled from and
+   //!returned to the size-class bins of memory algorithms that have them, like
+   //!rbtree_best_fit, and with allocate_many() and deallocate_many() otherwise.
+   //!
+   //!Cached blocks are not free memory of the segment. They are returned to the
+   //!memory algorithm when a list exceeds the limit of blocks, by flush(),
+   //!by shrink_to_fit() called by the owner thread and by the destructor, so a
+   //!thread_cache constructed in the thread function is flushed on thread exit.
+   //!A thread_cache must be destroyed by the thread that constructed it and
+   //!before the segment is unmapped.
+   class thread_cache
+      /// @cond
+      :  public ipcdetail::thread_cache_link
+      /// @endcond
+   {
+      thread_cache(const thread_cache &);
+      thread_cache &operator=(const thread_cache &);
+
+      public:
+      static const size_type NumClasses = 16;
+
+      //!Registers the cache for the calling thread. Each list caches up to "max_blocks".
+      //!Never throws
+      explicit thread_cache(segment_manager_base &mngr, size_type max_blocks = 32);
+
+      //!Returns all cached blocks to the memory algorithm. Never throws
+      ~thread_cache();
+
+      //!Allocates nbytes bytes. Returns 0 if there is no memory. Never throws
+      void *allocate(size_type nbytes);
+
+      //!Caches memory allocated from the segment manager. Never throws
+      void deallocate(void *addr);
+
+      //!Returns all cached blocks to the memory algorithm. Never throws
+      void flush();
+
+      //!Returns the number of cached blocks
+      size_type get_num_cached() const;
+
+      //!Returns the number of allocations served from the lists
+      size_type get_hits() const
+      {  return m_hits;  }
+
+      //!Returns the number of allocations that needed the memory algorithm
+      size_type get_misses() const
+      {  return m_misses;  }
+
+      //!Returns the maximum number of blocks of each list
+      size_type get_max_blocks() const
+      {  return m_max_blocks;  }
+
+      //!Returns the biggest allocation served from the lists
+      static size_type get_max_cached_size()
+      {  return NumClasses*MemoryAlgorithm::Alignment;  }
+
+      segment_manager_base &get_segment_manager() const
+      {  return m_mngr;  }
+
+      /// @cond
+      private:
+      typedef ipcdetail::bool_<ipcdetail::has_bin_list<MemoryAlgorithm>::value> has_bin_list_t;
+
+      //!Refills the empty list "cls" with up to "n" blocks and returns one more
+      void *priv_refill(size_type cls, size_type n, ipcdetail::true_);
+      void *priv_refill(size_type cls, size_type n, ipcdetail::false_);
+
+      //!Returns the blocks linked through their first bytes in "list" to the memory algorithm
+      void priv_deallocate_list(void *list, ipcdetail::true_);
+      void priv_deallocate_list(void *list, ipcdetail::false_);
+
+      void priv_flush(size_type cls, size_type n);
+
+      segment_manager_base &m_mngr;
+      size_type             m_max_blocks;
+      void                 *m_lists[NumClasses];
+      size_type             m_counts[NumClasses];
+      size_type             m_hits;
+      size_type             m_misses;
+      /// @endcond
+   };
+
+   /// @cond
+   private:
+   typedef ipcdetail::thread_cache_tss<0> thread_cache_tss_t;
+
+   thread_cache *priv_thread_cache()
+   {  return static_cast<thread_cache*>(thread_cache_tss_t::find(this));  }
+
+   void priv_mark_free_memory_zeroed(ipcdetail::true_)
+   {  MemoryAlgorithm::mark_free_memory_zeroed();  }
+
+   void priv_mark_free_memory_zeroed(ipcdetail::false_)
+   {}
+
    protected:
+   //!Returns the blocks of the thread_cache of the calling thread, if any,
+   //!to the memory algorithm
+   void prot_flush_thread_cache()
+   {
+      if(thread_cache *cache = this->priv_thread_cache())
+         cache->flush();
+   }
+
+   //!Allocates nbytes bytes with the memory algorithm, bypassing the
+   //!thread_cache of the calling thread. Never throws
+   void *prot_algo_allocate(size_type nbytes)
+   {  return MemoryAlgorithm::allocate(nbytes);  }
+
+   //!Deallocates "addr" with the memory algorithm, bypassing the
+   //!thread_cache of the calling thread. Never throws
+   void prot_algo_deallocate(void *addr)
+   {  MemoryAlgorithm::deallocate(addr);  }
+
    void * prot_anonymous_construct
       (size_type num, bool dothrow, ipcdetail::in_place_interface &table)
    {
@@ -316,6 +514,173 @@ class segment_manager_base
    /// @endcond
 };
 
+/// @cond
+
+template<class MemoryAlgorithm>
+inline segment_manager_base<MemoryAlgorithm>::thread_cache::thread_cache
+   (segment_manager_base &mngr, size_type max_blocks)
+   :  m_mngr(mngr), m_max_blocks(max_blocks), m_hits(0), m_misses(0)
+{
+   for(size_type i = 0; i != NumClasses; ++i){
+      m_lists[i]  = 0;
+      m_counts[i] = 0;
+   }
+   thread_cache_tss_t::link(*this, &mngr);
+}
+
+template<class MemoryAlgorithm>
+inline segment_manager_base<MemoryAlgorithm>::thread_cache::~thread_cache()
+{
+   thread_cache_tss_t::unlink(*this);
+   this->flush();
+}
+
+template<class MemoryAlgorithm>
+inline void *segment_manager_base<MemoryAlgorithm>::thread_cache::allocate(size_type nbytes)
+{
+   const size_type cls = nbytes ? (nbytes - 1)/MemoryAlgorithm::Alignment : 0;
+   if(cls < NumClasses){
+      if(m_counts[cls]){
+         void *ret = m_lists[cls];
+         m_lists[cls] = *static_cast<void**>(ret);
+         --m_counts[cls];
+         ++m_hits;
+         return ret;
+      }
+      ++m_misses;
+      //Refill the list with half of the limit, keeping one of them
+      const size_type refill = m_max_blocks/2;
+      if(refill){
+         if(void *ret = this->priv_refill(cls, refill, has_bin_list_t())){
+            return ret;
+         }
+      }
+   }
+   else{
+      ++m_misses;
+   }
+   return static_cast<MemoryAlgorithm&>(m_mngr).allocate(nbytes);
+}
+
+template<class MemoryAlgorithm>
+inline void segment_manager_base<MemoryAlgorithm>::thread_cache::deallocate(void *addr)
+{
+   if(!addr)
+      return;
+   //A block of "n" usable bytes serves the allocations of list n/Alignment - 1
+   const size_type units = m_mngr.size(addr)/MemoryAlgorithm::Alignment;
+   if(!units || units > NumClasses || !m_max_blocks){
+      static_cast<MemoryAlgorithm&>(m_mngr).deallocate(addr);
+      return;
+   }
+   const size_type cls = units - 1;
+   if(m_counts[cls] >= m_max_blocks){
+      this->priv_flush(cls, m_max_blocks/2 ? m_max_blocks/2 : 1);
+   }
+   *static_cast<void**>(addr) = m_lists[cls];
+   m_lists[cls] = addr;
+   ++m_counts[cls];
+}
+
+template<class MemoryAlgorithm>
+inline void segment_manager_base<MemoryAlgorithm>::thread_cache::flush()
+{
+   for(size_type i = 0; i != NumClasses; ++i){
+      this->priv_flush(i, m_counts[i]);
+   }
+}
+
+template<class MemoryAlgorithm>
+inline typename segment_manager_base<MemoryAlgorithm>::size_type
+   segment_manager_base<MemoryAlgorithm>::thread_cache::get_num_cached() const
+{
+   size_type n = 0;
+   for(size_type i = 0; i != NumClasses; ++i){
+      n += m_counts[i];
+   }
+   return n;
+}
+
+template<class MemoryAlgorithm>
+void *segment_manager_base<MemoryAlgorithm>::thread_cache::priv_refill
+   (size_type cls, size_type n, ipcdetail::true_)
+{
+   const size_type nbytes = (cls + 1)*MemoryAlgorithm::Alignment;
+   if(nbytes > MemoryAlgorithm::get_max_bin_size()){
+      return this->priv_refill(cls, n, ipcdetail::false_());
+   }
+   //The list returned by the bins has the same layout as the cache lists
+   void *list = 0;
+   const size_type count = static_cast<MemoryAlgorithm&>(m_mngr).allocate_bin_list(nbytes, n + 1, list);
+   if(!count){
+      return 0;
+   }
+   void *ret = list;
+   m_lists[cls]  = *static_cast<void**>(ret);
+   m_counts[cls] = count - 1;
+   return ret;
+}
+
+template<class MemoryAlgorithm>
+void *segment_manager_base<MemoryAlgorithm>::thread_cache::priv_refill
+   (size_type cls, size_type n, ipcdetail::false_)
+{
+   multiallocation_chain chain;
+   m_mngr.allocate_many
+      (std::nothrow_t(), (cls + 1)*MemoryAlgorithm::Alignment, n + 1, chain);
+   if(chain.empty()){
+      return 0;
+   }
+   void *ret = ipcdetail::to_raw_pointer(chain.pop_front());
+   while(!chain.empty()){
+      void *block = ipcdetail::to_raw_pointer(chain.pop_front());
+      *static_cast<void**>(block) = m_lists[cls];
+      m_lists[cls] = block;
+      ++m_counts[cls];
+   }
+   return ret;
+}
+
+template<class MemoryAlgorithm>
+inline void segment_manager_base<MemoryAlgorithm>::thread_cache::priv_deallocate_list
+   (void *list, ipcdetail::true_)
+{  static_cast<MemoryAlgorithm&>(m_mngr).deallocate_bin_list(list);  }
+
+template<class MemoryAlgorithm>
+void segment_manager_base<MemoryAlgorithm>::thread_cache::priv_deallocate_list
+   (void *list, ipcdetail::false_)
+{
+   multiallocation_chain chain;
+   while(list){
+      void *next = *static_cast<void**>(list);
+      chain.push_front(void_pointer(list));
+      list = next;
+   }
+   m_mngr.deallocate_many(chain);
+}
+
+template<class MemoryAlgorithm>
+void segment_manager_base<MemoryAlgorithm>::thread_cache::priv_flush(size_type cls, size_type n)
+{
+   if(!n || !m_counts[cls])
+      return;
+   if(n > m_counts[cls]){
+      n = m_counts[cls];
+   }
+   //Unlink the first n blocks
+   void *first = m_lists[cls];
+   void *last  = first;
+   for(size_type i = 1; i != n; ++i){
+      last = *static_cast<void**>(last);
+   }
+   m_lists[cls] = *static_cast<void**>(last);
+   *static_cast<void**>(last) = 0;
+   m_counts[cls] -= n;
+   this->priv_deallocate_list(first, has_bin_list_t());
+}
+
+/// @endcond
+
 //!This object is placed in the beginning of memory segment and
 //!implements the allocation (named or anonymous) of portions
 //!of the segment. This object contains two indexes that
@@ -625,6 +990,81 @@ class segment_manager
       return m_header.m_unique_index.size();
    }
 
+   //!Registers "ptr" as the owner of a relocatable buffer: compact() can move the
+   //!buffer "ptr" points to and make "ptr" point to the new address. "ptr" must be
+   //!placed in this segment, but not in a relocatable buffer, and it must be
+   //!unregistered before it's destroyed. It can be null or point to a buffer
+   //!allocated with allocate() or allocation_command(). Buffers are copied with
+   //!std::memcpy, so the pointee type must be trivially copyable, which rules out
+   //!types containing offset_ptr-s. Containers can't register their buffers.
+   //!Can throw boost::interprocess::bad_alloc if there is no enough memory.
+   template<class Pointer>
+   void register_relocatable(Pointer &ptr)
+   {
+      typedef typename boost::intrusive::pointer_traits<Pointer>::element_type element_type;
+      BOOST_STATIC_ASSERT((ipcdetail::is_same<typename boost::intrusive::pointer_traits
+         <Pointer>::template rebind_pointer<void>::type, void_pointer>::value));
+      BOOST_STATIC_ASSERT((boost::has_trivial_copy<element_type>::value));
+      //-------------------------------
+      scoped_lock<rmutex> guard(m_header);
+      //-------------------------------
+      this->priv_register_relocatable(this->priv_relocatable_offset(&ptr));
+   }
+
+   //!Unregisters "ptr", previously registered with register_relocatable().
+   //!Returns false if "ptr" was not registered. Never throws.
+   template<class Pointer>
+   bool unregister_relocatable(Pointer &ptr)
+   {
+      //-------------------------------
+      scoped_lock<rmutex> guard(m_header);
+      //-------------------------------
+      return this->priv_unregister_relocatable(this->priv_relocatable_offset(&ptr));
+   }
+
+   //!Returns the number of pointers registered with register_relocatable()
+   size_type get_num_relocatables()
+   {
+      //-------------------------------
+      scoped_lock<rmutex> guard(m_header);
+      //-------------------------------
+      return m_header.m_num_relocatables;
+   }
+
+   //!Moves relocatable buffers towards the start of the segment, so that free
+   //!memory is merged at the end of the segment and shrink_to_fit() can return it.
+   //!First each buffer slides over the free block placed before it, expanding it
+   //!backwards with allocation_command() and returning the tail. Then, starting
+   //!from the end of the segment, buffers are moved to a lower free block if
+   //!there is one. Returns the number of moves, a buffer can be moved twice.
+   //!Buffers are allocated and deallocated with the memory algorithm, bypassing
+   //!thread caches, and the thread_cache of the calling thread is flushed first.
+   //!No other thread or process can access relocatable buffers during the call.
+   size_type compact()
+   {
+      this->prot_flush_thread_cache();
+      //-------------------------------
+      scoped_lock<rmutex> guard(m_header);
+      //-------------------------------
+      size_type *const first = ipcdetail::to_raw_pointer(m_header.m_relocatables);
+      size_type *const last  = first + m_header.m_num_relocatables;
+      size_type moved = 0;
+      std::sort(first, last, relocatable_compare(*this, false));
+      for(size_type *it = first; it != last; ++it){
+         moved += this->priv_slide_relocatable(this->priv_relocatable_ptr(*it)) ? 1 : 0;
+      }
+      std::sort(first, last, relocatable_compare(*this, true));
+      for(size_type *it = first; it != last; ++it){
+         moved += this->priv_move_relocatable(this->priv_relocatable_ptr(*it)) ? 1 : 0;
+      }
+      //The offsets can be moved too
+      void_pointer offsets(m_header.m_relocatables);
+      if(this->priv_move_relocatable(offsets)){
+         m_header.m_relocatables = static_cast<size_type*>(ipcdetail::to_raw_pointer(offsets));
+      }
+      return moved;
+   }
+
    //!Obtains the minimum size needed by the
    //!segment manager
    static size_type get_min_size()
@@ -829,6 +1269,140 @@ class segment_manager
       return (instance_type)ctrl_data->alloc_type();
    }
 
+   typedef typename boost::intrusive::pointer_traits<void_pointer>::template
+      rebind_pointer<size_type>::type                    size_type_ptr;
+
+   //!Orders offsets of relocatable pointers by the address of their buffers
+   struct relocatable_compare;
+   friend struct relocatable_compare;
+
+   struct relocatable_compare
+   {
+      relocatable_compare(segment_manager &mngr, bool descending)
+         :  m_mngr(mngr), m_descending(descending)
+      {}
+
+      bool operator()(size_type a, size_type b) const
+      {
+         const void *buf_a = ipcdetail::to_raw_pointer(m_mngr.priv_relocatable_ptr(a));
+         const void *buf_b = ipcdetail::to_raw_pointer(m_mngr.priv_relocatable_ptr(b));
+         return m_descending ? std::less<const void*>()(buf_b, buf_a)
+                             : std::less<const void*>()(buf_a, buf_b);
+      }
+
+      segment_manager &m_mngr;
+      bool m_descending;
+   };
+
+   size_type priv_relocatable_offset(const void *ptr)
+   {
+      const char *const addr = static_cast<const char*>(ptr);
+      const char *const this_addr = reinterpret_cast<const char*>(this);
+      BOOST_ASSERT(addr >= this_addr && addr < this_addr + this->get_size());
+      return size_type(addr - this_addr);
+   }
+
+   //!Returns the relocatable pointer placed "offset" bytes after the segment manager.
+   //!All pointers whose rebind to void is void_pointer have its representation.
+   void_pointer &priv_relocatable_ptr(size_type offset)
+   {  return *reinterpret_cast<void_pointer*>(reinterpret_cast<char*>(this) + offset);  }
+
+   void priv_register_relocatable(size_type offset)
+   {
+      if(m_header.m_num_relocatables == m_header.m_relocatables_capacity){
+         const size_type new_capacity = m_header.m_relocatables_capacity
+            ? m_header.m_relocatables_capacity*2 : 16;
+         size_type *const new_offsets = static_cast<size_type*>
+            (this->prot_algo_allocate(new_capacity*sizeof(size_type)));
+         if(!new_offsets){
+            throw bad_alloc();
+         }
+         size_type *const old_offsets = ipcdetail::to_raw_pointer(m_header.m_relocatables);
+         if(old_offsets){
+            std::memcpy(new_offsets, old_offsets, m_header.m_num_relocatables*sizeof(size_type));
+            this->prot_algo_deallocate(old_offsets);
+         }
+         m_header.m_relocatables = new_offsets;
+         m_header.m_relocatables_capacity = new_capacity;
+      }
+      ipcdetail::to_raw_pointer(m_header.m_relocatables)[m_header.m_num_relocatables++] = offset;
+   }
+
+   bool priv_unregister_relocatable(size_type offset)
+   {
+      size_type *const offsets = ipcdetail::to_raw_pointer(m_header.m_relocatables);
+      size_type *const last    = offsets + m_header.m_num_relocatables;
+      size_type *const it      = std::find(offsets, last, offset);
+      if(it == last){
+         return false;
+      }
+      *it = *(last - 1);
+      //Free the offsets with the last pointer
+      if(!--m_header.m_num_relocatables){
+         this->prot_algo_deallocate(offsets);
+         m_header.m_relocatables = 0;
+         m_header.m_relocatables_capacity = 0;
+      }
+      return true;
+   }
+
+   //!Expands the buffer of "owner" backwards over the free block placed before
+   //!it and shrinks it to its old size, while the free block is big enough.
+   //!Memory algorithms don't move the contents of buffers expanded backwards.
+   bool priv_slide_relocatable(void_pointer &owner)
+   {
+      char *buffer = static_cast<char*>(ipcdetail::to_raw_pointer(owner));
+      if(!buffer){
+         return false;
+      }
+      const size_type bytes = this->size(buffer);
+      if(bytes > this->get_size()/2){
+         return false;
+      }
+      bool moved = false;
+      size_type received;
+      for(;;){
+         char *const lower = Base::template allocation_command<char>
+            (boost::interprocess::expand_bwd | boost::interprocess::nothrow_allocation
+            , 2*bytes, 2*bytes, received, buffer).first;
+         if(!lower || !(lower < buffer)){
+            break;
+         }
+         std::memmove(lower, buffer, bytes);
+         owner = lower;
+         moved = true;
+         //Return the tail, merging it with the next free block
+         Base::template allocation_command<char>
+            (boost::interprocess::shrink_in_place | boost::interprocess::nothrow_allocation
+            , bytes, bytes, received, lower);
+         buffer = lower;
+      }
+      return moved;
+   }
+
+   //!Moves the buffer of "owner" to a new block if the
+   //!memory algorithm places it at a lower address
+   bool priv_move_relocatable(void_pointer &owner)
+   {
+      char *const buffer = static_cast<char*>(ipcdetail::to_raw_pointer(owner));
+      if(!buffer){
+         return false;
+      }
+      const size_type bytes = this->size(buffer);
+      char *const new_buffer = static_cast<char*>(this->prot_algo_allocate(bytes));
+      if(!new_buffer){
+         return false;
+      }
+      if(!(new_buffer < buffer)){
+         this->prot_algo_deallocate(new_buffer);
+         return false;
+      }
+      std::memcpy(new_buffer, buffer, bytes);
+      owner = new_buffer;
+      this->prot_algo_deallocate(buffer);
+      return true;
+   }
+
    static size_type priv_get_reserved_bytes()
    {
       //Get the number of bytes until the end of (*this)
@@ -1347,10 +1921,18 @@ class segment_manager
    {
       named_index_t           m_named_index;
       unique_index_t          m_unique_index;
+      //!Offsets from the segment manager of the pointers
+      //!registered with register_relocatable()
+      size_type_ptr           m_relocatables;
+      size_type               m_num_relocatables;
+      size_type               m_relocatables_capacity;
 
       header_t(Base *restricted_segment_mngr)
          :  m_named_index (restricted_segment_mngr)
          ,  m_unique_index(restricted_segment_mngr)
+         ,  m_relocatables(0)
+         ,  m_num_relocatables(0)
+         ,  m_relocatables_capacity(0)
       {}
    }  m_header;
 
@@ -34,6 +34,9 @@
 #elif !defined(BOOST_INTERPROCESS_FORCE_GENERIC_EMULATION) && defined (BOOST_INTERPROCESS_WINDOWS)
    #include <boost/interprocess/sync/windows/condition.hpp>
    #define BOOST_INTERPROCESS_USE_WINDOWS
+#elif !defined(BOOST_INTERPROCESS_DOXYGEN_INVOKED) && defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+   #include <boost/interprocess/sync/linux/condition.hpp>
+   #define BOOST_INTERPROCESS_USE_LINUX_FUTEX
 #elif !defined(BOOST_INTERPROCESS_DOXYGEN_INVOKED)
    #include <boost/interprocess/sync/spin/condition.hpp>
    #define BOOST_INTERPROCESS_USE_GENERIC_EMULATION
@@ -136,6 +139,9 @@ class interprocess_condition
    #if defined (BOOST_INTERPROCESS_USE_GENERIC_EMULATION)
       #undef BOOST_INTERPROCESS_USE_GENERIC_EMULATION
       ipcdetail::spin_condition m_condition;
+   #elif defined (BOOST_INTERPROCESS_USE_LINUX_FUTEX)
+      #undef BOOST_INTERPROCESS_USE_LINUX_FUTEX
+      ipcdetail::futex_condition m_condition;
    #elif defined(BOOST_INTERPROCESS_USE_POSIX)
       #undef BOOST_INTERPROCESS_USE_POSIX
       ipcdetail::posix_condition m_condition;
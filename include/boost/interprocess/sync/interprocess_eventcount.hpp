@@ -0,0 +1,205 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOST_INTERPROCESS_EVENTCOUNT_HPP
+#define BOOST_INTERPROCESS_EVENTCOUNT_HPP
+
+#if (defined _MSC_VER) && (_MSC_VER >= 1200)
+#  pragma once
+#endif
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/detail/workaround.hpp>
+#include <boost/interprocess/detail/posix_time_types_wrk.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+#include <boost/cstdint.hpp>
+
+#if defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+   #include <boost/interprocess/sync/linux/futex_helpers.hpp>
+#endif
+
+//!\file
+//!Describes interprocess_eventcount class
+
+namespace boost {
+namespace interprocess {
+
+//!An eventcount that can be placed in shared memory and can be shared between
+//!processes. It lets lock-free algorithms block until a predicate becomes true
+//!without protecting the predicate with a mutex:
+//!
+//!\code
+//!while(!predicate()){
+//!   const interprocess_eventcount::key_type key = ec.prepare_wait();
+//!   if(predicate()){
+//!      ec.cancel_wait();
+//!      break;
+//!   }
+//!   ec.wait(key);
+//!}
+//!\endcode
+//!
+//!Threads that make the predicate true call notify_one() or notify_all(), which
+//!return without writing to shared memory or issuing system calls if no thread is
+//!waiting. On Linux waiters sleep on a futex shared between processes, otherwise
+//!they yield until they are notified, as spin based synchronization primitives do.
+//!
+//!The class is initialized to zero, so zeroed memory is a valid eventcount.
+class interprocess_eventcount
+{
+   //Non-copyable
+   interprocess_eventcount(const interprocess_eventcount &);
+   interprocess_eventcount &operator=(const interprocess_eventcount &);
+   public:
+
+   //!Type of the key returned by prepare_wait()
+   typedef boost::uint32_t key_type;
+
+   //!Constructs the eventcount. Does not throw.
+   interprocess_eventcount();
+
+   //!Destroys the eventcount. Does not throw.
+   ~interprocess_eventcount();
+
+   //!Effects: Registers the calling thread as a waiter. The predicate must be
+   //!   checked again after this call, followed by a call to wait(), timed_wait()
+   //!   or cancel_wait().
+   //!Returns: The key that must be passed to wait() or timed_wait().
+   //!Throws: Nothing.
+   key_type prepare_wait();
+
+   //!Precondition: The calling thread has called prepare_wait().
+   //!Effects: Unregisters the calling thread, that won't wait.
+   //!Throws: Nothing.
+   void cancel_wait();
+
+   //!Precondition: prepare_wait() has returned "key" to the calling thread.
+   //!Effects: Blocks until a notification is issued after prepare_wait() returned
+   //!   and unregisters the calling thread. Spurious wakeups are possible.
+   //!Throws: Nothing.
+   void wait(key_type key);
+
+   //!Same as wait() but waits until abs_time is reached at most.
+   //!Returns: false if abs_time was reached.
+   //!Throws: Nothing.
+   bool timed_wait(key_type key, const boost::posix_time::ptime &abs_time);
+
+   //!Effects: Wakes a waiting thread, if any. Must be called after
+   //!   the predicate has been made true.
+   //!Throws: Nothing.
+   void notify_one();
+
+   //!Effects: Wakes all waiting threads. Must be called after
+   //!   the predicate has been made true.
+   //!Throws: Nothing.
+   void notify_all();
+
+   /// @cond
+   private:
+   void notify(bool all);
+
+   //Incremented by each notification that finds waiters
+   volatile boost::uint32_t m_epoch;
+   //Threads between prepare_wait() and the return of wait() or cancel_wait().
+   //A waiter only leaves the count itself, so a notifier can never miss
+   //a thread that is blocked or about to block.
+   volatile boost::uint32_t m_waiters;
+   /// @endcond
+};
+
+/// @cond
+
+inline interprocess_eventcount::interprocess_eventcount()
+   :  m_epoch(0), m_waiters(0)
+{
+   //Note that this class is initialized to zero.
+   //So zeroed memory can be interpreted as an
+   //initialized eventcount
+}
+
+inline interprocess_eventcount::~interprocess_eventcount()
+{
+   //Trivial destructor
+}
+
+inline interprocess_eventcount::key_type interprocess_eventcount::prepare_wait()
+{
+   //atomic_inc32 is a full barrier, so the registration is
+   //visible before the predicate is checked again
+   ipcdetail::atomic_inc32(&m_waiters);
+   return ipcdetail::atomic_read32(&m_epoch);
+}
+
+inline void interprocess_eventcount::cancel_wait()
+{  ipcdetail::atomic_dec32(&m_waiters);  }
+
+inline void interprocess_eventcount::wait(key_type key)
+{  this->timed_wait(key, boost::posix_time::pos_infin);  }
+
+inline void interprocess_eventcount::notify_one()
+{  this->notify(false);  }
+
+inline void interprocess_eventcount::notify_all()
+{  this->notify(true);  }
+
+inline void interprocess_eventcount::notify(bool all)
+{
+   //Predicate stores must be visible before checking waiters,
+   //otherwise a waiter could miss the notification
+   ipcdetail::atomic_full_barrier();
+   if(!ipcdetail::atomic_read32(&m_waiters)){
+      return;
+   }
+   //A new epoch makes threads that have not blocked yet return from wait
+   ipcdetail::atomic_inc32(&m_epoch);
+   #if defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+   if(all){
+      ipcdetail::futex_wake_all(&m_epoch);
+   }
+   else{
+      ipcdetail::futex_wake(&m_epoch, 1);
+   }
+   #else
+   //Spinning waiters return as soon as the epoch changes
+   (void)all;
+   #endif
+}
+
+inline bool interprocess_eventcount::timed_wait
+   (key_type key, const boost::posix_time::ptime &abs_time)
+{
+   bool notified = true;
+   #if defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+   //Returns immediately if the epoch has already changed
+   notified = ipcdetail::futex_timed_wait(&m_epoch, key, abs_time);
+   #else
+   //Spin and yield until the epoch changes, as spin primitives do
+   for(unsigned k = 0; ipcdetail::atomic_read32(&m_epoch) == key; ++k){
+      if(abs_time != boost::posix_time::pos_infin &&
+         (k % 64) == 0 && microsec_clock::universal_time() >= abs_time){
+         notified = false;
+         break;
+      }
+      ipcdetail::thread_yield();
+   }
+   #endif
+   ipcdetail::atomic_dec32(&m_waiters);
+   return notified;
+}
+
+/// @endcond
+
+}  //namespace interprocess {
+}  //namespace boost {
+
+#include <boost/interprocess/detail/config_end.hpp>
+
+#endif   //BOOST_INTERPROCESS_EVENTCOUNT_HPP
@@ -0,0 +1,259 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOST_INTERPROCESS_SEQLOCK_HPP
+#define BOOST_INTERPROCESS_SEQLOCK_HPP
+
+#if (defined _MSC_VER) && (_MSC_VER >= 1200)
+#  pragma once
+#endif
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/detail/workaround.hpp>
+#include <boost/interprocess/detail/posix_time_types_wrk.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/type_traits/has_trivial_copy.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/cstdint.hpp>
+
+//!\file
+//!Describes interprocess_seqlock and seqlock_protected classes
+
+namespace boost {
+namespace interprocess {
+
+//!A sequence lock that can be placed in shared memory and can be shared between
+//!processes. Writers are mutually exclusive and increment a sequence counter
+//!before and after modifying the protected data. Readers don't write to shared
+//!memory: they read the data optimistically and retry if the sequence shows that a
+//!writer was active. Suited for small, read-mostly data that can be copied while
+//!being modified (the copy is discarded in that case).
+//!
+//!The class is initialized to zero, so zeroed memory is a valid unlocked seqlock.
+class interprocess_seqlock
+{
+   //Non-copyable
+   interprocess_seqlock(const interprocess_seqlock &);
+   interprocess_seqlock &operator=(const interprocess_seqlock &);
+   public:
+
+   //!Constructs the seqlock. Does not throw.
+   interprocess_seqlock();
+
+   //!Destroys the seqlock. Does not throw.
+   ~interprocess_seqlock();
+
+   //Writer locking
+
+   //!Effects: The calling thread obtains exclusive (writer) ownership,
+   //!   waiting if another writer owns the seqlock.
+   //!Throws: Nothing.
+   void lock();
+
+   //!Effects: The calling thread tries to obtain exclusive (writer) ownership
+   //!   without waiting.
+   //!Returns: If it can acquire ownership immediately returns true.
+   //!Throws: Nothing.
+   bool try_lock();
+
+   //!Effects: The calling thread tries to obtain exclusive (writer) ownership
+   //!   waiting if necessary until abs_time is reached.
+   //!Returns: If acquires ownership returns true. Otherwise returns false.
+   //!Throws: Nothing.
+   bool timed_lock(const boost::posix_time::ptime &abs_time);
+
+   //!Precondition: The thread must have exclusive (writer) ownership.
+   //!Effects: Publishes the modifications and releases the ownership.
+   //!Throws: Nothing.
+   void unlock();
+
+   //Optimistic reading
+
+   //!Effects: Waits until no writer owns the seqlock and returns the current
+   //!   sequence, that must be passed to read_retry() after reading the data.
+   //!Throws: Nothing.
+   boost::uint32_t read_begin() const;
+
+   //!Returns: true if a writer has owned the seqlock since read_begin() returned
+   //!   "seq", so that the data read must be discarded and read again.
+   //!Throws: Nothing.
+   bool read_retry(boost::uint32_t seq) const;
+
+   /// @cond
+   private:
+   boost::uint32_t read_seq() const
+   {  return ipcdetail::atomic_read32(const_cast<boost::uint32_t*>(&m_seq));  }
+
+   //Odd while a writer owns the seqlock
+   volatile boost::uint32_t m_seq;
+   /// @endcond
+};
+
+//!Wraps a trivially copyable object protected by an interprocess_seqlock.
+//!Loads never write to shared memory and return a consistent copy,
+//!stores and modifications are serialized between writers.
+template<class T>
+class seqlock_protected
+{
+   BOOST_STATIC_ASSERT((::boost::has_trivial_copy<T>::value));
+   //Non-copyable
+   seqlock_protected(const seqlock_protected &);
+   seqlock_protected &operator=(const seqlock_protected &);
+   public:
+
+   //!Value-initializes the protected object. Does not throw.
+   seqlock_protected()
+      :  m_lock(), m_value()
+   {}
+
+   //!Initializes the protected object with a copy of value. Does not throw.
+   explicit seqlock_protected(const T &value)
+      :  m_lock(), m_value(value)
+   {}
+
+   //!Returns a consistent copy of the protected object.
+   T load() const
+   {
+      T value;
+      this->load(value);
+      return value;
+   }
+
+   //!Copies the protected object in "value".
+   void load(T &value) const
+   {
+      boost::uint32_t seq;
+      do{
+         seq = m_lock.read_begin();
+         value = m_value;
+      }while(m_lock.read_retry(seq));
+   }
+
+   //!Replaces the protected object with a copy of value.
+   void store(const T &value)
+   {
+      scoped_lock<interprocess_seqlock> lck(m_lock);
+      m_value = value;
+   }
+
+   //!Calls modifier(object) with writer ownership, so that the
+   //!protected object can be updated in place.
+   template<class Modifier>
+   void modify(Modifier modifier)
+   {
+      scoped_lock<interprocess_seqlock> lck(m_lock);
+      modifier(m_value);
+   }
+
+   //!Returns the seqlock, for example to protect additional
+   //!data or to use it with scoped_lock.
+   interprocess_seqlock &seqlock()
+   {  return m_lock;  }
+
+   /// @cond
+   private:
+   mutable interprocess_seqlock  m_lock;
+   T                             m_value;
+   /// @endcond
+};
+
+/// @cond
+
+inline interprocess_seqlock::interprocess_seqlock()
+   :  m_seq(0)
+{
+   //Note that this class is initialized to zero.
+   //So zeroed memory can be interpreted as an
+   //initialized seqlock
+}
+
+inline interprocess_seqlock::~interprocess_seqlock()
+{
+   //Trivial destructor
+}
+
+inline bool interprocess_seqlock::try_lock()
+{
+   //An even sequence means no writer is active,
+   //make it odd to exclude other writers
+   const boost::uint32_t seq = this->read_seq();
+   if(seq & 1u){
+      return false;
+   }
+   if(ipcdetail::atomic_cas32(&m_seq, seq + 1, seq) != seq){
+      return false;
+   }
+   //Data stores can't be reordered before the sequence change
+   ipcdetail::atomic_write_barrier();
+   return true;
+}
+
+inline void interprocess_seqlock::lock()
+{
+   while(!this->try_lock()){
+      //Writers are expected to be short, relinquish the
+      //current timeslice while another writer is active
+      ipcdetail::thread_yield();
+   }
+}
+
+inline bool interprocess_seqlock::timed_lock(const boost::posix_time::ptime &abs_time)
+{
+   if(abs_time == boost::posix_time::pos_infin){
+      this->lock();
+      return true;
+   }
+   while(!this->try_lock()){
+      if(microsec_clock::universal_time() >= abs_time){
+         return false;
+      }
+      ipcdetail::thread_yield();
+   }
+   return true;
+}
+
+inline void interprocess_seqlock::unlock()
+{
+   //Data stores must be visible before the sequence is even again
+   ipcdetail::atomic_write_barrier();
+   ipcdetail::atomic_write32(&m_seq, this->read_seq() + 1);
+}
+
+inline boost::uint32_t interprocess_seqlock::read_begin() const
+{
+   boost::uint32_t seq = this->read_seq();
+   for(unsigned k = 0; seq & 1u; ++k){
+      if(k > 64){
+         ipcdetail::thread_yield();
+      }
+      seq = this->read_seq();
+   }
+   //Data loads can't be reordered before the sequence load
+   ipcdetail::atomic_read_barrier();
+   return seq;
+}
+
+inline bool interprocess_seqlock::read_retry(boost::uint32_t seq) const
+{
+   //Data loads must be finished before loading the sequence again
+   ipcdetail::atomic_read_barrier();
+   return this->read_seq() != seq;
+}
+
+/// @endcond
+
+}  //namespace interprocess {
+}  //namespace boost {
+
+#include <boost/interprocess/detail/config_end.hpp>
+
+#endif   //BOOST_INTERPROCESS_SEQLOCK_HPP
@@ -23,33 +23,39 @@
 #include <boost/interprocess/detail/posix_time_types_wrk.hpp>
 #include <boost/interprocess/sync/interprocess_mutex.hpp>
 #include <boost/interprocess/sync/interprocess_condition.hpp>
-#include <climits>
+#include <boost/interprocess/sync/sharable_mutex_policies.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/cstdint.hpp>
 
 
 //!\file
-//!Describes interprocess_upgradable_mutex class
+//!Describes interprocess_upgradable_mutex_t class template and the
+//!interprocess_upgradable_mutex class
 
 namespace boost {
 namespace interprocess {
 
 //!Wraps a interprocess_upgradable_mutex that can be placed in shared memory and can be
-//!shared between processes. Allows timed lock tries
-class interprocess_upgradable_mutex
+//!shared between processes. Allows timed lock tries. Policy selects how blocked
+//!readers and writers are scheduled (see sharable_mutex_policies.hpp). All processes
+//!sharing the mutex must use the same policy.
+template<class Policy>
+class interprocess_upgradable_mutex_t
 {
    //Non-copyable
-   interprocess_upgradable_mutex(const interprocess_upgradable_mutex &);
-   interprocess_upgradable_mutex &operator=(const interprocess_upgradable_mutex &);
+   interprocess_upgradable_mutex_t(const interprocess_upgradable_mutex_t &);
+   interprocess_upgradable_mutex_t &operator=(const interprocess_upgradable_mutex_t &);
 
    friend class interprocess_condition;
    public:
 
    //!Constructs the upgradable lock.
    //!Throws interprocess_exception on error.
-   interprocess_upgradable_mutex();
+   interprocess_upgradable_mutex_t();
 
    //!Destroys the upgradable lock.
    //!Does not throw.
-   ~interprocess_upgradable_mutex();
+   ~interprocess_upgradable_mutex_t();
 
    //Exclusive locking
 
@@ -200,433 +206,763 @@ class interprocess_upgradable_mutex
    /// @cond
    private:
    typedef scoped_lock<interprocess_mutex> scoped_lock_t;
+   typedef ipcdetail::sharable_policy_traits<Policy> policy_traits;
+
+   //All the control data is packed in a word so that uncontended
+   //acquisitions and releases are a single atomic operation.
+   //The internal mutex and the gates are only used when a thread
+   //must block or when blocked threads must be notified.
+   volatile boost::uint32_t   m_ctrl;
+   //Number of threads registered as waiters (protected by m_mut)
+   boost::uint32_t            m_num_waiters;
+   //Number of threads waiting for exclusive ownership
+   //when readers must yield to them (protected by m_mut)
+   boost::uint32_t            m_num_pending_writers;
+   //Phase-fair scheduling data (protected by m_mut): writer
+   //tickets, tickets abandoned behind the one being served, the
+   //current phase, readers blocked in the current phase and
+   //readers admitted by the last writer phase change.
+   boost::uint32_t            m_next_ticket;
+   boost::uint32_t            m_now_serving;
+   //Bit i is set if ticket m_now_serving + i was abandoned
+   boost::uint32_t            m_abandoned_tickets;
+   boost::uint32_t            m_phase;
+   boost::uint32_t            m_num_blocked_readers;
+   boost::uint32_t            m_num_admitted_readers;
+   interprocess_mutex         m_mut;
+   interprocess_condition     m_first_gate;
+   interprocess_condition     m_second_gate;
+
+   struct constants
+   {
+      static const boost::uint32_t exclusive_in  = boost::uint32_t(1) << 31;
+      static const boost::uint32_t upgradable_in = boost::uint32_t(1) << 30;
+      //Set while there are threads blocked in the gates,
+      //so that releases can't use the lock-free path
+      static const boost::uint32_t waiters_in    = boost::uint32_t(1) << 29;
+      //Set while a writer is waiting and new readers must yield
+      static const boost::uint32_t writer_pending = boost::uint32_t(1) << 28;
+      static const boost::uint32_t max_readers   = writer_pending - 1;
+      //Outstanding tickets, so that abandoned ones fit in the bitmap
+      static const boost::uint32_t max_tickets   = 32;
+   };
+
+   static boost::uint32_t num_upr_shar(boost::uint32_t ctrl)
+   {  return ctrl & constants::max_readers;  }
 
-   //Pack all the control data in a word to be able
-   //to use atomic instructions in the future
-   struct control_word_t
+   //Tries to change the control word from "cmp" to "with".
+   //On failure "cmp" is updated with the current value.
+   bool cas_ctrl(boost::uint32_t &cmp, boost::uint32_t with)
    {
-      unsigned exclusive_in         : 1;
-      unsigned upgradable_in        : 1;
-      unsigned num_upr_shar         : sizeof(unsigned)*CHAR_BIT-2;
-   }                       m_ctrl;
+      const boost::uint32_t prev = ipcdetail::atomic_cas32(&m_ctrl, with, cmp);
+      const bool success = prev == cmp;
+      cmp = prev;
+      return success;
+   }
 
-   interprocess_mutex      m_mut;
-   interprocess_condition  m_first_gate;
-   interprocess_condition  m_second_gate;
+   boost::uint32_t read_ctrl()
+   {  return ipcdetail::atomic_read32(&m_ctrl);  }
+
+   //Atomically sets/clears bits of the control word, returns the old value
+   boost::uint32_t set_ctrl_bits(boost::uint32_t bits)
+   {
+      boost::uint32_t c = this->read_ctrl();
+      while(!this->cas_ctrl(c, c | bits)){}
+      return c;
+   }
+
+   boost::uint32_t clear_ctrl_bits(boost::uint32_t bits)
+   {
+      boost::uint32_t c = this->read_ctrl();
+      while(!this->cas_ctrl(c, c & ~bits)){}
+      return c;
+   }
+
+   //Returns true if a sharable (or upgradable) lock can be
+   //acquired with control word "c". Phase-fair readers admitted
+   //by a writer phase change don't yield to pending writers.
+   static bool can_lock_sharable(boost::uint32_t c, bool upgradable, bool admitted)
+   {
+      boost::uint32_t blocking = constants::exclusive_in;
+      if(upgradable){
+         blocking |= constants::upgradable_in;
+      }
+      if(policy_traits::readers_yield && !admitted){
+         blocking |= constants::writer_pending;
+      }
+      return !(c & blocking) && num_upr_shar(c) != constants::max_readers;
+   }
+
+   //Returns true if the exclusive lock can be acquired without
+   //waiting. Phase-fair writers don't overtake blocked threads.
+   static bool can_try_lock(boost::uint32_t c)
+   {
+      boost::uint32_t blocking = constants::exclusive_in | constants::max_readers;
+      if(policy_traits::phase_fair){
+         blocking |= constants::waiters_in | constants::writer_pending;
+      }
+      return !(c & blocking);
+   }
+
+   //Returns true if a blocked writer (the caller must own m_mut) can
+   //mark the exclusive lock. If the policy announces writers, it marks
+   //the lock before waiting for readers to leave.
+   bool can_mark_exclusive(boost::uint32_t c, bool ticketed, boost::uint32_t ticket) const
+   {
+      const boost::uint32_t blocking = policy_traits::announce_writer
+         ? (constants::exclusive_in | constants::upgradable_in)
+         : (constants::exclusive_in | constants::max_readers);
+      if(c & blocking){
+         return false;
+      }
+      if(policy_traits::phase_fair){
+         //Admitted readers enter before the next writer phase and
+         //ticketed writers are served in FIFO order. Timed writers
+         //only enter if no ticketed writer is waiting.
+         return !m_num_admitted_readers &&
+            (ticketed ? m_now_serving == ticket : m_now_serving == m_next_ticket);
+      }
+      return true;
+   }
+
+   //Waits in a gate, returns false on timeout
+   static bool gate_wait(interprocess_condition &gate, scoped_lock_t &lck
+                        ,bool timed, const boost::posix_time::ptime &abs_time)
+   {
+      if(timed){
+         return gate.timed_wait(lck, abs_time);
+      }
+      gate.wait(lck);
+      return true;
+   }
+
+   //Serves the next ticket, skipping the abandoned ones
+   //(the caller must own m_mut)
+   void advance_now_serving()
+   {
+      do{
+         ++m_now_serving;
+         m_abandoned_tickets >>= 1;
+      }while(m_abandoned_tickets & 1u);
+   }
+
+   //Called with m_mut locked after an exclusive lock is released
+   //while there are blocked threads. In phase-fair mode readers
+   //blocked during the writer phase are admitted.
+   void exclusive_released()
+   {
+      if(policy_traits::phase_fair){
+         ++m_phase;
+         m_num_admitted_readers += m_num_blocked_readers;
+         m_num_blocked_readers = 0;
+      }
+      m_first_gate.notify_all();
+   }
+
+   //Slow paths, called with m_mut locked
+   bool do_lock(scoped_lock_t &lck, bool timed, const boost::posix_time::ptime &abs_time);
+   bool do_lock_sharable(scoped_lock_t &lck, bool upgradable, bool timed, const boost::posix_time::ptime &abs_time);
+
+   //Registers the calling thread (that must own m_mut) as a
+   //waiter for the lifetime of the object. Waiters must check
+   //the control word after being registered and before blocking.
+   struct waiter_registration
+   {
+      waiter_registration(interprocess_upgradable_mutex_t &mut)
+         :  m_mtx(mut)
+      {
+         if(!m_mtx.m_num_waiters++){
+            m_mtx.set_ctrl_bits(constants::waiters_in);
+         }
+      }
+
+      ~waiter_registration()
+      {
+         if(!--m_mtx.m_num_waiters){
+            m_mtx.clear_ctrl_bits(constants::waiters_in);
+         }
+      }
+      interprocess_upgradable_mutex_t &m_mtx;
+   };
+
+   //Registers a blocked writer so that new readers yield to it
+   //(only for policies where readers yield). If the writer gives up
+   //readers blocked by the pending mark are notified.
+   struct pending_writer_registration
+   {
+      pending_writer_registration(interprocess_upgradable_mutex_t &mut)
+         :  mp_mtx(policy_traits::readers_yield ? &mut : 0)
+      {
+         if(mp_mtx && !mp_mtx->m_num_pending_writers++){
+            mp_mtx->set_ctrl_bits(constants::writer_pending);
+         }
+      }
+
+      //The writer has marked the exclusive lock, which
+      //keeps readers out, so there is no need to notify them
+      void release()
+      {
+         if(mp_mtx && !--mp_mtx->m_num_pending_writers){
+            mp_mtx->clear_ctrl_bits(constants::writer_pending);
+         }
+         mp_mtx = 0;
+      }
+
+      ~pending_writer_registration()
+      {
+         if(mp_mtx && !--mp_mtx->m_num_pending_writers){
+            mp_mtx->clear_ctrl_bits(constants::writer_pending);
+            mp_mtx->m_first_gate.notify_all();
+         }
+      }
+      interprocess_upgradable_mutex_t *mp_mtx;
+   };
+
+   //Phase-fair bookkeeping of a reader that had to block. A reader
+   //blocked in a phase is admitted when the phase changes and the next
+   //writer waits until all admitted readers have entered or given up.
+   struct blocked_reader_registration
+   {
+      blocked_reader_registration(interprocess_upgradable_mutex_t &mut)
+         :  m_mtx(mut), m_blocked(false), m_phase(0)
+      {}
+
+      void block()
+      {
+         if(policy_traits::phase_fair && !m_blocked){
+            m_blocked = true;
+            m_phase = m_mtx.m_phase;
+            ++m_mtx.m_num_blocked_readers;
+         }
+      }
+
+      bool admitted() const
+      {  return m_blocked && m_phase != m_mtx.m_phase;  }
+
+      ~blocked_reader_registration()
+      {
+         if(m_blocked){
+            if(!this->admitted()){
+               --m_mtx.m_num_blocked_readers;
+            }
+            else if(!--m_mtx.m_num_admitted_readers){
+               //Writers can start the next phase
+               m_mtx.m_first_gate.notify_all();
+            }
+         }
+      }
+      interprocess_upgradable_mutex_t &m_mtx;
+      bool m_blocked;
+      boost::uint32_t m_phase;
+   };
+
+   //Phase-fair writer ticket. If the writer leaves the queue because
+   //of an exception, its turn is skipped: immediately if it's being
+   //served, otherwise when the previous tickets have been served.
+   struct ticket_rollback
+   {
+      ticket_rollback(interprocess_upgradable_mutex_t &mut, boost::uint32_t ticket)
+         :  mp_mtx(&mut), m_ticket(ticket)
+      {}
+
+      void release()
+      {  mp_mtx = 0;   }
+
+      ~ticket_rollback()
+      {
+         if(mp_mtx){
+            const boost::uint32_t pos = m_ticket - mp_mtx->m_now_serving;
+            if(!pos){
+               mp_mtx->advance_now_serving();
+               mp_mtx->m_first_gate.notify_all();
+            }
+            else{
+               mp_mtx->m_abandoned_tickets |= boost::uint32_t(1u) << pos;
+            }
+         }
+      }
+      interprocess_upgradable_mutex_t *mp_mtx;
+      boost::uint32_t m_ticket;
+   };
+
+   friend struct waiter_registration;
+   friend struct pending_writer_registration;
+   friend struct blocked_reader_registration;
+   friend struct ticket_rollback;
 
-   private:
    //Rollback structures for exceptions or failure return values
    struct exclusive_rollback
    {
-      exclusive_rollback(control_word_t         &ctrl
-                        ,interprocess_condition &first_gate)
-         :  mp_ctrl(&ctrl), m_first_gate(first_gate)
+      exclusive_rollback(interprocess_upgradable_mutex_t &mut)
+         :  mp_mtx(&mut)
       {}
 
       void release()
-      {  mp_ctrl = 0;   }
+      {  mp_mtx = 0;   }
 
       ~exclusive_rollback()
       {
-         if(mp_ctrl){
-            mp_ctrl->exclusive_in = 0;
-            m_first_gate.notify_all();
+         if(mp_mtx){
+            mp_mtx->clear_ctrl_bits(constants::exclusive_in);
+            mp_mtx->exclusive_released();
          }
       }
-      control_word_t          *mp_ctrl;
-      interprocess_condition  &m_first_gate;
+      interprocess_upgradable_mutex_t *mp_mtx;
    };
 
    struct upgradable_to_exclusive_rollback
    {
-      upgradable_to_exclusive_rollback(control_word_t         &ctrl)
-         :  mp_ctrl(&ctrl)
+      upgradable_to_exclusive_rollback(interprocess_upgradable_mutex_t &mut)
+         :  mp_mtx(&mut)
       {}
 
       void release()
-      {  mp_ctrl = 0;   }
+      {  mp_mtx = 0;   }
 
       ~upgradable_to_exclusive_rollback()
       {
-         if(mp_ctrl){
-            //Recover upgradable lock
-            mp_ctrl->upgradable_in = 1;
-            ++mp_ctrl->num_upr_shar;
-            //Execute the second half of exclusive locking
-            mp_ctrl->exclusive_in = 0;
+         if(mp_mtx){
+            //Recover upgradable lock and execute the
+            //second half of exclusive locking
+            boost::uint32_t c = mp_mtx->read_ctrl();
+            while(!mp_mtx->cas_ctrl(c, ((c & ~constants::exclusive_in) | constants::upgradable_in) + 1)){}
+            //Sharables blocked by the exclusive mark can enter again
+            mp_mtx->m_first_gate.notify_all();
          }
       }
-      control_word_t          *mp_ctrl;
+      interprocess_upgradable_mutex_t *mp_mtx;
    };
 
-   template<int Dummy>
-   struct base_constants_t
-   {
-      static const unsigned max_readers
-         = ~(unsigned(3) << (sizeof(unsigned)*CHAR_BIT-2));
-   };
-   typedef base_constants_t<0> constants;
+   friend struct exclusive_rollback;
+   friend struct upgradable_to_exclusive_rollback;
    /// @endcond
 };
 
+//!Upgradable mutex using the default (two gate) scheduling policy
+class interprocess_upgradable_mutex
+   :  public interprocess_upgradable_mutex_t<two_gate_policy>
+{
+   //Non-copyable
+   interprocess_upgradable_mutex(const interprocess_upgradable_mutex &);
+   interprocess_upgradable_mutex &operator=(const interprocess_upgradable_mutex &);
+
+   public:
+   //!Constructs the upgradable lock.
+   //!Throws interprocess_exception on error.
+   interprocess_upgradable_mutex()
+   {}
+};
+
 /// @cond
 
-template <int Dummy>
-const unsigned interprocess_upgradable_mutex::base_constants_t<Dummy>::max_readers;
+template <class Policy>
+const boost::uint32_t interprocess_upgradable_mutex_t<Policy>::constants::exclusive_in;
 
-inline interprocess_upgradable_mutex::interprocess_upgradable_mutex()
-{
-   this->m_ctrl.exclusive_in  = 0;
-   this->m_ctrl.upgradable_in = 0;
-   this->m_ctrl.num_upr_shar   = 0;
-}
+template <class Policy>
+const boost::uint32_t interprocess_upgradable_mutex_t<Policy>::constants::upgradable_in;
+
+template <class Policy>
+const boost::uint32_t interprocess_upgradable_mutex_t<Policy>::constants::waiters_in;
+
+template <class Policy>
+const boost::uint32_t interprocess_upgradable_mutex_t<Policy>::constants::writer_pending;
+
+template <class Policy>
+const boost::uint32_t interprocess_upgradable_mutex_t<Policy>::constants::max_readers;
+
+template <class Policy>
+const boost::uint32_t interprocess_upgradable_mutex_t<Policy>::constants::max_tickets;
+
+template <class Policy>
+inline interprocess_upgradable_mutex_t<Policy>::interprocess_upgradable_mutex_t()
+   :  m_ctrl(0), m_num_waiters(0), m_num_pending_writers(0)
+   ,  m_next_ticket(0), m_now_serving(0), m_abandoned_tickets(0), m_phase(0)
+   ,  m_num_blocked_readers(0), m_num_admitted_readers(0)
+{}
 
-inline interprocess_upgradable_mutex::~interprocess_upgradable_mutex()
+template <class Policy>
+inline interprocess_upgradable_mutex_t<Policy>::~interprocess_upgradable_mutex_t()
 {}
 
-inline void interprocess_upgradable_mutex::lock()
+template <class Policy>
+inline bool interprocess_upgradable_mutex_t<Policy>::do_lock
+   (scoped_lock_t &lck, bool timed, const boost::posix_time::ptime &abs_time)
 {
-   scoped_lock_t lck(m_mut);
+   waiter_registration registration(*this);
+   pending_writer_registration pending(*this);
 
-   //The exclusive lock must block in the first gate
-   //if an exclusive or upgradable lock has been acquired
-   while (this->m_ctrl.exclusive_in || this->m_ctrl.upgradable_in){
+   //Phase-fair writers blocked without timeout are served in FIFO order.
+   //Tickets are only handed out while abandoned ones can be recorded.
+   const bool ticketed = policy_traits::phase_fair && !timed;
+   while(ticketed && (m_next_ticket - m_now_serving) >= constants::max_tickets){
       this->m_first_gate.wait(lck);
    }
+   const boost::uint32_t ticket = ticketed ? m_next_ticket++ : 0;
+   ticket_rollback ticket_rb(*this, ticket);
+   if(!ticketed){
+      ticket_rb.release();
+   }
+
+   //The exclusive lock must block in the first gate
+   //until the policy allows marking it
+   boost::uint32_t c = this->read_ctrl();
+   do{
+      while(!this->can_mark_exclusive(c, ticketed, ticket)){
+         if(!gate_wait(this->m_first_gate, lck, timed, abs_time)){
+            c = this->read_ctrl();
+            if(!this->can_mark_exclusive(c, ticketed, ticket)){
+               return false;
+            }
+            break;
+         }
+         c = this->read_ctrl();
+      }
+      //Mark that exclusive lock has been acquired
+   }while(!this->cas_ctrl(c, c | constants::exclusive_in));
 
-   //Mark that exclusive lock has been acquired
-   this->m_ctrl.exclusive_in = 1;
+   pending.release();
+   if(ticketed){
+      this->advance_now_serving();
+      ticket_rb.release();
+   }
 
    //Prepare rollback
-   exclusive_rollback rollback(this->m_ctrl, this->m_first_gate);
+   exclusive_rollback rollback(*this);
 
    //Now wait until all readers are gone
-   while (this->m_ctrl.num_upr_shar){
-      this->m_second_gate.wait(lck);
+   while (num_upr_shar(this->read_ctrl())){
+      if(!gate_wait(this->m_second_gate, lck, timed, abs_time)){
+         if(num_upr_shar(this->read_ctrl())){
+            return false;
+         }
+         break;
+      }
    }
    rollback.release();
+   return true;
 }
 
-inline bool interprocess_upgradable_mutex::try_lock()
+template <class Policy>
+inline void interprocess_upgradable_mutex_t<Policy>::lock()
 {
-   scoped_lock_t lck(m_mut, try_to_lock);
+   //Fast path: no lock is held
+   if(this->try_lock()){
+      return;
+   }
+   scoped_lock_t lck(m_mut);
+   this->do_lock(lck, false, boost::posix_time::ptime());
+}
 
-   //If we can't lock or any has there is any exclusive, upgradable
+template <class Policy>
+inline bool interprocess_upgradable_mutex_t<Policy>::try_lock()
+{
+   //If there is any exclusive, upgradable
    //or sharable mark return false;
-   if(!lck.owns()
-      || this->m_ctrl.exclusive_in
-      || this->m_ctrl.num_upr_shar){
-      return false;
+   boost::uint32_t c = this->read_ctrl();
+   while(can_try_lock(c)){
+      if(this->cas_ctrl(c, c | constants::exclusive_in)){
+         return true;
+      }
    }
-   this->m_ctrl.exclusive_in = 1;
-   return true;
+   return false;
 }
 
-inline bool interprocess_upgradable_mutex::timed_lock
+template <class Policy>
+inline bool interprocess_upgradable_mutex_t<Policy>::timed_lock
    (const boost::posix_time::ptime &abs_time)
 {
    if(abs_time == boost::posix_time::pos_infin){
       this->lock();
       return true;
    }
+   if(this->try_lock()){
+      return true;
+   }
    scoped_lock_t lck(m_mut, abs_time);
    if(!lck.owns())   return false;
+   return this->do_lock(lck, true, abs_time);
+}
 
-   //The exclusive lock must block in the first gate
-   //if an exclusive or upgradable lock has been acquired
-   while (this->m_ctrl.exclusive_in || this->m_ctrl.upgradable_in){
-      if(!this->m_first_gate.timed_wait(lck, abs_time)){
-         if(this->m_ctrl.exclusive_in || this->m_ctrl.upgradable_in){
-            return false;
-         }
-         break;
-      }
+template <class Policy>
+inline void interprocess_upgradable_mutex_t<Policy>::unlock()
+{
+   //Only take the internal mutex if there are blocked threads
+   if(this->clear_ctrl_bits(constants::exclusive_in) & constants::waiters_in){
+      scoped_lock_t lck(m_mut);
+      this->exclusive_released();
    }
+}
 
-   //Mark that exclusive lock has been acquired
-   this->m_ctrl.exclusive_in = 1;
-
-   //Prepare rollback
-   exclusive_rollback rollback(this->m_ctrl, this->m_first_gate);
-
-   //Now wait until all readers are gone
-   while (this->m_ctrl.num_upr_shar){
-      if(!this->m_second_gate.timed_wait(lck, abs_time)){
-         if(this->m_ctrl.num_upr_shar){
-            return false;
+template <class Policy>
+inline bool interprocess_upgradable_mutex_t<Policy>::do_lock_sharable
+   (scoped_lock_t &lck, bool upgradable, bool timed, const boost::posix_time::ptime &abs_time)
+{
+   waiter_registration registration(*this);
+   blocked_reader_registration reader(*this);
+
+   //The sharable or upgradable lock must block in the first gate
+   //if an exclusive (or upgradable) lock has been acquired,
+   //if there are too many sharable locks or if the policy
+   //requires yielding to a pending writer
+   boost::uint32_t c = this->read_ctrl();
+   do{
+      while(!can_lock_sharable(c, upgradable, reader.admitted())){
+         reader.block();
+         if(!gate_wait(this->m_first_gate, lck, timed, abs_time)){
+            c = this->read_ctrl();
+            if(!can_lock_sharable(c, upgradable, reader.admitted())){
+               return false;
+            }
+            break;
          }
-         break;
+         c = this->read_ctrl();
       }
-   }
-   rollback.release();
+      //Increment sharable count (an upgradable lock is also
+      //marked and added to the sharable count)
+   }while(!this->cas_ctrl(c, (upgradable ? (c | constants::upgradable_in) : c) + 1));
    return true;
 }
 
-inline void interprocess_upgradable_mutex::unlock()
-{
-   scoped_lock_t lck(m_mut);
-   this->m_ctrl.exclusive_in = 0;
-   this->m_first_gate.notify_all();
-}
-
 //Upgradable locking
 
-inline void interprocess_upgradable_mutex::lock_upgradable()
+template <class Policy>
+inline void interprocess_upgradable_mutex_t<Policy>::lock_upgradable()
 {
-   scoped_lock_t lck(m_mut);
-
-   //The upgradable lock must block in the first gate
-   //if an exclusive or upgradable lock has been acquired
-   //or there are too many sharable locks
-   while(this->m_ctrl.exclusive_in || this->m_ctrl.upgradable_in
-         || this->m_ctrl.num_upr_shar == constants::max_readers){
-      this->m_first_gate.wait(lck);
+   //Fast path: no exclusive or upgradable lock is held
+   if(this->try_lock_upgradable()){
+      return;
    }
-
-   //Mark that upgradable lock has been acquired
-   //And add upgradable to the sharable count
-   this->m_ctrl.upgradable_in = 1;
-   ++this->m_ctrl.num_upr_shar;
+   scoped_lock_t lck(m_mut);
+   this->do_lock_sharable(lck, true, false, boost::posix_time::ptime());
 }
 
-inline bool interprocess_upgradable_mutex::try_lock_upgradable()
+template <class Policy>
+inline bool interprocess_upgradable_mutex_t<Policy>::try_lock_upgradable()
 {
-   scoped_lock_t lck(m_mut, try_to_lock);
-
    //The upgradable lock must fail
    //if an exclusive or upgradable lock has been acquired
    //or there are too many sharable locks
-   if(!lck.owns()
-      || this->m_ctrl.exclusive_in
-      || this->m_ctrl.upgradable_in
-      || this->m_ctrl.num_upr_shar == constants::max_readers){
-      return false;
+   boost::uint32_t c = this->read_ctrl();
+   while(can_lock_sharable(c, true, false)){
+      //Mark that upgradable lock has been acquired
+      //And add upgradable to the sharable count
+      if(this->cas_ctrl(c, (c | constants::upgradable_in) + 1)){
+         return true;
+      }
    }
-
-   //Mark that upgradable lock has been acquired
-   //And add upgradable to the sharable count
-   this->m_ctrl.upgradable_in = 1;
-   ++this->m_ctrl.num_upr_shar;
-   return true;
+   return false;
 }
 
-inline bool interprocess_upgradable_mutex::timed_lock_upgradable
+template <class Policy>
+inline bool interprocess_upgradable_mutex_t<Policy>::timed_lock_upgradable
    (const boost::posix_time::ptime &abs_time)
 {
    if(abs_time == boost::posix_time::pos_infin){
       this->lock_upgradable();
       return true;
    }
+   if(this->try_lock_upgradable()){
+      return true;
+   }
    scoped_lock_t lck(m_mut, abs_time);
    if(!lck.owns())   return false;
-
-   //The upgradable lock must block in the first gate
-   //if an exclusive or upgradable lock has been acquired
-   //or there are too many sharable locks
-   while(this->m_ctrl.exclusive_in
-         || this->m_ctrl.upgradable_in
-         || this->m_ctrl.num_upr_shar == constants::max_readers){
-      if(!this->m_first_gate.timed_wait(lck, abs_time)){
-         if((this->m_ctrl.exclusive_in
-             || this->m_ctrl.upgradable_in
-             || this->m_ctrl.num_upr_shar == constants::max_readers)){
-            return false;
-         }
-         break;
-      }
-   }
-
-   //Mark that upgradable lock has been acquired
-   //And add upgradable to the sharable count
-   this->m_ctrl.upgradable_in = 1;
-   ++this->m_ctrl.num_upr_shar;
-   return true;
+   return this->do_lock_sharable(lck, true, true, abs_time);
 }
 
-inline void interprocess_upgradable_mutex::unlock_upgradable()
+template <class Policy>
+inline void interprocess_upgradable_mutex_t<Policy>::unlock_upgradable()
 {
-   scoped_lock_t lck(m_mut);
-   //Mark that upgradable lock has been acquired
-   //And add upgradable to the sharable count
-   this->m_ctrl.upgradable_in = 0;
-   --this->m_ctrl.num_upr_shar;
-   this->m_first_gate.notify_all();
+   //Unmark upgradable lock and remove it from the sharable count
+   boost::uint32_t c = this->read_ctrl();
+   while(!this->cas_ctrl(c, (c & ~constants::upgradable_in) - 1)){}
+   if(c & constants::waiters_in){
+      scoped_lock_t lck(m_mut);
+      this->m_first_gate.notify_all();
+   }
 }
 
 //Sharable locking
 
-inline void interprocess_upgradable_mutex::lock_sharable()
+template <class Policy>
+inline void interprocess_upgradable_mutex_t<Policy>::lock_sharable()
 {
-   scoped_lock_t lck(m_mut);
-
-   //The sharable lock must block in the first gate
-   //if an exclusive lock has been acquired
-   //or there are too many sharable locks
-   while(this->m_ctrl.exclusive_in
-        || this->m_ctrl.num_upr_shar == constants::max_readers){
-      this->m_first_gate.wait(lck);
+   //Fast path: no exclusive lock is held
+   if(this->try_lock_sharable()){
+      return;
    }
-
-   //Increment sharable count
-   ++this->m_ctrl.num_upr_shar;
+   scoped_lock_t lck(m_mut);
+   this->do_lock_sharable(lck, false, false, boost::posix_time::ptime());
 }
 
-inline bool interprocess_upgradable_mutex::try_lock_sharable()
+template <class Policy>
+inline bool interprocess_upgradable_mutex_t<Policy>::try_lock_sharable()
 {
-   scoped_lock_t lck(m_mut, try_to_lock);
-
    //The sharable lock must fail
    //if an exclusive lock has been acquired
    //or there are too many sharable locks
-   if(!lck.owns()
-      || this->m_ctrl.exclusive_in
-      || this->m_ctrl.num_upr_shar == constants::max_readers){
-      return false;
+   boost::uint32_t c = this->read_ctrl();
+   while(can_lock_sharable(c, false, false)){
+      //Increment sharable count
+      if(this->cas_ctrl(c, c + 1)){
+         return true;
+      }
    }
-
-   //Increment sharable count
-   ++this->m_ctrl.num_upr_shar;
-   return true;
+   return false;
 }
 
-inline bool interprocess_upgradable_mutex::timed_lock_sharable
+template <class Policy>
+inline bool interprocess_upgradable_mutex_t<Policy>::timed_lock_sharable
    (const boost::posix_time::ptime &abs_time)
 {
    if(abs_time == boost::posix_time::pos_infin){
       this->lock_sharable();
       return true;
    }
+   if(this->try_lock_sharable()){
+      return true;
+   }
    scoped_lock_t lck(m_mut, abs_time);
    if(!lck.owns())   return false;
-
-   //The sharable lock must block in the first gate
-   //if an exclusive lock has been acquired
-   //or there are too many sharable locks
-   while (this->m_ctrl.exclusive_in
-         || this->m_ctrl.num_upr_shar == constants::max_readers){
-      if(!this->m_first_gate.timed_wait(lck, abs_time)){   
-         if(this->m_ctrl.exclusive_in
-            || this->m_ctrl.num_upr_shar == constants::max_readers){
-            return false;
-         }
-         break;
-      }
-   }
-
-   //Increment sharable count
-   ++this->m_ctrl.num_upr_shar;
-   return true;
+   return this->do_lock_sharable(lck, false, true, abs_time);
 }
 
-inline void interprocess_upgradable_mutex::unlock_sharable()
+template <class Policy>
+inline void interprocess_upgradable_mutex_t<Policy>::unlock_sharable()
 {
-   scoped_lock_t lck(m_mut);
    //Decrement sharable count
-   --this->m_ctrl.num_upr_shar;
-   if (this->m_ctrl.num_upr_shar == 0){
-      this->m_second_gate.notify_one();
-   }
-   //Check if there are blocked sharables because of
-   //there were too many sharables
-   else if(this->m_ctrl.num_upr_shar == (constants::max_readers-1)){
-      this->m_first_gate.notify_all();
+   boost::uint32_t c = this->read_ctrl();
+   while(!this->cas_ctrl(c, c - 1)){}
+
+   //Only take the internal mutex if there are blocked threads
+   if(c & constants::waiters_in){
+      scoped_lock_t lck(m_mut);
+      const boost::uint32_t num = num_upr_shar(c) - 1;
+      if (num == 0){
+         this->m_second_gate.notify_one();
+         //Writers that don't announce themselves wait
+         //in the first gate until all readers are gone
+         if(!policy_traits::announce_writer){
+            this->m_first_gate.notify_all();
+         }
+      }
+      //Check if there are blocked sharables because of
+      //there were too many sharables
+      else if(num == (constants::max_readers-1)){
+         this->m_first_gate.notify_all();
+      }
    }
 }
 
 //Downgrading
 
-inline void interprocess_upgradable_mutex::unlock_and_lock_upgradable()
+template <class Policy>
+inline void interprocess_upgradable_mutex_t<Policy>::unlock_and_lock_upgradable()
 {
-   scoped_lock_t lck(m_mut);
-   //Unmark it as exclusive
-   this->m_ctrl.exclusive_in     = 0;
-   //Mark it as upgradable
-   this->m_ctrl.upgradable_in    = 1;
-   //The sharable count should be 0 so increment it
-   this->m_ctrl.num_upr_shar   = 1;
+   //Unmark it as exclusive, mark it as upgradable
+   //and increment the sharable count (it should be 0)
+   boost::uint32_t c = this->read_ctrl();
+   while(!this->cas_ctrl(c, ((c & ~constants::exclusive_in) | constants::upgradable_in) + 1)){}
    //Notify readers that they can enter
-   m_first_gate.notify_all();
+   if(c & constants::waiters_in){
+      scoped_lock_t lck(m_mut);
+      this->exclusive_released();
+   }
 }
 
-inline void interprocess_upgradable_mutex::unlock_and_lock_sharable()
+template <class Policy>
+inline void interprocess_upgradable_mutex_t<Policy>::unlock_and_lock_sharable()
 {
-   scoped_lock_t lck(m_mut);
-   //Unmark it as exclusive
-   this->m_ctrl.exclusive_in   = 0;
-   //The sharable count should be 0 so increment it
-   this->m_ctrl.num_upr_shar   = 1;
+   //Unmark it as exclusive and increment
+   //the sharable count (it should be 0)
+   boost::uint32_t c = this->read_ctrl();
+   while(!this->cas_ctrl(c, (c & ~constants::exclusive_in) + 1)){}
    //Notify readers that they can enter
-   m_first_gate.notify_all();
+   if(c & constants::waiters_in){
+      scoped_lock_t lck(m_mut);
+      this->exclusive_released();
+   }
 }
 
-inline void interprocess_upgradable_mutex::unlock_upgradable_and_lock_sharable()
+template <class Policy>
+inline void interprocess_upgradable_mutex_t<Policy>::unlock_upgradable_and_lock_sharable()
 {
-   scoped_lock_t lck(m_mut);
    //Unmark it as upgradable (we don't have to decrement count)
-   this->m_ctrl.upgradable_in    = 0;
-   //Notify readers/upgradable that they can enter
-   m_first_gate.notify_all();
+   //and notify readers/upgradable that they can enter
+   if(this->clear_ctrl_bits(constants::upgradable_in) & constants::waiters_in){
+      scoped_lock_t lck(m_mut);
+      this->m_first_gate.notify_all();
+   }
 }
 
 //Upgrading
 
-inline void interprocess_upgradable_mutex::unlock_upgradable_and_lock()
+template <class Policy>
+inline void interprocess_upgradable_mutex_t<Policy>::unlock_upgradable_and_lock()
 {
-   scoped_lock_t lck(m_mut);
    //Simulate unlock_upgradable() without
-   //notifying sharables.
-   this->m_ctrl.upgradable_in = 0;
-   --this->m_ctrl.num_upr_shar;
-   //Execute the second half of exclusive locking
-   this->m_ctrl.exclusive_in = 1;
+   //notifying sharables and execute the
+   //first half of exclusive locking
+   boost::uint32_t c = this->read_ctrl();
+   while(!this->cas_ctrl(c, ((c & ~constants::upgradable_in) | constants::exclusive_in) - 1)){}
+
+   //Fast path: there were no other readers
+   if(num_upr_shar(c) == 1){
+      return;
+   }
+
+   scoped_lock_t lck(m_mut);
+   waiter_registration registration(*this);
 
    //Prepare rollback
-   upgradable_to_exclusive_rollback rollback(m_ctrl);
+   upgradable_to_exclusive_rollback rollback(*this);
 
-   while (this->m_ctrl.num_upr_shar){
+   while (num_upr_shar(this->read_ctrl())){
       this->m_second_gate.wait(lck);
    }
    rollback.release();
 }
 
-inline bool interprocess_upgradable_mutex::try_unlock_upgradable_and_lock()
+template <class Policy>
+inline bool interprocess_upgradable_mutex_t<Policy>::try_unlock_upgradable_and_lock()
 {
-   scoped_lock_t lck(m_mut, try_to_lock);
    //Check if there are no readers
-   if(!lck.owns()
-      || this->m_ctrl.num_upr_shar != 1){
-      return false;
-   }
-   //Now unlock upgradable and mark exclusive
-   this->m_ctrl.upgradable_in = 0;
-   --this->m_ctrl.num_upr_shar;
-   this->m_ctrl.exclusive_in = 1;
-   return true;
+   boost::uint32_t c = this->read_ctrl();
+   while(num_upr_shar(c) == 1){
+      //Now unlock upgradable and mark exclusive
+      if(this->cas_ctrl(c, ((c & ~constants::upgradable_in) | constants::exclusive_in) - 1)){
+         return true;
+      }
+   }
+   return false;
 }
 
-inline bool interprocess_upgradable_mutex::timed_unlock_upgradable_and_lock
+template <class Policy>
+inline bool interprocess_upgradable_mutex_t<Policy>::timed_unlock_upgradable_and_lock
    (const boost::posix_time::ptime &abs_time)
 {
    if(abs_time == boost::posix_time::pos_infin){
       this->unlock_upgradable_and_lock();
       return true;
    }
+   if(this->try_unlock_upgradable_and_lock()){
+      return true;
+   }
    scoped_lock_t lck(m_mut, abs_time);
    if(!lck.owns())   return false;
+   waiter_registration registration(*this);
 
    //Simulate unlock_upgradable() without
-   //notifying sharables.
-   this->m_ctrl.upgradable_in = 0;
-   --this->m_ctrl.num_upr_shar;
-   //Execute the second half of exclusive locking
-   this->m_ctrl.exclusive_in = 1;
+   //notifying sharables and execute the
+   //first half of exclusive locking
+   boost::uint32_t c = this->read_ctrl();
+   while(!this->cas_ctrl(c, ((c & ~constants::upgradable_in) | constants::exclusive_in) - 1)){}
 
    //Prepare rollback
-   upgradable_to_exclusive_rollback rollback(m_ctrl);
+   upgradable_to_exclusive_rollback rollback(*this);
 
-   while (this->m_ctrl.num_upr_shar){
+   while (num_upr_shar(this->read_ctrl())){
       if(!this->m_second_gate.timed_wait(lck, abs_time)){
-         if(this->m_ctrl.num_upr_shar){
+         if(num_upr_shar(this->read_ctrl())){
             return false;
          }
          break;
@@ -636,38 +972,34 @@ inline bool interprocess_upgradable_mutex::timed_unlock_upgradable_and_lock
    return true;
 }
 
-inline bool interprocess_upgradable_mutex::try_unlock_sharable_and_lock()
+template <class Policy>
+inline bool interprocess_upgradable_mutex_t<Policy>::try_unlock_sharable_and_lock()
 {
-   scoped_lock_t lck(m_mut, try_to_lock);
-
-   //If we can't lock or any has there is any exclusive, upgradable
-   //or sharable mark return false;
-   if(!lck.owns()
-      || this->m_ctrl.exclusive_in
-      || this->m_ctrl.upgradable_in
-      || this->m_ctrl.num_upr_shar != 1){
-      return false;
-   }
-   this->m_ctrl.exclusive_in = 1;
-   this->m_ctrl.num_upr_shar = 0;
-   return true;
+   //If there is any exclusive, upgradable
+   //or other sharable mark return false;
+   boost::uint32_t c = this->read_ctrl();
+   while(!(c & (constants::exclusive_in | constants::upgradable_in))
+         && num_upr_shar(c) == 1){
+      if(this->cas_ctrl(c, (c - 1) | constants::exclusive_in)){
+         return true;
+      }
+   }
+   return false;
 }
 
-inline bool interprocess_upgradable_mutex::try_unlock_sharable_and_lock_upgradable()
+template <class Policy>
+inline bool interprocess_upgradable_mutex_t<Policy>::try_unlock_sharable_and_lock_upgradable()
 {
-   scoped_lock_t lck(m_mut, try_to_lock);
-
    //The upgradable lock must fail
    //if an exclusive or upgradable lock has been acquired
-   if(!lck.owns()
-      || this->m_ctrl.exclusive_in
-      || this->m_ctrl.upgradable_in){
-      return false;
+   boost::uint32_t c = this->read_ctrl();
+   while(!(c & (constants::exclusive_in | constants::upgradable_in))){
+      //Mark that upgradable lock has been acquired
+      if(this->cas_ctrl(c, c | constants::upgradable_in)){
+         return true;
+      }
    }
-
-   //Mark that upgradable lock has been acquired
-   this->m_ctrl.upgradable_in = 1;
-   return true;
+   return false;
 }
 
 /// @endcond
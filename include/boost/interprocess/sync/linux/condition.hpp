@@ -0,0 +1,279 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOST_INTERPROCESS_DETAIL_FUTEX_CONDITION_HPP
+#define BOOST_INTERPROCESS_DETAIL_FUTEX_CONDITION_HPP
+
+#if (defined _MSC_VER) && (_MSC_VER >= 1200)
+#  pragma once
+#endif
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/detail/workaround.hpp>
+#include <boost/interprocess/sync/spin/mutex.hpp>
+#include <boost/interprocess/sync/linux/futex_helpers.hpp>
+#include <boost/interprocess/detail/posix_time_types_wrk.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <climits>
+
+namespace boost {
+namespace interprocess {
+namespace ipcdetail {
+
+//!Condition variable based on a futex sequence counter. Waiters sleep on
+//!the sequence word and notifications increment it before waking, so
+//!notify_one wakes a single waiter and notifications with no waiters
+//!don't issue any syscall.
+//!
+//!When waiting with a spin_mutex, notify_all wakes a single waiter and
+//!requeues the rest to the mutex futex, so that they are woken one by one
+//!as the mutex is released. As with offset_ptr, this requires that the
+//!condition and the mutex are placed in the same mapped region. The
+//!condition is bound to the spin_mutex of its first waiter: once it's
+//!waited with another mutex, notify_all wakes all waiters. Define
+//!BOOST_INTERPROCESS_FUTEX_CONDITION_NO_REQUEUE to always wake all waiters.
+class futex_condition
+{
+   futex_condition(const futex_condition &);
+   futex_condition &operator=(const futex_condition &);
+   public:
+   futex_condition();
+   ~futex_condition();
+
+   void notify_one();
+   void notify_all();
+
+   template <typename L>
+   bool timed_wait(L& lock, const boost::posix_time::ptime &abs_time)
+   {
+      if(abs_time == boost::posix_time::pos_infin){
+         this->wait(lock);
+         return true;
+      }
+      if (!lock)
+         throw lock_exception();
+      return this->do_timed_wait(abs_time, *lock.mutex());
+   }
+
+   template <typename L, typename Pr>
+   bool timed_wait(L& lock, const boost::posix_time::ptime &abs_time, Pr pred)
+   {
+      if(abs_time == boost::posix_time::pos_infin){
+         this->wait(lock, pred);
+         return true;
+      }
+      if (!lock)
+         throw lock_exception();
+      while (!pred()){
+         if (!this->do_timed_wait(abs_time, *lock.mutex()))
+            return pred();
+      }
+      return true;
+   }
+
+   template <typename L>
+   void wait(L& lock)
+   {
+      if (!lock)
+         throw lock_exception();
+      do_wait(*lock.mutex());
+   }
+
+   template <typename L, typename Pr>
+   void wait(L& lock, Pr pred)
+   {
+      if (!lock)
+         throw lock_exception();
+
+      while (!pred())
+         do_wait(*lock.mutex());
+   }
+
+   template<class InterprocessMutex>
+   void do_wait(InterprocessMutex &mut);
+
+   template<class InterprocessMutex>
+   bool do_timed_wait(const boost::posix_time::ptime &abs_time, InterprocessMutex &mut);
+
+   private:
+   template<class InterprocessMutex>
+   bool do_timed_wait(bool tout_enabled, const boost::posix_time::ptime &abs_time, InterprocessMutex &mut);
+
+   //Generic mutexes can't be requeued, waiters are just woken
+   template<class InterprocessMutex>
+   void register_mutex(InterprocessMutex &)
+   {  this->disable_requeue();  }
+
+   template<class InterprocessMutex>
+   void relock(InterprocessMutex &mut)
+   {  mut.lock(); }
+
+   void register_mutex(spin_mutex &mut);
+   void relock(spin_mutex &mut);
+   void disable_requeue();
+
+   enum { RequeueUnbound, RequeueBound, RequeueDisabled };
+
+   volatile boost::uint32_t   m_seq;
+   volatile boost::uint32_t   m_num_waiters;
+   //RequeueUnbound until the first spin_mutex waiter binds the
+   //condition to its mutex, RequeueDisabled after a wait with another mutex
+   volatile boost::uint32_t   m_requeue;
+   //Distance from this object to the futex word of the bound
+   //spin_mutex or 0 if unknown
+   volatile std::ptrdiff_t    m_mutex_off;
+};
+
+inline futex_condition::futex_condition()
+{
+   //Note that this class is initialized to zero.
+   //So zeroed memory can be interpreted as an initialized
+   //condition variable
+   m_seq          = 0;
+   m_num_waiters  = 0;
+   m_requeue      = RequeueUnbound;
+   m_mutex_off    = 0;
+}
+
+inline futex_condition::~futex_condition()
+{
+   //Trivial destructor
+}
+
+inline void futex_condition::notify_one()
+{
+   //No syscall if nobody is waiting
+   if(!atomic_read32(&m_num_waiters)){
+      return;
+   }
+   atomic_inc32(&m_seq);
+   futex_wake(&m_seq, 1);
+}
+
+inline void futex_condition::notify_all()
+{
+   if(!atomic_read32(&m_num_waiters)){
+      return;
+   }
+   const boost::uint32_t seq = atomic_inc32(&m_seq) + 1;
+   //A waiter that disables requeueing changes the sequence before sleeping,
+   //so if it's racing with this notification the requeue below fails
+   const std::ptrdiff_t off = atomic_read32(&m_requeue) == RequeueBound ? m_mutex_off : 0;
+   if(off){
+      volatile boost::uint32_t *const mutex_word = reinterpret_cast<volatile boost::uint32_t*>
+         (const_cast<char*>(reinterpret_cast<const volatile char*>(this)) + off);
+      //If the sequence has changed, another notification is racing with
+      //this one, so just wake everybody
+      if(futex_cmp_requeue(&m_seq, 1, mutex_word, INT_MAX, seq)){
+         return;
+      }
+   }
+   futex_wake_all(&m_seq);
+}
+
+inline void futex_condition::register_mutex(spin_mutex &mut)
+{
+   #if !defined(BOOST_INTERPROCESS_FUTEX_CONDITION_NO_REQUEUE)
+   const std::ptrdiff_t off = reinterpret_cast<const volatile char*>(&mut.m_s) -
+                              reinterpret_cast<const volatile char*>(this);
+   boost::uint32_t state = atomic_read32(&m_requeue);
+   if(state == RequeueUnbound){
+      state = atomic_cas32(&m_requeue, RequeueBound, RequeueUnbound);
+      if(state == RequeueUnbound){
+         //Until the offset is written notify_all just wakes all waiters
+         m_mutex_off = off;
+         return;
+      }
+   }
+   //Waiters with the bound mutex are serialized with the waiter that
+   //bound it, so a different offset means that the mutex is another one
+   //or that it's still being bound by a waiter with another mutex
+   if(state == RequeueBound && m_mutex_off != off){
+      this->disable_requeue();
+   }
+   #else
+   (void)mut;
+   #endif
+}
+
+inline void futex_condition::disable_requeue()
+{
+   #if !defined(BOOST_INTERPROCESS_FUTEX_CONDITION_NO_REQUEUE)
+   if(atomic_read32(&m_requeue) != RequeueDisabled){
+      atomic_write32(&m_requeue, RequeueDisabled);
+      //Makes a notify_all that read the previous state fail to requeue,
+      //this waiter reads the sequence after the change
+      atomic_inc32(&m_seq);
+   }
+   #endif
+}
+
+inline void futex_condition::relock(spin_mutex &mut)
+{
+   #if !defined(BOOST_INTERPROCESS_FUTEX_CONDITION_NO_REQUEUE)
+   //We might have been requeued to the mutex futex
+   mut.lock_contended();
+   #else
+   mut.lock();
+   #endif
+}
+
+template<class InterprocessMutex>
+inline void futex_condition::do_wait(InterprocessMutex &mut)
+{
+   this->do_timed_wait(false, boost::posix_time::ptime(), mut);
+}
+
+template<class InterprocessMutex>
+inline bool futex_condition::do_timed_wait
+   (const boost::posix_time::ptime &abs_time, InterprocessMutex &mut)
+{
+   return this->do_timed_wait(true, abs_time, mut);
+}
+
+template<class InterprocessMutex>
+inline bool futex_condition::do_timed_wait(bool tout_enabled,
+                                     const boost::posix_time::ptime &abs_time,
+                                     InterprocessMutex &mut)
+{
+   //The external mutex is locked, so the waiter count and the sequence
+   //are recorded before any notification for a state change
+   //protected by the mutex can be issued.
+   this->register_mutex(mut);
+   atomic_inc32(&m_num_waiters);
+   const boost::uint32_t seq = atomic_read32(&m_seq);
+   mut.unlock();
+
+   //If the sequence has changed after unlocking the mutex
+   //the kernel returns immediately
+   bool timed_out = false;
+   if(tout_enabled){
+      timed_out = !futex_timed_wait(&m_seq, seq, abs_time);
+   }
+   else{
+      futex_wait(&m_seq, seq);
+   }
+
+   atomic_dec32(&m_num_waiters);
+   //Lock external again before returning from the method
+   this->relock(mut);
+   return !timed_out;
+}
+
+}  //namespace ipcdetail
+}  //namespace interprocess
+}  //namespace boost
+
+#include <boost/interprocess/detail/config_end.hpp>
+
+#endif   //BOOST_INTERPROCESS_DETAIL_FUTEX_CONDITION_HPP
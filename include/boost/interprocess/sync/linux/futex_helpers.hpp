@@ -0,0 +1,120 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOST_INTERPROCESS_DETAIL_FUTEX_HELPERS_HPP
+#define BOOST_INTERPROCESS_DETAIL_FUTEX_HELPERS_HPP
+
+#if (defined _MSC_VER) && (_MSC_VER >= 1200)
+#  pragma once
+#endif
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/detail/workaround.hpp>
+#include <boost/interprocess/detail/posix_time_types_wrk.hpp>
+#include <boost/interprocess/sync/posix/ptime_to_timespec.hpp>
+#include <boost/cstdint.hpp>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <climits>
+
+//Number of iterations a futex based primitive spins in user space
+//before going to sleep in the kernel
+#ifndef BOOST_INTERPROCESS_FUTEX_SPIN_COUNT
+   #define BOOST_INTERPROCESS_FUTEX_SPIN_COUNT 128
+#endif
+
+namespace boost {
+namespace interprocess {
+namespace ipcdetail {
+
+//All futex operations are issued without FUTEX_PRIVATE_FLAG
+//as futex words are placed in memory shared between processes.
+inline long futex_syscall
+   ( volatile boost::uint32_t *uaddr, int op, boost::uint32_t val
+   , const timespec *ts, volatile boost::uint32_t *uaddr2, boost::uint32_t val3)
+{
+   return ::syscall( SYS_futex, const_cast<boost::uint32_t*>(uaddr), op, val
+                   , ts, const_cast<boost::uint32_t*>(uaddr2), val3);
+}
+
+//!Hints the processor that the caller is spinning
+inline void futex_cpu_relax()
+{
+   #if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+   __asm__ __volatile__("pause" ::: "memory");
+   #else
+   __asm__ __volatile__("" ::: "memory");
+   #endif
+}
+
+//!Blocks the calling thread if *uaddr == val until futex_wake is called
+//!on uaddr. Spurious wakeups are possible so callers must recheck the
+//!futex word.
+inline void futex_wait(volatile boost::uint32_t *uaddr, boost::uint32_t val)
+{  futex_syscall(uaddr, FUTEX_WAIT, val, 0, 0, 0);  }
+
+//!Same as futex_wait but returns false if abs_time (UTC) is reached
+//!before the thread is woken. Spurious wakeups are possible.
+inline bool futex_timed_wait
+   (volatile boost::uint32_t *uaddr, boost::uint32_t val, const boost::posix_time::ptime &abs_time)
+{
+   if(abs_time == boost::posix_time::pos_infin){
+      futex_wait(uaddr, val);
+      return true;
+   }
+   const timespec ts = ptime_to_timespec(abs_time);
+   if(ts.tv_sec < 0 || ts.tv_nsec < 0){
+      return false;
+   }
+   //FUTEX_WAIT_BITSET takes an absolute timeout, CLOCK_REALTIME
+   //is the clock used by microsec_clock::universal_time()
+   if(-1 == futex_syscall( uaddr, FUTEX_WAIT_BITSET | FUTEX_CLOCK_REALTIME, val
+                         , &ts, 0, FUTEX_BITSET_MATCH_ANY)){
+      return errno != ETIMEDOUT;
+   }
+   return true;
+}
+
+//!Wakes up to "count" threads blocked in uaddr.
+//!Returns the number of woken threads.
+inline int futex_wake(volatile boost::uint32_t *uaddr, int count)
+{
+   const long ret = futex_syscall(uaddr, FUTEX_WAKE, boost::uint32_t(count), 0, 0, 0);
+   return ret < 0 ? 0 : int(ret);
+}
+
+//!Wakes all threads blocked in uaddr.
+inline int futex_wake_all(volatile boost::uint32_t *uaddr)
+{  return futex_wake(uaddr, INT_MAX);  }
+
+//!If *uaddr == val, wakes up to "wake_count" threads blocked in uaddr and
+//!moves up to "requeue_count" of the remaining ones to wait on uaddr2.
+//!Returns false if *uaddr != val, so no thread was woken or requeued.
+inline bool futex_cmp_requeue
+   ( volatile boost::uint32_t *uaddr, int wake_count
+   , volatile boost::uint32_t *uaddr2, int requeue_count, boost::uint32_t val)
+{
+   //For FUTEX_CMP_REQUEUE the timeout argument carries the requeue count
+   return -1 != futex_syscall
+      ( uaddr, FUTEX_CMP_REQUEUE, boost::uint32_t(wake_count)
+      , reinterpret_cast<const timespec*>(static_cast<long>(requeue_count)), uaddr2, val);
+}
+
+}  //namespace ipcdetail {
+}  //namespace interprocess {
+}  //namespace boost {
+
+#include <boost/interprocess/detail/config_end.hpp>
+
+#endif   //BOOST_INTERPROCESS_DETAIL_FUTEX_HELPERS_HPP
@@ -41,32 +41,34 @@ class named_condition;
 //!A sharable mutex with a global name, so it can be found from different
 //!processes. This mutex can't be placed in shared memory, and
 //!each process should have it's own named sharable mutex.
-class named_sharable_mutex
+//!All processes opening the mutex must use the same Policy.
+template<class Policy>
+class named_sharable_mutex_t
 {
    /// @cond
    //Non-copyable
-   named_sharable_mutex();
-   named_sharable_mutex(const named_sharable_mutex &);
-   named_sharable_mutex &operator=(const named_sharable_mutex &);
+   named_sharable_mutex_t();
+   named_sharable_mutex_t(const named_sharable_mutex_t &);
+   named_sharable_mutex_t &operator=(const named_sharable_mutex_t &);
    /// @endcond
    public:
 
    //!Creates a global sharable mutex with a name.
    //!If the sharable mutex can't be created throws interprocess_exception
-   named_sharable_mutex(create_only_t create_only, const char *name, const permissions &perm = permissions());
+   named_sharable_mutex_t(create_only_t create_only, const char *name, const permissions &perm = permissions());
 
    //!Opens or creates a global sharable mutex with a name.
    //!If the sharable mutex is created, this call is equivalent to
-   //!named_sharable_mutex(create_only_t, ...)
+   //!named_sharable_mutex_t(create_only_t, ...)
    //!If the sharable mutex is already created, this call is equivalent to
-   //!named_sharable_mutex(open_only_t, ... ).
-   named_sharable_mutex(open_or_create_t open_or_create, const char *name, const permissions &perm = permissions());
+   //!named_sharable_mutex_t(open_only_t, ... ).
+   named_sharable_mutex_t(open_or_create_t open_or_create, const char *name, const permissions &perm = permissions());
 
    //!Opens a global sharable mutex with a name if that sharable mutex
    //!is previously.
    //!created. If it is not previously created this function throws
    //!interprocess_exception.
-   named_sharable_mutex(open_only_t open_only, const char *name);
+   named_sharable_mutex_t(open_only_t open_only, const char *name);
 
    //!Destroys *this and indicates that the calling process is finished using
    //!the resource. The destructor function will deallocate
@@ -74,7 +76,7 @@ class named_sharable_mutex
    //!this resource. The resource can still be opened again calling
    //!the open constructor overload. To erase the resource from the system
    //!use remove().
-   ~named_sharable_mutex();
+   ~named_sharable_mutex_t();
 
    //Exclusive locking
 
@@ -141,25 +143,30 @@ class named_sharable_mutex
    friend class ipcdetail::interprocess_tester;
    void dont_close_on_destruction();
 
-   interprocess_sharable_mutex *mutex() const
-   {  return static_cast<interprocess_sharable_mutex*>(m_shmem.get_user_address()); }
+   interprocess_sharable_mutex_t<Policy> *mutex() const
+   {  return static_cast<interprocess_sharable_mutex_t<Policy>*>(m_shmem.get_user_address()); }
 
    typedef ipcdetail::managed_open_or_create_impl<shared_memory_object, 0, true, false> open_create_impl_t;
    open_create_impl_t m_shmem;
-   typedef ipcdetail::named_creation_functor<interprocess_sharable_mutex> construct_func_t;
+   typedef ipcdetail::named_creation_functor<interprocess_sharable_mutex_t<Policy> > construct_func_t;
    /// @endcond
 };
 
+//!Named sharable mutex using the default (two gate) scheduling policy
+typedef named_sharable_mutex_t<two_gate_policy> named_sharable_mutex;
+
 /// @cond
 
-inline named_sharable_mutex::~named_sharable_mutex()
+template<class Policy>
+inline named_sharable_mutex_t<Policy>::~named_sharable_mutex_t()
 {}
 
-inline named_sharable_mutex::named_sharable_mutex
+template<class Policy>
+inline named_sharable_mutex_t<Policy>::named_sharable_mutex_t
    (create_only_t, const char *name, const permissions &perm)
    :  m_shmem  (create_only
                ,name
-               ,sizeof(interprocess_sharable_mutex) +
+               ,sizeof(interprocess_sharable_mutex_t<Policy>) +
                   open_create_impl_t::ManagedOpenOrCreateUserOffset
                ,read_write
                ,0
@@ -167,11 +174,12 @@ inline named_sharable_mutex::named_sharable_mutex
                ,perm)
 {}
 
-inline named_sharable_mutex::named_sharable_mutex
+template<class Policy>
+inline named_sharable_mutex_t<Policy>::named_sharable_mutex_t
    (open_or_create_t, const char *name, const permissions &perm)
    :  m_shmem  (open_or_create
                ,name
-               ,sizeof(interprocess_sharable_mutex) +
+               ,sizeof(interprocess_sharable_mutex_t<Policy>) +
                   open_create_impl_t::ManagedOpenOrCreateUserOffset
                ,read_write
                ,0
@@ -179,7 +187,8 @@ inline named_sharable_mutex::named_sharable_mutex
                ,perm)
 {}
 
-inline named_sharable_mutex::named_sharable_mutex
+template<class Policy>
+inline named_sharable_mutex_t<Policy>::named_sharable_mutex_t
    (open_only_t, const char *name)
    :  m_shmem  (open_only
                ,name
@@ -188,36 +197,46 @@ inline named_sharable_mutex::named_sharable_mutex
                ,construct_func_t(ipcdetail::DoOpen))
 {}
 
-inline void named_sharable_mutex::dont_close_on_destruction()
+template<class Policy>
+inline void named_sharable_mutex_t<Policy>::dont_close_on_destruction()
 {  ipcdetail::interprocess_tester::dont_close_on_destruction(m_shmem);  }
 
-inline void named_sharable_mutex::lock()
+template<class Policy>
+inline void named_sharable_mutex_t<Policy>::lock()
 {  this->mutex()->lock();  }
 
-inline void named_sharable_mutex::unlock()
+template<class Policy>
+inline void named_sharable_mutex_t<Policy>::unlock()
 {  this->mutex()->unlock();  }
 
-inline bool named_sharable_mutex::try_lock()
+template<class Policy>
+inline bool named_sharable_mutex_t<Policy>::try_lock()
 {  return this->mutex()->try_lock();  }
 
-inline bool named_sharable_mutex::timed_lock
+template<class Policy>
+inline bool named_sharable_mutex_t<Policy>::timed_lock
    (const boost::posix_time::ptime &abs_time)
 {  return this->mutex()->timed_lock(abs_time);  }
 
-inline void named_sharable_mutex::lock_sharable()
+template<class Policy>
+inline void named_sharable_mutex_t<Policy>::lock_sharable()
 {  this->mutex()->lock_sharable();  }
 
-inline void named_sharable_mutex::unlock_sharable()
+template<class Policy>
+inline void named_sharable_mutex_t<Policy>::unlock_sharable()
 {  this->mutex()->unlock_sharable();  }
 
-inline bool named_sharable_mutex::try_lock_sharable()
+template<class Policy>
+inline bool named_sharable_mutex_t<Policy>::try_lock_sharable()
 {  return this->mutex()->try_lock_sharable();  }
 
-inline bool named_sharable_mutex::timed_lock_sharable
+template<class Policy>
+inline bool named_sharable_mutex_t<Policy>::timed_lock_sharable
    (const boost::posix_time::ptime &abs_time)
 {  return this->mutex()->timed_lock_sharable(abs_time);  }
 
-inline bool named_sharable_mutex::remove(const char *name)
+template<class Policy>
+inline bool named_sharable_mutex_t<Policy>::remove(const char *name)
 {  return shared_memory_object::remove(name); }
 
 /// @endcond
@@ -41,33 +41,35 @@ class named_condition;
 //!A upgradable mutex with a global name, so it can be found from different
 //!processes. This mutex can't be placed in shared memory, and
 //!each process should have it's own named upgradable mutex.
-class named_upgradable_mutex
+//!All processes opening the mutex must use the same Policy.
+template<class Policy>
+class named_upgradable_mutex_t
 {
    /// @cond
    //Non-copyable
-   named_upgradable_mutex();
-   named_upgradable_mutex(const named_upgradable_mutex &);
-   named_upgradable_mutex &operator=(const named_upgradable_mutex &);
+   named_upgradable_mutex_t();
+   named_upgradable_mutex_t(const named_upgradable_mutex_t &);
+   named_upgradable_mutex_t &operator=(const named_upgradable_mutex_t &);
    friend class named_condition;
    /// @endcond
    public:
 
    //!Creates a global upgradable mutex with a name.
    //!If the upgradable mutex can't be created throws interprocess_exception
-   named_upgradable_mutex(create_only_t create_only, const char *name, const permissions &perm = permissions());
+   named_upgradable_mutex_t(create_only_t create_only, const char *name, const permissions &perm = permissions());
 
    //!Opens or creates a global upgradable mutex with a name.
    //!If the upgradable mutex is created, this call is equivalent to
-   //!named_upgradable_mutex(create_only_t, ...)
+   //!named_upgradable_mutex_t(create_only_t, ...)
    //!If the upgradable mutex is already created, this call is equivalent to
-   //!named_upgradable_mutex(open_only_t, ... ).
-   named_upgradable_mutex(open_or_create_t open_or_create, const char *name, const permissions &perm = permissions());
+   //!named_upgradable_mutex_t(open_only_t, ... ).
+   named_upgradable_mutex_t(open_or_create_t open_or_create, const char *name, const permissions &perm = permissions());
 
    //!Opens a global upgradable mutex with a name if that upgradable mutex
    //!is previously.
    //!created. If it is not previously created this function throws
    //!interprocess_exception.
-   named_upgradable_mutex(open_only_t open_only, const char *name);
+   named_upgradable_mutex_t(open_only_t open_only, const char *name);
 
    //!Destroys *this and indicates that the calling process is finished using
    //!the resource. The destructor function will deallocate
@@ -75,7 +77,7 @@ class named_upgradable_mutex
    //!this resource. The resource can still be opened again calling
    //!the open constructor overload. To erase the resource from the system
    //!use remove().
-   ~named_upgradable_mutex();
+   ~named_upgradable_mutex_t();
 
    //Exclusive locking
 
@@ -232,25 +234,30 @@ class named_upgradable_mutex
    friend class ipcdetail::interprocess_tester;
    void dont_close_on_destruction();
 
-   interprocess_upgradable_mutex *mutex() const
-   {  return static_cast<interprocess_upgradable_mutex*>(m_shmem.get_user_address()); }
+   interprocess_upgradable_mutex_t<Policy> *mutex() const
+   {  return static_cast<interprocess_upgradable_mutex_t<Policy>*>(m_shmem.get_user_address()); }
 
    typedef ipcdetail::managed_open_or_create_impl<shared_memory_object, 0, true, false> open_create_impl_t;
    open_create_impl_t m_shmem;
-   typedef ipcdetail::named_creation_functor<interprocess_upgradable_mutex> construct_func_t;
+   typedef ipcdetail::named_creation_functor<interprocess_upgradable_mutex_t<Policy> > construct_func_t;
    /// @endcond
 };
 
+//!Named upgradable mutex using the default (two gate) scheduling policy
+typedef named_upgradable_mutex_t<two_gate_policy> named_upgradable_mutex;
+
 /// @cond
 
-inline named_upgradable_mutex::~named_upgradable_mutex()
+template<class Policy>
+inline named_upgradable_mutex_t<Policy>::~named_upgradable_mutex_t()
 {}
 
-inline named_upgradable_mutex::named_upgradable_mutex
+template<class Policy>
+inline named_upgradable_mutex_t<Policy>::named_upgradable_mutex_t
    (create_only_t, const char *name, const permissions &perm)
    :  m_shmem  (create_only
                ,name
-               ,sizeof(interprocess_upgradable_mutex) +
+               ,sizeof(interprocess_upgradable_mutex_t<Policy>) +
                   open_create_impl_t::ManagedOpenOrCreateUserOffset
                ,read_write
                ,0
@@ -258,11 +265,12 @@ inline named_upgradable_mutex::named_upgradable_mutex
                ,perm)
 {}
 
-inline named_upgradable_mutex::named_upgradable_mutex
+template<class Policy>
+inline named_upgradable_mutex_t<Policy>::named_upgradable_mutex_t
    (open_or_create_t, const char *name, const permissions &perm)
    :  m_shmem  (open_or_create
                ,name
-               ,sizeof(interprocess_upgradable_mutex) +
+               ,sizeof(interprocess_upgradable_mutex_t<Policy>) +
                   open_create_impl_t::ManagedOpenOrCreateUserOffset
                ,read_write
                ,0
@@ -270,7 +278,8 @@ inline named_upgradable_mutex::named_upgradable_mutex
                ,perm)
 {}
 
-inline named_upgradable_mutex::named_upgradable_mutex
+template<class Policy>
+inline named_upgradable_mutex_t<Policy>::named_upgradable_mutex_t
    (open_only_t, const char *name)
    :  m_shmem  (open_only
                ,name
@@ -279,74 +288,96 @@ inline named_upgradable_mutex::named_upgradable_mutex
                ,construct_func_t(ipcdetail::DoOpen))
 {}
 
-inline void named_upgradable_mutex::dont_close_on_destruction()
+template<class Policy>
+inline void named_upgradable_mutex_t<Policy>::dont_close_on_destruction()
 {  ipcdetail::interprocess_tester::dont_close_on_destruction(m_shmem);  }
 
-inline void named_upgradable_mutex::lock()
+template<class Policy>
+inline void named_upgradable_mutex_t<Policy>::lock()
 {  this->mutex()->lock();  }
 
-inline void named_upgradable_mutex::unlock()
+template<class Policy>
+inline void named_upgradable_mutex_t<Policy>::unlock()
 {  this->mutex()->unlock();  }
 
-inline bool named_upgradable_mutex::try_lock()
+template<class Policy>
+inline bool named_upgradable_mutex_t<Policy>::try_lock()
 {  return this->mutex()->try_lock();  }
 
-inline bool named_upgradable_mutex::timed_lock
+template<class Policy>
+inline bool named_upgradable_mutex_t<Policy>::timed_lock
    (const boost::posix_time::ptime &abs_time)
 {  return this->mutex()->timed_lock(abs_time);  }
 
-inline void named_upgradable_mutex::lock_upgradable()
+template<class Policy>
+inline void named_upgradable_mutex_t<Policy>::lock_upgradable()
 {  this->mutex()->lock_upgradable();  }
 
-inline void named_upgradable_mutex::unlock_upgradable()
+template<class Policy>
+inline void named_upgradable_mutex_t<Policy>::unlock_upgradable()
 {  this->mutex()->unlock_upgradable();  }
 
-inline bool named_upgradable_mutex::try_lock_upgradable()
+template<class Policy>
+inline bool named_upgradable_mutex_t<Policy>::try_lock_upgradable()
 {  return this->mutex()->try_lock_upgradable();  }
 
-inline bool named_upgradable_mutex::timed_lock_upgradable
+template<class Policy>
+inline bool named_upgradable_mutex_t<Policy>::timed_lock_upgradable
    (const boost::posix_time::ptime &abs_time)
 {  return this->mutex()->timed_lock_upgradable(abs_time);   }
 
-inline void named_upgradable_mutex::lock_sharable()
+template<class Policy>
+inline void named_upgradable_mutex_t<Policy>::lock_sharable()
 {  this->mutex()->lock_sharable();  }
 
-inline void named_upgradable_mutex::unlock_sharable()
+template<class Policy>
+inline void named_upgradable_mutex_t<Policy>::unlock_sharable()
 {  this->mutex()->unlock_sharable();  }
 
-inline bool named_upgradable_mutex::try_lock_sharable()
+template<class Policy>
+inline bool named_upgradable_mutex_t<Policy>::try_lock_sharable()
 {  return this->mutex()->try_lock_sharable();  }
 
-inline bool named_upgradable_mutex::timed_lock_sharable
+template<class Policy>
+inline bool named_upgradable_mutex_t<Policy>::timed_lock_sharable
    (const boost::posix_time::ptime &abs_time)
 {  return this->mutex()->timed_lock_sharable(abs_time);  }
 
-inline void named_upgradable_mutex::unlock_and_lock_upgradable()
+template<class Policy>
+inline void named_upgradable_mutex_t<Policy>::unlock_and_lock_upgradable()
 {  this->mutex()->unlock_and_lock_upgradable();  }
 
-inline void named_upgradable_mutex::unlock_and_lock_sharable()
+template<class Policy>
+inline void named_upgradable_mutex_t<Policy>::unlock_and_lock_sharable()
 {  this->mutex()->unlock_and_lock_sharable();  }
 
-inline void named_upgradable_mutex::unlock_upgradable_and_lock_sharable()
+template<class Policy>
+inline void named_upgradable_mutex_t<Policy>::unlock_upgradable_and_lock_sharable()
 {  this->mutex()->unlock_upgradable_and_lock_sharable();  }
 
-inline void named_upgradable_mutex::unlock_upgradable_and_lock()
+template<class Policy>
+inline void named_upgradable_mutex_t<Policy>::unlock_upgradable_and_lock()
 {  this->mutex()->unlock_upgradable_and_lock();  }
 
-inline bool named_upgradable_mutex::try_unlock_upgradable_and_lock()
+template<class Policy>
+inline bool named_upgradable_mutex_t<Policy>::try_unlock_upgradable_and_lock()
 {  return this->mutex()->try_unlock_upgradable_and_lock();  }
 
-inline bool named_upgradable_mutex::timed_unlock_upgradable_and_lock
+template<class Policy>
+inline bool named_upgradable_mutex_t<Policy>::timed_unlock_upgradable_and_lock
    (const boost::posix_time::ptime &abs_time)
 {  return this->mutex()->timed_unlock_upgradable_and_lock(abs_time);  }
 
-inline bool named_upgradable_mutex::try_unlock_sharable_and_lock()
+template<class Policy>
+inline bool named_upgradable_mutex_t<Policy>::try_unlock_sharable_and_lock()
 {  return this->mutex()->try_unlock_sharable_and_lock();  }
 
-inline bool named_upgradable_mutex::try_unlock_sharable_and_lock_upgradable()
+template<class Policy>
+inline bool named_upgradable_mutex_t<Policy>::try_unlock_sharable_and_lock_upgradable()
 {  return this->mutex()->try_unlock_sharable_and_lock_upgradable();  }
 
-inline bool named_upgradable_mutex::remove(const char *name)
+template<class Policy>
+inline bool named_upgradable_mutex_t<Policy>::remove(const char *name)
 {  return shared_memory_object::remove(name); }
 
 /// @endcond
@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOST_INTERPROCESS_SHARABLE_MUTEX_POLICIES_HPP
+#define BOOST_INTERPROCESS_SHARABLE_MUTEX_POLICIES_HPP
+
+#if (defined _MSC_VER) && (_MSC_VER >= 1200)
+#  pragma once
+#endif
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/detail/workaround.hpp>
+
+//!\file
+//!Describes the scheduling policies that can be selected for
+//!interprocess_sharable_mutex_t and interprocess_upgradable_mutex_t classes
+
+namespace boost {
+namespace interprocess {
+
+//!Default policy (Howard Hinnant's two gate algorithm). A thread requesting
+//!exclusive ownership blocks new sharable owners and waits until current ones
+//!release the mutex. When the exclusive owner unlocks the mutex, blocked
+//!exclusive and sharable owners compete for the ownership.
+struct two_gate_policy {};
+
+//!Sharable owners are only blocked by a thread that already has exclusive
+//!ownership. A thread requesting exclusive ownership waits until there are no
+//!sharable owners, so writers can be starved by a steady stream of readers.
+struct reader_preferring_policy {};
+
+//!New sharable and upgradable owners are blocked while any thread is waiting
+//!for exclusive ownership, so writers can't be starved but readers can.
+//!A thread must not recursively acquire sharable ownership, as it would
+//!deadlock with a writer waiting for the first sharable lock to be released.
+struct writer_preferring_policy {};
+
+//!Phase-fair policy: reader and writer phases alternate. Threads blocked
+//!requesting exclusive ownership are served in FIFO order and sharable owners
+//!blocked by a writer enter as a group when that writer unlocks the mutex,
+//!before the next writer. Neither readers nor writers can be starved.
+//!
+//!Timed and try exclusive locks don't take a place in the FIFO: try_lock only
+//!succeeds if no thread is blocked waiting for the mutex and timed_lock waits
+//!until no writer is queued. As with writer_preferring_policy, sharable
+//!ownership must not be acquired recursively.
+struct phase_fair_policy {};
+
+/// @cond
+namespace ipcdetail {
+
+template<class Policy>
+struct sharable_policy_traits;
+
+template<>
+struct sharable_policy_traits<two_gate_policy>
+{
+   //Exclusive lockers block new readers before waiting readers to leave
+   static const bool announce_writer   = true;
+   //Readers don't enter while a writer is waiting to acquire the mutex
+   static const bool readers_yield     = false;
+   //Readers and writers are scheduled in alternating phases
+   static const bool phase_fair        = false;
+};
+
+template<>
+struct sharable_policy_traits<reader_preferring_policy>
+{
+   static const bool announce_writer   = false;
+   static const bool readers_yield     = false;
+   static const bool phase_fair        = false;
+};
+
+template<>
+struct sharable_policy_traits<writer_preferring_policy>
+{
+   static const bool announce_writer   = true;
+   static const bool readers_yield     = true;
+   static const bool phase_fair        = false;
+};
+
+template<>
+struct sharable_policy_traits<phase_fair_policy>
+{
+   static const bool announce_writer   = true;
+   static const bool readers_yield     = true;
+   static const bool phase_fair        = true;
+};
+
+}  //namespace ipcdetail {
+/// @endcond
+
+}  //namespace interprocess {
+}  //namespace boost {
+
+#include <boost/interprocess/detail/config_end.hpp>
+
+#endif   //BOOST_INTERPROCESS_SHARABLE_MUTEX_POLICIES_HPP
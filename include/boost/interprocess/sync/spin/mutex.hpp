@@ -22,11 +22,18 @@
 #include <boost/interprocess/detail/atomic.hpp>
 #include <boost/cstdint.hpp>
 #include <boost/interprocess/detail/os_thread_functions.hpp>
+#if defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+#include <boost/interprocess/sync/linux/futex_helpers.hpp>
+#endif
 
 namespace boost {
 namespace interprocess {
 namespace ipcdetail {
 
+#if defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+class futex_condition;
+#endif
+
 class spin_mutex
 {
    spin_mutex(const spin_mutex &);
@@ -42,6 +49,13 @@ class spin_mutex
    void unlock();
    void take_ownership(){};
    private:
+   #if defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+   friend class futex_condition;
+   //Futex word states
+   enum { Unlocked = 0, Locked = 1, Contended = 2 };
+   bool spin_lock();
+   void lock_contended();
+   #endif
    volatile boost::uint32_t m_s;
 };
 
@@ -58,6 +72,97 @@ inline spin_mutex::~spin_mutex()
    //Trivial destructor
 }
 
+#if defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+
+//The lock word is a futex with three states: Unlocked, Locked (no waiters)
+//and Contended (there might be waiters sleeping in the kernel). This
+//is the "mutex2" algorithm from Ulrich Drepper's "Futexes Are Tricky".
+
+inline bool spin_mutex::spin_lock()
+{
+   //Bounded spinning with exponential backoff before going to sleep,
+   //so that short critical sections don't pay a context switch
+   for(unsigned int i = 1; i <= BOOST_INTERPROCESS_FUTEX_SPIN_COUNT; i *= 2){
+      for(unsigned int j = 0; j != i; ++j){
+         ipcdetail::futex_cpu_relax();
+      }
+      if(atomic_read32(&m_s) == Unlocked &&
+         ipcdetail::atomic_cas32(const_cast<boost::uint32_t*>(&m_s), Locked, Unlocked) == Unlocked){
+         return true;
+      }
+   }
+   return false;
+}
+
+inline void spin_mutex::lock(void)
+{
+   boost::uint32_t c = ipcdetail::atomic_cas32(const_cast<boost::uint32_t*>(&m_s), Locked, Unlocked);
+   if(c == Unlocked || this->spin_lock()){
+      return;
+   }
+   c = atomic_read32(&m_s);
+   do{
+      //Mark the lock as contended before sleeping so that unlock wakes us
+      if(c == Contended ||
+         ipcdetail::atomic_cas32(const_cast<boost::uint32_t*>(&m_s), Contended, Locked) != Unlocked){
+         ipcdetail::futex_wait(&m_s, Contended);
+      }
+      //We don't know if there are other waiters, so acquire it as contended
+   }while((c = ipcdetail::atomic_cas32(const_cast<boost::uint32_t*>(&m_s), Contended, Unlocked)) != Unlocked);
+}
+
+//Used by threads that might have been requeued from a condition variable
+//to this futex: other requeued threads might be sleeping here, so the
+//lock must be taken as contended so that unlock wakes the next one.
+inline void spin_mutex::lock_contended()
+{
+   while(ipcdetail::atomic_cas32(const_cast<boost::uint32_t*>(&m_s), Contended, Unlocked) != Unlocked){
+      if(ipcdetail::atomic_cas32(const_cast<boost::uint32_t*>(&m_s), Contended, Locked) != Unlocked){
+         ipcdetail::futex_wait(&m_s, Contended);
+      }
+   }
+}
+
+inline bool spin_mutex::try_lock(void)
+{
+   return Unlocked == ipcdetail::atomic_cas32(const_cast<boost::uint32_t*>(&m_s), Locked, Unlocked);
+}
+
+inline bool spin_mutex::timed_lock(const boost::posix_time::ptime &abs_time)
+{
+   if(abs_time == boost::posix_time::pos_infin){
+      this->lock();
+      return true;
+   }
+   boost::uint32_t c = ipcdetail::atomic_cas32(const_cast<boost::uint32_t*>(&m_s), Locked, Unlocked);
+   if(c == Unlocked || this->spin_lock()){
+      return true;
+   }
+   c = atomic_read32(&m_s);
+   do{
+      if(c == Contended ||
+         ipcdetail::atomic_cas32(const_cast<boost::uint32_t*>(&m_s), Contended, Locked) != Unlocked){
+         if(!ipcdetail::futex_timed_wait(&m_s, Contended, abs_time)){
+            //Last chance, the lock might have been released just now
+            return Unlocked == ipcdetail::atomic_cas32
+               (const_cast<boost::uint32_t*>(&m_s), Contended, Unlocked);
+         }
+      }
+   }while((c = ipcdetail::atomic_cas32(const_cast<boost::uint32_t*>(&m_s), Contended, Unlocked)) != Unlocked);
+   return true;
+}
+
+inline void spin_mutex::unlock(void)
+{
+   //Only issue a syscall if the lock was contended
+   if(ipcdetail::atomic_dec32(&m_s) != Locked){
+      ipcdetail::atomic_write32(&m_s, Unlocked);
+      ipcdetail::futex_wake(&m_s, 1);
+   }
+}
+
+#else //#if defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+
 inline void spin_mutex::lock(void)
 {
    do{
@@ -105,6 +210,8 @@ inline bool spin_mutex::timed_lock(const boost::posix_time::ptime &abs_time)
 inline void spin_mutex::unlock(void)
 {  ipcdetail::atomic_cas32(const_cast<boost::uint32_t*>(&m_s), 0, 1);   }
 
+#endif   //#if defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+
 }  //namespace ipcdetail {
 }  //namespace interprocess {
 }  //namespace boost {
@@ -20,8 +20,14 @@
 #include <boost/interprocess/detail/atomic.hpp>
 #include <boost/interprocess/detail/os_thread_functions.hpp>
 #include <boost/interprocess/detail/posix_time_types_wrk.hpp>
+#include <boost/interprocess/exceptions.hpp>
 #include <boost/cstdint.hpp>
 
+#if defined(BOOST_INTERPROCESS_LINUX_FUTEX) && defined(BOOST_INTERPROCESS_HAS_ATOMIC64)
+   #include <boost/interprocess/sync/linux/futex_helpers.hpp>
+   #define BOOST_INTERPROCESS_FUTEX_SEMAPHORE
+#endif
+
 namespace boost {
 namespace interprocess {
 namespace ipcdetail {
@@ -42,9 +48,128 @@ class spin_semaphore
 
 //   int get_count() const;
    private:
+   #if defined(BOOST_INTERPROCESS_FUTEX_SEMAPHORE)
+   //The state word holds the count in the low 32 bits and the number
+   //of sleeping waiters in the high 32 bits so that post can atomically
+   //increment the count and know if a wakeup is needed. The count half
+   //is the futex word waiters sleep on.
+   static const boost::uint64_t WaiterInc = boost::uint64_t(1) << 32;
+   static const boost::uint64_t CountMask = WaiterInc - 1;
+   volatile boost::uint32_t *count_futex();
+   bool do_wait(bool tout_enabled, const boost::posix_time::ptime &abs_time);
+   volatile boost::uint64_t m_state __attribute__((__aligned__(8)));
+   #else
    volatile boost::uint32_t m_count;
+   #endif
 };
 
+#if defined(BOOST_INTERPROCESS_FUTEX_SEMAPHORE)
+
+inline spin_semaphore::~spin_semaphore()
+{}
+
+inline spin_semaphore::spin_semaphore(unsigned int initialCount)
+   : m_state(boost::uint64_t(initialCount))
+{}
+
+inline volatile boost::uint32_t *spin_semaphore::count_futex()
+{
+   #if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+   return reinterpret_cast<volatile boost::uint32_t*>(&m_state) + 1;
+   #else
+   return reinterpret_cast<volatile boost::uint32_t*>(&m_state);
+   #endif
+}
+
+inline void spin_semaphore::post()
+{
+   //The count can't be incremented blindly, as an overflow
+   //would carry into the number of waiters
+   boost::uint64_t old = ipcdetail::atomic_read64(&m_state);
+   while(1){
+      if((old & CountMask) == CountMask){
+         throw interprocess_exception(error_info(sem_error),
+            "boost::interprocess: semaphore count overflow");
+      }
+      const boost::uint64_t prev = ipcdetail::atomic_cas64(&m_state, old + 1, old);
+      if(prev == old){
+         break;
+      }
+      old = prev;
+   }
+   //Only issue a syscall if someone is sleeping
+   if(old >> 32){
+      ipcdetail::futex_wake(this->count_futex(), 1);
+   }
+}
+
+inline bool spin_semaphore::try_wait()
+{
+   boost::uint64_t s = ipcdetail::atomic_read64(&m_state);
+   while(s & CountMask){
+      const boost::uint64_t prev = ipcdetail::atomic_cas64(&m_state, s - 1, s);
+      if(prev == s){
+         return true;
+      }
+      s = prev;
+   }
+   return false;
+}
+
+inline void spin_semaphore::wait()
+{  this->do_wait(false, boost::posix_time::ptime());  }
+
+inline bool spin_semaphore::timed_wait(const boost::posix_time::ptime &abs_time)
+{
+   if(abs_time == boost::posix_time::pos_infin){
+      this->wait();
+      return true;
+   }
+   return this->do_wait(true, abs_time);
+}
+
+inline bool spin_semaphore::do_wait(bool tout_enabled, const boost::posix_time::ptime &abs_time)
+{
+   //Short bounded spin before registering as a waiter
+   for(unsigned int i = 0; i != BOOST_INTERPROCESS_FUTEX_SPIN_COUNT; ++i){
+      if(this->try_wait()){
+         return true;
+      }
+      ipcdetail::futex_cpu_relax();
+   }
+   while(1){
+      //Take a unit if available, otherwise register as a waiter
+      //in the same atomic operation so that no post is lost
+      boost::uint64_t s = ipcdetail::atomic_read64(&m_state);
+      boost::uint64_t prev;
+      while(1){
+         const boost::uint64_t with = (s & CountMask) ? s - 1 : s + WaiterInc;
+         prev = ipcdetail::atomic_cas64(&m_state, with, s);
+         if(prev == s){
+            break;
+         }
+         s = prev;
+      }
+      if(s & CountMask){
+         return true;
+      }
+      //Sleep until the count is non-zero
+      bool timed_out = false;
+      if(tout_enabled){
+         timed_out = !ipcdetail::futex_timed_wait(this->count_futex(), 0, abs_time);
+      }
+      else{
+         ipcdetail::futex_wait(this->count_futex(), 0);
+      }
+      ipcdetail::atomic_add64(&m_state, boost::uint64_t(0) - WaiterInc);
+      if(timed_out){
+         return this->try_wait();
+      }
+   }
+}
+
+#else //#if defined(BOOST_INTERPROCESS_FUTEX_SEMAPHORE)
+
 
 inline spin_semaphore::~spin_semaphore()
 {}
@@ -54,7 +179,10 @@ inline spin_semaphore::spin_semaphore(unsigned int initialCount)
 
 inline void spin_semaphore::post()
 {
-   ipcdetail::atomic_inc32(&m_count);
+   if(!ipcdetail::atomic_add_unless32(&m_count, 1, boost::uint32_t(-1))){
+      throw interprocess_exception(error_info(sem_error),
+         "boost::interprocess: semaphore count overflow");
+   }
 }
 
 inline void spin_semaphore::wait()
@@ -95,6 +223,7 @@ inline bool spin_semaphore::timed_wait(const boost::posix_time::ptime &abs_time)
    return true;
 }
 
+#endif   //#if defined(BOOST_INTERPROCESS_FUTEX_SEMAPHORE)
 
 //inline int spin_semaphore::get_count() const
 //{
@@ -0,0 +1,202 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/allocators/arena_allocator.hpp>
+#include <boost/interprocess/allocators/allocator.hpp>
+#include <boost/interprocess/containers/list.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include "get_process_id_name.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  This example tests segment_arena and arena_allocator and compares the     //
+//  time needed to build and destroy an object graph with allocator and with  //
+//  arena_allocator.                                                          //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace boost::interprocess;
+
+typedef managed_shared_memory::segment_manager        segment_manager_t;
+typedef segment_arena<segment_manager_t>              arena_t;
+typedef arena_t::size_type                            size_type;
+typedef arena_allocator<int, segment_manager_t>       int_arena_allocator_t;
+typedef allocator<int, segment_manager_t>             int_allocator_t;
+typedef list<int, int_arena_allocator_t>              arena_list_t;
+typedef list<int, int_allocator_t>                    list_t;
+
+namespace boost {
+namespace interprocess {
+
+//Explicit instantiations to catch compilation errors
+template class segment_arena<segment_manager_t>;
+template class arena_allocator<int, segment_manager_t>;
+
+}}
+
+bool test_arena(managed_shared_memory &segment)
+{
+   const size_type free_memory = segment.get_free_memory();
+   {
+      arena_t arena(segment.get_segment_manager(), 4096);
+      if(arena.get_num_chunks() || arena.get_free_memory() || arena.get_chunk_size() != 4096)
+         return false;
+
+      //Allocations are aligned, unique and use few chunks
+      std::vector<char*> buffers;
+      for(size_type i = 0; i != 1000; ++i){
+         const size_type size = 1 + i % 100;
+         char *ptr = static_cast<char*>(arena.allocate(size));
+         if(std::size_t(ptr) % arena_t::Alignment)
+            return false;
+         std::memset(ptr, (int)i, size);
+         buffers.push_back(ptr);
+      }
+      for(size_type i = 0; i != buffers.size(); ++i){
+         if(buffers[i][0] != (char)i || buffers[i][i % 100] != (char)i)
+            return false;
+      }
+      std::vector<char*> sorted(buffers);
+      std::sort(sorted.begin(), sorted.end());
+      if(std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+         return false;
+      const size_type num_chunks = arena.get_num_chunks();
+      if(num_chunks < 2 || num_chunks > 1000*112/4096 + 2)
+         return false;
+
+      //Big allocations get their own chunk and don't waste the current one
+      const size_type cur_free = arena.get_free_memory();
+      char *big = static_cast<char*>(arena.allocate(10000));
+      std::memset(big, 0, 10000);
+      if(arena.get_num_chunks() != num_chunks + 1 || arena.get_free_memory() != cur_free)
+         return false;
+
+      //reset keeps the current chunk
+      arena.reset();
+      if(arena.get_num_chunks() != 1 || arena.get_free_memory() != 4096 - arena_t::Alignment ||
+         segment.get_free_memory() >= free_memory)
+         return false;
+      arena.allocate(100);
+
+      //release returns all memory
+      arena.release();
+      if(arena.get_num_chunks() || free_memory != segment.get_free_memory())
+         return false;
+
+      //An arena whose first allocation is big
+      arena.allocate(100000);
+      arena.allocate(100);
+      if(arena.get_num_chunks() != 2)
+         return false;
+      arena.reset();
+      if(arena.get_num_chunks() != 1)
+         return false;
+   }
+   return free_memory == segment.get_free_memory();
+}
+
+struct less_than_5000
+{
+   bool operator()(int value) const
+   {  return value < 5000;  }
+};
+
+bool test_arena_allocator(managed_shared_memory &segment)
+{
+   const size_type free_memory = segment.get_free_memory();
+   {
+      //The arena and the list are placed in the segment
+      arena_t *arena = segment.construct<arena_t>(anonymous_instance)(segment.get_segment_manager());
+      int_arena_allocator_t alloc(arena);
+      if(alloc.get_arena() != arena || alloc.get_segment_manager() != segment.get_segment_manager())
+         return false;
+      arena_allocator<char, segment_manager_t> char_alloc(alloc);
+      if(int_arena_allocator_t(char_alloc) != alloc)
+         return false;
+
+      arena_list_t *l = segment.construct<arena_list_t>(anonymous_instance)(alloc);
+      for(int i = 0; i != 10000; ++i){
+         l->push_back(i);
+      }
+      l->remove_if(less_than_5000());
+      int expected = 5000;
+      for(arena_list_t::iterator it = l->begin(); it != l->end(); ++it, ++expected){
+         if(*it != expected)
+            return false;
+      }
+      if(expected != 10000)
+         return false;
+      segment.destroy_ptr(l);
+      arena->reset();
+      segment.destroy_ptr(arena);
+   }
+   return free_memory == segment.get_free_memory();
+}
+
+//Builds a list and destroys it, returning build and teardown times
+template<class List>
+void time_list(const typename List::allocator_type &alloc, long &build_us, long &teardown_us)
+{
+   typedef boost::posix_time::microsec_clock clock_t;
+   boost::posix_time::ptime start = clock_t::universal_time();
+   List *l = new List(alloc);
+   for(int i = 0; i != 100000; ++i){
+      l->push_back(i);
+   }
+   boost::posix_time::ptime end = clock_t::universal_time();
+   build_us = (long)(end - start).total_microseconds();
+   start = end;
+   delete l;
+   end = clock_t::universal_time();
+   teardown_us = (long)(end - start).total_microseconds();
+}
+
+int main ()
+{
+   const char *const shMemName = test::get_process_id_name();
+   shared_memory_object::remove(shMemName);
+   {
+      managed_shared_memory segment(create_only, shMemName, 16*1024*1024);
+      if(!test_arena(segment) || !test_arena_allocator(segment)){
+         shared_memory_object::remove(shMemName);
+         return 1;
+      }
+
+      long build_us, teardown_us, arena_build_us, arena_teardown_us;
+      const size_type free_memory = segment.get_free_memory();
+      time_list<list_t>(int_allocator_t(segment.get_segment_manager()), build_us, teardown_us);
+      {
+         arena_t arena(segment.get_segment_manager());
+         time_list<arena_list_t>(int_arena_allocator_t(&arena), arena_build_us, arena_teardown_us);
+         const boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+         arena.reset();
+         arena_teardown_us += (long)(boost::posix_time::microsec_clock::universal_time() - start).total_microseconds();
+      }
+      if(free_memory != segment.get_free_memory()){
+         shared_memory_object::remove(shMemName);
+         return 1;
+      }
+      std::cout << "allocator: "       << " build: " << std::setw(8) << build_us       << "us"
+                << " teardown: "       << std::setw(8) << teardown_us       << "us" << std::endl;
+      std::cout << "arena_allocator: " << " build: " << std::setw(8) << arena_build_us << "us"
+                << " teardown: "       << std::setw(8) << arena_teardown_us << "us" << std::endl;
+   }
+   shared_memory_object::remove(shMemName);
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
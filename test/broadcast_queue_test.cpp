@@ -0,0 +1,377 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/ipc/broadcast_queue.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <vector>
+#include <cstddef>
+#include "get_process_id_name.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  This example tests the process shared publish/subscribe queue.           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace boost::interprocess;
+
+typedef broadcast_queue::subscriber subscriber;
+
+static boost::posix_time::ptime after_ms(long ms)
+{
+   return boost::posix_time::microsec_clock::universal_time() +
+          boost::posix_time::milliseconds(ms);
+}
+
+//Receives the next message and checks its contents
+static bool receive_value(subscriber &sub, std::size_t expected)
+{
+   broadcast_queue::size_type recvd = 0;
+   unsigned int priority = 0;
+   std::size_t value;
+   if(!sub.try_receive(&value, sizeof(value), recvd, priority))
+      return false;
+   return value == expected && recvd == sizeof(value) && priority == expected%10;
+}
+
+//This test checks that every subscriber receives all messages in order,
+//that the sender blocks on the slowest one and that subscribers only
+//receive messages sent after they were attached
+bool test_block_policy()
+{
+   broadcast_queue::remove(test::get_process_id_name());
+   {
+      broadcast_queue q1
+         (create_only, test::get_process_id_name(), 6, sizeof(std::size_t), 3);
+      broadcast_queue q2
+         (open_only, test::get_process_id_name());
+
+      //The number of slots is rounded to a power of two
+      if(q2.get_max_msg() != 8 || q2.get_max_msg_size() != sizeof(std::size_t))
+         return false;
+      if(q2.get_max_subscribers() != 3 || q2.get_policy() != block_slow_subscribers)
+         return false;
+
+      //Nobody receives messages sent without subscribers
+      std::size_t value = 1000;
+      for(std::size_t i = 0; i != 20; ++i){
+         if(!q1.try_send(&value, sizeof(value), 0))
+            return false;
+      }
+
+      subscriber fast(q2);
+      subscriber slow(q2);
+      std::size_t next = 0;
+      {
+         subscriber gone(q1);
+         if(q1.get_num_subscribers() != 3 || fast.get_num_msg() != 0)
+            return false;
+         //All subscribers are taken
+         bool thrown = false;
+         try{
+            subscriber extra(q2);
+         }
+         catch(interprocess_exception &ex){
+            thrown = ex.get_error_code() == out_of_resource_error;
+         }
+         if(!thrown)
+            return false;
+
+         for(; next != 8; ++next){
+            if(!q1.try_send(&next, sizeof(next), (unsigned int)(next%10)))
+               return false;
+         }
+         //Full for all subscribers
+         if(q1.try_send(&next, sizeof(next), 0) ||
+            q1.timed_send(&next, sizeof(next), 0, after_ms(10)))
+            return false;
+         for(std::size_t i = 0; i != 8; ++i){
+            if(!receive_value(fast, i))
+               return false;
+         }
+         for(std::size_t i = 0; i != 4; ++i){
+            if(!receive_value(slow, i))
+               return false;
+         }
+         //"gone" has not received anything yet
+         if(q1.try_send(&next, sizeof(next), 0))
+            return false;
+      }
+      //Now "slow" is the slowest subscriber
+      if(q1.get_num_subscribers() != 2 || slow.get_num_msg() != 4)
+         return false;
+
+      //Several laps so that positions wrap around the ring
+      for(std::size_t lap = 0; lap != 3; ++lap){
+         const std::size_t first = next;
+         for(std::size_t i = 0; i != 4; ++i, ++next){
+            if(!q1.try_send(&next, sizeof(next), (unsigned int)(next%10)))
+               return false;
+         }
+         if(q1.try_send(&next, sizeof(next), 0))
+            return false;
+         for(std::size_t i = first - 4; i != next; ++i){
+            if(!receive_value(slow, i))
+               return false;
+         }
+         for(std::size_t i = first; i != next; ++i){
+            if(!receive_value(fast, i))
+               return false;
+         }
+         for(std::size_t i = 0; i != 4; ++i, ++next){
+            if(!q1.try_send(&next, sizeof(next), (unsigned int)(next%10)))
+               return false;
+         }
+         for(std::size_t i = next - 4; i != next; ++i){
+            if(!receive_value(fast, i))
+               return false;
+         }
+      }
+
+      //No new messages for "fast"
+      broadcast_queue::size_type recvd = 0;
+      unsigned int priority = 0;
+      if(fast.try_receive(&value, sizeof(value), recvd, priority) ||
+         fast.timed_receive(&value, sizeof(value), recvd, priority, after_ms(10)))
+         return false;
+      if(fast.get_num_lost() != 0 || slow.get_num_lost() != 0 || slow.get_num_msg() != 4)
+         return false;
+
+      //Size errors
+      char buf[16] = {};
+      bool thrown = false;
+      try{
+         q1.send(buf, sizeof(std::size_t) + 1, 0);
+      }
+      catch(interprocess_exception &ex){
+         thrown = ex.get_error_code() == size_error;
+      }
+      if(!thrown)
+         return false;
+      thrown = false;
+      try{
+         slow.receive(buf, sizeof(std::size_t) - 1, recvd, priority);
+      }
+      catch(interprocess_exception &ex){
+         thrown = ex.get_error_code() == size_error;
+      }
+      if(!thrown || slow.get_num_msg() != 4)
+         return false;
+   }
+   broadcast_queue::remove(test::get_process_id_name());
+   return true;
+}
+
+//This test checks that slow subscribers skip overwritten messages
+//and count them as lost
+bool test_overwrite_policy()
+{
+   broadcast_queue::remove(test::get_process_id_name());
+   {
+      broadcast_queue q
+         (create_only, test::get_process_id_name(), 8, sizeof(std::size_t), 2, overwrite_slow_subscribers);
+      if(q.get_policy() != overwrite_slow_subscribers)
+         return false;
+      subscriber fast(q);
+      subscriber slow(q);
+
+      std::size_t next = 0;
+      for(; next != 20; ++next){
+         if(!q.try_send(&next, sizeof(next), (unsigned int)(next%10)))
+            return false;
+         if(!receive_value(fast, next))
+            return false;
+      }
+      //Only the last lap can be received
+      if(slow.get_num_msg() != 8)
+         return false;
+      if(!receive_value(slow, 12) || slow.get_num_lost() != 12)
+         return false;
+      for(std::size_t i = 13; i != 20; ++i){
+         if(!receive_value(slow, i))
+            return false;
+      }
+      if(slow.get_num_lost() != 12 || fast.get_num_lost() != 0 || slow.get_num_msg() != 0)
+         return false;
+   }
+   broadcast_queue::remove(test::get_process_id_name());
+   return true;
+}
+
+//This test checks that subscribers a lap behind are evicted
+bool test_evict_policy()
+{
+   broadcast_queue::remove(test::get_process_id_name());
+   {
+      broadcast_queue q
+         (open_or_create, test::get_process_id_name(), 8, sizeof(std::size_t), 2, evict_slow_subscribers);
+      if(q.get_policy() != evict_slow_subscribers)
+         return false;
+      subscriber fast(q);
+      std::size_t next = 0;
+      {
+         subscriber slow(q);
+         for(; next != 8; ++next){
+            if(!q.try_send(&next, sizeof(next), (unsigned int)(next%10)))
+               return false;
+            if(!receive_value(fast, next))
+               return false;
+         }
+         if(!receive_value(slow, 0) || slow.is_evicted())
+            return false;
+         for(; next != 10; ++next){
+            if(!q.try_send(&next, sizeof(next), (unsigned int)(next%10)))
+               return false;
+         }
+         //The slot of the message "slow" had not received was needed
+         if(!slow.is_evicted() || fast.is_evicted() || q.get_num_subscribers() != 2)
+            return false;
+         std::size_t value;
+         broadcast_queue::size_type recvd = 0;
+         unsigned int priority = 0;
+         bool thrown = false;
+         try{
+            slow.receive(&value, sizeof(value), recvd, priority);
+         }
+         catch(interprocess_exception &ex){
+            thrown = ex.get_error_code() == not_found_error;
+         }
+         if(!thrown)
+            return false;
+      }
+      //The evicted subscriber can be reused when it is destroyed
+      subscriber late(q);
+      if(late.is_evicted() || late.get_num_msg() != 0)
+         return false;
+      for(std::size_t i = 8; i != 10; ++i){
+         if(!receive_value(fast, i))
+            return false;
+      }
+      if(!q.try_send(&next, sizeof(next), (unsigned int)(next%10)) ||
+         !receive_value(fast, next) || !receive_value(late, next))
+         return false;
+   }
+   broadcast_queue::remove(test::get_process_id_name());
+   return true;
+}
+
+static const std::size_t NumThreadMsg = 20000;
+
+struct sender_thread
+{
+   explicit sender_thread(broadcast_queue &q)
+      :  m_q(q)
+   {}
+
+   void operator()()
+   {
+      for(std::size_t i = 0; i != NumThreadMsg; ++i){
+         m_q.send(&i, sizeof(i), 0);
+      }
+   }
+
+   broadcast_queue &m_q;
+};
+
+struct subscriber_thread
+{
+   explicit subscriber_thread(subscriber &sub)
+      :  m_sub(sub), m_num_recvd(0), m_ok(true)
+   {}
+
+   void operator()()
+   {
+      broadcast_queue::size_type recvd;
+      unsigned int priority;
+      std::size_t value = 0, last = std::size_t(-1);
+      //The last message is never overwritten
+      while(value != NumThreadMsg - 1){
+         m_sub.receive(&value, sizeof(value), recvd, priority);
+         //Messages must be received in order
+         if(last != std::size_t(-1) && value <= last){
+            m_ok = false;
+            return;
+         }
+         last = value;
+         ++m_num_recvd;
+      }
+   }
+
+   subscriber &m_sub;
+   std::size_t m_num_recvd;
+   bool m_ok;
+};
+
+//A sender broadcasts to several subscribers blocking on a small queue. Each
+//subscriber receives all messages in order, or counts the skipped ones as lost
+bool test_threads(broadcast_policy policy, std::size_t num_subscribers)
+{
+   broadcast_queue::remove(test::get_process_id_name());
+   bool ok = true;
+   {
+      broadcast_queue q
+         (create_only, test::get_process_id_name(), 8, sizeof(std::size_t), num_subscribers, policy);
+
+      std::vector<subscriber*> subs;
+      std::vector<subscriber_thread> threads_data;
+      for(std::size_t i = 0; i != num_subscribers; ++i){
+         subs.push_back(new subscriber(q));
+      }
+      for(std::size_t i = 0; i != num_subscribers; ++i){
+         threads_data.push_back(subscriber_thread(*subs[i]));
+      }
+
+      boost::thread_group threads;
+      for(std::size_t i = 0; i != num_subscribers; ++i){
+         threads.create_thread(boost::ref(threads_data[i]));
+      }
+      threads.create_thread(sender_thread(q));
+      threads.join_all();
+
+      for(std::size_t i = 0; i != num_subscribers; ++i){
+         ok = ok && threads_data[i].m_ok;
+         ok = ok && threads_data[i].m_num_recvd + subs[i]->get_num_lost() == NumThreadMsg;
+         if(policy == block_slow_subscribers){
+            ok = ok && subs[i]->get_num_lost() == 0;
+         }
+         delete subs[i];
+      }
+      ok = ok && q.get_num_subscribers() == 0;
+   }
+   broadcast_queue::remove(test::get_process_id_name());
+   return ok;
+}
+
+int main ()
+{
+   if(!test_block_policy())
+      return 1;
+
+   if(!test_overwrite_policy())
+      return 1;
+
+   if(!test_evict_policy())
+      return 1;
+
+   if(!test_threads(block_slow_subscribers, 1))
+      return 1;
+
+   if(!test_threads(block_slow_subscribers, 4))
+      return 1;
+
+   if(!test_threads(overwrite_slow_subscribers, 4))
+      return 1;
+
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
@@ -31,12 +31,18 @@ typedef ipcdetail::cached_adaptive_pool_v1
    <int, managed_shared_memory::segment_manager>
    cached_node_allocator_v1_t;
 
+//Alias a cached adaptive pool that caches ints in per-thread magazines
+typedef cached_adaptive_pool
+   <int, managed_shared_memory::segment_manager, 64, 2, 5, magazine_cache_policy>
+   magazine_node_allocator_t;
+
 namespace boost {
 namespace interprocess {
 
 //Explicit instantiations to catch compilation errors
 template class cached_adaptive_pool<int, managed_shared_memory::segment_manager>;
 template class cached_adaptive_pool<void, managed_shared_memory::segment_manager>;
+template class cached_adaptive_pool<int, managed_shared_memory::segment_manager, 64, 2, 5, magazine_cache_policy>;
 
 namespace ipcdetail {
 
@@ -48,10 +54,12 @@ template class ipcdetail::cached_adaptive_pool_v1<void, managed_shared_memory::s
 //Alias list types
 typedef list<int, cached_node_allocator_t>    MyShmList;
 typedef list<int, cached_node_allocator_v1_t> MyShmListV1;
+typedef list<int, magazine_node_allocator_t>  MyShmMagazineList;
 
 //Alias vector types
 typedef vector<int, cached_node_allocator_t>    MyShmVector;
 typedef vector<int, cached_node_allocator_v1_t> MyShmVectorV1;
+typedef vector<int, magazine_node_allocator_t>  MyShmMagazineVector;
 
 int main ()
 {
@@ -61,12 +69,18 @@ int main ()
    if(test::list_test<managed_shared_memory, MyShmListV1, true>())
       return 1;
 
+   if(test::list_test<managed_shared_memory, MyShmMagazineList, true>())
+      return 1;
+
    if(test::vector_test<managed_shared_memory, MyShmVector>())
       return 1;
 
    if(test::vector_test<managed_shared_memory, MyShmVectorV1>())
       return 1;
 
+   if(test::vector_test<managed_shared_memory, MyShmMagazineVector>())
+      return 1;
+
    return 0;
 }
 
@@ -28,6 +28,9 @@ typedef cached_node_allocator
 typedef ipcdetail::cached_node_allocator_v1
    <int, managed_shared_memory::segment_manager>
    cached_node_allocator_v1_t;
+typedef cached_node_allocator
+   <int, managed_shared_memory::segment_manager, 64, lock_free_pool_policy>
+   lock_free_cached_node_allocator_t;
 
 namespace boost {
 namespace interprocess {
@@ -35,6 +38,10 @@ namespace interprocess {
 //Explicit instantiations to catch compilation errors
 template class cached_node_allocator<int, managed_shared_memory::segment_manager>;
 template class cached_node_allocator<void, managed_shared_memory::segment_manager>;
+template class cached_node_allocator<int, managed_shared_memory::segment_manager, 64, lock_free_pool_policy>;
+template class cached_node_allocator<void, managed_shared_memory::segment_manager, 64, lock_free_pool_policy>;
+template class cached_node_allocator<int, managed_shared_memory::segment_manager, 64, mutex_pool_policy, magazine_cache_policy>;
+template class cached_node_allocator<void, managed_shared_memory::segment_manager, 64, mutex_pool_policy, magazine_cache_policy>;
 
 namespace ipcdetail {
 
@@ -46,10 +53,12 @@ template class ipcdetail::cached_node_allocator_v1<void, managed_shared_memory::
 //Alias list types
 typedef list<int, cached_node_allocator_t>    MyShmList;
 typedef list<int, cached_node_allocator_v1_t> MyShmListV1;
+typedef list<int, lock_free_cached_node_allocator_t> MyShmLockFreeList;
 
 //Alias vector types
 typedef vector<int, cached_node_allocator_t>    MyShmVector;
 typedef vector<int, cached_node_allocator_v1_t> MyShmVectorV1;
+typedef vector<int, lock_free_cached_node_allocator_t> MyShmLockFreeVector;
 
 int main ()
 {
@@ -57,10 +66,14 @@ int main ()
       return 1;
    if(test::list_test<managed_shared_memory, MyShmListV1, true>())
       return 1;
+   if(test::list_test<managed_shared_memory, MyShmLockFreeList, true>())
+      return 1;
    if(test::vector_test<managed_shared_memory, MyShmVector>())
       return 1;
    if(test::vector_test<managed_shared_memory, MyShmVectorV1>())
       return 1;
+   if(test::vector_test<managed_shared_memory, MyShmLockFreeVector>())
+      return 1;
    return 0;
 }
 
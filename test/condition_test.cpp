@@ -19,10 +19,80 @@
 #include <boost/interprocess/sync/windows/mutex.hpp>
 #include <boost/interprocess/sync/spin/condition.hpp>
 #include <boost/interprocess/sync/spin/mutex.hpp>
+#elif defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+#include <boost/interprocess/sync/linux/condition.hpp>
+#include <boost/interprocess/sync/spin/condition.hpp>
+#include <boost/interprocess/sync/spin/mutex.hpp>
 #endif
 
 using namespace boost::interprocess;
 
+#if defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+
+//Waits for the flag with its own mutex. If notify_all requeues the waiter
+//to the futex of another mutex, the wait times out
+template<class Mutex>
+struct futex_condition_waiter
+{
+   futex_condition_waiter(ipcdetail::futex_condition &cond, Mutex &mut, bool &flag)
+      : m_cond(cond), m_mut(mut), m_flag(flag), m_woken(false)
+   {}
+
+   void operator()()
+   {
+      scoped_lock<Mutex> lock(m_mut);
+      while(!m_flag){
+         if(!m_cond.timed_wait(lock, test::ptime_delay(10)))
+            return;
+      }
+      m_woken = true;
+   }
+
+   ipcdetail::futex_condition &m_cond;
+   Mutex &m_mut;
+   bool &m_flag;
+   bool m_woken;
+};
+
+template<class Mutex>
+void notify_flag(ipcdetail::futex_condition &cond, Mutex &mut, bool &flag)
+{
+   scoped_lock<Mutex> lock(mut);
+   flag = true;
+   cond.notify_all();
+}
+
+//notify_all must wake waiters using different mutexes, including
+//waiters with a mutex that can't be requeued, after the condition
+//has been bound to a spin_mutex
+bool test_futex_condition_mixed_mutexes()
+{
+   ipcdetail::futex_condition cond;
+   ipcdetail::spin_mutex mut1, mut2;
+   interprocess_mutex generic_mut;
+   bool flag1 = false, flag2 = false, generic_flag = false;
+
+   futex_condition_waiter<ipcdetail::spin_mutex> first(cond, mut1, flag1);
+   boost::thread th1(boost::ref(first));
+   //Let the first waiter bind the condition to its mutex
+   boost::thread::sleep(test::delay(1));
+   futex_condition_waiter<ipcdetail::spin_mutex> second(cond, mut2, flag2);
+   futex_condition_waiter<interprocess_mutex> generic(cond, generic_mut, generic_flag);
+   boost::thread th2(boost::ref(second));
+   boost::thread th3(boost::ref(generic));
+   boost::thread::sleep(test::delay(1));
+
+   notify_flag(cond, mut1, flag1);
+   notify_flag(cond, mut2, flag2);
+   notify_flag(cond, generic_mut, generic_flag);
+   th1.join();
+   th2.join();
+   th3.join();
+   return first.m_woken && second.m_woken && generic.m_woken;
+}
+
+#endif
+
 int main ()
 {
    #if defined(BOOST_INTERPROCESS_WINDOWS)
@@ -30,6 +100,13 @@ int main ()
          return 1;
       if(!test::do_test_condition<ipcdetail::spin_condition, ipcdetail::spin_mutex>())
          return 1;
+   #elif defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+      if(!test::do_test_condition<ipcdetail::futex_condition, ipcdetail::spin_mutex>())
+         return 1;
+      if(!test_futex_condition_mixed_mutexes())
+         return 1;
+      if(!test::do_test_condition<ipcdetail::spin_condition, ipcdetail::spin_mutex>())
+         return 1;
    #endif
    if(!test::do_test_condition<interprocess_condition, interprocess_mutex>())
       return 1;
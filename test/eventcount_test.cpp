@@ -0,0 +1,203 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/sync/interprocess_eventcount.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/cstdint.hpp>
+#include <cstring>
+#include "get_process_id_name.hpp"
+
+using namespace boost::interprocess;
+
+//Items produced and consumed without a mutex, consumers
+//sleep on "not_empty" when there are no items
+struct shared_items
+{
+   shared_items()
+      :  produced(0), consumed(0)
+   {}
+
+   //Claims an item, returns false if there is none
+   bool try_consume()
+   {
+      boost::uint32_t c = ipcdetail::atomic_read32(&consumed);
+      while(c != ipcdetail::atomic_read32(&produced)){
+         const boost::uint32_t old = ipcdetail::atomic_cas32(&consumed, c + 1, c);
+         if(old == c){
+            return true;
+         }
+         c = old;
+      }
+      return false;
+   }
+
+   volatile boost::uint32_t   produced;
+   volatile boost::uint32_t   consumed;
+   interprocess_eventcount    not_empty;
+};
+
+static const boost::uint32_t NumItems     = 50000;
+static const unsigned        NumConsumers = 4;
+
+struct consumer_thread
+{
+   consumer_thread(shared_items &items, volatile boost::uint32_t &done, boost::uint32_t &count)
+      :  m_items(items), m_done(done), m_count(count)
+   {}
+
+   void operator()()
+   {
+      for(;;){
+         while(!m_items.try_consume()){
+            if(ipcdetail::atomic_read32(&m_done)){
+               return;
+            }
+            const interprocess_eventcount::key_type key = m_items.not_empty.prepare_wait();
+            if(ipcdetail::atomic_read32(&m_items.consumed) != ipcdetail::atomic_read32(&m_items.produced) ||
+               ipcdetail::atomic_read32(&m_done)){
+               m_items.not_empty.cancel_wait();
+               continue;
+            }
+            m_items.not_empty.wait(key);
+         }
+         ++m_count;
+      }
+   }
+
+   shared_items &m_items;
+   volatile boost::uint32_t &m_done;
+   boost::uint32_t &m_count;
+};
+
+//Every item produced is consumed once and no consumer sleeps forever
+bool test_producer_consumers(shared_items &items)
+{
+   volatile boost::uint32_t done = 0;
+   boost::uint32_t counts[NumConsumers] = {};
+   boost::thread_group threads;
+   for(unsigned i = 0; i != NumConsumers; ++i){
+      threads.create_thread(consumer_thread(items, done, counts[i]));
+   }
+   for(boost::uint32_t i = 0; i != NumItems; ++i){
+      ipcdetail::atomic_inc32(&items.produced);
+      items.not_empty.notify_one();
+      if(i % 64 == 0){
+         ipcdetail::thread_yield();
+      }
+   }
+   //Wait until all items are consumed before stopping the consumers
+   while(ipcdetail::atomic_read32(&items.consumed) != NumItems){
+      ipcdetail::thread_yield();
+   }
+   ipcdetail::atomic_write32(&done, 1);
+   items.not_empty.notify_all();
+   threads.join_all();
+
+   boost::uint32_t total = 0;
+   for(unsigned i = 0; i != NumConsumers; ++i){
+      total += counts[i];
+   }
+   return total == NumItems;
+}
+
+struct flag_waiter
+{
+   flag_waiter(interprocess_eventcount &ec, volatile boost::uint32_t &flag)
+      :  m_ec(ec), m_flag(flag)
+   {}
+
+   void operator()()
+   {
+      while(!ipcdetail::atomic_read32(&m_flag)){
+         const interprocess_eventcount::key_type key = m_ec.prepare_wait();
+         if(ipcdetail::atomic_read32(&m_flag)){
+            m_ec.cancel_wait();
+            break;
+         }
+         m_ec.wait(key);
+      }
+   }
+
+   interprocess_eventcount &m_ec;
+   volatile boost::uint32_t &m_flag;
+};
+
+//notify_all wakes every blocked thread
+bool test_notify_all(interprocess_eventcount &ec)
+{
+   volatile boost::uint32_t flag = 0;
+   boost::thread_group threads;
+   for(unsigned i = 0; i != NumConsumers; ++i){
+      threads.create_thread(flag_waiter(ec, flag));
+   }
+   boost::thread::sleep(boost::get_system_time() + boost::posix_time::milliseconds(50));
+   ipcdetail::atomic_write32(&flag, 1);
+   ec.notify_all();
+   threads.join_all();
+   return true;
+}
+
+int main ()
+{
+   struct shm_remove
+   {
+      shm_remove(){ shared_memory_object::remove(test::get_process_id_name()); }
+      ~shm_remove(){ shared_memory_object::remove(test::get_process_id_name()); }
+   } remover;
+
+   managed_shared_memory segment(create_only, test::get_process_id_name(), 65536);
+
+   //Zeroed memory is a valid eventcount
+   {
+      void *mem = segment.allocate(sizeof(interprocess_eventcount));
+      std::memset(mem, 0, sizeof(interprocess_eventcount));
+      interprocess_eventcount &ec = *static_cast<interprocess_eventcount*>(mem);
+
+      //Notifications without waiters are not remembered
+      ec.notify_one();
+      ec.notify_all();
+      interprocess_eventcount::key_type key = ec.prepare_wait();
+      if(ec.timed_wait(key, boost::posix_time::microsec_clock::universal_time() +
+                            boost::posix_time::milliseconds(10))){
+         return 1;
+      }
+
+      //A notification issued after prepare_wait is not lost
+      key = ec.prepare_wait();
+      ec.notify_one();
+      if(!ec.timed_wait(key, boost::posix_time::microsec_clock::universal_time() +
+                             boost::posix_time::milliseconds(1000))){
+         return 1;
+      }
+
+      //Cancelled waiters are not counted
+      key = ec.prepare_wait();
+      ec.cancel_wait();
+      if(!test_notify_all(ec)){
+         return 1;
+      }
+      segment.deallocate(mem);
+   }
+
+   {
+      shared_items *items = segment.construct<shared_items>("items")();
+      if(!test_producer_consumers(*items)){
+         return 1;
+      }
+      segment.destroy_ptr(items);
+   }
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/allocators/node_allocator.hpp>
+#include <boost/interprocess/allocators/cached_node_allocator.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include "get_process_id_name.hpp"
+#include "random_allocation_test_template.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  This example tests node allocators that use a lock-free node pool from    //
+//  several threads and compares them with allocators that use a mutex.      //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace boost::interprocess;
+
+typedef managed_shared_memory::segment_manager segment_manager_t;
+
+struct node_t
+{
+   std::size_t m_values[3];
+};
+
+typedef node_allocator<node_t, segment_manager_t>                                  mutex_allocator_t;
+typedef node_allocator<node_t, segment_manager_t, 64, lock_free_pool_policy>       lock_free_allocator_t;
+typedef cached_node_allocator<node_t, segment_manager_t>                           mutex_cached_allocator_t;
+typedef cached_node_allocator<node_t, segment_manager_t, 64, lock_free_pool_policy> lock_free_cached_allocator_t;
+
+//Checks that nodes are unique and that free blocks are returned to the segment
+template<class Allocator>
+bool test_allocator(managed_shared_memory &segment)
+{
+   const managed_shared_memory::size_type free_memory = segment.get_free_memory();
+   {
+      Allocator alloc(segment.get_segment_manager());
+      std::vector<node_t*> nodes;
+      for(std::size_t i = 0; i != 1000; ++i){
+         node_t *node = ipcdetail::to_raw_pointer(alloc.allocate_one());
+         node->m_values[0] = node->m_values[1] = node->m_values[2] = i;
+         nodes.push_back(node);
+      }
+      std::vector<node_t*> sorted(nodes);
+      std::sort(sorted.begin(), sorted.end());
+      if(std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+         return false;
+      for(std::size_t i = 0; i != nodes.size(); ++i){
+         if(nodes[i]->m_values[0] != i || nodes[i]->m_values[2] != i)
+            return false;
+         alloc.deallocate_one(nodes[i]);
+      }
+
+      //Allocate and deallocate them together
+      typename Allocator::multiallocation_chain chain;
+      alloc.allocate_individual(500, chain);
+      if(chain.size() != 500)
+         return false;
+      alloc.deallocate_individual(chain);
+      alloc.deallocate_free_blocks();
+
+      //Other allocators of the same type share the pool
+      Allocator alloc2(alloc);
+      if(alloc2.get_node_pool() != alloc.get_node_pool())
+         return false;
+   }
+   return free_memory == segment.get_free_memory();
+}
+
+//Returns the time in microseconds threads take, or -1 on error
+template<class Allocator>
+long run_threads(managed_shared_memory &segment, std::size_t num_threads)
+{
+   const managed_shared_memory::size_type free_memory = segment.get_free_memory();
+   long elapsed_us;
+   {
+      Allocator alloc(segment.get_segment_manager());
+      elapsed_us = test::run_random_allocation_threads
+         (test::node_allocator_handle<Allocator>(alloc), num_threads, sizeof(node_t), sizeof(node_t));
+   }
+   return free_memory == segment.get_free_memory() ? elapsed_us : -1;
+}
+
+int main ()
+{
+   const char *const shMemName = test::get_process_id_name();
+   shared_memory_object::remove(shMemName);
+   {
+      managed_shared_memory segment(create_only, shMemName, 1024*1024);
+      if(!test_allocator<lock_free_allocator_t>(segment) ||
+         !test_allocator<lock_free_cached_allocator_t>(segment)){
+         shared_memory_object::remove(shMemName);
+         return 1;
+      }
+
+      const std::size_t num_threads[] = { 1, 4, 16 };
+      for(std::size_t i = 0; i != sizeof(num_threads)/sizeof(num_threads[0]); ++i){
+         const long mutex_us            = run_threads<mutex_allocator_t>(segment, num_threads[i]);
+         const long lock_free_us        = run_threads<lock_free_allocator_t>(segment, num_threads[i]);
+         const long mutex_cached_us     = run_threads<mutex_cached_allocator_t>(segment, num_threads[i]);
+         const long lock_free_cached_us = run_threads<lock_free_cached_allocator_t>(segment, num_threads[i]);
+         if(mutex_us < 0 || lock_free_us < 0 || mutex_cached_us < 0 || lock_free_cached_us < 0){
+            shared_memory_object::remove(shMemName);
+            return 1;
+         }
+         std::cout << "threads: "     << std::setw(2) << num_threads[i]
+                   << " mutex: "      << std::setw(8) << mutex_us            << "us"
+                   << " lock-free: "  << std::setw(8) << lock_free_us        << "us"
+                   << " cached mutex: "     << std::setw(8) << mutex_cached_us     << "us"
+                   << " cached lock-free: " << std::setw(8) << lock_free_cached_us << "us" << std::endl;
+      }
+   }
+   shared_memory_object::remove(shMemName);
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
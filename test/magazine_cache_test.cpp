@@ -0,0 +1,282 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/allocators/cached_node_allocator.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/barrier.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include "get_process_id_name.hpp"
+#include "random_allocation_test_template.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  This example tests cached_node_allocators that cache nodes in per-thread //
+//  magazines, frees nodes in threads that did not allocate them and         //
+//  compares them with allocators that cache nodes in each allocator.        //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace boost::interprocess;
+
+typedef managed_shared_memory::segment_manager segment_manager_t;
+
+struct node_t
+{
+   std::size_t m_values[3];
+};
+
+typedef cached_node_allocator
+   <node_t, segment_manager_t>                                                   node_allocator_t;
+typedef cached_node_allocator
+   <node_t, segment_manager_t, 64, mutex_pool_policy, magazine_cache_policy>     magazine_node_allocator_t;
+typedef cached_node_allocator
+   <node_t, segment_manager_t, 64, lock_free_pool_policy, magazine_cache_policy> lock_free_magazine_node_allocator_t;
+
+//Checks that nodes are unique, that allocators share the magazines
+//and that flushed nodes are returned to the segment
+template<class Allocator>
+bool test_allocator(managed_shared_memory &segment)
+{
+   const managed_shared_memory::size_type free_memory = segment.get_free_memory();
+   {
+      Allocator alloc(segment.get_segment_manager());
+      if(alloc.get_max_cached_nodes() != 64)
+         return false;
+      const managed_shared_memory::size_type pool_free_memory = segment.get_free_memory();
+      std::vector<node_t*> nodes;
+      for(std::size_t i = 0; i != 1000; ++i){
+         node_t *node = ipcdetail::to_raw_pointer(alloc.allocate_one());
+         node->m_values[0] = node->m_values[1] = node->m_values[2] = i;
+         nodes.push_back(node);
+      }
+      std::vector<node_t*> sorted(nodes);
+      std::sort(sorted.begin(), sorted.end());
+      if(std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+         return false;
+      for(std::size_t i = 0; i != nodes.size(); ++i){
+         if(nodes[i]->m_values[0] != i || nodes[i]->m_values[2] != i)
+            return false;
+         alloc.deallocate_one(nodes[i]);
+      }
+
+      //Nodes cached by an allocator are available to its copies
+      Allocator alloc2(alloc);
+      if(alloc2.get_node_pool() != alloc.get_node_pool())
+         return false;
+      const managed_shared_memory::size_type cached_free_memory = segment.get_free_memory();
+      node_t *node = ipcdetail::to_raw_pointer(alloc2.allocate_one());
+      if(std::find(nodes.begin(), nodes.end(), node) == nodes.end() ||
+         cached_free_memory != segment.get_free_memory())
+         return false;
+      alloc2.deallocate_one(node);
+
+      //Allocate and deallocate them together
+      typename Allocator::multiallocation_chain chain;
+      alloc.allocate_individual(500, chain);
+      if(chain.size() != 500)
+         return false;
+      alloc.deallocate_individual(chain);
+
+      //Smaller magazines
+      alloc.set_max_cached_nodes(8);
+      if(alloc2.get_max_cached_nodes() != 8)
+         return false;
+      alloc.allocate_individual(100, chain);
+      alloc.deallocate_individual(chain);
+
+      //Flushing magazines returns all the memory
+      alloc.deallocate_cache();
+      alloc.deallocate_free_blocks();
+      if(pool_free_memory != segment.get_free_memory())
+         return false;
+      alloc.set_max_cached_nodes(64);
+   }
+   return free_memory == segment.get_free_memory();
+}
+
+static const std::size_t MaxThreads = 16;
+
+//Allocates nodes that other threads deallocate
+template<class Allocator>
+struct producer_thread
+{
+   producer_thread(const Allocator &alloc, std::vector<node_t*> &nodes)
+      :  m_alloc(alloc), m_nodes(nodes)
+   {}
+
+   void operator()()
+   {
+      for(std::size_t i = 0; i != m_nodes.size(); ++i){
+         m_nodes[i] = ipcdetail::to_raw_pointer(m_alloc.allocate_one());
+         m_nodes[i]->m_values[0] = m_nodes[i]->m_values[1] = m_nodes[i]->m_values[2] = i;
+      }
+   }
+
+   Allocator m_alloc;
+   std::vector<node_t*> &m_nodes;
+};
+
+template<class Allocator>
+struct consumer_thread
+{
+   consumer_thread(const Allocator &alloc, std::vector<node_t*> &nodes, bool &ok)
+      :  m_alloc(alloc), m_nodes(nodes), m_ok(ok)
+   {}
+
+   void operator()()
+   {
+      for(std::size_t i = 0; i != m_nodes.size(); ++i){
+         if(m_nodes[i]->m_values[0] != i || m_nodes[i]->m_values[2] != i)
+            m_ok = false;
+         m_alloc.deallocate_one(m_nodes[i]);
+      }
+   }
+
+   Allocator m_alloc;
+   std::vector<node_t*> &m_nodes;
+   bool &m_ok;
+};
+
+//Nodes allocated by each thread are deallocated by another thread
+template<class Allocator>
+bool test_cross_thread(managed_shared_memory &segment)
+{
+   const managed_shared_memory::size_type free_memory = segment.get_free_memory();
+   {
+      Allocator alloc(segment.get_segment_manager());
+      std::vector<std::vector<node_t*> > nodes(MaxThreads, std::vector<node_t*>(1000));
+      bool ok[MaxThreads];
+      for(std::size_t round = 0; round != 4; ++round){
+         boost::thread_group producers;
+         for(std::size_t i = 0; i != MaxThreads; ++i){
+            producers.create_thread(producer_thread<Allocator>(alloc, nodes[i]));
+         }
+         producers.join_all();
+         boost::thread_group consumers;
+         for(std::size_t i = 0; i != MaxThreads; ++i){
+            ok[i] = true;
+            consumers.create_thread
+               (consumer_thread<Allocator>(alloc, nodes[(i + round + 1) % MaxThreads], ok[i]));
+         }
+         consumers.join_all();
+         for(std::size_t i = 0; i != MaxThreads; ++i){
+            if(!ok[i])
+               return false;
+         }
+      }
+   }
+   return free_memory == segment.get_free_memory();
+}
+
+//Stores the thread hash of a thread while all of them are alive,
+//so that no thread id is reused
+struct hash_thread
+{
+   hash_thread(boost::barrier &barrier, std::size_t &hash)
+      :  m_barrier(barrier), m_hash(hash)
+   {}
+
+   void operator()()
+   {
+      m_hash = ipcdetail::get_current_thread_hash();
+      m_barrier.wait();
+   }
+
+   boost::barrier &m_barrier;
+   std::size_t &m_hash;
+};
+
+//Checks that distinct threads get distinct hashes and that ids which only
+//differ in the high bits of a byte, like glibc thread ids placed a stack
+//size apart, are spread among the slots of magazine pools
+bool test_thread_hash_spread()
+{
+   const std::size_t NumHashThreads = 64;
+   const std::size_t NumSlots = 16;
+   std::size_t hashes[NumHashThreads];
+   {
+      boost::barrier barrier(NumHashThreads);
+      boost::thread_group threads;
+      for(std::size_t i = 0; i != NumHashThreads; ++i){
+         threads.create_thread(hash_thread(barrier, hashes[i]));
+      }
+      threads.join_all();
+   }
+   std::sort(hashes, hashes + NumHashThreads);
+   if(std::unique(hashes, hashes + NumHashThreads) != hashes + NumHashThreads)
+      return false;
+
+   //The FNV-1a hash of these ids is the same modulo NumSlots
+   bool used[NumSlots] = {};
+   std::size_t num_used = 0;
+   for(std::size_t i = 0; i != NumSlots; ++i){
+      const unsigned long id = 0x7f0006c0ul | (unsigned long)(i << 12);
+      const std::size_t slot = ipcdetail::thread_hash_finalize
+         (ipcdetail::fnv1a_hash(&id, sizeof(id))) % NumSlots;
+      num_used += !used[slot];
+      used[slot] = true;
+   }
+   return num_used > NumSlots/2;
+}
+
+//Returns the time in microseconds threads take, or -1 on error
+template<class Allocator>
+long run_threads(managed_shared_memory &segment, std::size_t num_threads)
+{
+   const managed_shared_memory::size_type free_memory = segment.get_free_memory();
+   long elapsed_us;
+   {
+      Allocator alloc(segment.get_segment_manager());
+      elapsed_us = test::run_random_allocation_threads
+         (test::node_allocator_handle<Allocator>(alloc), num_threads, sizeof(node_t), sizeof(node_t));
+   }
+   return free_memory == segment.get_free_memory() ? elapsed_us : -1;
+}
+
+int main ()
+{
+   const char *const shMemName = test::get_process_id_name();
+   shared_memory_object::remove(shMemName);
+   {
+      managed_shared_memory segment(create_only, shMemName, 4*1024*1024);
+      if(!test_thread_hash_spread() ||
+         !test_allocator<magazine_node_allocator_t>(segment) ||
+         !test_allocator<lock_free_magazine_node_allocator_t>(segment) ||
+         !test_cross_thread<magazine_node_allocator_t>(segment) ||
+         !test_cross_thread<lock_free_magazine_node_allocator_t>(segment)){
+         shared_memory_object::remove(shMemName);
+         return 1;
+      }
+
+      const std::size_t num_threads[] = { 1, 4, 16 };
+      for(std::size_t i = 0; i != sizeof(num_threads)/sizeof(num_threads[0]); ++i){
+         const long node_us      = run_threads<node_allocator_t>(segment, num_threads[i]);
+         const long magazine_us  = run_threads<magazine_node_allocator_t>(segment, num_threads[i]);
+         const long lock_free_us = run_threads<lock_free_magazine_node_allocator_t>(segment, num_threads[i]);
+         if(node_us < 0 || magazine_us < 0 || lock_free_us < 0){
+            shared_memory_object::remove(shMemName);
+            return 1;
+         }
+         std::cout << "threads: "     << std::setw(2) << num_threads[i]
+                   << " allocator cache: "     << std::setw(8) << node_us      << "us"
+                   << " magazines: "           << std::setw(8) << magazine_us  << "us"
+                   << " lock-free magazines: " << std::setw(8) << lock_free_us << "us" << std::endl;
+      }
+   }
+   shared_memory_object::remove(shMemName);
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
@@ -12,8 +12,10 @@
 #include <boost/interprocess/allocators/allocator.hpp>
 #include <boost/interprocess/containers/vector.hpp>
 #include <boost/interprocess/managed_mapped_file.hpp>
+#include <boost/cstdint.hpp>
 #include <cstdio>
 #include <string>
+#include <fstream>
 #include "get_process_id_name.hpp"
 
 using namespace boost::interprocess;
@@ -26,6 +28,40 @@ inline std::string get_filename()
    return ret;
 }
 
+//Overwrites the word at the start of the file that stores
+//the initialization state and the layout version
+inline bool swap_init_word(const char *filename, boost::uint32_t &word)
+{
+   std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+   boost::uint32_t old_word;
+   if(!file.read(reinterpret_cast<char*>(&old_word), sizeof(old_word)))
+      return false;
+   file.seekp(0);
+   if(!file.write(reinterpret_cast<const char*>(&word), sizeof(word)))
+      return false;
+   word = old_word;
+   return true;
+}
+
+//Checks that files created by a library with another layout,
+//which are initialized with a different word, can't be opened
+inline bool test_layout_version(const char *filename)
+{
+   //Segments created before layout versions were recorded
+   boost::uint32_t word = 2;
+   if(!swap_init_word(filename, word))
+      return false;
+   bool thrown = false;
+   try{
+      managed_mapped_file mfile(open_only, filename);
+   }
+   catch(interprocess_exception &e){
+      thrown = e.get_error_code() == corrupted_error;
+   }
+   //Restore the word
+   return swap_init_word(filename, word) && thrown;
+}
+
 int main ()
 {
    const int FileSize          = 65536*10;
@@ -219,6 +255,14 @@ int main ()
       }
    }
 
+   if(!test_layout_version(FileName))
+      return -1;
+   {
+      managed_mapped_file mfile(open_only, FileName);
+      if(!mfile.check_sanity())
+         return -1;
+   }
+
    file_mapping::remove(FileName);
    return 0;
 }
@@ -12,12 +12,46 @@
 #include <boost/interprocess/allocators/allocator.hpp>
 #include <boost/interprocess/containers/vector.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/mem_algo/simple_seq_fit.hpp>
+#include <boost/static_assert.hpp>
 #include <cstdio>
+#include <cstring>
 #include <string>
 #include "get_process_id_name.hpp"
 
 using namespace boost::interprocess;
 
+//Only rbtree_best_fit is told that a new segment reads as zero
+BOOST_STATIC_ASSERT((ipcdetail::has_mark_free_memory_zeroed
+   <managed_shared_memory::segment_manager::memory_algorithm>::value));
+BOOST_STATIC_ASSERT((!ipcdetail::has_mark_free_memory_zeroed
+   <simple_seq_fit<mutex_family> >::value));
+
+//Buffers allocated with zero_memory from a new segment, whose free memory
+//is marked as zero instead of being cleared, and after writing and
+//deallocating them, must read as zero
+bool test_zero_memory_new_segment(const char *name)
+{
+   shared_memory_object::remove(name);
+   bool ok = true;
+   {
+      managed_shared_memory shmem(create_only, name, 65536);
+      managed_shared_memory::size_type received_size;
+      for(int round = 0; round != 2 && ok; ++round){
+         char *ptr = shmem.allocation_command<char>
+            (allocate_new | zero_memory, 4096, 4096, received_size).first;
+         for(managed_shared_memory::size_type i = 0; i != received_size; ++i){
+            ok = ok && ptr[i] == 0;
+         }
+         std::memset(ptr, 1, received_size);
+         shmem.deallocate(ptr);
+      }
+      ok = ok && shmem.all_memory_deallocated() && shmem.check_sanity();
+   }
+   shared_memory_object::remove(name);
+   return ok;
+}
+
 int main ()
 {
    const int ShmemSize          = 65536;
@@ -210,6 +244,8 @@ int main ()
    }
 
    shared_memory_object::remove(ShmemName);
+   if(!test_zero_memory_new_segment(ShmemName))
+      return 1;
    return 0;
 }
 
@@ -12,6 +12,8 @@
 #include <boost/interprocess/managed_shared_memory.hpp>
 #include <boost/interprocess/mem_algo/simple_seq_fit.hpp>
 #include <boost/interprocess/mem_algo/rbtree_best_fit.hpp>
+#include <boost/interprocess/mem_algo/sharded_best_fit.hpp>
+#include <boost/interprocess/mem_algo/tlsf_fit.hpp>
 #include <boost/interprocess/indexes/null_index.hpp>
 #include <boost/interprocess/sync/mutex_family.hpp>
 #include <boost/interprocess/detail/type_traits.hpp>
@@ -19,6 +21,8 @@
 #include "memory_algorithm_test_template.hpp"
 #include <iostream>
 #include <string>
+#include <vector>
+#include <new>
 #include "get_process_id_name.hpp"
 
 using namespace boost::interprocess;
@@ -67,6 +71,121 @@ int test_rbtree_best_fit()
    return 0;
 }
 
+//Grows the algorithm by less bytes than a block needs and by just enough
+//for one. The new memory must only become a free block in the latter case,
+//so that the algorithm stays consistent
+template<std::size_t Alignment>
+int test_rbtree_best_fit_grow_small()
+{
+   typedef rbtree_best_fit<mutex_family, offset_ptr<void>, Alignment> algo_t;
+   typedef typename algo_t::size_type size_type;
+
+   std::vector<char> buffer(Memsize + Alignment);
+   //The memory algorithm must be aligned
+   void *addr = &buffer[0] + (Alignment - (std::size_t)&buffer[0] % Alignment);
+   const size_type initial_size = algo_t::get_min_size(0) + 4096;
+   for(size_type extra = 1; extra != 8*Alignment; ++extra){
+      algo_t *algo = new(addr) algo_t(initial_size, 0);
+      const size_type free_memory = algo->get_free_memory();
+      algo->grow(extra);
+      const bool ok = algo->check_sanity() && algo->get_free_memory() >= free_memory;
+      algo->~algo_t();
+      if(!ok){
+         return 1;
+      }
+   }
+   return 0;
+}
+
+template<std::size_t Alignment>
+int test_rbtree_best_fit_bins()
+{
+   //A shared memory with red-black tree best fit algorithm
+   //serving small allocations from size-class bins
+   typedef basic_managed_shared_memory
+      <char
+      ,rbtree_best_fit<mutex_family, offset_ptr<void>, Alignment>
+      ,null_index
+      > my_managed_shared_memory;
+
+   //Create shared memory
+   shared_memory_object::remove(shMemName);
+   my_managed_shared_memory segment(create_only, shMemName, Memsize);
+   typename my_managed_shared_memory::segment_manager &a = *segment.get_segment_manager();
+   a.set_bin_capacity(64);
+   if(a.get_bin_capacity() != 64){
+      return 1;
+   }
+
+   //Now launch memory tests. test_clear_free_memory is not run because
+   //blocks cached after zero_free_memory() are not cleared when an
+   //allocation fails and they are returned to the free block tree
+   if(!test::test_allocation(a)                      ||
+      !test::test_many_equal_allocation(a)           ||
+      !test::test_many_different_allocation(a)       ||
+      !test::test_many_deallocation(a)               ||
+      !test::test_allocation_shrink(a)               ||
+      !test::test_allocation_shrink_and_expand(a)    ||
+      !test::test_allocation_expand(a)               ||
+      !test::test_allocation_deallocation_expand(a)  ||
+      !test::test_allocation_with_reuse(a)           ||
+      !test::test_aligned_allocation(a)              ||
+      !test::test_continuous_aligned_allocation(a)   ||
+      !test::test_grow_shrink_to_fit(a)){
+      return 1;
+   }
+
+   //Disabling bins returns cached blocks to the tree
+   a.set_bin_capacity(0);
+   if(!test::test_all_allocation(a)){
+      return 1;
+   }
+   return 0;
+}
+
+int test_sharded_best_fit()
+{
+   //A shared memory with several best fit arenas
+   typedef sharded_best_fit<mutex_family, offset_ptr<void>, 4> algo_t;
+   typedef basic_managed_shared_memory
+      <char
+      ,algo_t
+      ,null_index
+      > my_managed_shared_memory;
+
+   //Create shared memory big enough for all arenas
+   shared_memory_object::remove(shMemName);
+   my_managed_shared_memory segment(create_only, shMemName, 5*algo_t::MinArenaSize);
+
+   //Now take the segment manager and launch memory test
+   if(!test::test_all_allocation(*segment.get_segment_manager())){
+      return 1;
+   }
+   return 0;
+}
+
+template<std::size_t Alignment>
+int test_tlsf_fit()
+{
+   //A shared memory with two-level segregated fit algorithm
+   typedef basic_managed_shared_memory
+      <char
+      ,tlsf_fit<mutex_family, offset_ptr<void>, Alignment>
+      ,null_index
+      > my_managed_shared_memory;
+
+   //Create shared memory. The header of the algorithm
+   //stores the heads of all free lists
+   shared_memory_object::remove(shMemName);
+   my_managed_shared_memory segment(create_only, shMemName, 2*Memsize);
+
+   //Now take the segment manager and launch memory test
+   if(!test::test_all_allocation(*segment.get_segment_manager())){
+      return 1;
+   }
+   return 0;
+}
+
 int main ()
 {
    const std::size_t void_ptr_align = ::boost::alignment_of<offset_ptr<void> >::value;
@@ -83,6 +202,27 @@ int main ()
    if(test_rbtree_best_fit<4*void_ptr_align>()){
       return 1;
    }
+   if(test_rbtree_best_fit_grow_small<void_ptr_align>()){
+      return 1;
+   }
+   if(test_rbtree_best_fit_grow_small<4*void_ptr_align>()){
+      return 1;
+   }
+   if(test_rbtree_best_fit_bins<void_ptr_align>()){
+      return 1;
+   }
+   if(test_rbtree_best_fit_bins<4*void_ptr_align>()){
+      return 1;
+   }
+   if(test_sharded_best_fit()){
+      return 1;
+   }
+   if(test_tlsf_fit<void_ptr_align>()){
+      return 1;
+   }
+   if(test_tlsf_fit<4*void_ptr_align>()){
+      return 1;
+   }
 
    shared_memory_object::remove(shMemName);
    return 0;
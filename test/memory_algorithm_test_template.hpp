@@ -533,6 +533,70 @@ bool test_clear_free_memory(Allocator &a)
    return true;
 }
 
+//Allocates buffers with the zero_memory flag until there is no more memory,
+//checking they are zero, and writes them with a non-zero value
+template<class Allocator>
+bool test_zero_memory_buffers(Allocator &a, std::vector<void*> &buffers)
+{
+   typename Allocator::size_type received_size;
+   for(std::size_t i = 0; true; ++i){
+      const std::size_t size = (i*37) % 2000;
+      char *ptr = a.template allocation_command<char>
+         ( boost::interprocess::allocate_new | boost::interprocess::zero_memory |
+           boost::interprocess::nothrow_allocation, size, size, received_size).first;
+      if(!ptr)
+         break;
+      if(received_size < size)
+         return false;
+      for(std::size_t j = 0; j != received_size; ++j){
+         if(ptr[j])
+            return false;
+      }
+      std::memset(ptr, 1, received_size);
+      buffers.push_back(ptr);
+   }
+   return !buffers.empty();
+}
+
+//This test allocates buffers with the zero_memory flag from written free memory,
+//from memory cleared by zero_free_memory and after expanding buffers over it
+template<class Allocator>
+bool test_zero_memory_allocation(Allocator &a)
+{
+   std::vector<void*> buffers;
+   for(int round = 0; round != 3; ++round){
+      if(round){
+         a.zero_free_memory();
+      }
+      //Grow a buffer in small steps over the cleared memory
+      if(round == 2){
+         void *ptr = a.allocate(100);
+         typename Allocator::size_type received_size = a.size(ptr);
+         for(int i = 0; i != 100; ++i){
+            const std::size_t min_size = received_size + 1;
+            if(!a.template allocation_command<char>
+               ( boost::interprocess::expand_fwd | boost::interprocess::nothrow_allocation
+               , min_size, min_size, received_size, static_cast<char*>(ptr)).first)
+               break;
+            std::memset(ptr, 1, received_size);
+         }
+         buffers.push_back(ptr);
+      }
+      if(!test_zero_memory_buffers(a, buffers))
+         return false;
+      //Deallocate in non sequential order
+      for(std::size_t i = 0; i < buffers.size(); i += 2){
+         a.deallocate(buffers[i]);
+      }
+      for(std::size_t i = 1; i < buffers.size(); i += 2){
+         a.deallocate(buffers[i]);
+      }
+      buffers.clear();
+      if(!a.all_memory_deallocated() || !a.check_sanity())
+         return false;
+   }
+   return true;
+}
 
 //This test uses tests grow and shrink_to_fit functions
 template<class Allocator>
@@ -902,6 +966,81 @@ bool test_many_deallocation(Allocator &a)
 }
 
 
+//This test checks the statistics of free and allocated blocks
+//after allocating buffers and deallocating every other one
+template<class Allocator>
+bool test_stats(Allocator &a)
+{
+   typedef typename Allocator::size_type  size_type;
+   typedef typename Allocator::stats_type stats_type;
+   stats_type before;
+   a.get_stats(before);
+   if(before.segment_size != a.get_size() || !before.free_blocks ||
+      before.largest_free_block >= before.free_bytes ||
+      before.free_bytes + before.allocated_bytes + before.overhead_bytes != before.segment_size){
+      return false;
+   }
+
+   //The biggest free block can be allocated
+   void *biggest = a.allocate(before.largest_free_block, std::nothrow);
+   if(!biggest){
+      return false;
+   }
+   a.deallocate(biggest);
+
+   std::vector<void*> buffers;
+   for(size_type i = 0; i != 64; ++i){
+      void *ptr = a.allocate(16 + i*8, std::nothrow);
+      if(!ptr)
+         break;
+      buffers.push_back(ptr);
+   }
+   size_type user_bytes = 0, num_allocated = 0;
+   for(size_type i = 0; i != buffers.size(); ++i){
+      if(i % 2){
+         user_bytes += a.size(buffers[i]);
+         ++num_allocated;
+      }
+      else{
+         a.deallocate(buffers[i]);
+      }
+   }
+
+   stats_type stats;
+   a.get_stats(stats);
+   if(stats.allocations   != before.allocations + 1 + buffers.size() ||
+      stats.deallocations != before.deallocations + 1 + (buffers.size() - num_allocated)){
+      return false;
+   }
+   if(stats.allocated_blocks != before.allocated_blocks + num_allocated ||
+      stats.allocated_bytes  != before.allocated_bytes + user_bytes ||
+      stats.overhead_bytes   != before.overhead_bytes + num_allocated*Allocator::PayloadPerAllocation ||
+      stats.free_bytes + stats.allocated_bytes + stats.overhead_bytes != stats.segment_size ||
+      stats.largest_free_block >= stats.free_bytes){
+      return false;
+   }
+
+   //Histograms count all blocks
+   size_type free_blocks = 0, allocated_blocks = 0;
+   for(std::size_t i = 0; i != stats_type::NumSizeClasses; ++i){
+      free_blocks      += stats.free_histogram[i];
+      allocated_blocks += stats.allocated_histogram[i];
+   }
+   if(free_blocks != stats.free_blocks || allocated_blocks != stats.allocated_blocks){
+      return false;
+   }
+
+   for(size_type i = 1; i < buffers.size(); i += 2){
+      a.deallocate(buffers[i]);
+   }
+   a.get_stats(stats);
+   return stats.allocated_blocks == before.allocated_blocks &&
+          stats.allocated_bytes  == before.allocated_bytes  &&
+          stats.free_bytes       == before.free_bytes       &&
+          stats.deallocations    == before.deallocations + 1 + buffers.size() &&
+          a.check_sanity();
+}
+
 //This function calls all tests
 template<class Allocator>
 bool test_all_allocation(Allocator &a)
@@ -1008,6 +1147,24 @@ bool test_all_allocation(Allocator &a)
       return false;
    }
 
+   std::cout << "Starting test_zero_memory_allocation. Class: "
+             << typeid(a).name() << std::endl;
+
+   if(!test_zero_memory_allocation(a)){
+      std::cout << "test_zero_memory_allocation failed. Class: "
+                << typeid(a).name() << std::endl;
+      return false;
+   }
+
+   std::cout << "Starting test_stats. Class: "
+             << typeid(a).name() << std::endl;
+
+   if(!test_stats(a)){
+      std::cout << "test_stats failed. Class: "
+                << typeid(a).name() << std::endl;
+      return false;
+   }
+
    std::cout << "Starting test_grow_shrink_to_fit. Class: "
              << typeid(a).name() << std::endl;
 
@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+//Throughput benchmark: a thread sends 64 byte messages to another thread
+//through message_queue, one by one and with send_n/receive_n batches of
+//several sizes. Prints the number of messages per second.
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/ipc/message_queue.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include "get_process_id_name.hpp"
+
+using namespace boost::interprocess;
+
+static const std::size_t NumMsg  = 400000;
+static const std::size_t MaxMsg  = 256;
+static const std::size_t MsgSize = 64;
+
+struct message
+{
+   std::size_t seq;
+   char payload[MsgSize - sizeof(std::size_t)];
+};
+
+struct producer_thread
+{
+   producer_thread(message_queue &mq, std::size_t batch)
+      :  m_mq(mq), m_batch(batch)
+   {}
+
+   void operator()()
+   {
+      std::vector<message> msgs(m_batch);
+      std::vector<message_queue::send_buffer> bufs(m_batch);
+      for(std::size_t i = 0; i < NumMsg; i += m_batch){
+         const std::size_t n = (NumMsg - i) < m_batch ? (NumMsg - i) : m_batch;
+         for(std::size_t j = 0; j != n; ++j){
+            msgs[j].seq = i + j;
+         }
+         if(m_batch == 1){
+            m_mq.send(&msgs[0], sizeof(message), 0);
+            continue;
+         }
+         for(std::size_t j = 0; j != n; ++j){
+            bufs[j].buffer   = &msgs[j];
+            bufs[j].size     = sizeof(message);
+            bufs[j].priority = 0;
+         }
+         m_mq.send_n(&bufs[0], n);
+      }
+   }
+
+   message_queue &m_mq;
+   std::size_t m_batch;
+};
+
+struct consumer_thread
+{
+   consumer_thread(message_queue &mq, std::size_t batch, bool &ok)
+      :  m_mq(mq), m_batch(batch), m_ok(ok)
+   {}
+
+   void operator()()
+   {
+      std::vector<message> msgs(m_batch);
+      std::vector<message_queue::receive_buffer> bufs(m_batch);
+      for(std::size_t j = 0; j != m_batch; ++j){
+         bufs[j].buffer      = &msgs[j];
+         bufs[j].buffer_size = sizeof(message);
+      }
+      std::size_t next = 0;
+      while(next != NumMsg){
+         message_queue::size_type n = 1;
+         if(m_batch == 1){
+            unsigned int priority;
+            m_mq.receive(&msgs[0], sizeof(message), bufs[0].recvd_size, priority);
+         }
+         else{
+            n = m_mq.receive_n(&bufs[0], m_batch);
+         }
+         for(std::size_t j = 0; j != n; ++j){
+            if(msgs[j].seq != next++){
+               m_ok = false;
+               return;
+            }
+         }
+      }
+      m_ok = true;
+   }
+
+   message_queue &m_mq;
+   std::size_t m_batch;
+   bool &m_ok;
+};
+
+bool run_batch(std::size_t batch)
+{
+   const char *const name = test::get_process_id_name();
+   message_queue::remove(name);
+   bool ok = false;
+   boost::posix_time::time_duration elapsed;
+   {
+      message_queue mq(create_only, name, MaxMsg, sizeof(message));
+      const boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+      boost::thread_group threads;
+      threads.create_thread(consumer_thread(mq, batch, ok));
+      threads.create_thread(producer_thread(mq, batch));
+      threads.join_all();
+      elapsed = boost::posix_time::microsec_clock::universal_time() - start;
+   }
+   message_queue::remove(name);
+   if(!ok){
+      return false;
+   }
+
+   const double secs = double(elapsed.total_microseconds())/1000000.0;
+   std::cout << std::setw(16) << (batch == 1 ? "send/receive" : "send_n/receive_n")
+             << " batch: " << std::setw(3) << batch
+             << " msgs/s: " << std::setw(12) << std::fixed << std::setprecision(0)
+             << (secs > 0 ? double(NumMsg)/secs : 0.0) << std::endl;
+   return true;
+}
+
+int main ()
+{
+   const std::size_t batches[] = { 1, 4, 16, 64 };
+   for(std::size_t i = 0; i != sizeof(batches)/sizeof(batches[0]); ++i){
+      if(!run_batch(batches[i]))
+         return 1;
+   }
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
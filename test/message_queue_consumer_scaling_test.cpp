@@ -0,0 +1,124 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+//Consumer scaling benchmark: a thread sends bursts of messages through
+//message_queue to 1..8 consumer threads that block when the queue is empty.
+//Each message takes a consumer some time to process (it sleeps, so that
+//consumers run in parallel even with a single CPU). Prints the number of
+//messages per second and the speedup over a single consumer, which should
+//grow linearly if every queued message wakes a blocked consumer.
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/ipc/message_queue.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <iostream>
+#include <iomanip>
+#include "get_process_id_name.hpp"
+
+using namespace boost::interprocess;
+
+static const std::size_t NumMsg    = 4000;
+static const std::size_t MaxMsg    = 256;
+static const std::size_t BurstSize = 16;
+static const long        WorkUsecs = 200;
+//Consumers stop when they receive this value
+static const std::size_t StopMsg   = std::size_t(-1);
+
+struct consumer_thread
+{
+   consumer_thread(message_queue &mq, std::size_t &num_recvd)
+      :  m_mq(mq), m_num_recvd(num_recvd)
+   {}
+
+   void operator()()
+   {
+      message_queue::size_type recvd;
+      unsigned int priority;
+      std::size_t msg;
+      for(;;){
+         m_mq.receive(&msg, sizeof(msg), recvd, priority);
+         if(msg == StopMsg){
+            return;
+         }
+         ++m_num_recvd;
+         boost::this_thread::sleep(boost::posix_time::microseconds(WorkUsecs));
+      }
+   }
+
+   message_queue &m_mq;
+   std::size_t &m_num_recvd;
+};
+
+//Returns the number of messages per second or 0 on error
+double run_consumers(std::size_t num_consumers)
+{
+   const char *const name = test::get_process_id_name();
+   message_queue::remove(name);
+   std::size_t total = 0;
+   boost::posix_time::time_duration elapsed;
+   {
+      message_queue mq(create_only, name, MaxMsg, sizeof(std::size_t));
+      std::size_t num_recvd[8] = {};
+      boost::thread_group consumers;
+      for(std::size_t i = 0; i != num_consumers; ++i){
+         consumers.create_thread(consumer_thread(mq, num_recvd[i]));
+      }
+      //Let consumers block on the empty queue
+      boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+
+      const boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+      for(std::size_t i = 0; i != NumMsg; ++i){
+         mq.send(&i, sizeof(i), 0);
+         //Bursts are sent while consumers are still busy
+         //with the previous one or blocked on the empty queue
+         if((i % BurstSize) == BurstSize - 1){
+            while(mq.get_num_msg() != 0){
+               boost::this_thread::yield();
+            }
+         }
+      }
+      for(std::size_t i = 0; i != num_consumers; ++i){
+         mq.send(&StopMsg, sizeof(StopMsg), 0);
+      }
+      consumers.join_all();
+      elapsed = boost::posix_time::microsec_clock::universal_time() - start;
+      for(std::size_t i = 0; i != num_consumers; ++i){
+         total += num_recvd[i];
+      }
+   }
+   message_queue::remove(name);
+   if(total != NumMsg){
+      return 0.0;
+   }
+   const double secs = double(elapsed.total_microseconds())/1000000.0;
+   return secs > 0 ? double(NumMsg)/secs : 0.0;
+}
+
+int main ()
+{
+   const std::size_t num_consumers[] = { 1, 2, 4, 8 };
+   double base = 0.0;
+   for(std::size_t i = 0; i != sizeof(num_consumers)/sizeof(num_consumers[0]); ++i){
+      const double rate = run_consumers(num_consumers[i]);
+      if(rate == 0.0){
+         return 1;
+      }
+      if(i == 0){
+         base = rate;
+      }
+      std::cout << "consumers: " << std::setw(2) << num_consumers[i]
+                << " msgs/s: " << std::setw(10) << std::fixed << std::setprecision(0) << rate
+                << " speedup: " << std::setprecision(2) << rate/base << std::endl;
+   }
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
@@ -12,6 +12,8 @@
 #include <boost/interprocess/ipc/message_queue.hpp>
 #include <boost/interprocess/managed_external_buffer.hpp>
 #include <boost/interprocess/managed_heap_memory.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <boost/interprocess/containers/map.hpp>
 #include <boost/interprocess/containers/set.hpp>
 #include <boost/interprocess/allocators/node_allocator.hpp>
@@ -21,6 +23,8 @@
 #include <boost/thread.hpp>
 #include <memory>
 #include <string>
+#include <cstdlib>
+#include <cstring>
 #include "get_process_id_name.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -34,14 +38,14 @@ using namespace boost::interprocess;
 //This test inserts messages with different priority and marks them with a
 //time-stamp to check if receiver obtains highest priority messages first and
 //messages with same priority are received in fifo order
-bool test_priority_order()
+bool test_priority_order(message_queue_index index, message_queue::size_type storage_size)
 {
    message_queue::remove(test::get_process_id_name());
    {
       message_queue mq1
-         (open_or_create, test::get_process_id_name(), 100, sizeof(std::size_t)),
+         (open_or_create, test::get_process_id_name(), 100, sizeof(std::size_t), index, storage_size),
          mq2
-         (open_or_create, test::get_process_id_name(), 100, sizeof(std::size_t));
+         (open_or_create, test::get_process_id_name(), 100, sizeof(std::size_t), index, storage_size);
 
       //We test that the queue is ordered by priority and in the
       //same priority, is a FIFO
@@ -266,9 +270,781 @@ bool test_buffer_overflow()
    return true;
 }
 
+//This test checks that reserved messages are taken into account to
+//detect a full queue and that committed messages are ordered by priority
+bool test_reserve_send()
+{
+   message_queue::remove(test::get_process_id_name());
+   {
+      message_queue mq
+         (create_only, test::get_process_id_name(), 3, sizeof(std::size_t));
+      message_queue::size_type recvd = 0;
+      unsigned int priority = 0;
+      std::size_t value = 0;
+
+      message_queue::send_slot s1(mq.reserve_send(sizeof(std::size_t), 1));
+      message_queue::send_slot s2(mq.try_reserve_send(sizeof(std::size_t), 2));
+      if(!s1.valid() || !s2.valid() || s1.size() != sizeof(std::size_t) || s2.priority() != 2)
+         return false;
+      value = 3;
+      mq.send(&value, sizeof(value), 0);
+      //Reserved messages are not queued but the queue is full
+      if(mq.get_num_msg() != 1 || mq.try_send(&value, sizeof(value), 0))
+         return false;
+      if(mq.try_reserve_send(1, 0).valid())
+         return false;
+      if(mq.timed_reserve_send(1, 0, boost::posix_time::microsec_clock::universal_time()).valid())
+         return false;
+
+      //Cancelling a reservation frees the message
+      s2.cancel();
+      if(s2.valid() || !mq.try_send(&value, sizeof(value), 0))
+         return false;
+
+      //Write in place and commit part of the message
+      value = 1;
+      std::memcpy(s1.data(), &value, sizeof(value));
+      s1.commit(1);
+      if(s1.valid() || mq.get_num_msg() != 3)
+         return false;
+
+      mq.receive(&value, sizeof(value), recvd, priority);
+      if(priority != 1 || recvd != 1)
+         return false;
+      mq.receive(&value, sizeof(value), recvd, priority);
+      if(priority != 0 || recvd != sizeof(value) || value != 3)
+         return false;
+      mq.send(&value, sizeof(value), 0);
+
+      //Slots not committed are cancelled on destruction and moved reservations
+      //are only cancelled once
+      {
+         message_queue::send_slot s3(mq.reserve_send(1, 0));
+         message_queue::send_slot s4(boost::move(s3));
+         message_queue::send_slot s5;
+         s5 = boost::move(s4);
+         if(s3.valid() || s4.valid() || !s5.valid() || mq.try_reserve_send(1, 0).valid())
+            return false;
+      }
+      if(!mq.try_reserve_send(1, 0).valid())
+         return false;
+   }
+   message_queue::remove(test::get_process_id_name());
+   return true;
+}
+
+//This test checks that peeked messages are out of the queue until they are
+//released and that their buffers are not reused meanwhile
+bool test_peek_receive()
+{
+   message_queue::remove(test::get_process_id_name());
+   {
+      message_queue mq
+         (create_only, test::get_process_id_name(), 3, sizeof(std::size_t));
+      std::size_t value;
+
+      if(mq.try_peek_receive().valid())
+         return false;
+      if(mq.timed_peek_receive(boost::posix_time::microsec_clock::universal_time()).valid())
+         return false;
+
+      for(value = 0; value != 3; ++value){
+         mq.send(&value, sizeof(value), (unsigned int)value);
+      }
+      message_queue::receive_view v1(mq.peek_receive());
+      if(!v1.valid() || v1.priority() != 2 || v1.size() != sizeof(value) ||
+         *static_cast<const std::size_t*>(v1.data()) != 2 || mq.get_num_msg() != 2)
+         return false;
+
+      //The peeked message buffer is still in use
+      if(mq.try_send(&value, sizeof(value), 0))
+         return false;
+      v1.release();
+      if(v1.valid() || !mq.try_send(&value, sizeof(value), 0))
+         return false;
+
+      message_queue::receive_view v2(mq.try_peek_receive());
+      message_queue::receive_view v3(mq.try_peek_receive());
+      if(v2.priority() != 1 || v3.priority() != 0)
+         return false;
+      v2 = boost::move(v3);
+      if(v3.valid() || !v2.valid() || v2.priority() != 0 || mq.get_num_msg() != 1)
+         return false;
+   }
+   message_queue::remove(test::get_process_id_name());
+   return true;
+}
+
+//Randomly mixes copying, reserved and peeked operations and checks
+//received messages against a priority queue model
+bool test_reserve_and_peek_model(message_queue_index index, message_queue::size_type storage_size)
+{
+   message_queue::remove(test::get_process_id_name());
+   {
+      const std::size_t MaxMsg = 8;
+      message_queue mq
+         (create_only, test::get_process_id_name(), MaxMsg, sizeof(std::size_t), index, storage_size);
+
+      //Queued messages in the model: (priority, sequence) in insertion order
+      std::vector<std::pair<unsigned int, std::size_t> > model;
+      std::vector<message_queue::send_slot*>    slots;
+      std::vector<message_queue::receive_view*> views;
+      std::vector<std::size_t>                  view_values;
+      std::size_t seq = 0;
+      message_queue::size_type recvd;
+      unsigned int priority;
+      std::size_t value;
+      std::srand(0);
+
+      for(std::size_t i = 0; i != 20000; ++i){
+         const std::size_t used = model.size() + slots.size() + views.size();
+         switch(std::rand() % 5){
+            case 0:  //send
+               value = seq++;
+               priority = unsigned(std::rand() % 4);
+               if(mq.try_send(&value, sizeof(value), priority) != (used < MaxMsg))
+                  return false;
+               if(used < MaxMsg)
+                  model.push_back(std::make_pair(priority, value));
+            break;
+            case 1:  //reserve
+            {
+               priority = unsigned(std::rand() % 4);
+               message_queue::send_slot *slot =
+                  new message_queue::send_slot(mq.try_reserve_send(sizeof(value), priority));
+               if(slot->valid() != (used < MaxMsg))
+                  return false;
+               if(slot->valid()){
+                  value = seq++;
+                  std::memcpy(slot->data(), &value, sizeof(value));
+                  slots.push_back(slot);
+               }
+               else{
+                  delete slot;
+               }
+            }
+            break;
+            case 2:  //commit or cancel
+               if(!slots.empty()){
+                  const std::size_t n = std::size_t(std::rand()) % slots.size();
+                  message_queue::send_slot *slot = slots[n];
+                  slots.erase(slots.begin() + n);
+                  std::memcpy(&value, slot->data(), sizeof(value));
+                  if(std::rand() % 4){
+                     model.push_back(std::make_pair(slot->priority(), value));
+                     slot->commit();
+                  }
+                  delete slot;
+               }
+            break;
+            case 3:  //receive or peek
+            {
+               //Expected message: highest priority, oldest first
+               std::size_t top = 0;
+               for(std::size_t m = 1; m < model.size(); ++m){
+                  if(model[m].first > model[top].first)
+                     top = m;
+               }
+               if(std::rand() % 2){
+                  if(mq.try_receive(&value, sizeof(value), recvd, priority) == model.empty())
+                     return false;
+                  if(!model.empty() && (value != model[top].second || priority != model[top].first))
+                     return false;
+               }
+               else{
+                  message_queue::receive_view *view = new message_queue::receive_view(mq.try_peek_receive());
+                  if(view->valid() == model.empty())
+                     return false;
+                  if(!model.empty()){
+                     if(*static_cast<const std::size_t*>(view->data()) != model[top].second ||
+                        view->priority() != model[top].first)
+                        return false;
+                     views.push_back(view);
+                     view_values.push_back(model[top].second);
+                  }
+                  else{
+                     delete view;
+                  }
+               }
+               if(!model.empty())
+                  model.erase(model.begin() + top);
+            }
+            break;
+            default: //release
+               if(!views.empty()){
+                  const std::size_t n = std::size_t(std::rand()) % views.size();
+                  //The buffer must not have been reused
+                  if(*static_cast<const std::size_t*>(views[n]->data()) != view_values[n])
+                     return false;
+                  delete views[n];
+                  views.erase(views.begin() + n);
+                  view_values.erase(view_values.begin() + n);
+               }
+            break;
+         }
+         if(mq.get_num_msg() != model.size())
+            return false;
+      }
+      for(std::size_t i = 0; i != slots.size(); ++i)
+         delete slots[i];
+      for(std::size_t i = 0; i != views.size(); ++i)
+         delete views[i];
+   }
+   message_queue::remove(test::get_process_id_name());
+   return true;
+}
+
+static const std::size_t NumZeroCopyMsg = 20000;
+
+struct zero_copy_sender
+{
+   zero_copy_sender(message_queue &mq)
+      :  m_mq(mq)
+   {}
+
+   void operator()()
+   {
+      for(std::size_t i = 0; i != NumZeroCopyMsg; ++i){
+         message_queue::send_slot slot(m_mq.reserve_send(sizeof(i), 0));
+         std::memcpy(slot.data(), &i, sizeof(i));
+         slot.commit();
+      }
+   }
+
+   message_queue &m_mq;
+};
+
+struct zero_copy_receiver
+{
+   zero_copy_receiver(message_queue &mq, std::size_t &sum)
+      :  m_mq(mq), m_sum(sum)
+   {}
+
+   void operator()()
+   {
+      for(std::size_t i = 0; i != NumZeroCopyMsg; ++i){
+         message_queue::receive_view view(m_mq.peek_receive());
+         m_sum += *static_cast<const std::size_t*>(view.data());
+      }
+   }
+
+   message_queue &m_mq;
+   std::size_t &m_sum;
+};
+
+//A sender and a receiver block on a small queue using
+//only reserved and peeked messages
+bool test_zero_copy_threads()
+{
+   message_queue::remove(test::get_process_id_name());
+   std::size_t sum = 0;
+   {
+      message_queue mq
+         (create_only, test::get_process_id_name(), 4, sizeof(std::size_t));
+      boost::thread_group threads;
+      threads.create_thread(zero_copy_receiver(mq, sum));
+      threads.create_thread(zero_copy_sender(mq));
+      threads.join_all();
+      if(mq.get_num_msg() != 0)
+         return false;
+   }
+   message_queue::remove(test::get_process_id_name());
+   return sum == NumZeroCopyMsg*(NumZeroCopyMsg - 1)/2;
+}
+
+//This test checks that the index is recorded in the queue and
+//that the bucket index rejects priorities it can't store
+bool test_bucket_index()
+{
+   message_queue::remove(test::get_process_id_name());
+   {
+      message_queue mq1
+         (create_only, test::get_process_id_name(), 16, sizeof(std::size_t), bucket_priority_index);
+      message_queue mq2
+         (open_only, test::get_process_id_name());
+      if(mq1.get_index() != bucket_priority_index || mq2.get_index() != bucket_priority_index)
+         return false;
+
+      std::size_t value = 0;
+      bool thrown = false;
+      try{
+         mq1.send(&value, sizeof(value), message_queue_bucket_priorities);
+      }
+      catch(interprocess_exception &ex){
+         thrown = ex.get_error_code() == invalid_argument;
+      }
+      if(!thrown || mq1.get_num_msg() != 0)
+         return false;
+
+      //Highest and lowest priorities in reverse order, several times
+      //to reuse free messages
+      message_queue::size_type recvd;
+      unsigned int priority;
+      for(std::size_t lap = 0; lap != 3; ++lap){
+         for(std::size_t i = 0; i != 16; ++i){
+            value = i;
+            mq1.send(&value, sizeof(value), i < 8 ? 0u : message_queue_bucket_priorities - 1);
+         }
+         for(std::size_t i = 0; i != 16; ++i){
+            mq2.receive(&value, sizeof(value), recvd, priority);
+            if(value != (i < 8 ? i + 8 : i - 8))
+               return false;
+         }
+      }
+   }
+   message_queue::remove(test::get_process_id_name());
+   {
+      message_queue mq
+         (open_or_create, test::get_process_id_name(), 16, sizeof(std::size_t));
+      if(mq.get_index() != sorted_priority_index)
+         return false;
+   }
+   message_queue::remove(test::get_process_id_name());
+   return true;
+}
+
+//This test checks that variable size storage only uses the size of
+//queued messages and that senders block when it's exhausted
+bool test_variable_storage(message_queue_index index)
+{
+   message_queue::remove(test::get_process_id_name());
+   {
+      const std::size_t MaxMsgSize = 4096;
+      const std::size_t SmallSize  = 100;
+      message_queue mq
+         (create_only, test::get_process_id_name(), 1000, MaxMsgSize, index, 16*1024);
+      if(mq.get_storage_size() < 16*1024 || mq.get_storage_size() > 17*1024)
+         return false;
+
+      //Fill the storage with small messages
+      char buf[MaxMsgSize];
+      std::size_t num_sent = 0;
+      for(;; ++num_sent){
+         std::memset(buf, int(num_sent & 0xFF), SmallSize);
+         if(!mq.try_send(buf, SmallSize, 0))
+            break;
+      }
+      //Much more messages than preallocated messages of the same
+      //storage size, and far less than the maximum number of messages
+      if(num_sent < 4*(16*1024/MaxMsgSize) || num_sent >= mq.get_max_msg())
+         return false;
+      if(mq.get_num_msg() != num_sent)
+         return false;
+      if(mq.timed_send(buf, SmallSize, 0,
+            boost::posix_time::microsec_clock::universal_time() +
+            boost::posix_time::milliseconds(10)))
+         return false;
+      if(mq.try_reserve_send(SmallSize, 0).valid())
+         return false;
+
+      //A received message frees storage for another one
+      message_queue::size_type recvd;
+      unsigned int priority;
+      mq.receive(buf, MaxMsgSize, recvd, priority);
+      if(recvd != SmallSize || buf[0] != 0 || buf[SmallSize-1] != 0)
+         return false;
+      if(!mq.try_send(buf, SmallSize, 0))
+         return false;
+
+      //Drain the queue checking messages
+      for(std::size_t i = 1; i <= num_sent; ++i){
+         if(!mq.try_receive(buf, MaxMsgSize, recvd, priority))
+            return false;
+         if(recvd != SmallSize || buf[SmallSize-1] != char(i == num_sent ? 0 : i & 0xFF))
+            return false;
+      }
+      if(mq.get_num_msg() != 0)
+         return false;
+
+      //An empty queue can always hold a message of the maximum size
+      std::memset(buf, 'x', MaxMsgSize);
+      message_queue::send_slot slot(mq.try_reserve_send(MaxMsgSize, 0));
+      if(!slot.valid())
+         return false;
+      slot.cancel();
+      if(!mq.try_send(buf, MaxMsgSize, 0))
+         return false;
+      message_queue::receive_view view(mq.try_peek_receive());
+      if(!view.valid() || view.size() != MaxMsgSize ||
+         static_cast<const char*>(view.data())[MaxMsgSize-1] != 'x')
+         return false;
+   }
+   message_queue::remove(test::get_process_id_name());
+   return true;
+}
+
+static const std::size_t NumStorageMsg = 5000;
+static const std::size_t MaxStorageMsgSize = 1024;
+
+struct storage_sender
+{
+   storage_sender(message_queue &mq)
+      :  m_mq(mq)
+   {}
+
+   void operator()()
+   {
+      char buf[MaxStorageMsgSize];
+      for(std::size_t i = 0; i != NumStorageMsg; ++i){
+         //Sizes from 1 to MaxStorageMsgSize bytes
+         const std::size_t size = 1u + (i*37u) % MaxStorageMsgSize;
+         std::memset(buf, int(i & 0xFF), size);
+         m_mq.send(buf, size, 0);
+      }
+   }
+
+   message_queue &m_mq;
+};
+
+struct storage_receiver
+{
+   storage_receiver(message_queue &mq, bool &ok)
+      :  m_mq(mq), m_ok(ok)
+   {}
+
+   void operator()()
+   {
+      char buf[MaxStorageMsgSize];
+      message_queue::size_type recvd;
+      unsigned int priority;
+      for(std::size_t i = 0; i != NumStorageMsg; ++i){
+         m_mq.receive(buf, sizeof(buf), recvd, priority);
+         if(recvd != 1u + (i*37u) % MaxStorageMsgSize ||
+            buf[0] != char(i & 0xFF) || buf[recvd-1] != char(i & 0xFF)){
+            return;
+         }
+      }
+      m_ok = true;
+   }
+
+   message_queue &m_mq;
+   bool &m_ok;
+};
+
+//A sender blocks when the variable size storage is exhausted before
+//the maximum number of messages is reached, and the receiver wakes it
+bool test_variable_storage_threads(message_queue_index index)
+{
+   message_queue::remove(test::get_process_id_name());
+   bool ok = false;
+   {
+      message_queue mq
+         (create_only, test::get_process_id_name(), 1000, MaxStorageMsgSize, index, 4*MaxStorageMsgSize);
+      boost::thread_group threads;
+      threads.create_thread(storage_receiver(mq, ok));
+      threads.create_thread(storage_sender(mq));
+      threads.join_all();
+      if(mq.get_num_msg() != 0)
+         return false;
+   }
+   message_queue::remove(test::get_process_id_name());
+   return ok;
+}
+
+//This test checks that batches are sent and received in priority order,
+//that try_ variants return partial counts and that sizes are checked
+bool test_send_receive_n()
+{
+   message_queue::remove(test::get_process_id_name());
+   {
+      message_queue mq
+         (create_only, test::get_process_id_name(), 8, sizeof(std::size_t));
+
+      std::size_t values[12];
+      message_queue::send_buffer sbufs[12];
+      for(std::size_t i = 0; i != 12; ++i){
+         values[i] = i;
+         sbufs[i].buffer   = &values[i];
+         sbufs[i].size     = sizeof(std::size_t);
+         sbufs[i].priority = (unsigned int)(i%2);
+      }
+
+      //Only 8 messages fit
+      if(mq.try_send_n(sbufs, 12) != 8 || mq.get_num_msg() != 8)
+         return false;
+      if(mq.try_send_n(sbufs, 12) != 0)
+         return false;
+      if(mq.timed_send_n(sbufs, 1, boost::posix_time::microsec_clock::universal_time()) != 0)
+         return false;
+
+      std::size_t out[12];
+      message_queue::receive_buffer rbufs[12];
+      for(std::size_t i = 0; i != 12; ++i){
+         rbufs[i].buffer      = &out[i];
+         rbufs[i].buffer_size = sizeof(std::size_t);
+         rbufs[i].recvd_size  = 0;
+         rbufs[i].priority    = 0;
+      }
+
+      //Odd values have higher priority
+      if(mq.receive_n(rbufs, 3) != 3)
+         return false;
+      if(out[0] != 1 || out[1] != 3 || out[2] != 5 || rbufs[0].priority != 1)
+         return false;
+      if(mq.try_receive_n(rbufs, 12) != 5)
+         return false;
+      const std::size_t expected[] = { 7, 0, 2, 4, 6 };
+      for(std::size_t i = 0; i != 5; ++i){
+         if(out[i] != expected[i] || rbufs[i].recvd_size != sizeof(std::size_t) ||
+            rbufs[i].priority != (unsigned int)(expected[i]%2))
+            return false;
+      }
+      if(mq.try_receive_n(rbufs, 12) != 0)
+         return false;
+      if(mq.timed_receive_n(rbufs, 12, boost::posix_time::microsec_clock::universal_time()) != 0)
+         return false;
+
+      //Oversized messages are detected before sending anything
+      bool thrown = false;
+      sbufs[1].size = sizeof(std::size_t) + 1;
+      try{
+         mq.send_n(sbufs, 2);
+      }
+      catch(interprocess_exception &ex){
+         thrown = ex.get_error_code() == size_error;
+      }
+      if(!thrown || mq.get_num_msg() != 0)
+         return false;
+
+      //Small buffers are detected before receiving anything
+      mq.send_n(sbufs, 1);
+      thrown = false;
+      rbufs[1].buffer_size = sizeof(std::size_t) - 1;
+      try{
+         mq.receive_n(rbufs, 2);
+      }
+      catch(interprocess_exception &ex){
+         thrown = ex.get_error_code() == size_error;
+      }
+      if(!thrown || mq.get_num_msg() != 1)
+         return false;
+   }
+   message_queue::remove(test::get_process_id_name());
+   return true;
+}
+
+static const std::size_t NumBatchMsg = 20000;
+static const std::size_t BatchSize   = 7;
+
+struct batch_sender
+{
+   batch_sender(message_queue &mq)
+      :  m_mq(mq)
+   {}
+
+   void operator()()
+   {
+      std::size_t values[BatchSize];
+      message_queue::send_buffer bufs[BatchSize];
+      for(std::size_t i = 0; i < NumBatchMsg; i += BatchSize){
+         const std::size_t n = (NumBatchMsg - i) < BatchSize ? (NumBatchMsg - i) : BatchSize;
+         for(std::size_t j = 0; j != n; ++j){
+            values[j] = i + j;
+            bufs[j].buffer   = &values[j];
+            bufs[j].size     = sizeof(std::size_t);
+            bufs[j].priority = 0;
+         }
+         m_mq.send_n(bufs, n);
+      }
+   }
+
+   message_queue &m_mq;
+};
+
+struct batch_receiver
+{
+   batch_receiver(message_queue &mq, bool &ok)
+      :  m_mq(mq), m_ok(ok)
+   {}
+
+   void operator()()
+   {
+      std::size_t values[BatchSize];
+      message_queue::receive_buffer bufs[BatchSize];
+      for(std::size_t j = 0; j != BatchSize; ++j){
+         bufs[j].buffer      = &values[j];
+         bufs[j].buffer_size = sizeof(std::size_t);
+      }
+      std::size_t next = 0;
+      while(next != NumBatchMsg){
+         const message_queue::size_type n = m_mq.receive_n(bufs, BatchSize);
+         for(std::size_t j = 0; j != n; ++j){
+            //Messages with the same priority are received in FIFO order
+            if(values[j] != next++){
+               m_ok = false;
+               return;
+            }
+         }
+      }
+      m_ok = true;
+   }
+
+   message_queue &m_mq;
+   bool &m_ok;
+};
+
+//A sender and a receiver block on a queue smaller than the batches
+bool test_send_receive_n_threads()
+{
+   message_queue::remove(test::get_process_id_name());
+   bool ok = false;
+   {
+      message_queue mq
+         (create_only, test::get_process_id_name(), 4, sizeof(std::size_t));
+      boost::thread_group threads;
+      threads.create_thread(batch_receiver(mq, ok));
+      threads.create_thread(batch_sender(mq));
+      threads.join_all();
+      if(mq.get_num_msg() != 0)
+         return false;
+   }
+   message_queue::remove(test::get_process_id_name());
+   return ok;
+}
+
+static const std::size_t NumBlocked = 4;
+
+struct blocked_receiver
+{
+   blocked_receiver(message_queue &mq)
+      :  m_mq(mq)
+   {}
+
+   void operator()()
+   {
+      std::size_t value;
+      message_queue::size_type recvd;
+      unsigned int priority;
+      m_mq.receive(&value, sizeof(value), recvd, priority);
+   }
+
+   message_queue &m_mq;
+};
+
+struct blocked_sender
+{
+   blocked_sender(message_queue &mq)
+      :  m_mq(mq)
+   {}
+
+   void operator()()
+   {
+      const std::size_t value = 0;
+      m_mq.send(&value, sizeof(value), 0);
+   }
+
+   message_queue &m_mq;
+};
+
+//Joins the threads or returns false if they are still blocked after a while
+bool timed_join_all(std::vector<boost::thread*> &threads)
+{
+   for(std::size_t i = 0; i != threads.size(); ++i){
+      if(!threads[i]->timed_join(boost::posix_time::seconds(10)))
+         return false;
+   }
+   return true;
+}
+
+//Messages sent or freed back to back must wake as many blocked
+//receivers or senders, although only the first one changes the
+//empty or full state of the queue
+bool test_wake_blocked()
+{
+   message_queue::remove(test::get_process_id_name());
+   {
+      message_queue mq
+         (create_only, test::get_process_id_name(), NumBlocked, sizeof(std::size_t));
+      std::vector<boost::thread*> threads;
+      for(std::size_t i = 0; i != NumBlocked; ++i){
+         threads.push_back(new boost::thread(blocked_receiver(mq)));
+      }
+      boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+      for(std::size_t i = 0; i != NumBlocked; ++i){
+         mq.send(&i, sizeof(i), 0);
+      }
+      if(!timed_join_all(threads) || mq.get_num_msg() != 0)
+         return false;
+
+      //Fill the queue and block the same number of senders
+      for(std::size_t i = 0; i != NumBlocked; ++i){
+         mq.send(&i, sizeof(i), 0);
+      }
+      std::vector<boost::thread*> senders;
+      for(std::size_t i = 0; i != NumBlocked; ++i){
+         senders.push_back(new boost::thread(blocked_sender(mq)));
+      }
+      boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+      std::size_t value;
+      message_queue::size_type recvd;
+      unsigned int priority;
+      for(std::size_t i = 0; i != NumBlocked; ++i){
+         mq.receive(&value, sizeof(value), recvd, priority);
+      }
+      if(!timed_join_all(senders) || mq.get_num_msg() != NumBlocked)
+         return false;
+      for(std::size_t i = 0; i != NumBlocked; ++i){
+         delete threads[i];
+         delete senders[i];
+      }
+   }
+   message_queue::remove(test::get_process_id_name());
+   return true;
+}
+
+//Returns true if opening the queue fails with corrupted_error
+//when its shared memory is marked with "init_word"
+bool open_fails_with_init_word(boost::uint32_t init_word)
+{
+   shared_memory_object shm(open_only, test::get_process_id_name(), read_write);
+   mapped_region region(shm, read_write);
+   boost::uint32_t *const pword = static_cast<boost::uint32_t*>(region.get_address());
+   const boost::uint32_t old_word = *pword;
+   *pword = init_word;
+   bool thrown = false;
+   try{
+      message_queue mq(open_only, test::get_process_id_name());
+   }
+   catch(interprocess_exception &e){
+      thrown = e.get_error_code() == corrupted_error;
+   }
+   *pword = old_word;
+   return thrown;
+}
+
+//This test checks that queues created by a library with another header
+//layout, that record another layout version, can't be opened
+bool test_layout_version()
+{
+   message_queue::remove(test::get_process_id_name());
+   bool ok;
+   {
+      message_queue mq(create_only, test::get_process_id_name(), 10, 10);
+      //Queues created before layout versions were recorded
+      //and queues created with a newer layout
+      ok = open_fails_with_init_word(2) && open_fails_with_init_word(2 | (0xFFu << 8));
+      message_queue same(open_only, test::get_process_id_name());
+      ok = ok && same.get_max_msg() == 10 && same.get_max_msg_size() == 10;
+   }
+   message_queue::remove(test::get_process_id_name());
+   return ok;
+}
+
 int main ()
 {
-   if(!test_priority_order()){
+   if(!test_priority_order(sorted_priority_index, 0)){
+      return 1;
+   }
+
+   if(!test_priority_order(bucket_priority_index, 0)){
+      return 1;
+   }
+
+   if(!test_priority_order(sorted_priority_index, 64*1024)){
+      return 1;
+   }
+
+   if(!test_priority_order(bucket_priority_index, 64*1024)){
       return 1;
    }
 
@@ -280,6 +1056,70 @@ int main ()
       return 1;
    }
 
+   if(!test_reserve_send()){
+      return 1;
+   }
+
+   if(!test_peek_receive()){
+      return 1;
+   }
+
+   if(!test_reserve_and_peek_model(sorted_priority_index, 0)){
+      return 1;
+   }
+
+   if(!test_reserve_and_peek_model(bucket_priority_index, 0)){
+      return 1;
+   }
+
+   if(!test_reserve_and_peek_model(sorted_priority_index, 64*1024)){
+      return 1;
+   }
+
+   if(!test_reserve_and_peek_model(bucket_priority_index, 64*1024)){
+      return 1;
+   }
+
+   if(!test_variable_storage(sorted_priority_index)){
+      return 1;
+   }
+
+   if(!test_variable_storage(bucket_priority_index)){
+      return 1;
+   }
+
+   if(!test_variable_storage_threads(sorted_priority_index)){
+      return 1;
+   }
+
+   if(!test_variable_storage_threads(bucket_priority_index)){
+      return 1;
+   }
+
+   if(!test_bucket_index()){
+      return 1;
+   }
+
+   if(!test_zero_copy_threads()){
+      return 1;
+   }
+
+   if(!test_send_receive_n()){
+      return 1;
+   }
+
+   if(!test_send_receive_n_threads()){
+      return 1;
+   }
+
+   if(!test_wake_blocked()){
+      return 1;
+   }
+
+   if(!test_layout_version()){
+      return 1;
+   }
+
    return 0;
 }
 
@@ -16,6 +16,8 @@
 #if defined(BOOST_INTERPROCESS_WINDOWS)
 #include <boost/interprocess/sync/windows/mutex.hpp>
 #include <boost/interprocess/sync/spin/mutex.hpp>
+#elif defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+#include <boost/interprocess/sync/spin/mutex.hpp>
 #endif
 
 int main ()
@@ -27,6 +29,9 @@ int main ()
       test::test_all_mutex<ipcdetail::windows_mutex>();
       test::test_all_lock<ipcdetail::spin_mutex>();
       test::test_all_mutex<ipcdetail::spin_mutex>();
+   #elif defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+      test::test_all_lock<ipcdetail::spin_mutex>();
+      test::test_all_mutex<ipcdetail::spin_mutex>();
    #endif
 
    test::test_all_lock<interprocess_mutex>();
@@ -27,6 +27,8 @@ typedef node_allocator
    <int, managed_shared_memory::segment_manager> shmem_node_allocator_t;
 typedef ipcdetail::node_allocator_v1
    <int, managed_shared_memory::segment_manager> shmem_node_allocator_v1_t;
+typedef node_allocator
+   <int, managed_shared_memory::segment_manager, 64, lock_free_pool_policy> shmem_lock_free_node_allocator_t;
 
 namespace boost {
 namespace interprocess {
@@ -34,6 +36,8 @@ namespace interprocess {
 //Explicit instantiations to catch compilation errors
 template class node_allocator<int, managed_shared_memory::segment_manager>;
 template class node_allocator<void, managed_shared_memory::segment_manager>;
+template class node_allocator<int, managed_shared_memory::segment_manager, 64, lock_free_pool_policy>;
+template class node_allocator<void, managed_shared_memory::segment_manager, 64, lock_free_pool_policy>;
 
 namespace ipcdetail {
 
@@ -45,10 +49,12 @@ template class ipcdetail::node_allocator_v1<void, managed_shared_memory::segment
 //Alias list types
 typedef list<int, shmem_node_allocator_t>    MyShmList;
 typedef list<int, shmem_node_allocator_v1_t> MyShmListV1;
+typedef list<int, shmem_lock_free_node_allocator_t> MyShmLockFreeList;
 
 //Alias vector types
 typedef vector<int, shmem_node_allocator_t>     MyShmVector;
 typedef vector<int, shmem_node_allocator_v1_t>  MyShmVectorV1;
+typedef vector<int, shmem_lock_free_node_allocator_t> MyShmLockFreeVector;
 
 int main ()
 {
@@ -56,10 +62,14 @@ int main ()
       return 1;
    if(test::list_test<managed_shared_memory, MyShmListV1, true>())
       return 1;
+   if(test::list_test<managed_shared_memory, MyShmLockFreeList, true>())
+      return 1;
    if(test::vector_test<managed_shared_memory, MyShmVector>())
       return 1;
    if(test::vector_test<managed_shared_memory, MyShmVectorV1>())
       return 1;
+   if(test::vector_test<managed_shared_memory, MyShmLockFreeVector>())
+      return 1;
    return 0;
 }
 
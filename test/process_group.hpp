@@ -0,0 +1,91 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOST_INTERPROCESS_TEST_PROCESS_GROUP_HPP
+#define BOOST_INTERPROCESS_TEST_PROCESS_GROUP_HPP
+
+#include <boost/config.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/cstdint.hpp>
+#include <string>    //std::string
+#include <list>      //std::list
+#include <cstdlib>   //std::system
+
+namespace boost{
+namespace interprocess{
+namespace test{
+
+//Runs commands, usually the test itself in child mode, each one from its
+//own thread so that the calling process can work while they run
+class process_group
+{
+   struct launcher
+   {
+      launcher(const std::string &cmd, int &result, volatile boost::uint32_t &finished)
+         :  m_cmd(cmd), m_result(result), m_finished(finished)
+      {}
+
+      void operator()()
+      {
+         m_result = std::system(m_cmd.c_str());
+         ipcdetail::atomic_inc32(&m_finished);
+      }
+
+      std::string                m_cmd;
+      int                        &m_result;
+      volatile boost::uint32_t   &m_finished;
+   };
+
+   process_group(const process_group &);
+   process_group &operator=(const process_group &);
+
+   public:
+   process_group()
+      :  m_finished(0)
+   {}
+
+   ~process_group()
+   {  m_threads.join_all();  }
+
+   //Starts running "cmd"
+   void launch(const std::string &cmd)
+   {
+      m_results.push_back(-1);
+      m_threads.create_thread(launcher(cmd, m_results.back(), m_finished));
+   }
+
+   //Returns the number of commands that have finished
+   boost::uint32_t num_finished()
+   {  return ipcdetail::atomic_read32(&m_finished);  }
+
+   //Waits until all commands finish and returns
+   //true if all of them returned 0
+   bool join_all()
+   {
+      m_threads.join_all();
+      for(std::list<int>::const_iterator it = m_results.begin(); it != m_results.end(); ++it){
+         if(*it != 0)
+            return false;
+      }
+      return true;
+   }
+
+   private:
+   boost::thread_group        m_threads;
+   std::list<int>             m_results;
+   volatile boost::uint32_t   m_finished;
+};
+
+}  //namespace test{
+}  //namespace interprocess{
+}  //namespace boost{
+
+#endif //#ifndef BOOST_INTERPROCESS_TEST_PROCESS_GROUP_HPP
@@ -0,0 +1,150 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BOOST_INTERPROCESS_TEST_RANDOM_ALLOCATION_TEST_TEMPLATE_HEADER
+#define BOOST_INTERPROCESS_TEST_RANDOM_ALLOCATION_TEST_TEMPLATE_HEADER
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/detail/utilities.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <cstddef>
+#include <cstring>   //std::memset
+
+namespace boost { namespace interprocess { namespace test {
+
+static const std::size_t RandomAllocationOps     = 20000;
+static const std::size_t RandomAllocationBuffers = 64;
+static const std::size_t RandomAllocationThreads = 64;
+
+//Handles used by random_allocation_thread offer allocate(size) and
+//deallocate(ptr). This one uses a memory algorithm or segment manager
+template<class Algo>
+struct memory_algorithm_handle
+{
+   explicit memory_algorithm_handle(Algo &algo)
+      :  mp_algo(&algo)
+   {}
+
+   void *allocate(std::size_t size)
+   {  return mp_algo->allocate(size);  }
+
+   void deallocate(void *ptr)
+   {  mp_algo->deallocate(ptr);  }
+
+   Algo *mp_algo;
+};
+
+//Allocates nodes of a node allocator. Each thread uses
+//its own copy, as cached allocators can't be shared
+template<class Allocator>
+struct node_allocator_handle
+{
+   explicit node_allocator_handle(const Allocator &alloc)
+      :  m_alloc(alloc)
+   {}
+
+   void *allocate(std::size_t)
+   {  return ipcdetail::to_raw_pointer(m_alloc.allocate_one());  }
+
+   void deallocate(void *ptr)
+   {  m_alloc.deallocate_one(static_cast<typename Allocator::value_type*>(ptr));  }
+
+   Allocator m_alloc;
+};
+
+//Randomly allocates and deallocates buffers of [min_size, max_size] bytes,
+//filling them with their index and checking it before deallocating them
+template<class Handle>
+struct random_allocation_thread
+{
+   random_allocation_thread(const Handle &handle, std::size_t index
+                           ,std::size_t min_size, std::size_t max_size, bool &ok)
+      :  m_handle(handle), m_index(index)
+      ,  m_min_size(min_size), m_max_size(max_size), m_ok(ok)
+   {}
+
+   void operator()()
+   {
+      //The copy is made in the thread, so handles can keep per-thread state
+      Handle handle(m_handle);
+      void *buffers[RandomAllocationBuffers] = {};
+      std::size_t sizes[RandomAllocationBuffers] = {};
+      unsigned int seed = (unsigned int)m_index + 1u;
+      for(std::size_t i = 0; i != RandomAllocationOps; ++i){
+         seed = seed*1103515245u + 12345u;
+         const std::size_t pos = (seed >> 8) % RandomAllocationBuffers;
+         if(buffers[pos]){
+            const unsigned char *p = static_cast<unsigned char*>(buffers[pos]);
+            for(std::size_t j = 0; j != sizes[pos]; ++j){
+               if(p[j] != (unsigned char)pos){
+                  m_ok = false;
+               }
+            }
+            handle.deallocate(buffers[pos]);
+            buffers[pos] = 0;
+         }
+         else{
+            sizes[pos] = m_min_size + (seed >> 16) % (m_max_size - m_min_size + 1);
+            buffers[pos] = handle.allocate(sizes[pos]);
+            if(!buffers[pos]){
+               m_ok = false;
+               break;
+            }
+            std::memset(buffers[pos], (int)pos, sizes[pos]);
+         }
+      }
+      for(std::size_t i = 0; i != RandomAllocationBuffers; ++i){
+         if(buffers[i])
+            handle.deallocate(buffers[i]);
+      }
+   }
+
+   Handle m_handle;
+   std::size_t m_index;
+   std::size_t m_min_size;
+   std::size_t m_max_size;
+   bool &m_ok;
+};
+
+//Runs num_threads random_allocation_threads on copies of handle. Returns the
+//time in microseconds they take, or -1 if an allocation failed or a buffer
+//was corrupted
+template<class Handle>
+long run_random_allocation_threads
+   (const Handle &handle, std::size_t num_threads, std::size_t min_size, std::size_t max_size)
+{
+   if(num_threads > RandomAllocationThreads || min_size > max_size)
+      return -1;
+   bool ok[RandomAllocationThreads];
+   const boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+   {
+      boost::thread_group threads;
+      for(std::size_t i = 0; i != num_threads; ++i){
+         ok[i] = true;
+         threads.create_thread
+            (random_allocation_thread<Handle>(handle, i, min_size, max_size, ok[i]));
+      }
+      threads.join_all();
+   }
+   const boost::posix_time::time_duration elapsed =
+      boost::posix_time::microsec_clock::universal_time() - start;
+   for(std::size_t i = 0; i != num_threads; ++i){
+      if(!ok[i])
+         return -1;
+   }
+   return (long)elapsed.total_microseconds();
+}
+
+}}}   //namespace boost { namespace interprocess { namespace test {
+
+#include <boost/interprocess/detail/config_end.hpp>
+
+#endif   //BOOST_INTERPROCESS_TEST_RANDOM_ALLOCATION_TEST_TEMPLATE_HEADER
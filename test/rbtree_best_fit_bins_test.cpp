@@ -0,0 +1,134 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/mem_algo/rbtree_best_fit.hpp>
+#include <boost/interprocess/sync/mutex_family.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstring>
+#include <new>
+#include "random_allocation_test_template.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  This example tests size-class bins of rbtree_best_fit and compares the   //
+//  time small allocations take from several threads.                        //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace boost::interprocess;
+
+typedef rbtree_best_fit<mutex_family>  algo_t;
+typedef algo_t::size_type              size_type;
+
+static const size_type MemSize = 1024*1024;
+
+//Checks that memory is correctly counted and that all blocks can be merged
+//again, which requires bins to be emptied if allocations don't fit
+bool test_bins(algo_t &algo)
+{
+   const size_type free_memory = algo.get_free_memory();
+   algo.set_bin_capacity(16);
+   if(algo.get_bin_capacity() != 16)
+      return false;
+
+   std::vector<void*> buffers;
+   for(size_type i = 0; i <= algo_t::get_max_bin_size(); ++i){
+      void *ptr = algo.allocate(i);
+      if(!ptr || algo.size(ptr) < i)
+         return false;
+      std::memset(ptr, 1, algo.size(ptr));
+      buffers.push_back(ptr);
+   }
+   for(size_type i = 0; i != buffers.size(); ++i){
+      algo.deallocate(buffers[i]);
+   }
+   buffers.clear();
+   //Cached blocks are free memory
+   if(free_memory != algo.get_free_memory() || !algo.check_sanity())
+      return false;
+
+   //Exhaust memory with small blocks and check that bins are
+   //emptied to serve a big allocation after deallocating them
+   for(void *ptr; (ptr = algo.allocate(24)) != 0; ){
+      buffers.push_back(ptr);
+   }
+   for(size_type i = 0; i != buffers.size(); ++i){
+      algo.deallocate(buffers[i]);
+   }
+   buffers.clear();
+   void *big = algo.allocate(MemSize/2);
+   if(!big)
+      return false;
+   algo.deallocate(big);
+
+   algo.set_bin_capacity(0);
+   return free_memory == algo.get_free_memory() &&
+          algo.all_memory_deallocated() && algo.check_sanity();
+}
+
+//The bins make the header of the algorithm bigger, so it's no longer a
+//multiple of Alignment. The first block is placed after the header and the
+//extra bytes rounded together, so shrink_to_fit() must reach exactly the
+//minimum size for any number of extra header bytes
+bool test_min_size(void *addr)
+{
+   for(size_type extra_hdr_bytes = 0; extra_hdr_bytes != 2*algo_t::Alignment; ++extra_hdr_bytes){
+      algo_t *algo = new(addr) algo_t(MemSize, extra_hdr_bytes);
+      algo->shrink_to_fit();
+      const bool ok = algo->get_size() == algo_t::get_min_size(extra_hdr_bytes) && algo->check_sanity();
+      algo->~algo_t();
+      if(!ok)
+         return false;
+   }
+   return true;
+}
+
+//Returns the time in microseconds threads take, or -1 on error
+long run_threads(algo_t &algo, size_type num_threads, size_type bin_capacity)
+{
+   algo.set_bin_capacity(bin_capacity);
+   const long elapsed_us = test::run_random_allocation_threads
+      (test::memory_algorithm_handle<algo_t>(algo), num_threads, 0, 127);
+   algo.set_bin_capacity(0);
+   if(!algo.all_memory_deallocated() || !algo.check_sanity())
+      return -1;
+   return elapsed_us;
+}
+
+int main ()
+{
+   std::vector<char> buffer(MemSize + algo_t::Alignment);
+   //The memory algorithm must be aligned
+   void *addr = &buffer[0] + (algo_t::Alignment - (std::size_t)&buffer[0] % algo_t::Alignment);
+   if(!test_min_size(addr))
+      return 1;
+   algo_t *algo = new(addr) algo_t(MemSize, 0);
+
+   if(!test_bins(*algo))
+      return 1;
+
+   const size_type num_threads[] = { 1, 4, 16 };
+   for(size_type i = 0; i != sizeof(num_threads)/sizeof(num_threads[0]); ++i){
+      const long tree_us  = run_threads(*algo, num_threads[i], 0);
+      const long bins_us  = run_threads(*algo, num_threads[i], 64);
+      if(tree_us < 0 || bins_us < 0)
+         return 1;
+      std::cout << "threads: " << std::setw(2) << num_threads[i]
+                << " tree: "  << std::setw(8) << tree_us  << "us"
+                << " bins: "  << std::setw(8) << bins_us  << "us" << std::endl;
+   }
+   algo->~algo_t();
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
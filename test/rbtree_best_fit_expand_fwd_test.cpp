@@ -0,0 +1,134 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstring>
+#include "get_process_id_name.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  This example tests that rbtree_best_fit expands the last allocation of a  //
+//  fragmented segment forward in place and measures the amortized cost of   //
+//  appending to it in small and big steps.                                   //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace boost::interprocess;
+
+typedef managed_shared_memory::segment_manager  segment_manager_t;
+typedef segment_manager_t::size_type            size_type;
+
+//Small enough for the usual 64MB limit of /dev/shm in containers
+static const size_type MemSize   = size_type(32u)*1024u*1024u;
+static const size_type NumHoles  = 10000;
+static const size_type NumAppends= 1000000;
+//Bigger than the holes, so that the buffer is placed after them
+static const size_type FirstSize = 2048;
+//Bytes appended to the buffer in each run
+static const size_type MaxAppendBytes = 4*1024*1024;
+
+//Touches the pages of the buffer that will be expanded, so that the
+//benchmark doesn't measure the page faults of the shared memory
+bool prefault(managed_shared_memory &segment)
+{
+   void *ptr = segment.allocate(FirstSize + 2*MaxAppendBytes, std::nothrow);
+   if(!ptr)
+      return false;
+   std::memset(ptr, 0, FirstSize + 2*MaxAppendBytes);
+   segment.deallocate(ptr);
+   return true;
+}
+
+//Leaves free blocks of different sizes between allocated blocks,
+//so that the tree of free blocks is big
+bool fragment(managed_shared_memory &segment, std::vector<void*> &buffers)
+{
+   for(size_type i = 0; i != 2*NumHoles; ++i){
+      void *ptr = segment.allocate(16 + (i*7919) % 1024, std::nothrow);
+      if(!ptr)
+         return false;
+      buffers.push_back(ptr);
+   }
+   for(size_type i = 0; i < buffers.size(); i += 2){
+      segment.deallocate(buffers[i]);
+      buffers[i] = 0;
+   }
+   return true;
+}
+
+//Appends "step" bytes to a buffer "num_appends" times, checking that it's expanded in place
+//and that previous contents are kept. Returns the time in nanoseconds per append or -1 on error
+double run_appends(managed_shared_memory &segment, size_type step, size_type num_appends)
+{
+   typedef boost::posix_time::microsec_clock clock_t;
+   segment_manager_t *mngr = segment.get_segment_manager();
+   const size_type free_memory = segment.get_free_memory();
+
+   char *const buf = static_cast<char*>(segment.allocate(FirstSize));
+   size_type size = FirstSize;
+   std::memset(buf, 1, size);
+   bool ok = true;
+   const boost::posix_time::ptime start = clock_t::universal_time();
+   for(size_type i = 0; i != num_appends; ++i){
+      size_type received = 0;
+      char *const ret = mngr->allocation_command<char>
+         (expand_fwd | nothrow_allocation, size + step, size + step, received, buf).first;
+      ok = ok && ret == buf && received >= size + step;
+      size = received;
+   }
+   const long elapsed_us = (long)(clock_t::universal_time() - start).total_microseconds();
+
+   ok = ok && buf[0] == 1 && buf[FirstSize - 1] == 1;
+   segment.deallocate(buf);
+   ok = ok && free_memory == segment.get_free_memory() && segment.check_sanity();
+   return ok ? double(elapsed_us)*1000.0/double(num_appends) : -1.0;
+}
+
+int main ()
+{
+   const char *const shMemName = test::get_process_id_name();
+   shared_memory_object::remove(shMemName);
+   int ret = 0;
+   {
+      managed_shared_memory segment(create_only, shMemName, MemSize);
+      std::vector<void*> buffers;
+      const size_type steps[] = { 8, 64, 512 };
+      for(size_type fragmented = 0; fragmented != 2 && !ret; ++fragmented){
+         if((fragmented && !fragment(segment, buffers)) || !prefault(segment)){
+            ret = 1;
+            break;
+         }
+         for(size_type i = 0; i != sizeof(steps)/sizeof(steps[0]); ++i){
+            const size_type num_appends = MaxAppendBytes/steps[i] < NumAppends
+               ? MaxAppendBytes/steps[i] : NumAppends;
+            const double ns = run_appends(segment, steps[i], num_appends);
+            if(ns < 0){
+               ret = 1;
+               break;
+            }
+            std::cout << "free blocks: " << std::setw(6) << (fragmented ? NumHoles : 0)
+                      << " append step: " << std::setw(4) << steps[i]
+                      << " amortized: " << std::setw(8) << ns << "ns" << std::endl;
+         }
+      }
+      for(size_type i = 0; i != buffers.size(); ++i){
+         segment.deallocate(buffers[i]);
+      }
+   }
+   shared_memory_object::remove(shMemName);
+   return ret;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
@@ -0,0 +1,261 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/ipc/ring_message_queue.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+#include "get_process_id_name.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  This example tests the process shared lock-free ring message queue.      //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace boost::interprocess;
+
+//This test checks that messages are received in FIFO order with
+//their priority and size, and the full and empty conditions
+bool test_fifo_order(ring_queue_mode mode)
+{
+   ring_message_queue::remove(test::get_process_id_name());
+   {
+      ring_message_queue mq1
+         (create_only, test::get_process_id_name(), 100, sizeof(std::size_t), mode);
+      ring_message_queue mq2
+         (open_only, test::get_process_id_name());
+
+      //The number of slots is rounded to a power of two
+      if(mq1.get_max_msg() != 128 || mq2.get_max_msg() != 128)
+         return false;
+      if(mq2.get_max_msg_size() != sizeof(std::size_t) || mq2.get_mode() != mode)
+         return false;
+
+      ring_message_queue::size_type recvd = 0;
+      unsigned int priority = 0;
+      std::size_t tstamp;
+
+      //Several laps so that positions wrap around the ring
+      for(std::size_t lap = 0; lap != 3; ++lap){
+         for(std::size_t i = 0; i != 128; ++i){
+            tstamp = lap*128 + i;
+            if(!mq1.try_send(&tstamp, sizeof(tstamp), (unsigned int)(i%10)))
+               return false;
+         }
+         if(mq2.get_num_msg() != 128)
+            return false;
+         //Full queue
+         if(mq1.try_send(&tstamp, sizeof(tstamp), 0))
+            return false;
+         if(mq1.timed_send(&tstamp, sizeof(tstamp), 0,
+               boost::posix_time::microsec_clock::universal_time() +
+               boost::posix_time::milliseconds(10)))
+            return false;
+
+         for(std::size_t i = 0; i != 128; ++i){
+            if(!mq2.try_receive(&tstamp, sizeof(tstamp), recvd, priority))
+               return false;
+            if(tstamp != lap*128 + i || recvd != sizeof(tstamp) || priority != i%10)
+               return false;
+         }
+         //Empty queue
+         if(mq2.try_receive(&tstamp, sizeof(tstamp), recvd, priority))
+            return false;
+         if(mq2.timed_receive(&tstamp, sizeof(tstamp), recvd, priority,
+               boost::posix_time::microsec_clock::universal_time() +
+               boost::posix_time::milliseconds(10)))
+            return false;
+         if(mq1.get_num_msg() != 0)
+            return false;
+      }
+
+      //Messages shorter than the maximum size
+      char c = 'a';
+      mq1.send(&c, 1, 3);
+      mq2.receive(&tstamp, sizeof(tstamp), recvd, priority);
+      if(recvd != 1 || priority != 3 || *reinterpret_cast<char*>(&tstamp) != 'a')
+         return false;
+   }
+   ring_message_queue::remove(test::get_process_id_name());
+   return true;
+}
+
+//Sequence differences are compared as 32 bit signed integers,
+//so the number of slots must not reach 2^31
+bool test_max_slots()
+{
+   typedef ipcdetail::ring_mq_hdr_t<offset_ptr<void> > hdr_t;
+   typedef ring_message_queue::size_type size_type;
+   return hdr_t::get_num_slots(1000) == 1024 &&
+          hdr_t::get_num_slots(size_type(1u) << 30) == (size_type(1u) << 30) &&
+          hdr_t::get_num_slots(size_type(-1)) == (size_type(1u) << 30);
+}
+
+//This test checks that oversized messages and too small
+//receive buffers are detected
+bool test_size_errors()
+{
+   ring_message_queue::remove(test::get_process_id_name());
+   {
+      ring_message_queue mq
+         (open_or_create, test::get_process_id_name(), 4, 8);
+      char buf[16] = {};
+      ring_message_queue::size_type recvd = 0;
+      unsigned int priority = 0;
+      bool thrown = false;
+      try{
+         mq.send(buf, 9, 0);
+      }
+      catch(interprocess_exception &ex){
+         thrown = ex.get_error_code() == size_error;
+      }
+      if(!thrown)
+         return false;
+      mq.send(buf, 8, 0);
+      thrown = false;
+      try{
+         mq.receive(buf, 7, recvd, priority);
+      }
+      catch(interprocess_exception &ex){
+         thrown = ex.get_error_code() == size_error;
+      }
+      if(!thrown || mq.get_num_msg() != 1)
+         return false;
+   }
+   ring_message_queue::remove(test::get_process_id_name());
+   return true;
+}
+
+static const std::size_t NumThreadMsg = 20000;
+
+struct sender_thread
+{
+   sender_thread(ring_message_queue &mq, std::size_t id)
+      :  m_mq(mq), m_id(id)
+   {}
+
+   void operator()()
+   {
+      for(std::size_t i = 0; i != NumThreadMsg; ++i){
+         std::size_t msg[2] = { m_id, i };
+         m_mq.send(msg, sizeof(msg), 0);
+      }
+   }
+
+   ring_message_queue &m_mq;
+   std::size_t m_id;
+};
+
+struct receiver_thread
+{
+   receiver_thread(ring_message_queue &mq, std::size_t num_msg, std::vector<std::size_t> &next)
+      :  m_mq(mq), m_num_msg(num_msg), m_next(next), m_ok(true)
+   {}
+
+   void operator()()
+   {
+      ring_message_queue::size_type recvd;
+      unsigned int priority;
+      std::vector<std::size_t> last(m_next.size(), std::size_t(-1));
+      for(std::size_t i = 0; i != m_num_msg; ++i){
+         std::size_t msg[2];
+         m_mq.receive(msg, sizeof(msg), recvd, priority);
+         //Messages of each sender must be received in order
+         if(msg[0] >= last.size() || (last[msg[0]] != std::size_t(-1) && msg[1] <= last[msg[0]])){
+            m_ok = false;
+            return;
+         }
+         last[msg[0]] = msg[1];
+         m_next[msg[0]] += 1;
+      }
+   }
+
+   ring_message_queue &m_mq;
+   std::size_t m_num_msg;
+   std::vector<std::size_t> &m_next;
+   bool m_ok;
+};
+
+//Senders and receivers block on a small queue, all messages
+//must be received once and in the order they were sent
+bool test_threads(ring_queue_mode mode, std::size_t num_senders, std::size_t num_receivers)
+{
+   ring_message_queue::remove(test::get_process_id_name());
+   bool ok = true;
+   {
+      ring_message_queue mq
+         (create_only, test::get_process_id_name(), 8, 2*sizeof(std::size_t), mode);
+
+      std::vector<std::vector<std::size_t> > counts
+         (num_receivers, std::vector<std::size_t>(num_senders, 0));
+      std::vector<receiver_thread> receivers;
+      for(std::size_t i = 0; i != num_receivers; ++i){
+         receivers.push_back(receiver_thread(mq, NumThreadMsg*num_senders/num_receivers, counts[i]));
+      }
+
+      boost::thread_group threads;
+      for(std::size_t i = 0; i != num_receivers; ++i){
+         threads.create_thread(boost::ref(receivers[i]));
+      }
+      for(std::size_t i = 0; i != num_senders; ++i){
+         threads.create_thread(sender_thread(mq, i));
+      }
+      threads.join_all();
+
+      for(std::size_t s = 0; s != num_senders; ++s){
+         std::size_t total = 0;
+         for(std::size_t r = 0; r != num_receivers; ++r){
+            total += counts[r][s];
+         }
+         ok = ok && total == NumThreadMsg;
+      }
+      for(std::size_t r = 0; r != num_receivers; ++r){
+         ok = ok && receivers[r].m_ok;
+      }
+      ok = ok && mq.get_num_msg() == 0;
+   }
+   ring_message_queue::remove(test::get_process_id_name());
+   return ok;
+}
+
+int main ()
+{
+   if(!test_fifo_order(spsc_ring_queue))
+      return 1;
+
+   if(!test_fifo_order(mpmc_ring_queue))
+      return 1;
+
+   if(!test_size_errors())
+      return 1;
+
+   if(!test_max_slots())
+      return 1;
+
+   if(!test_threads(spsc_ring_queue, 1, 1))
+      return 1;
+
+   if(!test_threads(mpmc_ring_queue, 1, 1))
+      return 1;
+
+   if(!test_threads(mpmc_ring_queue, 4, 4))
+      return 1;
+
+   if(!test_threads(mpmc_ring_queue, 4, 1))
+      return 1;
+
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
@@ -0,0 +1,203 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+//Throughput benchmark: a process sends small messages to another process
+//through message_queue and through ring_message_queue in both modes.
+//On Linux the sender and the receiver are pinned to different CPUs.
+//Prints the number of messages per second and the speedup of each
+//ring_message_queue mode against message_queue, measured in the same run.
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/ipc/message_queue.hpp>
+#include <boost/interprocess/ipc/ring_message_queue.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib> //std::atoi
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#include "get_process_id_name.hpp"
+#include "process_group.hpp"
+
+using namespace boost::interprocess;
+
+static const std::size_t NumMsg  = 1000000;
+static const std::size_t MaxMsg  = 1024;
+static const std::size_t MsgSize = 16;
+
+//Returns the two first CPUs the process can run on, or false
+//if they can't be found or CPU affinity is not supported
+bool get_benchmark_cpus(int &sender_cpu, int &receiver_cpu)
+{
+   #if defined(__linux__)
+   cpu_set_t set;
+   CPU_ZERO(&set);
+   if(::sched_getaffinity(0, sizeof(set), &set) != 0)
+      return false;
+   sender_cpu = receiver_cpu = -1;
+   for(int cpu = 0; cpu != CPU_SETSIZE && receiver_cpu < 0; ++cpu){
+      if(CPU_ISSET(cpu, &set)){
+         (sender_cpu < 0 ? sender_cpu : receiver_cpu) = cpu;
+      }
+   }
+   return receiver_cpu >= 0;
+   #else
+   (void)sender_cpu;
+   (void)receiver_cpu;
+   return false;
+   #endif
+}
+
+//Pins the calling thread to "cpu". A negative cpu leaves it unpinned
+bool pin_to_cpu(int cpu)
+{
+   if(cpu < 0)
+      return true;
+   #if defined(__linux__)
+   cpu_set_t set;
+   CPU_ZERO(&set);
+   CPU_SET(cpu, &set);
+   return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+   #else
+   return false;
+   #endif
+}
+
+//Receives the start message and NumMsg numbered messages
+template<class MessageQueue>
+int child_main(const char *name, int cpu)
+{
+   if(!pin_to_cpu(cpu)){
+      return 1;
+   }
+   MessageQueue mq(open_only, name);
+   typename MessageQueue::size_type recvd;
+   unsigned int priority;
+   std::size_t msg[MsgSize/sizeof(std::size_t)];
+   mq.receive(msg, sizeof(msg), recvd, priority);
+   for(std::size_t i = 0; i != NumMsg; ++i){
+      mq.receive(msg, sizeof(msg), recvd, priority);
+      if(msg[0] != i){
+         return 1;
+      }
+   }
+   return 0;
+}
+
+//Returns the messages per second or a negative value on error
+template<class MessageQueue>
+double run_queue(const char *argv0, const char *queue_name, unsigned queue_index, int receiver_cpu, MessageQueue *)
+{
+   const char *const name = test::get_process_id_name();
+   MessageQueue::remove(name);
+   bool ok;
+   boost::posix_time::time_duration elapsed;
+   {
+      MessageQueue mq(create_only, name, MaxMsg, MsgSize);
+      std::stringstream cmd;
+      cmd << argv0 << " child " << name << " " << queue_index << " " << receiver_cpu;
+      test::process_group receiver;
+      receiver.launch(cmd.str());
+
+      //Wait until the receiver is running
+      std::size_t msg[MsgSize/sizeof(std::size_t)] = {};
+      mq.send(msg, sizeof(msg), 0);
+      while(mq.get_num_msg() != 0){
+         ipcdetail::thread_yield();
+      }
+
+      const boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+      for(std::size_t i = 0; i != NumMsg; ++i){
+         msg[0] = i;
+         mq.send(msg, sizeof(msg), 0);
+      }
+      ok = receiver.join_all();
+      elapsed = boost::posix_time::microsec_clock::universal_time() - start;
+   }
+   MessageQueue::remove(name);
+   if(!ok){
+      return -1.0;
+   }
+
+   const double secs = double(elapsed.total_microseconds())/1000000.0;
+   const double rate = secs > 0 ? double(NumMsg)/secs : 0.0;
+   std::cout << std::setw(36) << queue_name
+             << " msgs/s: " << std::setw(12) << std::fixed << std::setprecision(0)
+             << rate << std::endl;
+   return rate;
+}
+
+void print_speedup(const char *queue_name, double rate, double baseline)
+{
+   std::cout << std::setw(36) << queue_name
+             << " vs message_queue: " << std::fixed << std::setprecision(2)
+             << (baseline > 0 ? rate/baseline : 0.0) << "x" << std::endl;
+}
+
+//Adapts ring_message_queue constructors to create single producer/consumer queues
+class spsc_ring_message_queue
+   : public ring_message_queue
+{
+   public:
+   spsc_ring_message_queue(create_only_t, const char *name, size_type max_num_msg, size_type max_msg_size)
+      :  ring_message_queue(create_only, name, max_num_msg, max_msg_size, spsc_ring_queue)
+   {}
+
+   spsc_ring_message_queue(open_only_t, const char *name)
+      :  ring_message_queue(open_only, name)
+   {}
+};
+
+int main (int argc, char *argv[])
+{
+   if(argc == 5 && std::string(argv[1]) == "child"){
+      const int cpu = std::atoi(argv[4]);
+      switch(std::atoi(argv[3])){
+         case 0:  return child_main<message_queue>(argv[2], cpu);
+         case 1:  return child_main<spsc_ring_message_queue>(argv[2], cpu);
+         case 2:  return child_main<ring_message_queue>(argv[2], cpu);
+         default: return 1;
+      }
+   }
+
+   //Receivers inherit the CPU of the sender and pin themselves to another one
+   int sender_cpu, receiver_cpu;
+   if(!get_benchmark_cpus(sender_cpu, receiver_cpu)){
+      sender_cpu = receiver_cpu = -1;
+      std::cout << "CPU affinity not available, processes are not pinned" << std::endl;
+   }
+   else if(!pin_to_cpu(sender_cpu)){
+      return 1;
+   }
+   else{
+      std::cout << "sender CPU: " << sender_cpu << " receiver CPU: " << receiver_cpu << std::endl;
+   }
+
+   const char *const spsc_name = "ring_message_queue (spsc_ring_queue)";
+   const char *const mpmc_name = "ring_message_queue (mpmc_ring_queue)";
+   const double baseline = run_queue(argv[0], "message_queue", 0, receiver_cpu, (message_queue*)0);
+   if(baseline < 0)
+      return 1;
+   const double spsc = run_queue(argv[0], spsc_name, 1, receiver_cpu, (spsc_ring_message_queue*)0);
+   if(spsc < 0)
+      return 1;
+   const double mpmc = run_queue(argv[0], mpmc_name, 2, receiver_cpu, (ring_message_queue*)0);
+   if(mpmc < 0)
+      return 1;
+   print_speedup(spsc_name, spsc, baseline);
+   print_speedup(mpmc_name, mpmc, baseline);
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
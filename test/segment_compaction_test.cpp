@@ -0,0 +1,169 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/mem_algo/simple_seq_fit.hpp>
+#include <boost/interprocess/mem_algo/tlsf_fit.hpp>
+#include <boost/interprocess/offset_ptr.hpp>
+#include <vector>
+#include <cstring>
+#include "get_process_id_name.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  This example fragments managed segments with relocatable buffers and     //
+//  checks that compact() moves them towards the start of the segment so     //
+//  that shrink_to_fit() returns more memory, with and without a thread cache.//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace boost::interprocess;
+
+//A relocatable buffer of chars placed in the segment
+struct record_t
+{
+   offset_ptr<char>  m_data;
+   std::size_t       m_size;
+};
+
+static const std::size_t NumRecords = 200;
+
+template<class ManagedMemory>
+bool test_compaction_records(ManagedMemory &segment)
+{
+   typedef typename ManagedMemory::segment_manager segment_manager_t;
+   typedef typename ManagedMemory::stats_type      stats_type;
+   segment_manager_t *mngr = segment.get_segment_manager();
+
+   record_t *records = segment.template construct<record_t>(anonymous_instance)[NumRecords]();
+   //A buffer that is not registered is never moved
+   char *fixed = static_cast<char*>(segment.allocate(64));
+   std::memset(fixed, 0x5a, 64);
+   //A null pointer can be registered too
+   offset_ptr<char> *null_ptr = segment.template construct<offset_ptr<char> >(anonymous_instance)();
+   segment.register_relocatable(*null_ptr);
+
+   //Interleave records with holes bigger than the records
+   std::vector<void*> holes;
+   for(std::size_t i = 0; i != NumRecords; ++i){
+      holes.push_back(segment.allocate(64 + (i % 4)*200));
+      records[i].m_size = 32 + (i % 8)*16;
+      records[i].m_data = static_cast<char*>(segment.allocate(records[i].m_size));
+      std::memset(records[i].m_data.get(), (int)i, records[i].m_size);
+      segment.register_relocatable(records[i].m_data);
+   }
+   if(mngr->get_num_relocatables() != NumRecords + 1)
+      return false;
+
+   for(std::size_t i = 0; i != holes.size(); ++i){
+      segment.deallocate(holes[i]);
+   }
+
+   //Only the free memory after the last record can be returned
+   const std::size_t size = mngr->get_size();
+   mngr->shrink_to_fit();
+   const std::size_t fragmented_size = mngr->get_size();
+   mngr->grow(size - fragmented_size);
+
+   stats_type before;
+   segment.get_stats(before);
+   const std::size_t moved = segment.compact();
+   stats_type after;
+   segment.get_stats(after);
+   if(!moved || after.free_blocks >= before.free_blocks ||
+      after.largest_free_block <= before.largest_free_block || !segment.check_sanity())
+      return false;
+
+   //Contents have been moved and pointers updated
+   for(std::size_t i = 0; i != NumRecords; ++i){
+      const char *data = records[i].m_data.get();
+      for(std::size_t j = 0; j != records[i].m_size; ++j){
+         if(data[j] != (char)i)
+            return false;
+      }
+   }
+   for(std::size_t i = 0; i != 64; ++i){
+      if(fixed[i] != 0x5a)
+         return false;
+   }
+   if(*null_ptr)
+      return false;
+
+   //Free memory has been merged at the end of the segment
+   mngr->shrink_to_fit();
+   const std::size_t shrunk_size = mngr->get_size();
+   mngr->grow(size - shrunk_size);
+   if(shrunk_size >= fragmented_size)
+      return false;
+
+   //Unregister and free everything
+   if(!segment.unregister_relocatable(*null_ptr) || segment.unregister_relocatable(*null_ptr))
+      return false;
+   for(std::size_t i = 0; i != NumRecords; ++i){
+      if(!segment.unregister_relocatable(records[i].m_data))
+         return false;
+      segment.deallocate(records[i].m_data.get());
+   }
+   if(mngr->get_num_relocatables())
+      return false;
+   segment.deallocate(fixed);
+   segment.destroy_ptr(null_ptr);
+   segment.destroy_ptr(records);
+   return true;
+}
+
+//Holes deallocated by a thread with a thread_cache stay in the cache
+//until compact() flushes it
+template<class ManagedMemory>
+bool test_compaction(ManagedMemory &segment, bool use_thread_cache)
+{
+   const std::size_t free_memory = segment.get_free_memory();
+   bool ok;
+   if(use_thread_cache){
+      typename ManagedMemory::segment_manager::thread_cache cache(*segment.get_segment_manager());
+      ok = test_compaction_records(segment);
+   }
+   else{
+      ok = test_compaction_records(segment);
+   }
+   return ok && free_memory == segment.get_free_memory() && segment.check_sanity();
+}
+
+template<class ManagedMemory>
+int run_test(const char *shMemName)
+{
+   shared_memory_object::remove(shMemName);
+   bool ok;
+   {
+      ManagedMemory segment(create_only, shMemName, 1024*1024);
+      ok = test_compaction(segment, false) && test_compaction(segment, true);
+   }
+   shared_memory_object::remove(shMemName);
+   return ok ? 0 : 1;
+}
+
+int main ()
+{
+   const char *const shMemName = test::get_process_id_name();
+   typedef basic_managed_shared_memory
+      <char, simple_seq_fit<mutex_family>, iset_index>   seq_managed_shared_memory;
+   typedef basic_managed_shared_memory
+      <char, tlsf_fit<mutex_family>, iset_index>         tlsf_managed_shared_memory;
+
+   if(run_test<managed_shared_memory>(shMemName) ||
+      run_test<seq_managed_shared_memory>(shMemName) ||
+      run_test<tlsf_managed_shared_memory>(shMemName)){
+      return 1;
+   }
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
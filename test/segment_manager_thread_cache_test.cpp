@@ -0,0 +1,219 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include "get_process_id_name.hpp"
+#include "random_allocation_test_template.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  This example tests the thread cache of segment managers and compares     //
+//  the time small raw allocations take from several threads with and        //
+//  without it.                                                               //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace boost::interprocess;
+
+typedef managed_shared_memory::segment_manager  segment_manager_t;
+typedef segment_manager_t::thread_cache         thread_cache_t;
+typedef segment_manager_t::size_type            size_type;
+
+struct order_t
+{
+   order_t(size_type id) : m_id(id), m_price(id*2), m_quantity(id*3) {}
+   size_type m_id, m_price, m_quantity;
+};
+
+bool test_thread_cache(managed_shared_memory &segment)
+{
+   segment_manager_t *mngr = segment.get_segment_manager();
+   const size_type free_memory = segment.get_free_memory();
+   const size_type segment_size = mngr->get_size();
+   {
+      thread_cache_t cache(*mngr);
+      if(cache.get_num_cached() || cache.get_hits() || cache.get_misses())
+         return false;
+
+      //Raw allocations go through the cache
+      std::vector<void*> buffers;
+      for(size_type i = 0; i != 1000; ++i){
+         const size_type size = 48 + i % 81;
+         void *ptr = segment.allocate(size);
+         if(segment.get_segment_manager()->size(ptr) < size)
+            return false;
+         std::memset(ptr, (int)i, size);
+         buffers.push_back(ptr);
+      }
+      if(cache.get_hits() + cache.get_misses() != 1000 || cache.get_hits() < cache.get_misses())
+         return false;
+      std::vector<void*> sorted(buffers);
+      std::sort(sorted.begin(), sorted.end());
+      if(std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+         return false;
+      for(size_type i = 0; i != buffers.size(); ++i){
+         if(*static_cast<unsigned char*>(buffers[i]) != (unsigned char)i)
+            return false;
+         segment.deallocate(buffers[i]);
+      }
+      if(!cache.get_num_cached() || free_memory == segment.get_free_memory())
+         return false;
+
+      //Cached blocks are reused
+      const size_type hits = cache.get_hits();
+      void *ptr = segment.allocate(100);
+      if(cache.get_hits() != hits + 1 ||
+         std::find(buffers.begin(), buffers.end(), ptr) == buffers.end())
+         return false;
+      segment.deallocate(ptr);
+
+      //Big allocations don't use the lists
+      ptr = segment.allocate(thread_cache_t::get_max_cached_size()*4);
+      if(cache.get_hits() != hits + 1)
+         return false;
+      segment.deallocate(ptr);
+
+      //Anonymous and named objects are constructed with the cache
+      const size_type allocations = cache.get_hits() + cache.get_misses();
+      order_t *anonymous = segment.construct<order_t>(anonymous_instance)(1);
+      order_t *named     = segment.construct<order_t>("order")(2);
+      if(cache.get_hits() + cache.get_misses() != allocations + 2 || named->m_price != 4)
+         return false;
+      segment.destroy_ptr(anonymous);
+      segment.destroy_ptr(named);
+
+      cache.flush();
+      if(cache.get_num_cached() || free_memory != segment.get_free_memory())
+         return false;
+
+      //Caches are registered per segment manager and thread
+      segment_manager_t::segment_manager_base_type &base = *mngr;
+      void *nested_ptr = 0;
+      {
+         thread_cache_t nested(*mngr, 4);
+         nested_ptr = base.allocate(64);
+         if(nested.get_misses() != 1)
+            return false;
+         base.deallocate(nested_ptr);
+         if(nested.get_num_cached() != 3)
+            return false;
+      }
+      //The destructor of the nested cache has flushed it
+      if(free_memory != segment.get_free_memory())
+         return false;
+
+      //shrink_to_fit flushes the cache of the calling thread
+      segment.deallocate(segment.allocate(64));
+      if(!cache.get_num_cached())
+         return false;
+      mngr->shrink_to_fit();
+      if(cache.get_num_cached())
+         return false;
+      mngr->grow(segment_size - mngr->get_size());
+
+      //With bins, lists are refilled from them and flushed blocks are
+      //cached in them, where they count as free memory
+      mngr->set_bin_capacity(64);
+      for(size_type i = 0; i != 200; ++i){
+         buffers[i] = segment.allocate(16 + i % 200);
+      }
+      for(size_type i = 0; i != 200; ++i){
+         segment.deallocate(buffers[i]);
+      }
+      cache.flush();
+      if(free_memory != segment.get_free_memory() || !segment.check_sanity())
+         return false;
+      mngr->set_bin_capacity(0);
+   }
+   return free_memory == segment.get_free_memory() && segment.check_sanity();
+}
+
+//Allocates through the segment manager with a thread cache
+//constructed in the thread that uses it, if requested
+struct segment_manager_handle
+{
+   segment_manager_handle(segment_manager_t &mngr, bool use_cache)
+      :  m_mngr(mngr), m_use_cache(use_cache), mp_cache(0)
+   {}
+
+   //Copies don't share the cache
+   segment_manager_handle(const segment_manager_handle &other)
+      :  m_mngr(other.m_mngr), m_use_cache(other.m_use_cache), mp_cache(0)
+   {}
+
+   //Flushes the cache in the thread that constructed it
+   ~segment_manager_handle()
+   {  delete mp_cache;  }
+
+   void *allocate(size_type size)
+   {
+      if(m_use_cache && !mp_cache)
+         mp_cache = new thread_cache_t(m_mngr);
+      return m_mngr.allocate(size);
+   }
+
+   void deallocate(void *ptr)
+   {  m_mngr.deallocate(ptr);  }
+
+   segment_manager_t &m_mngr;
+   bool m_use_cache;
+   thread_cache_t *mp_cache;
+
+   private:
+   segment_manager_handle &operator=(const segment_manager_handle &);
+};
+
+//Returns the time in microseconds threads take, or -1 on error
+long run_threads(managed_shared_memory &segment, size_type num_threads, bool use_cache)
+{
+   const size_type free_memory = segment.get_free_memory();
+   const long elapsed_us = test::run_random_allocation_threads
+      (segment_manager_handle(*segment.get_segment_manager(), use_cache), num_threads, 48, 128);
+   //Caches have been flushed when handles were destroyed
+   if(free_memory != segment.get_free_memory())
+      return -1;
+   return elapsed_us;
+}
+
+int main ()
+{
+   const char *const shMemName = test::get_process_id_name();
+   shared_memory_object::remove(shMemName);
+   {
+      managed_shared_memory segment(create_only, shMemName, 4*1024*1024);
+      if(!test_thread_cache(segment)){
+         shared_memory_object::remove(shMemName);
+         return 1;
+      }
+
+      const size_type num_threads[] = { 1, 4, 16 };
+      for(size_type i = 0; i != sizeof(num_threads)/sizeof(num_threads[0]); ++i){
+         const long locked_us = run_threads(segment, num_threads[i], false);
+         const long cached_us = run_threads(segment, num_threads[i], true);
+         if(locked_us < 0 || cached_us < 0){
+            shared_memory_object::remove(shMemName);
+            return 1;
+         }
+         std::cout << "threads: "         << std::setw(2) << num_threads[i]
+                   << " memory algorithm: " << std::setw(8) << locked_us << "us"
+                   << " thread_cache: "     << std::setw(8) << cached_us << "us" << std::endl;
+      }
+   }
+   shared_memory_object::remove(shMemName);
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
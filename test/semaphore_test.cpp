@@ -15,17 +15,22 @@
 #include "named_creation_template.hpp"
 #include "mutex_test_template.hpp"
 
+#if defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+#include <boost/interprocess/sync/spin/semaphore.hpp>
+#endif
+
 static const std::size_t SemCount      = 1;
 static const std::size_t RecSemCount   = 100;
 
 //This wrapper is necessary to plug this class
 //in named creation tests and interprocess_mutex tests
+template<class Semaphore = boost::interprocess::interprocess_semaphore>
 class semaphore_test_wrapper
-   : public boost::interprocess::interprocess_semaphore
+   : public Semaphore
 {
    public:
    semaphore_test_wrapper()
-      :  boost::interprocess::interprocess_semaphore(SemCount)
+      :  Semaphore(SemCount)
    {}
 
    void lock()
@@ -42,28 +47,60 @@ class semaphore_test_wrapper
 
    protected:
    semaphore_test_wrapper(int initial_count)
-      :  boost::interprocess::interprocess_semaphore(initial_count)
+      :  Semaphore(initial_count)
    {}
 };
 
 //This wrapper is necessary to plug this class
 //in recursive tests
+template<class Semaphore = boost::interprocess::interprocess_semaphore>
 class recursive_semaphore_test_wrapper
-   :  public semaphore_test_wrapper
+   :  public semaphore_test_wrapper<Semaphore>
 {
    public:
    recursive_semaphore_test_wrapper()
-      :  semaphore_test_wrapper(RecSemCount)
+      :  semaphore_test_wrapper<Semaphore>(RecSemCount)
    {}
 };
 
+#if defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+
+//Posting a semaphore at its maximum count must throw
+//and leave the count unchanged
+bool test_spin_semaphore_overflow()
+{
+   using namespace boost::interprocess;
+   ipcdetail::spin_semaphore sem(~0u);
+   try{
+      sem.post();
+      return false;
+   }
+   catch(interprocess_exception &ex){
+      if(ex.get_error_code() != sem_error)
+         return false;
+   }
+   if(!sem.try_wait())
+      return false;
+   sem.post();
+   return sem.try_wait();
+}
+
+#endif
+
 int main ()
 {
    using namespace boost::interprocess;
 
-   test::test_all_lock<semaphore_test_wrapper>();
-   test::test_all_recursive_lock<recursive_semaphore_test_wrapper>();
-   test::test_all_mutex<semaphore_test_wrapper>();
+   test::test_all_lock<semaphore_test_wrapper<> >();
+   test::test_all_recursive_lock<recursive_semaphore_test_wrapper<> >();
+   test::test_all_mutex<semaphore_test_wrapper<> >();
+   #if defined(BOOST_INTERPROCESS_LINUX_FUTEX)
+   test::test_all_lock<semaphore_test_wrapper<ipcdetail::spin_semaphore> >();
+   test::test_all_recursive_lock<recursive_semaphore_test_wrapper<ipcdetail::spin_semaphore> >();
+   test::test_all_mutex<semaphore_test_wrapper<ipcdetail::spin_semaphore> >();
+   if(!test_spin_semaphore_overflow())
+      return 1;
+   #endif
    return 0;
 }
 
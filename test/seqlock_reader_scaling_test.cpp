@@ -0,0 +1,141 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+//Reader scaling benchmark: readers copy a small snapshot protected by
+//interprocess_seqlock or by interprocess_sharable_mutex while a single
+//writer updates it. Prints the average cost of a read for 1..8 readers.
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/sync/interprocess_seqlock.hpp>
+#include <boost/interprocess/sync/interprocess_sharable_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/interprocess/sync/sharable_lock.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/cstdint.hpp>
+#include <iostream>
+#include <iomanip>
+
+using namespace boost::interprocess;
+
+static const unsigned NumReads = 200000;
+
+struct snapshot
+{
+   boost::uint32_t values[16];
+};
+
+//Snapshot protected by a sharable mutex, readers take a sharable lock
+class sharable_protected
+{
+   public:
+   sharable_protected()
+      :  m_value()
+   {}
+
+   snapshot load() const
+   {
+      sharable_lock<interprocess_sharable_mutex> lck(m_mtx);
+      return m_value;
+   }
+
+   void store(const snapshot &value)
+   {
+      scoped_lock<interprocess_sharable_mutex> lck(m_mtx);
+      m_value = value;
+   }
+
+   private:
+   mutable interprocess_sharable_mutex m_mtx;
+   snapshot m_value;
+};
+
+template<class Protected>
+struct reader_thread
+{
+   reader_thread(Protected &data, volatile boost::uint32_t &sink)
+      :  m_data(data), m_sink(sink)
+   {}
+
+   void operator()()
+   {
+      boost::uint32_t sum = 0;
+      for(unsigned i = 0; i != NumReads; ++i){
+         sum += m_data.load().values[i % 16];
+      }
+      m_sink = sum;
+   }
+
+   Protected &m_data;
+   volatile boost::uint32_t &m_sink;
+};
+
+template<class Protected>
+struct writer_thread
+{
+   writer_thread(Protected &data, volatile boost::uint32_t &stop)
+      :  m_data(data), m_stop(stop)
+   {}
+
+   void operator()()
+   {
+      snapshot s = snapshot();
+      while(!ipcdetail::atomic_read32(&m_stop)){
+         ++s.values[s.values[0] % 16];
+         m_data.store(s);
+         ipcdetail::thread_yield();
+      }
+   }
+
+   Protected &m_data;
+   volatile boost::uint32_t &m_stop;
+};
+
+template<class Protected>
+void run_readers(const char *name, unsigned num_readers)
+{
+   Protected data;
+   volatile boost::uint32_t stop = 0;
+   volatile boost::uint32_t sink = 0;
+   boost::thread writer((writer_thread<Protected>(data, stop)));
+
+   boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+   {
+      boost::thread_group readers;
+      for(unsigned i = 0; i != num_readers; ++i){
+         readers.create_thread(reader_thread<Protected>(data, sink));
+      }
+      readers.join_all();
+   }
+   boost::posix_time::time_duration elapsed =
+      boost::posix_time::microsec_clock::universal_time() - start;
+   ipcdetail::atomic_write32(&stop, 1);
+   writer.join();
+
+   const double usecs = double(elapsed.total_microseconds());
+   std::cout << std::setw(30) << name
+             << " readers: " << std::setw(2) << num_readers
+             << " ns/read: " << std::setw(8)
+             << (usecs*1000.0)/double(NumReads*num_readers) << std::endl;
+}
+
+int main ()
+{
+   const unsigned num_readers[] = { 1, 2, 4, 8 };
+   for(unsigned i = 0; i != sizeof(num_readers)/sizeof(num_readers[0]); ++i){
+      run_readers<sharable_protected>("interprocess_sharable_mutex", num_readers[i]);
+      run_readers<seqlock_protected<snapshot> >("interprocess_seqlock", num_readers[i]);
+   }
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
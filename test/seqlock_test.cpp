@@ -0,0 +1,160 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/sync/interprocess_seqlock.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/cstdint.hpp>
+#include <cstring>
+#include "mutex_test_template.hpp"
+#include "get_process_id_name.hpp"
+
+using namespace boost::interprocess;
+
+struct snapshot
+{
+   boost::uint32_t values[16];
+};
+
+static const unsigned NumReaders = 3;
+static const unsigned NumStores  = 20000;
+
+struct set_all
+{
+   set_all(boost::uint32_t v) : m_v(v) {}
+   void operator()(snapshot &s) const
+   {
+      for(unsigned i = 0; i != sizeof(s.values)/sizeof(s.values[0]); ++i){
+         s.values[i] = m_v;
+      }
+   }
+   boost::uint32_t m_v;
+};
+
+struct writer_thread
+{
+   writer_thread(seqlock_protected<snapshot> &data)
+      :  m_data(data)
+   {}
+
+   void operator()()
+   {
+      for(boost::uint32_t i = 1; i <= NumStores; ++i){
+         if(i % 2){
+            const set_all setter(i);
+            snapshot s;
+            setter(s);
+            m_data.store(s);
+         }
+         else{
+            m_data.modify(set_all(i));
+         }
+      }
+   }
+   seqlock_protected<snapshot> &m_data;
+};
+
+struct reader_thread
+{
+   reader_thread(seqlock_protected<snapshot> &data, bool &torn)
+      :  m_data(data), m_torn(torn)
+   {}
+
+   void operator()()
+   {
+      boost::uint32_t last = 0;
+      while(last != NumStores){
+         const snapshot s = m_data.load();
+         for(unsigned i = 1; i != sizeof(s.values)/sizeof(s.values[0]); ++i){
+            if(s.values[i] != s.values[0]){
+               m_torn = true;
+            }
+         }
+         //Stores are seen in order
+         if(s.values[0] < last){
+            m_torn = true;
+         }
+         last = s.values[0];
+      }
+   }
+   seqlock_protected<snapshot> &m_data;
+   bool &m_torn;
+};
+
+bool test_consistent_snapshots(seqlock_protected<snapshot> &data)
+{
+   bool torn[NumReaders] = {};
+   {
+      boost::thread_group threads;
+      for(unsigned i = 0; i != NumReaders; ++i){
+         threads.create_thread(reader_thread(data, torn[i]));
+      }
+      threads.create_thread(writer_thread(data));
+      threads.join_all();
+   }
+   for(unsigned i = 0; i != NumReaders; ++i){
+      if(torn[i]){
+         return false;
+      }
+   }
+   return true;
+}
+
+int main ()
+{
+   //Writer locking has the same interface as a mutex
+   test::test_all_lock<interprocess_seqlock>();
+   test::test_all_mutex<interprocess_seqlock>();
+
+   struct shm_remove
+   {
+      shm_remove(){ shared_memory_object::remove(test::get_process_id_name()); }
+      ~shm_remove(){ shared_memory_object::remove(test::get_process_id_name()); }
+   } remover;
+
+   managed_shared_memory segment(create_only, test::get_process_id_name(), 65536);
+
+   //Zeroed memory is an unlocked seqlock
+   {
+      void *mem = segment.allocate(sizeof(interprocess_seqlock));
+      std::memset(mem, 0, sizeof(interprocess_seqlock));
+      interprocess_seqlock &seqlock = *static_cast<interprocess_seqlock*>(mem);
+      const boost::uint32_t seq = seqlock.read_begin();
+      if(seqlock.read_retry(seq) || !seqlock.try_lock() || seqlock.try_lock()){
+         return 1;
+      }
+      seqlock.unlock();
+      //A writer has been active since read_begin
+      if(!seqlock.read_retry(seq)){
+         return 1;
+      }
+      segment.deallocate(mem);
+   }
+
+   //Readers never see a partially written snapshot
+   {
+      seqlock_protected<snapshot> *data =
+         segment.construct<seqlock_protected<snapshot> >("snapshot")();
+      if(data->load().values[0] != 0){
+         return 1;
+      }
+      if(!test_consistent_snapshots(*data)){
+         return 1;
+      }
+      if(data->load().values[15] != NumStores){
+         return 1;
+      }
+      segment.destroy_ptr(data);
+   }
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
@@ -0,0 +1,195 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+//Multi-process latency benchmark: several processes share an
+//interprocess_sharable_mutex_t placed in shared memory and measure
+//how long it takes to acquire sharable and exclusive ownership with
+//each scheduling policy. Prints p50/p99/p999/max latencies.
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/sync/interprocess_sharable_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/interprocess/sync/sharable_lock.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/cstdint.hpp>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib> //std::atoi
+#include <new>
+#include "get_process_id_name.hpp"
+#include "process_group.hpp"
+
+using namespace boost::interprocess;
+
+static const unsigned NumProcesses  = 4;
+static const unsigned NumIterations = 20000;
+//One of every WriteEvery acquisitions is exclusive
+static const unsigned WriteEvery    = 20;
+
+template<class Policy>
+struct latency_data
+{
+   typedef interprocess_sharable_mutex_t<Policy> mutex_type;
+
+   latency_data()
+      :  ready(0), go(0), value(0)
+   {
+      for(unsigned i = 0; i != NumProcesses; ++i){
+         num_reads[i] = num_writes[i] = 0;
+      }
+   }
+
+   mutex_type                 mtx;
+   volatile boost::uint32_t   ready;
+   volatile boost::uint32_t   go;
+   unsigned                   value;
+   //Acquisition latencies in microseconds, written by each process
+   unsigned                   num_reads[NumProcesses];
+   unsigned                   num_writes[NumProcesses];
+   boost::uint32_t            read_lat [NumProcesses][NumIterations];
+   boost::uint32_t            write_lat[NumProcesses][NumIterations];
+};
+
+static boost::uint32_t elapsed_usecs(const boost::posix_time::ptime &start)
+{
+   return boost::uint32_t
+      ((boost::posix_time::microsec_clock::universal_time() - start).total_microseconds());
+}
+
+template<class Policy>
+int child_main(const char *shm_name, unsigned proc)
+{
+   shared_memory_object shm(open_only, shm_name, read_write);
+   mapped_region region(shm, read_write);
+   latency_data<Policy> &data = *static_cast<latency_data<Policy>*>(region.get_address());
+   typedef typename latency_data<Policy>::mutex_type mutex_type;
+
+   //Wait until all processes are ready so that they compete
+   ipcdetail::atomic_inc32(&data.ready);
+   while(!ipcdetail::atomic_read32(&data.go)){
+      ipcdetail::thread_yield();
+   }
+
+   for(unsigned i = 0; i != NumIterations; ++i){
+      const boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+      //Stagger writers between processes
+      if(((i + proc) % WriteEvery) == 0){
+         scoped_lock<mutex_type> lock(data.mtx);
+         data.write_lat[proc][data.num_writes[proc]++] = elapsed_usecs(start);
+         ++data.value;
+      }
+      else{
+         sharable_lock<mutex_type> lock(data.mtx);
+         data.read_lat[proc][data.num_reads[proc]++] = elapsed_usecs(start);
+      }
+   }
+   return 0;
+}
+
+static void print_percentiles(const char *name, const char *kind, std::vector<boost::uint32_t> &v)
+{
+   if(v.empty()){
+      return;
+   }
+   std::sort(v.begin(), v.end());
+   std::cout << std::setw(26) << name << std::setw(10) << kind
+             << " n: "     << std::setw(6) << v.size()
+             << " p50: "   << std::setw(6) << v[v.size()/2]
+             << " p99: "   << std::setw(6) << v[(v.size()*99)/100]
+             << " p999: "  << std::setw(6) << v[(v.size()*999)/1000]
+             << " max: "   << std::setw(6) << v.back() << " us" << std::endl;
+}
+
+template<class Policy>
+bool run_policy(const char *argv0, const char *policy_name, unsigned policy_index)
+{
+   const char *const shm_name = test::get_process_id_name();
+   struct shm_remove
+   {
+      shm_remove(const char *name)  : m_name(name) { shared_memory_object::remove(m_name); }
+      ~shm_remove(){ shared_memory_object::remove(m_name); }
+      const char *m_name;
+   } remover(shm_name);
+
+   shared_memory_object shm(create_only, shm_name, read_write);
+   shm.truncate(sizeof(latency_data<Policy>));
+   mapped_region region(shm, read_write);
+   latency_data<Policy> *data = new (region.get_address()) latency_data<Policy>;
+
+   bool ok;
+   {
+      test::process_group children;
+      for(unsigned i = 0; i != NumProcesses; ++i){
+         std::stringstream cmd;
+         cmd << argv0 << " child " << shm_name << " " << policy_index << " " << i;
+         children.launch(cmd.str());
+      }
+      //Start the race when all children are waiting or
+      //give up if any of them has already finished
+      while(ipcdetail::atomic_read32(&data->ready) != NumProcesses && !children.num_finished()){
+         ipcdetail::thread_yield();
+      }
+      ipcdetail::atomic_write32(&data->go, 1);
+      ok = children.join_all();
+   }
+
+   unsigned num_writes = 0;
+   std::vector<boost::uint32_t> reads, writes;
+   for(unsigned i = 0; i != NumProcesses; ++i){
+      num_writes += data->num_writes[i];
+      reads.insert (reads.end(),  &data->read_lat[i][0],  &data->read_lat[i][0]  + data->num_reads[i]);
+      writes.insert(writes.end(), &data->write_lat[i][0], &data->write_lat[i][0] + data->num_writes[i]);
+   }
+   //All exclusive sections must have been executed
+   ok = ok && data->value == num_writes && reads.size() + writes.size() == NumProcesses*NumIterations;
+   if(ok){
+      print_percentiles(policy_name, "sharable", reads);
+      print_percentiles(policy_name, "exclusive", writes);
+   }
+   data->~latency_data<Policy>();
+   return ok;
+}
+
+int main (int argc, char *argv[])
+{
+   if(argc == 5 && std::string(argv[1]) == "child"){
+      const unsigned proc = unsigned(std::atoi(argv[4]));
+      if(proc >= NumProcesses){
+         return 1;
+      }
+      switch(std::atoi(argv[3])){
+         case 0:  return child_main<two_gate_policy>(argv[2], proc);
+         case 1:  return child_main<reader_preferring_policy>(argv[2], proc);
+         case 2:  return child_main<writer_preferring_policy>(argv[2], proc);
+         case 3:  return child_main<phase_fair_policy>(argv[2], proc);
+         default: return 1;
+      }
+   }
+
+   if(!run_policy<two_gate_policy>(argv[0], "two_gate_policy", 0))
+      return 1;
+   if(!run_policy<reader_preferring_policy>(argv[0], "reader_preferring_policy", 1))
+      return 1;
+   if(!run_policy<writer_preferring_policy>(argv[0], "writer_preferring_policy", 2))
+      return 1;
+   if(!run_policy<phase_fair_policy>(argv[0], "phase_fair_policy", 3))
+      return 1;
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
@@ -25,6 +25,17 @@ int main ()
    test::test_all_mutex<interprocess_sharable_mutex>();
    test::test_all_sharable_mutex<interprocess_sharable_mutex>();
 
+   //Alternative scheduling policies
+   test::test_all_lock<interprocess_sharable_mutex_t<reader_preferring_policy> >();
+   test::test_all_mutex<interprocess_sharable_mutex_t<reader_preferring_policy> >();
+   test::test_all_sharable_mutex<interprocess_sharable_mutex_t<reader_preferring_policy> >();
+   test::test_all_lock<interprocess_sharable_mutex_t<writer_preferring_policy> >();
+   test::test_all_mutex<interprocess_sharable_mutex_t<writer_preferring_policy> >();
+   test::test_all_sharable_mutex<interprocess_sharable_mutex_t<writer_preferring_policy> >();
+   test::test_all_lock<interprocess_sharable_mutex_t<phase_fair_policy> >();
+   test::test_all_mutex<interprocess_sharable_mutex_t<phase_fair_policy> >();
+   test::test_all_sharable_mutex<interprocess_sharable_mutex_t<phase_fair_policy> >();
+
    return 0;
 }
 
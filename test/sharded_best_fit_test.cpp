@@ -0,0 +1,192 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/mem_algo/sharded_best_fit.hpp>
+#include <boost/interprocess/mem_algo/rbtree_best_fit.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/sync/mutex_family.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstring>
+#include <cstdlib> //std::atoi
+#include <new>
+#include "get_process_id_name.hpp"
+#include "random_allocation_test_template.hpp"
+#include "process_group.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  This example tests sharded_best_fit arenas and compares the time small    //
+//  allocations take from 1 to 64 threads of several processes with the time  //
+//  they take with a single rbtree_best_fit.                                  //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace boost::interprocess;
+
+typedef rbtree_best_fit<mutex_family>  tree_algo_t;
+typedef sharded_best_fit<mutex_family> sharded_algo_t;
+typedef sharded_algo_t::size_type      size_type;
+
+static const size_type MemSize = 4*1024*1024;
+
+//Checks that arenas are used when the arena of the thread is exhausted,
+//that large buffers are allocated from the shared arena and that memory
+//is returned to the arena that owns it
+bool test_arenas(sharded_algo_t &algo)
+{
+   const size_type num_arenas = algo.get_num_arenas();
+   if(num_arenas != 8 || algo.get_thread_arena() >= num_arenas)
+      return false;
+
+   const size_type free_memory = algo.get_free_memory();
+   void *ptr = algo.allocate(100);
+   if(!ptr || algo.get_arena_index(ptr) != algo.get_thread_arena())
+      return false;
+   algo.deallocate(ptr);
+
+   //A buffer bigger than a thread arena
+   ptr = algo.allocate(MemSize/3);
+   if(!ptr || algo.get_arena_index(ptr) != num_arenas || algo.size(ptr) < MemSize/3)
+      return false;
+   std::memset(ptr, 1, MemSize/3);
+   algo.deallocate(ptr);
+   if(free_memory != algo.get_free_memory())
+      return false;
+
+   //Exhaust all arenas
+   std::vector<void*> buffers;
+   std::vector<bool> used(num_arenas + 1);
+   while((ptr = algo.allocate(1000)) != 0){
+      if(algo.get_arena(algo.get_arena_index(ptr)).size(ptr) < 1000)
+         return false;
+      std::memset(ptr, 1, 1000);
+      used[algo.get_arena_index(ptr)] = true;
+      buffers.push_back(ptr);
+   }
+   for(size_type i = 0; i != used.size(); ++i){
+      if(!used[i])
+         return false;
+   }
+
+   //Deallocate them together
+   sharded_algo_t::multiallocation_chain chain;
+   for(size_type i = 0; i != buffers.size(); ++i){
+      chain.push_back(buffers[i]);
+   }
+   algo.deallocate_many(chain);
+   if(free_memory != algo.get_free_memory() ||
+      !algo.all_memory_deallocated() || !algo.check_sanity())
+      return false;
+
+   //Allocate them together
+   algo.allocate_many(1000, 100, chain);
+   if(chain.size() != 100)
+      return false;
+   algo.deallocate_many(chain);
+   return free_memory == algo.get_free_memory() &&
+          algo.all_memory_deallocated() && algo.check_sanity();
+}
+
+static const unsigned  MaxThreads = 64;
+static const unsigned  MaxProcesses = 4;
+
+//Runs worker threads on the algorithm placed in the shared memory "name"
+template<class Algo>
+int child_main(const char *name, unsigned num_threads)
+{
+   shared_memory_object shm(open_only, name, read_write);
+   mapped_region region(shm, read_write);
+   Algo &algo = *static_cast<Algo*>(region.get_address());
+   return test::run_random_allocation_threads
+      (test::memory_algorithm_handle<Algo>(algo), num_threads, 0, 127) < 0 ? 1 : 0;
+}
+
+//Returns the time in microseconds processes take, or -1 on error
+template<class Algo>
+long run_processes(const char *argv0, unsigned algo_index, unsigned num_processes, unsigned num_threads)
+{
+   const char *const name = test::get_process_id_name();
+   shared_memory_object::remove(name);
+   long ret = -1;
+   {
+      shared_memory_object shm(create_only, name, read_write);
+      shm.truncate(MemSize);
+      mapped_region region(shm, read_write);
+      Algo *algo = new(region.get_address()) Algo(MemSize, 0);
+
+      const boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+      bool ok;
+      {
+         test::process_group children;
+         for(unsigned i = 0; i != num_processes; ++i){
+            std::stringstream cmd;
+            cmd << argv0 << " child " << name << " " << algo_index << " " << num_threads;
+            children.launch(cmd.str());
+         }
+         ok = children.join_all();
+      }
+      const boost::posix_time::time_duration elapsed =
+         boost::posix_time::microsec_clock::universal_time() - start;
+
+      ok = ok && algo->all_memory_deallocated() && algo->check_sanity();
+      algo->~Algo();
+      if(ok){
+         ret = (long)elapsed.total_microseconds();
+      }
+   }
+   shared_memory_object::remove(name);
+   return ret;
+}
+
+int main (int argc, char *argv[])
+{
+   if(argc == 5 && std::string(argv[1]) == "child"){
+      const unsigned num_threads = (unsigned)std::atoi(argv[4]);
+      if(num_threads > MaxThreads)
+         return 1;
+      return std::atoi(argv[3]) == 0
+         ? child_main<tree_algo_t>(argv[2], num_threads)
+         : child_main<sharded_algo_t>(argv[2], num_threads);
+   }
+
+   {
+      std::vector<char> buffer(MemSize + sharded_algo_t::Alignment);
+      //The memory algorithm must be aligned
+      void *addr = &buffer[0] + (sharded_algo_t::Alignment - (std::size_t)&buffer[0] % sharded_algo_t::Alignment);
+      sharded_algo_t *algo = new(addr) sharded_algo_t(MemSize, 0);
+      if(!test_arenas(*algo))
+         return 1;
+      algo->~sharded_algo_t();
+   }
+
+   //Threads are spread among up to MaxProcesses processes
+   for(unsigned total_threads = 1; total_threads <= MaxThreads; total_threads *= 2){
+      const unsigned num_processes = total_threads < MaxProcesses ? total_threads : MaxProcesses;
+      const unsigned num_threads   = total_threads/num_processes;
+      const long tree_us    = run_processes<tree_algo_t>(argv[0], 0, num_processes, num_threads);
+      const long sharded_us = run_processes<sharded_algo_t>(argv[0], 1, num_processes, num_threads);
+      if(tree_us < 0 || sharded_us < 0)
+         return 1;
+      std::cout << "threads: "    << std::setw(2) << total_threads
+                << " processes: " << num_processes
+                << " rbtree_best_fit: "  << std::setw(8) << tree_us    << "us"
+                << " sharded_best_fit: " << std::setw(8) << sharded_us << "us" << std::endl;
+   }
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
@@ -0,0 +1,229 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/mem_algo/tlsf_fit.hpp>
+#include <boost/interprocess/mem_algo/rbtree_best_fit.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/sync/mutex_family.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include "get_process_id_name.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//  This example tests tlsf_fit in a managed shared memory segment and        //
+//  compares the time allocations take in a segment with many free fragments  //
+//  with the time they take with rbtree_best_fit.                             //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace boost::interprocess;
+
+typedef tlsf_fit<mutex_family>         tlsf_algo_t;
+typedef rbtree_best_fit<mutex_family>  tree_algo_t;
+typedef tlsf_algo_t::size_type         size_type;
+
+typedef basic_managed_shared_memory
+   <char, tlsf_algo_t, iset_index>     tlsf_managed_shared_memory;
+
+namespace boost {
+namespace interprocess {
+
+//Explicit instantiations to catch compilation errors
+template class tlsf_fit<mutex_family>;
+template class tlsf_fit<null_mutex_family, void*>;
+
+}}
+
+//Checks expansions and that free fragments are reused
+bool test_tlsf(tlsf_managed_shared_memory &segment)
+{
+   tlsf_managed_shared_memory::segment_manager *mngr = segment.get_segment_manager();
+   const size_type free_memory = segment.get_free_memory();
+
+   //Expand forward in place over a free block
+   void *first  = segment.allocate(100);
+   void *second = segment.allocate(1000);
+   void *third  = segment.allocate(100);
+   segment.deallocate(second);
+   size_type received;
+   char *expanded = mngr->allocation_command<char>
+      (expand_fwd, 500, 800, received, static_cast<char*>(first)).first;
+   if(expanded != first || received < 800)
+      return false;
+
+   //Expand backwards over the rest of the free block
+   expanded = mngr->allocation_command<char>
+      (expand_bwd, 200, 300, received, static_cast<char*>(third)).first;
+   if(!expanded || expanded >= third || received < 300)
+      return false;
+   segment.deallocate(first);
+   segment.deallocate(expanded);
+   if(free_memory != segment.get_free_memory() || !segment.all_memory_deallocated())
+      return false;
+
+   //Aligned allocations
+   for(size_type alignment = 32; alignment <= 4096; alignment <<= 1){
+      void *ptr = mngr->allocate_aligned(alignment + 10, alignment);
+      if(std::size_t(ptr) % alignment)
+         return false;
+      segment.deallocate(ptr);
+   }
+
+   //Fragment the segment, freeing every other block,
+   //and check that holes of the same size are reused
+   std::vector<void*> buffers;
+   for(size_type i = 0; i != 1000; ++i){
+      void *ptr = segment.allocate(64 + (i % 16)*16);
+      std::memset(ptr, (int)i, 64);
+      buffers.push_back(ptr);
+   }
+   std::vector<void*> holes;
+   for(size_type i = 0; i < buffers.size(); i += 2){
+      segment.deallocate(buffers[i]);
+      holes.push_back(buffers[i]);
+   }
+   for(size_type i = 0; i < buffers.size(); i += 2){
+      buffers[i] = segment.allocate(64 + (i % 16)*16);
+      if(std::find(holes.begin(), holes.end(), buffers[i]) == holes.end())
+         return false;
+      std::memset(buffers[i], (int)i, 64);
+   }
+   for(size_type i = 0; i != buffers.size(); ++i){
+      if(*static_cast<unsigned char*>(buffers[i]) != (unsigned char)i)
+         return false;
+      segment.deallocate(buffers[i]);
+   }
+
+   //Allocate and deallocate them together
+   tlsf_algo_t::multiallocation_chain chain;
+   segment.allocate_many(100, 1000, chain);
+   if(chain.size() != 1000)
+      return false;
+   segment.deallocate_many(chain);
+
+   return free_memory == segment.get_free_memory() &&
+          segment.all_memory_deallocated() && segment.check_sanity();
+}
+
+//Grows the segment by less bytes than a block needs and by just enough
+//for one. The new memory must only become a free block in the latter case,
+//so that the segment stays consistent
+template<class Algo>
+bool test_grow_small(void *addr)
+{
+   const size_type InitialSize = Algo::get_min_size(0) + 4096;
+   for(size_type extra = 1; extra != 8*Algo::Alignment; ++extra){
+      Algo *algo = new(addr) Algo(InitialSize, 0);
+      const size_type free_memory = algo->get_free_memory();
+      algo->grow(extra);
+      const bool ok = algo->check_sanity() && algo->get_free_memory() >= free_memory;
+      algo->~Algo();
+      if(!ok)
+         return false;
+   }
+   return true;
+}
+
+static const size_type MemSize      = 64*1024*1024;
+static const size_type NumBuffers   = 200000;
+static const size_type NumOps       = 400000;
+static const size_type OpsPerBatch  = 1000;
+
+//Fragments the segment and measures random allocations and deallocations.
+//Returns the time in microseconds and the slowest batch of operations, or -1 on error
+template<class Algo>
+long run_fragmented(void *addr, long &worst_batch_us)
+{
+   typedef boost::posix_time::microsec_clock clock_t;
+   Algo *algo = new(addr) Algo(MemSize, 0);
+   const size_type free_memory = algo->get_free_memory();
+   std::vector<void*> buffers(NumBuffers);
+   unsigned int seed = 12345u;
+
+   //Leave a free fragment between allocated blocks
+   for(size_type i = 0; i != NumBuffers; ++i){
+      seed = seed*1103515245u + 12345u;
+      buffers[i] = algo->allocate(16 + (seed >> 8) % 128);
+   }
+   for(size_type i = 0; i < NumBuffers; i += 2){
+      algo->deallocate(buffers[i]);
+      buffers[i] = 0;
+   }
+
+   worst_batch_us = 0;
+   bool ok = true;
+   const boost::posix_time::ptime start = clock_t::universal_time();
+   boost::posix_time::ptime batch_start = start;
+   for(size_type i = 0; i != NumOps; ++i){
+      seed = seed*1103515245u + 12345u;
+      const size_type pos = (seed >> 8) % NumBuffers;
+      if(buffers[pos]){
+         algo->deallocate(buffers[pos]);
+         buffers[pos] = 0;
+      }
+      else{
+         buffers[pos] = algo->allocate(16 + (seed >> 16) % 1024);
+         ok = ok && buffers[pos];
+      }
+      if((i + 1) % OpsPerBatch == 0){
+         const boost::posix_time::ptime now = clock_t::universal_time();
+         const long batch_us = (long)(now - batch_start).total_microseconds();
+         worst_batch_us = batch_us > worst_batch_us ? batch_us : worst_batch_us;
+         batch_start = now;
+      }
+   }
+   const long elapsed_us = (long)(clock_t::universal_time() - start).total_microseconds();
+
+   for(size_type i = 0; i != NumBuffers; ++i){
+      algo->deallocate(buffers[i]);
+   }
+   ok = ok && free_memory == algo->get_free_memory() &&
+        algo->all_memory_deallocated() && algo->check_sanity();
+   algo->~Algo();
+   return ok ? elapsed_us : -1;
+}
+
+int main ()
+{
+   const char *const shMemName = test::get_process_id_name();
+   shared_memory_object::remove(shMemName);
+   {
+      tlsf_managed_shared_memory segment(create_only, shMemName, 1024*1024);
+      if(!test_tlsf(segment)){
+         shared_memory_object::remove(shMemName);
+         return 1;
+      }
+   }
+   shared_memory_object::remove(shMemName);
+
+   std::vector<char> buffer(MemSize + tlsf_algo_t::Alignment);
+   void *addr = &buffer[0] + (tlsf_algo_t::Alignment - (std::size_t)&buffer[0] % tlsf_algo_t::Alignment);
+   if(!test_grow_small<tlsf_algo_t>(addr))
+      return 1;
+   long tree_worst_us, tlsf_worst_us;
+   const long tree_us = run_fragmented<tree_algo_t>(addr, tree_worst_us);
+   const long tlsf_us = run_fragmented<tlsf_algo_t>(addr, tlsf_worst_us);
+   if(tree_us < 0 || tlsf_us < 0)
+      return 1;
+   std::cout << "rbtree_best_fit: " << std::setw(8) << tree_us << "us"
+             << " worst " << OpsPerBatch << " ops: " << std::setw(6) << tree_worst_us << "us" << std::endl;
+   std::cout << "tlsf_fit:        " << std::setw(8) << tlsf_us << "us"
+             << " worst " << OpsPerBatch << " ops: " << std::setw(6) << tlsf_worst_us << "us" << std::endl;
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
@@ -0,0 +1,168 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// (C) Copyright Boost.Interprocess contributors 2026. Distributed under the Boost
+// Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://www.boost.org/libs/interprocess for documentation.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+//Contention benchmark: compares interprocess_upgradable_mutex (lock-free
+//fast path) with the classic two gate algorithm where every operation
+//takes the internal mutex.
+
+#include <boost/interprocess/detail/config_begin.hpp>
+#include <boost/interprocess/sync/interprocess_upgradable_mutex.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/sync/interprocess_condition.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/interprocess/sync/sharable_lock.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <iostream>
+#include <iomanip>
+
+using namespace boost::interprocess;
+
+//Reference implementation: the gate algorithm used by
+//interprocess_upgradable_mutex before the atomic control word
+class gate_sharable_mutex
+{
+   gate_sharable_mutex(const gate_sharable_mutex &);
+   gate_sharable_mutex &operator=(const gate_sharable_mutex &);
+   typedef scoped_lock<interprocess_mutex> scoped_lock_t;
+
+   public:
+   gate_sharable_mutex()
+      :  m_exclusive_in(false), m_num_shared(0)
+   {}
+
+   void lock()
+   {
+      scoped_lock_t lck(m_mut);
+      while (m_exclusive_in){
+         m_first_gate.wait(lck);
+      }
+      m_exclusive_in = true;
+      while (m_num_shared){
+         m_second_gate.wait(lck);
+      }
+   }
+
+   void unlock()
+   {
+      scoped_lock_t lck(m_mut);
+      m_exclusive_in = false;
+      m_first_gate.notify_all();
+   }
+
+   void lock_sharable()
+   {
+      scoped_lock_t lck(m_mut);
+      while(m_exclusive_in){
+         m_first_gate.wait(lck);
+      }
+      ++m_num_shared;
+   }
+
+   void unlock_sharable()
+   {
+      scoped_lock_t lck(m_mut);
+      if (--m_num_shared == 0 && m_exclusive_in){
+         m_second_gate.notify_one();
+      }
+   }
+
+   private:
+   bool                    m_exclusive_in;
+   unsigned                m_num_shared;
+   interprocess_mutex      m_mut;
+   interprocess_condition  m_first_gate;
+   interprocess_condition  m_second_gate;
+};
+
+static const unsigned NumThreads    = 4;
+static const unsigned NumIterations = 100000;
+
+template<class Mutex>
+struct contention_data
+{
+   Mutex    mtx;
+   unsigned value;
+};
+
+template<class Mutex>
+struct contention_thread
+{
+   contention_thread(contention_data<Mutex> &data, unsigned write_permille)
+      :  m_data(data), m_write_permille(write_permille)
+   {}
+
+   void operator()()
+   {
+      unsigned sum = 0;
+      for(unsigned i = 0; i != NumIterations; ++i){
+         if((i % 1000) < m_write_permille){
+            scoped_lock<Mutex> lock(m_data.mtx);
+            ++m_data.value;
+         }
+         else{
+            sharable_lock<Mutex> lock(m_data.mtx);
+            sum += m_data.value;
+         }
+      }
+      m_sum = sum;
+   }
+
+   contention_data<Mutex> &m_data;
+   unsigned m_write_permille;
+   unsigned m_sum;
+};
+
+template<class Mutex>
+bool run_contention(const char *name, unsigned write_permille)
+{
+   contention_data<Mutex> data;
+   data.value = 0;
+   boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+   {
+      boost::thread_group threads;
+      for(unsigned i = 0; i != NumThreads; ++i){
+         threads.create_thread(contention_thread<Mutex>(data, write_permille));
+      }
+      threads.join_all();
+   }
+   boost::posix_time::time_duration elapsed =
+      boost::posix_time::microsec_clock::universal_time() - start;
+
+   //Check all writes were performed
+   unsigned expected = 0;
+   for(unsigned i = 0; i != NumIterations; ++i){
+      expected += (i % 1000) < write_permille;
+   }
+   if(data.value != expected*NumThreads){
+      return false;
+   }
+
+   const double usecs = double(elapsed.total_microseconds());
+   std::cout << std::setw(30) << name
+             << " writes/1000: " << std::setw(4) << write_permille
+             << " ns/op: " << std::setw(8)
+             << (usecs*1000.0)/double(NumIterations*NumThreads) << std::endl;
+   return true;
+}
+
+int main ()
+{
+   const unsigned write_permille[] = { 0, 1, 10, 100 };
+   for(unsigned i = 0; i != sizeof(write_permille)/sizeof(write_permille[0]); ++i){
+      if(!run_contention<gate_sharable_mutex>("gate_sharable_mutex", write_permille[i]))
+         return 1;
+      if(!run_contention<interprocess_upgradable_mutex>("interprocess_upgradable_mutex", write_permille[i]))
+         return 1;
+   }
+   return 0;
+}
+
+#include <boost/interprocess/detail/config_end.hpp>
@@ -16,8 +16,57 @@
 #include <boost/interprocess/sync/sharable_lock.hpp>
 #include <boost/interprocess/sync/upgradable_lock.hpp>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/thread.hpp>
 #include "util.hpp"
 
+//The default mutexes are classes, so users can forward declare them
+namespace boost {
+namespace interprocess {
+
+class interprocess_sharable_mutex;
+class interprocess_upgradable_mutex;
+
+}  //namespace interprocess {
+}  //namespace boost {
+
+typedef boost::interprocess::interprocess_upgradable_mutex_t
+   <boost::interprocess::phase_fair_policy> phase_fair_mutex_t;
+
+struct phase_fair_writer
+{
+   phase_fair_writer(phase_fair_mutex_t &mut, unsigned &count)
+      :  m_mut(mut), m_count(count)
+   {}
+
+   void operator()()
+   {
+      boost::interprocess::scoped_lock<phase_fair_mutex_t> lock(m_mut);
+      ++m_count;
+   }
+
+   phase_fair_mutex_t &m_mut;
+   unsigned &m_count;
+};
+
+//More phase-fair writers than outstanding tickets block at once:
+//the last ones wait for a ticket and all of them must get the lock
+bool test_phase_fair_many_writers()
+{
+   const unsigned NumWriters = 48;
+   phase_fair_mutex_t mut;
+   unsigned count = 0;
+   boost::thread_group writers;
+   {
+      boost::interprocess::scoped_lock<phase_fair_mutex_t> lock(mut);
+      for(unsigned i = 0; i != NumWriters; ++i){
+         writers.create_thread(phase_fair_writer(mut, count));
+      }
+      boost::thread::sleep(boost::get_system_time() + boost::posix_time::milliseconds(500));
+   }
+   writers.join_all();
+   return count == NumWriters;
+}
+
 int main ()
 {
    using namespace boost::interprocess;
@@ -26,6 +75,19 @@ int main ()
    test::test_all_mutex<interprocess_upgradable_mutex>();
    test::test_all_sharable_mutex<interprocess_upgradable_mutex>();
 
+   //Alternative scheduling policies
+   test::test_all_lock<interprocess_upgradable_mutex_t<reader_preferring_policy> >();
+   test::test_all_mutex<interprocess_upgradable_mutex_t<reader_preferring_policy> >();
+   test::test_all_sharable_mutex<interprocess_upgradable_mutex_t<reader_preferring_policy> >();
+   test::test_all_lock<interprocess_upgradable_mutex_t<writer_preferring_policy> >();
+   test::test_all_mutex<interprocess_upgradable_mutex_t<writer_preferring_policy> >();
+   test::test_all_sharable_mutex<interprocess_upgradable_mutex_t<writer_preferring_policy> >();
+   test::test_all_lock<interprocess_upgradable_mutex_t<phase_fair_policy> >();
+   test::test_all_mutex<interprocess_upgradable_mutex_t<phase_fair_policy> >();
+   test::test_all_sharable_mutex<interprocess_upgradable_mutex_t<phase_fair_policy> >();
+   if(!test_phase_fair_many_writers())
+      return 1;
+
    //Test lock transition
    {
       typedef interprocess_upgradable_mutex Mutex;